@@ -1,4 +1,6 @@
 #include "Core/Core.h"
+#include "BatchMode.h"
+#include <cstring>
 #include <iostream>
 #include <limits>
 
@@ -183,6 +185,10 @@ static void showManual()
 	std::cout << "3. Exit:\n";
 	std::cout << "   - Exits the CoreRoller app.\n";
 	std::cout << "\n";
+	std::cout << "Batch Mode:\n";
+	std::cout << "   - Run 'App --batch [--input path] [--output path] [--threads N] [--seed N]' to resolve\n";
+	std::cout << "     CSV roll requests without prompts. See BatchMode.h for the line formats.\n";
+	std::cout << "\n";
 	std::cout << "Boons and Banes:\n";
 	std::cout << "   - Boons add extra dice to the roll, keeping the highest results.\n";
 	std::cout << "   - Banes add extra dice but keep the lowest results.\n";
@@ -230,8 +236,20 @@ static void runCoreRoller()
 }
 
 
-int main()
+int main(int argc, char** argv)
 {
+	// Resolve requests from a stream without prompts
+	if (argc > 1 and std::strcmp(argv[1], "--batch") == 0)
+	{
+		BatchOptions options;
+		if (not parseBatchOptions(argc - 2, argv + 2, options))
+		{
+			std::cerr << "Usage: App --batch [--input path] [--output path] [--threads N] [--seed N]\n";
+			return 2;
+		}
+		return runBatchMode(options);
+	}
+
 	// Start CoreRoller
 	runCoreRoller();
 	return 0;
@@ -0,0 +1,324 @@
+#include "BatchMode.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "Core/Core.h"
+#include "Core/ThreadPool.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+	constexpr std::size_t READ_BLOCK_BYTES = std::size_t{ 4 } << 20;  // Initial input buffer size
+	constexpr std::size_t OUTPUT_BUFFER_BYTES = std::size_t{ 1 } << 20;
+	constexpr std::size_t CHUNK_LINES = 4096;                          // Lines resolved per parallel task
+
+	// Request limits, the same as the roll service's (Protocol::isValidRequest)
+	constexpr int MAX_SKILL_LEVEL = 1000;
+	constexpr int MAX_MODIFIER = 64; // Boons and banes are 0 .. MAX_MODIFIER
+	constexpr int MIN_DIFFICULTY_LEVEL = 1;
+	constexpr int MAX_DIFFICULTY_LEVEL = 10;
+
+	bool inRange(int value, int low, int high) { return value >= low and value <= high; }
+
+	// Structure: Line
+	// One input line, without its line terminator.
+	struct Line
+	{
+		const char* begin;
+		const char* end;
+		std::uint64_t number; // 1-based line number in the whole input
+	};
+
+	// Function: readSome
+	// Reads whatever input is available (up to `size` bytes), so piped requests are answered without
+	// waiting for a full buffer. Returns 0 at end of input or on error.
+	std::size_t readSome(std::FILE* input, char* data, std::size_t size)
+	{
+#if defined(_WIN32)
+		return std::fread(data, 1, size, input);
+#else
+		ssize_t count;
+		do
+		{
+			count = ::read(fileno(input), data, size);
+		} while (count < 0 and errno == EINTR);
+		return count > 0 ? static_cast<std::size_t>(count) : 0;
+#endif
+	}
+
+	// Function: parseFields
+	// Parses `count` comma-separated integers following the request letter. No allocation.
+	bool parseFields(const char* cursor, const char* end, int* values, int count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			if (cursor == end or *cursor != ',')
+			{
+				return false;
+			}
+			++cursor;
+			while (cursor != end and *cursor == ' ') ++cursor;
+			auto [next, error] = std::from_chars(cursor, end, values[i]);
+			if (error != std::errc())
+			{
+				return false;
+			}
+			cursor = next;
+			while (cursor != end and *cursor == ' ') ++cursor;
+		}
+		return cursor == end;
+	}
+
+	// Class: OutputBuffer
+	// Growable character buffer results are formatted into; keeps its capacity between blocks.
+	class OutputBuffer
+	{
+	public:
+		void clear() { m_size = 0; }
+		const char* data() const { return m_data.data(); }
+		std::size_t size() const { return m_size; }
+
+		// Function: reserveLine
+		// Makes room for one more formatted result line.
+		void reserveLine()
+		{
+			if (m_data.size() - m_size < MAX_LINE)
+			{
+				m_data.resize(m_data.size() * 2 + MAX_LINE);
+			}
+		}
+
+		void put(char c) { m_data[m_size++] = c; }
+
+		template <typename Integer>
+		void put(Integer value)
+		{
+			auto result = std::to_chars(m_data.data() + m_size, m_data.data() + m_data.size(), value);
+			m_size = static_cast<std::size_t>(result.ptr - m_data.data());
+		}
+
+		void putFlag(bool value) { put(value ? '1' : '0'); }
+
+	private:
+		static constexpr std::size_t MAX_LINE = 128;
+		std::vector<char> m_data;
+		std::size_t m_size = 0;
+	};
+
+	// Function: resolveLine
+	// Parses one request, resolves it with its own stream of the seed and appends the result line.
+	void resolveLine(const Line& line, std::uint64_t seed, OutputBuffer& output)
+	{
+		const char* begin = line.begin;
+		const char* end = line.end;
+		while (begin != end and (*begin == ' ' or *begin == '\t')) ++begin;
+		while (end != begin and (end[-1] == '\r' or end[-1] == ' ' or end[-1] == '\t')) --end;
+		if (begin == end or *begin == '#')
+		{
+			return;
+		}
+
+		output.reserveLine();
+		Core::RngContext rng(seed, line.number);
+		int fields[6];
+		if (*begin == 'O' and parseFields(begin + 1, end, fields, 6)
+			and inRange(fields[0], -MAX_SKILL_LEVEL, MAX_SKILL_LEVEL) and inRange(fields[1], -MAX_SKILL_LEVEL, MAX_SKILL_LEVEL)
+			and inRange(fields[2], 0, MAX_MODIFIER) and inRange(fields[3], 0, MAX_MODIFIER)
+			and inRange(fields[4], 0, MAX_MODIFIER) and inRange(fields[5], 0, MAX_MODIFIER))
+		{
+			Core::OpposedRollResult result = Core::opposedRoll(rng, fields[0], fields[1], fields[2], fields[3], fields[4], fields[5]);
+			output.put('O');
+			output.put(',');
+			output.put(result.winner == Core::Winner::ATTACKER ? 'A' : result.winner == Core::Winner::DEFENDER ? 'D' : 'T');
+			output.put(',');
+			output.put(result.degree);
+			output.put(',');
+			output.putFlag(result.critWin);
+			output.put(',');
+			output.putFlag(result.critLoss);
+			output.put(',');
+			output.put(result.attackerRoll.total);
+			output.put(',');
+			output.put(result.defenderRoll.total);
+		}
+		else if (*begin == 'T' and parseFields(begin + 1, end, fields, 4)
+			and inRange(fields[0], -MAX_SKILL_LEVEL, MAX_SKILL_LEVEL)
+			and inRange(fields[1], MIN_DIFFICULTY_LEVEL, MAX_DIFFICULTY_LEVEL)
+			and inRange(fields[2], 0, MAX_MODIFIER) and inRange(fields[3], 0, MAX_MODIFIER))
+		{
+			Core::TargetRollResult result = Core::targetRoll(rng, fields[0], fields[1], fields[2], fields[3]);
+			output.put('T');
+			output.put(',');
+			output.putFlag(result.success);
+			output.put(',');
+			output.put(result.degree);
+			output.put(',');
+			output.putFlag(result.critSuccess);
+			output.put(',');
+			output.putFlag(result.critFailure);
+			output.put(',');
+			output.put(result.roll.total);
+		}
+		else
+		{
+			output.put('E');
+			output.put(',');
+			output.put(line.number);
+		}
+		output.put('\n');
+	}
+
+	// Function: openFile
+	// Opens a file, or returns the standard stream for "" and "-".
+	std::FILE* openFile(const std::string& path, const char* mode, std::FILE* standard)
+	{
+		return path.empty() or path == "-" ? standard : std::fopen(path.c_str(), mode);
+	}
+}
+
+bool parseBatchOptions(int argc, char** argv, BatchOptions& options)
+{
+	for (int i = 0; i < argc; ++i)
+	{
+		std::string argument = argv[i];
+		if (i + 1 >= argc)
+		{
+			return false; // Every option takes a value
+		}
+		const char* value = argv[++i];
+
+		if (argument == "--input") options.inputPath = value;
+		else if (argument == "--output") options.outputPath = value;
+		else if (argument == "--threads") options.threads = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+		else if (argument == "--seed")
+		{
+			options.seed = std::strtoull(value, nullptr, 10);
+			options.hasSeed = true;
+		}
+		else return false;
+	}
+	return true;
+}//End of parseBatchOptions
+
+int runBatchMode(const BatchOptions& options)
+{
+	std::FILE* input = openFile(options.inputPath, "rb", stdin);
+	if (not input)
+	{
+		std::fprintf(stderr, "Cannot open input file %s\n", options.inputPath.c_str());
+		return 1;
+	}
+	std::FILE* output = openFile(options.outputPath, "wb", stdout);
+	if (not output)
+	{
+		std::fprintf(stderr, "Cannot open output file %s\n", options.outputPath.c_str());
+		return 1;
+	}
+	std::setvbuf(output, nullptr, _IOFBF, OUTPUT_BUFFER_BYTES);
+
+	const std::uint64_t seed = options.hasSeed ? options.seed : Core::RngContext::fromEntropy().next64();
+	std::unique_ptr<Core::ThreadPool> pool;
+	if (options.threads != 1)
+	{
+		pool = std::make_unique<Core::ThreadPool>(options.threads);
+	}
+
+	std::vector<char> buffer(READ_BLOCK_BYTES);
+	std::vector<Line> lines;
+	std::vector<OutputBuffer> chunkOutputs;
+	std::size_t filled = 0;
+	std::uint64_t lineNumber = 0;
+	bool endOfInput = false;
+	bool writeFailed = false;
+
+	while (not endOfInput or filled > 0)
+	{
+		if (not endOfInput)
+		{
+			if (filled == buffer.size())
+			{
+				buffer.resize(buffer.size() * 2); // A single line longer than the buffer
+			}
+			std::size_t count = readSome(input, buffer.data() + filled, buffer.size() - filled);
+			endOfInput = count == 0;
+			filled += count;
+		}
+
+		// Split off every complete line (and the unterminated last line at end of input)
+		lines.clear();
+		const char* cursor = buffer.data();
+		const char* end = buffer.data() + filled;
+		while (const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor)))
+		{
+			lines.push_back({ cursor, newline, ++lineNumber });
+			cursor = newline + 1;
+		}
+		if (endOfInput and cursor != end)
+		{
+			lines.push_back({ cursor, end, ++lineNumber });
+			cursor = end;
+		}
+
+		// Resolve the lines in chunks, in parallel if requested, then write the chunks in order
+		const std::size_t chunkCount = (lines.size() + CHUNK_LINES - 1) / CHUNK_LINES;
+		if (chunkOutputs.size() < chunkCount)
+		{
+			chunkOutputs.resize(chunkCount);
+		}
+		auto resolveChunk = [&](std::size_t chunk, unsigned) {
+			OutputBuffer& chunkOutput = chunkOutputs[chunk];
+			chunkOutput.clear();
+			std::size_t last = std::min(lines.size(), (chunk + 1) * CHUNK_LINES);
+			for (std::size_t i = chunk * CHUNK_LINES; i < last; ++i)
+			{
+				resolveLine(lines[i], seed, chunkOutput);
+			}
+		};
+		if (pool and chunkCount > 1)
+		{
+			pool->parallelFor(chunkCount, resolveChunk);
+		}
+		else
+		{
+			for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+			{
+				resolveChunk(chunk, 0);
+			}
+		}
+		for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			const OutputBuffer& chunkOutput = chunkOutputs[chunk];
+			writeFailed |= std::fwrite(chunkOutput.data(), 1, chunkOutput.size(), output) != chunkOutput.size();
+		}
+		if (chunkCount > 0)
+		{
+			std::fflush(output); // Once per block, so streaming callers see their results
+		}
+
+		// Keep the unfinished line for the next read
+		std::size_t consumed = static_cast<std::size_t>(cursor - buffer.data());
+		std::memmove(buffer.data(), cursor, filled - consumed);
+		filled -= consumed;
+	}
+
+	if (input != stdin) std::fclose(input);
+	writeFailed |= std::fflush(output) != 0;
+	if (output != stdout) writeFailed |= std::fclose(output) != 0;
+	if (writeFailed)
+	{
+		std::fprintf(stderr, "Failed to write results\n");
+		return 1;
+	}
+	return 0;
+}//End of runBatchMode
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+//BatchMode.h
+// Non-interactive mode: `App --batch` reads roll requests as CSV lines and writes one result line per request.
+//
+// Requests:
+//   O,attackerSkill,defenderSkill,attackerBoons,attackerBanes,defenderBoons,defenderBanes
+//   T,skill,difficulty,boons,banes
+// Results:
+//   O,winner(A|D|T),degree,critWin(0|1),critLoss(0|1),attackerTotal,defenderTotal
+//   T,success(0|1),degree,critSuccess(0|1),critFailure(0|1),total
+//   E,lineNumber                          (malformed or out-of-range request)
+// Skills must be within ±1000, boons and banes within 0..64 and difficulty within 1..10.
+// Blank lines and lines starting with '#' produce no output.
+//
+// Line n of the input is resolved with stream n of the seed, so the output for a given seed does not
+// depend on the thread count or on how the input arrives.
+
+// Structure: BatchOptions
+// Command line options of batch mode.
+struct BatchOptions
+{
+	std::string inputPath;  // Request file ("" or "-" reads stdin)
+	std::string outputPath; // Result file ("" or "-" writes stdout)
+	unsigned threads = 1;   // Worker threads (0 uses every hardware thread)
+	bool hasSeed = false;   // True if --seed was given
+	std::uint64_t seed = 0; // Seed for reproducible results
+};
+
+// Function: parseBatchOptions
+// Parses the arguments following --batch: [--input path] [--output path] [--threads N] [--seed N].
+//
+// Returns:
+// - True if every argument was understood.
+bool parseBatchOptions(int argc, char** argv, BatchOptions& options);
+
+// Function: runBatchMode
+// Resolves every request from the input and writes the results in input order.
+//
+// Returns:
+// - The process exit code: 0 on success, 1 if a file could not be opened or written.
+int runBatchMode(const BatchOptions& options);
@@ -0,0 +1,83 @@
+#include "Arena.h"
+
+#include <algorithm>
+#include <new>
+
+//Arena.cpp
+namespace Core
+{
+	Arena::Arena(std::size_t blockBytes, std::pmr::memory_resource* upstream)
+		: m_upstream(upstream), m_nextBlockBytes(std::max<std::size_t>(blockBytes, 64))
+	{
+	}
+
+	Arena::~Arena()
+	{
+		releaseBlocks();
+	}
+
+	// Function: reset
+	// Rewinds to the start of the current block, first merging several blocks into one.
+	void Arena::reset()
+	{
+		if (m_blocks and m_blocks->next)
+		{
+			const std::size_t combined = m_capacity;
+			releaseBlocks();
+			addBlock(combined);
+		}
+		m_cursor = blockData(m_blocks);
+		m_usedInFullBlocks = 0;
+	}//End of reset
+
+	// Function: do_allocate
+	// Bumps the cursor, moving to a new block when the current one cannot fit the request.
+	void* Arena::do_allocate(std::size_t bytes, std::size_t alignment)
+	{
+		auto padding = [&]() {
+			const auto address = reinterpret_cast<std::uintptr_t>(m_cursor);
+			return (alignment - address % alignment) % alignment;
+		};
+
+		if (not m_cursor or static_cast<std::size_t>(m_end - m_cursor) < padding() + bytes)
+		{
+			if (m_blocks)
+			{
+				m_usedInFullBlocks += static_cast<std::size_t>(m_cursor - blockData(m_blocks));
+			}
+			addBlock(bytes + alignment);
+		}
+		std::byte* memory = m_cursor + padding();
+		m_cursor = memory + bytes;
+		return memory;
+	}//End of do_allocate
+
+	// Function: addBlock
+	// Makes a new block of at least `minimumBytes` usable bytes the current one.
+	void Arena::addBlock(std::size_t minimumBytes)
+	{
+		const std::size_t size = std::max(m_nextBlockBytes, minimumBytes);
+		void* memory = m_upstream->allocate(sizeof(Block) + size, alignof(std::max_align_t));
+		m_blocks = new (memory) Block{ m_blocks, size };
+		m_cursor = blockData(m_blocks);
+		m_end = m_cursor + size;
+		m_capacity += size;
+		m_nextBlockBytes = size * 2;
+		++m_upstreamAllocations;
+	}//End of addBlock
+
+	// Function: releaseBlocks
+	// Returns every block to the upstream resource.
+	void Arena::releaseBlocks()
+	{
+		while (m_blocks)
+		{
+			Block* next = m_blocks->next;
+			m_upstream->deallocate(m_blocks, sizeof(Block) + m_blocks->size, alignof(std::max_align_t));
+			m_blocks = next;
+		}
+		m_cursor = m_end = nullptr;
+		m_capacity = 0;
+		m_usedInFullBlocks = 0;
+	}//End of releaseBlocks
+}//End of Namespace Core
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+//Arena.h
+namespace Core
+{
+	// Class: Arena
+	// Bump-pointer memory resource for turn- or session-scoped roll results.
+	//
+	// Allocations advance a cursor through blocks taken from the upstream resource; deallocation does
+	// nothing, and reset() releases everything at once. When a turn needed more than one block, reset()
+	// replaces them with a single block of their combined size, so a workload that repeats similar turns
+	// stops calling the upstream resource after the first one.
+	//
+	// Pass an Arena to the std::pmr overloads of rollDice, skillRoll, opposedRoll and targetRoll. Results
+	// allocated from it must not be read after reset() or after the arena is destroyed. Passed as an Arena*,
+	// the arena tells them to leave their blocks alone (see RollMemory), so destroying them later is fine.
+	// Not thread-safe: use one arena per thread.
+	class Arena : public std::pmr::memory_resource
+	{
+	public:
+		static constexpr std::size_t DEFAULT_BLOCK_BYTES = std::size_t{ 16 } << 10;
+
+		// Constructor: blockBytes is the size of the first block; later blocks double in size.
+		explicit Arena(std::size_t blockBytes = DEFAULT_BLOCK_BYTES,
+			std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+		~Arena() override;
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		// Function: reset
+		// Releases every allocation made since the last reset, keeping the memory for reuse.
+		void reset();
+
+		// Function: bytesUsed
+		// Bytes handed out since the last reset, including alignment padding.
+		std::size_t bytesUsed() const { return m_usedInFullBlocks + static_cast<std::size_t>(m_cursor - blockData(m_blocks)); }
+
+		// Function: capacity
+		// Bytes available across all blocks currently held.
+		std::size_t capacity() const { return m_capacity; }
+
+		// Function: upstreamAllocations
+		// Number of blocks requested from the upstream resource over the arena's lifetime.
+		std::uint64_t upstreamAllocations() const { return m_upstreamAllocations; }
+
+	private:
+		// Structure: Block
+		// Header at the start of every block; the usable bytes follow it.
+		struct Block
+		{
+			Block* next;
+			std::size_t size; // Usable bytes after the header
+		};
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void*, std::size_t, std::size_t) override {}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+		void addBlock(std::size_t minimumBytes);
+		void releaseBlocks();
+		static std::byte* blockData(Block* block) { return block ? reinterpret_cast<std::byte*>(block + 1) : nullptr; }
+
+		std::pmr::memory_resource* m_upstream;
+		std::size_t m_nextBlockBytes;
+		Block* m_blocks = nullptr;        // Current block first
+		std::byte* m_cursor = nullptr;    // Next free byte of the current block
+		std::byte* m_end = nullptr;       // End of the current block
+		std::size_t m_usedInFullBlocks = 0; // Bytes handed out from blocks before the current one
+		std::size_t m_capacity = 0;
+		std::uint64_t m_upstreamAllocations = 0;
+	};
+}//End of Namespace Core
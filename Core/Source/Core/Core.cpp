@@ -1,18 +1,330 @@
 #include "Core.h"
 
+#include <array>
+
+#include "Arena.h"
+#include "Dice.h"
+#include "DiceKernels.h"
+#include "Metrics.h"
+
 namespace
 {
-	// Static RNG setup (translation unit scope)
-	static std::random_device rd;      // Seed source
-	static std::mt19937 gen(rd());     // Mersenne Twister RNG
+	// Dice are generated ahead in blocks of this size (or of the largest pool, if that is bigger).
+	constexpr std::size_t FEED_BLOCK_SIZE = 256;
+
+	// Function: isValidSkillConfig
+	// Mirrors the parameter checks skillRoll has always applied.
+	bool isValidSkillConfig(int baseDiceCount, int diceSides, int minValue)
+	{
+		return baseDiceCount > 0 and diceSides > 0 and minValue <= diceSides;
+	}
+
+	// Function: fitsRows
+	// True if an optional output span is empty or can hold `rows` entries of `width` values each.
+	template <typename T>
+	bool fitsRows(std::span<T> values, std::size_t rows, std::size_t width = 1)
+	{
+		return values.empty() or values.size() >= rows * width;
+	}
+
+	bool fitsRows(const Core::SkillRollBatchOutput& output, std::size_t rows, int baseDiceCount)
+	{
+		return fitsRows(output.totals, rows) and fitsRows(output.critSuccess, rows)
+			and fitsRows(output.critFailure, rows)
+			and fitsRows(output.dice, rows, static_cast<std::size_t>(baseDiceCount));
+	}
+
+	// Function: poolSize
+	// Number of dice one skill roll rolls.
+	int poolSize(int boons, int banes, int baseDiceCount)
+	{
+		return baseDiceCount + std::abs(boons - banes);
+	}
+
+	// Structure: PoolSizes
+	// Dice needed by a whole batch of rolls.
+	struct PoolSizes
+	{
+		std::size_t total = 0; // Dice rolled across the batch
+		int largest = 0;       // Dice rolled by the biggest single roll
+	};
+
+	void addPoolSizes(PoolSizes& sizes, std::span<const int> boons, std::span<const int> banes, int baseDiceCount)
+	{
+		for (std::size_t i = 0; i < boons.size(); ++i)
+		{
+			int dice = poolSize(boons[i], banes[i], baseDiceCount);
+			sizes.total += dice;
+			sizes.largest = std::max(sizes.largest, dice);
+		}
+	}
+
+	// Class: DiceFeed
+	// Generates a batch's dice in blocks through the dice kernels and hands them out one roll at a time.
+	// It never generates more dice than the batch still needs, so the RngContext ends exactly where
+	// rolling every die with RngContext::uniform would have left it.
+	class DiceFeed
+	{
+	public:
+		DiceFeed(Core::RngContext& rng, const Core::Kernels::KernelTable& kernels, int minValue, int maxValue, const PoolSizes& sizes,
+			std::pmr::memory_resource* scratch)
+			: m_rng(rng), m_kernels(kernels), m_minValue(minValue), m_maxValue(maxValue), m_remaining(sizes.total),
+			  m_capacity(std::max<std::size_t>(FEED_BLOCK_SIZE, sizes.largest)), m_heap(scratch)
+		{
+			if (m_capacity > FEED_BLOCK_SIZE)
+			{
+				m_heap.resize(m_capacity);
+			}
+		}
+
+		// Function: take
+		// Returns the next `count` dice. The pointer is valid until the next call.
+		int* take(int count)
+		{
+			int* dice = m_heap.empty() ? m_stack.data() : m_heap.data();
+			if (m_end - m_begin < static_cast<std::size_t>(count))
+			{
+				// Keep the leftover dice and top the buffer up
+				std::copy(dice + m_begin, dice + m_end, dice);
+				m_end -= m_begin;
+				m_begin = 0;
+				std::size_t generated = std::min(m_capacity - m_end, m_remaining);
+				Core::Kernels::generateDice(m_kernels, m_rng, { dice + m_end, generated }, m_minValue, m_maxValue);
+				m_end += generated;
+				m_remaining -= generated;
+			}
+
+			int* taken = dice + m_begin;
+			m_begin += count;
+			return taken;
+		}
+
+	private:
+		Core::RngContext& m_rng;
+		const Core::Kernels::KernelTable& m_kernels;
+		int m_minValue;
+		int m_maxValue;
+		std::size_t m_remaining;  // Dice the batch still needs that have not been generated
+		std::size_t m_capacity;
+		std::size_t m_begin = 0;  // First unused die in the buffer
+		std::size_t m_end = 0;    // One past the last generated die
+		std::array<int, FEED_BLOCK_SIZE> m_stack;
+		std::pmr::vector<int> m_heap;
+	};
+
+	// Class: SelectedDice
+	// Scratch buffer the scalar roll functions collect one roll's selected dice in before packing them
+	// into a DiceRolls. Lives on the stack unless baseDiceCount is unusually large, in which case it and
+	// the packed dice come from `memory`.
+	class SelectedDice
+	{
+	public:
+		SelectedDice(int baseDiceCount, Core::RollMemory memory)
+			: m_count(baseDiceCount > 0 ? static_cast<std::size_t>(baseDiceCount) : 0), m_release(memory.release), m_heap(memory.resource)
+		{
+			if (m_count > m_stack.size())
+			{
+				m_heap.resize(m_count);
+			}
+		}
+
+		std::span<int> dice() { return { m_heap.empty() ? m_stack.data() : m_heap.data(), m_count }; }
+
+		// Function: storeInto
+		// Copies the collected dice into `rolls`.
+		void storeInto(Core::DiceRolls& rolls) { rolls.assign(dice(), m_heap.get_allocator().resource(), m_release); }
+
+	private:
+		std::size_t m_count;
+		Core::BlockRelease m_release;
+		std::array<int, Core::DiceRolls::INLINE_CAPACITY> m_stack;
+		std::pmr::vector<int> m_heap;
+	};
+
+	// Function: isDefaultConfig
+	// True if a dice configuration is the one DefaultDice is specialized for.
+	bool isDefaultConfig(int baseDiceCount, int diceSides, int minValue)
+	{
+		return baseDiceCount == Core::DefaultDice::BASE_DICE_COUNT and diceSides == Core::DefaultDice::DICE_SIDES
+			and minValue == Core::DefaultDice::MIN_VALUE;
+	}
+
+	// Function: recordDefaultRoll
+	// Records a skill roll resolved by DefaultDice, which is not instrumented itself.
+	void recordDefaultRoll(const Core::SkillRollResult& roll, int skillLevel, int boons, int banes)
+	{
+		Core::metrics::recordSkillRoll(boons, banes, poolSize(boons, banes, Core::DefaultDice::BASE_DICE_COUNT),
+			roll.total - skillLevel, roll.critSuccess, roll.critFailure);
+	}
+
+	// Structure: SkillRollOutcome
+	// Total and crit flags of one resolved skill roll.
+	struct SkillRollOutcome
+	{
+		int total;
+		bool critSuccess;
+		bool critFailure;
+	};
+
+	// Function: resolveSkillRoll
+	// Resolves one skill roll from its rolled pool and leaves the selected dice in the first
+	// baseDiceCount entries, best first when boons or banes applied.
+	SkillRollOutcome resolveSkillRoll(const Core::Kernels::KernelTable& kernels, int* pool,
+		int skillLevel, int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		// When boons exceed banes keep the highest baseDiceCount rolls, when banes exceed boons keep
+		// the lowest, and when they cancel out keep the rolls as they are.
+		if (boons != banes)
+		{
+			kernels.selectKept(pool, poolSize(boons, banes, baseDiceCount), baseDiceCount, boons > banes);
+		}
+
+		// Calculate the total (including the skill level) and check for critical success or failure
+		Core::Kernels::KeptSummary summary = kernels.summarizeKept(pool, baseDiceCount, diceSides, minValue);
+		Core::metrics::recordSkillRoll(boons, banes, poolSize(boons, banes, baseDiceCount),
+			summary.total, summary.critSuccess, summary.critFailure);
+		return { skillLevel + summary.total, summary.critSuccess, summary.critFailure };
+	}
+
+	// Function: rollSkillFrom
+	// Resolves one skill roll from a PackedDice or PrefetchedDice. The dice configuration must be valid.
+	template <typename Source>
+	Core::SkillRollResult rollSkillFrom(Source& source, int skillLevel, int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		if (isDefaultConfig(baseDiceCount, diceSides, minValue))
+		{
+			Core::SkillRollResult result = Core::DefaultDice::skillRoll(source, skillLevel, boons, banes);
+			recordDefaultRoll(result, skillLevel, boons, banes);
+			return result;
+		}
+
+		SelectedDice pool(poolSize(boons, banes, baseDiceCount), std::pmr::new_delete_resource());
+		source.fill(pool.dice(), minValue, diceSides);
+		SkillRollOutcome outcome = resolveSkillRoll(Core::Kernels::activeKernelTable(), pool.dice().data(),
+			skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+
+		Core::SkillRollResult result{ outcome.total, {}, outcome.critSuccess, outcome.critFailure };
+		result.rolls.assign(pool.dice().first(static_cast<std::size_t>(baseDiceCount)));
+		return result;
+	}
+
+	// Function: rollDiceFrom, skillRollFrom, opposedRollFrom, targetRollFrom
+	// The public rolls over a dice source with roll() and fill(), such as PackedDice or PrefetchedDice. Same
+	// rules as the RngContext overloads; only the source of the dice differs.
+	template <typename Source>
+	std::vector<int> rollDiceFrom(Source& dice, int rollCount, int diceSides, int minValue)
+	{
+		if (diceSides < minValue or rollCount <= 0)
+		{
+			return {};
+		}
+		std::vector<int> rolls(rollCount);
+		dice.fill(rolls, minValue, diceSides);
+		return rolls;
+	}
+
+	template <typename Source>
+	Core::SkillRollResult skillRollFrom(Source& dice, int skillLevel, int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		Core::metrics::CallScope metricsScope(Core::metrics::RollKind::SKILL);
+		if (not isValidSkillConfig(baseDiceCount, diceSides, minValue))
+		{
+			Core::metrics::recordValidationFailure(Core::metrics::RollKind::SKILL);
+			return { skillLevel, {}, false, false };
+		}
+		return rollSkillFrom(dice, skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
+
+	template <typename Source>
+	Core::OpposedRollResult opposedRollFrom(Source& dice, int attackerSkillLevel, int defenderSkillLevel,
+		int attackerBoons, int attackerBanes,
+		int defenderBoons, int defenderBanes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		Core::metrics::CallScope metricsScope(Core::metrics::RollKind::OPPOSED);
+		Core::OpposedRollResult result{ Core::Winner::TIE, 0,
+			{ attackerSkillLevel, {}, false, false }, { defenderSkillLevel, {}, false, false }, false, false };
+		if (isValidSkillConfig(baseDiceCount, diceSides, minValue))
+		{
+			result.attackerRoll = rollSkillFrom(dice, attackerSkillLevel, attackerBoons, attackerBanes, baseDiceCount, diceSides, minValue);
+			result.defenderRoll = rollSkillFrom(dice, defenderSkillLevel, defenderBoons, defenderBanes, baseDiceCount, diceSides, minValue);
+		}
+		else
+		{
+			Core::metrics::recordValidationFailure(Core::metrics::RollKind::OPPOSED);
+		}
+
+		Core::OpposedOutcome outcome = Core::decideOpposedOutcome(
+			attackerSkillLevel, result.attackerRoll.total, result.attackerRoll.critSuccess, result.attackerRoll.critFailure,
+			defenderSkillLevel, result.defenderRoll.total, result.defenderRoll.critSuccess, result.defenderRoll.critFailure);
+		result.winner = outcome.winner;
+		result.degree = outcome.degree;
+		result.critWin = outcome.critWin;
+		result.critLoss = outcome.critLoss;
+		return result;
+	}
+
+	template <typename Source>
+	Core::TargetRollResult targetRollFrom(Source& dice, int skillLevel, int difficultyLevel,
+		int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		Core::metrics::CallScope metricsScope(Core::metrics::RollKind::TARGET);
+		Core::TargetRollResult result{ false, 0, { skillLevel, {}, false, false }, false, false };
+		if (isValidSkillConfig(baseDiceCount, diceSides, minValue))
+		{
+			result.roll = rollSkillFrom(dice, skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+		}
+		else
+		{
+			Core::metrics::recordValidationFailure(Core::metrics::RollKind::TARGET);
+		}
+
+		int targetNumber = difficultyLevel * Core::DIFFICULTY_SCALING_FACTOR;
+		result.success = result.roll.total >= targetNumber;
+		result.degree = (result.roll.total - targetNumber) / Core::DIFFICULTY_SCALING_FACTOR;
+		result.critSuccess = result.roll.critSuccess;
+		result.critFailure = result.roll.critFailure;
+		return result;
+	}//End of rollDiceFrom, skillRollFrom, opposedRollFrom, targetRollFrom
+
+
+	// Function: storeSkillRoll
+	// Writes one resolved skill roll into row `row` of the optional output spans.
+	void storeSkillRoll(const Core::SkillRollBatchOutput& output, std::size_t row,
+		const SkillRollOutcome& outcome, const int* selected, int baseDiceCount)
+	{
+		if (not output.totals.empty()) output.totals[row] = outcome.total;
+		if (not output.critSuccess.empty()) output.critSuccess[row] = outcome.critSuccess;
+		if (not output.critFailure.empty()) output.critFailure[row] = outcome.critFailure;
+		if (selected and not output.dice.empty())
+		{
+			std::copy(selected, selected + baseDiceCount, output.dice.begin() + row * baseDiceCount);
+		}
+	}
 }
 
 //Core.cpp
 namespace Core
 {
+	// Batch implementations behind both the batch and the scalar entry points, which each count their
+	// own calls in Core::metrics
+	static bool resolveSkillRollBatch(RngContext& rng, const SkillRollBatchInput& input, const SkillRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue, std::pmr::memory_resource* scratch);
+	static bool resolveOpposedRollBatch(RngContext& rng, const OpposedRollBatchInput& input, const OpposedRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue, std::pmr::memory_resource* scratch);
+	static bool resolveTargetRollBatch(RngContext& rng, const TargetRollBatchInput& input, const TargetRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue, std::pmr::memory_resource* scratch);
+
 	// Function: rollDice
 	// Rolls a specified number of dice and returns the results.
 	std::vector<int> rollDice(int rollCount, int diceSides, int minValue)
+	{
+		return rollDice(defaultRngContext(), rollCount, diceSides, minValue);
+	}
+
+	std::vector<int> rollDice(RngContext& rng, int rollCount, int diceSides, int minValue)
 	{
 		// Validate input parameters
 		if (diceSides < minValue or rollCount <= 0)
@@ -20,176 +332,489 @@ namespace Core
 			return {}; // Return an empty vector for invalid parameters
 		}
 
-		// Random number
-		std::uniform_int_distribution<> dis(minValue, diceSides);
-
 		// Preallocate the vector and fill it with rolls
 		std::vector<int> Dicerolls(rollCount);
-		for (int i = 0; i < rollCount; ++i)
-		{
-			Dicerolls[i] = dis(gen);
-		}
+		rollDiceBatch(rng, Dicerolls, diceSides, minValue);
 
 		return Dicerolls;
 	}//End of rollDice
 
+	RollMemory::RollMemory(Arena* arena)
+		: resource(arena), release(BlockRelease::NONE)
+	{
+	}
+
+	std::pmr::vector<int> rollDice(std::pmr::memory_resource* resource, int rollCount, int diceSides, int minValue)
+	{
+		return rollDice(defaultRngContext(), resource, rollCount, diceSides, minValue);
+	}
+
+	std::pmr::vector<int> rollDice(RngContext& rng, std::pmr::memory_resource* resource, int rollCount, int diceSides, int minValue)
+	{
+		if (diceSides < minValue or rollCount <= 0)
+		{
+			return std::pmr::vector<int>(resource);
+		}
+
+		std::pmr::vector<int> dice(rollCount, resource);
+		rollDiceBatch(rng, dice, diceSides, minValue);
+		return dice;
+	}
+
 	 // Function: skillRoll
 	// Performs a skill roll, including adjustments for boons and banes.
 	SkillRollResult skillRoll(int skillLevel, int boons, int banes, int baseDiceCount, int diceSides, int minValue)
 	{
+		return skillRoll(defaultRngContext(), skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
+
+	SkillRollResult skillRoll(RngContext& rng, int skillLevel, int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		return skillRoll(rng, std::pmr::new_delete_resource(), skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
+
+	SkillRollResult skillRoll(RollMemory memory, int skillLevel, int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		return skillRoll(defaultRngContext(), memory, skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
+
+	SkillRollResult skillRoll(RngContext& rng, RollMemory memory,
+		int skillLevel, int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		metrics::CallScope metricsScope(metrics::RollKind::SKILL);
+		if (isDefaultConfig(baseDiceCount, diceSides, minValue))
+		{
+			SkillRollResult result = DefaultDice::skillRoll(rng, skillLevel, boons, banes);
+			recordDefaultRoll(result, skillLevel, boons, banes);
+			return result;
+		}
+
+		SkillRollResult result{ skillLevel, {}, false, false };
+
 		// Validate input parameters
-		if (baseDiceCount <= 0 or diceSides <= 0 or minValue > diceSides)
+		if (not isValidSkillConfig(baseDiceCount, diceSides, minValue))
 		{
-			return { skillLevel, {}, false, false }; // Invalid roll
+			metrics::recordValidationFailure(metrics::RollKind::SKILL);
+			return result; // Invalid roll
 		}
 
-		// Calculate the total number of extra rolls caused by the imbalance between boons and banes.
-		int extraRolls = std::abs(boons - banes);
+		SelectedDice selected(baseDiceCount, memory);
+		resolveSkillRollBatch(rng, { { &skillLevel, 1 }, { &boons, 1 }, { &banes, 1 } },
+			{ { &result.total, 1 }, { &result.critSuccess, 1 }, { &result.critFailure, 1 }, selected.dice() },
+			baseDiceCount, diceSides, minValue, memory.resource);
+		selected.storeInto(result.rolls);
+
+		return result;
+	}//End of skillRoll
+
+	// Function: opposedRoll
+	// Performs an opposed roll between two contestants.
+	OpposedRollResult opposedRoll(int attackerSkillLevel, int defenderSkillLevel,
+		int attackerBoons, int attackerBanes,
+		int defenderBoons, int defenderBanes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return opposedRoll(defaultRngContext(), attackerSkillLevel, defenderSkillLevel,
+			attackerBoons, attackerBanes, defenderBoons, defenderBanes, baseDiceCount, diceSides, minValue);
+	}
 
-		// The total number of dice to roll is the sum of base dice and any extra rolls.
-		int totalRolls = baseDiceCount + extraRolls;
+	OpposedRollResult opposedRoll(RngContext& rng, int attackerSkillLevel, int defenderSkillLevel,
+		int attackerBoons, int attackerBanes,
+		int defenderBoons, int defenderBanes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return opposedRoll(rng, std::pmr::new_delete_resource(), attackerSkillLevel, defenderSkillLevel,
+			attackerBoons, attackerBanes, defenderBoons, defenderBanes, baseDiceCount, diceSides, minValue);
+	}
 
-		// Generate all the required dice rolls.
-		std::vector<int> Dicerolls = rollDice(totalRolls, diceSides, minValue);
+	OpposedRollResult opposedRoll(RollMemory memory, int attackerSkillLevel, int defenderSkillLevel,
+		int attackerBoons, int attackerBanes,
+		int defenderBoons, int defenderBanes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return opposedRoll(defaultRngContext(), memory, attackerSkillLevel, defenderSkillLevel,
+			attackerBoons, attackerBanes, defenderBoons, defenderBanes, baseDiceCount, diceSides, minValue);
+	}
 
-		// If rollDice returns an empty vector, propagate the error.
-		if (Dicerolls.empty())
+	OpposedRollResult opposedRoll(RngContext& rng, RollMemory memory,
+		int attackerSkillLevel, int defenderSkillLevel,
+		int attackerBoons, int attackerBanes,
+		int defenderBoons, int defenderBanes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		metrics::CallScope metricsScope(metrics::RollKind::OPPOSED);
+		if (isDefaultConfig(baseDiceCount, diceSides, minValue))
 		{
-			return { skillLevel, {}, false, false }; // Invalid roll
+			OpposedRollResult result = DefaultDice::opposedRoll(rng, attackerSkillLevel, defenderSkillLevel,
+				attackerBoons, attackerBanes, defenderBoons, defenderBanes);
+			recordDefaultRoll(result.attackerRoll, attackerSkillLevel, attackerBoons, attackerBanes);
+			recordDefaultRoll(result.defenderRoll, defenderSkillLevel, defenderBoons, defenderBanes);
+			return result;
 		}
 
-		// Prepare a vector to store the final selected rolls.
-		std::vector<int> selectedRolls(baseDiceCount);
+		OpposedRollResult result{ Winner::TIE, 0,
+			{ attackerSkillLevel, {}, false, false }, { defenderSkillLevel, {}, false, false }, false, false };
 
-		if (boons > banes)
+		const bool valid = isValidSkillConfig(baseDiceCount, diceSides, minValue);
+		if (not valid)
 		{
-			// When boons exceed banes, select the highest baseDiceCount rolls.
-			std::nth_element(Dicerolls.begin(), Dicerolls.begin() + baseDiceCount, Dicerolls.end(),
-				[](int a, int b) { return a > b; });
-
-			std::copy(Dicerolls.begin(), Dicerolls.begin() + baseDiceCount, selectedRolls.begin());
+			metrics::recordValidationFailure(metrics::RollKind::OPPOSED);
 		}
-		else if (banes > boons)
-		{
-			// When banes exceed boons, select the lowest baseDiceCount rolls.
-			std::nth_element(Dicerolls.begin(), Dicerolls.begin() + baseDiceCount, Dicerolls.end());
+		SelectedDice attackerDice(valid ? baseDiceCount : 0, memory);
+		SelectedDice defenderDice(valid ? baseDiceCount : 0, memory);
+
+		SkillRollBatchOutput attackerRoll{ { &result.attackerRoll.total, 1 },
+			{ &result.attackerRoll.critSuccess, 1 }, { &result.attackerRoll.critFailure, 1 }, attackerDice.dice() };
+		SkillRollBatchOutput defenderRoll{ { &result.defenderRoll.total, 1 },
+			{ &result.defenderRoll.critSuccess, 1 }, { &result.defenderRoll.critFailure, 1 }, defenderDice.dice() };
+
+		resolveOpposedRollBatch(rng,
+			{ { &attackerSkillLevel, 1 }, { &defenderSkillLevel, 1 },
+			  { &attackerBoons, 1 }, { &attackerBanes, 1 }, { &defenderBoons, 1 }, { &defenderBanes, 1 } },
+			{ { &result.winner, 1 }, { &result.degree, 1 }, { &result.critWin, 1 }, { &result.critLoss, 1 },
+			  attackerRoll, defenderRoll },
+			baseDiceCount, diceSides, minValue, memory.resource);
+
+		attackerDice.storeInto(result.attackerRoll.rolls);
+		defenderDice.storeInto(result.defenderRoll.rolls);
+
+		return result;
+	}//End of opposedRoll
+
+	// Function: targetRoll
+	// Rolls against a target number to determine success or failure.
+	TargetRollResult targetRoll(int skillLevel, int difficultyLevel,
+		int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return targetRoll(defaultRngContext(), skillLevel, difficultyLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
+
+	TargetRollResult targetRoll(RngContext& rng, int skillLevel, int difficultyLevel,
+		int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return targetRoll(rng, std::pmr::new_delete_resource(), skillLevel, difficultyLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
+
+	TargetRollResult targetRoll(RollMemory memory, int skillLevel, int difficultyLevel,
+		int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return targetRoll(defaultRngContext(), memory, skillLevel, difficultyLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
 
-			std::copy(Dicerolls.begin(), Dicerolls.begin() + baseDiceCount, selectedRolls.begin());
+	TargetRollResult targetRoll(RngContext& rng, RollMemory memory, int skillLevel, int difficultyLevel,
+		int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		metrics::CallScope metricsScope(metrics::RollKind::TARGET);
+		if (isDefaultConfig(baseDiceCount, diceSides, minValue))
+		{
+			TargetRollResult result = DefaultDice::targetRoll(rng, skillLevel, difficultyLevel, boons, banes);
+			recordDefaultRoll(result.roll, skillLevel, boons, banes);
+			return result;
 		}
-		else
+
+		TargetRollResult result{ false, 0, { skillLevel, {}, false, false }, false, false };
+
+		const bool valid = isValidSkillConfig(baseDiceCount, diceSides, minValue);
+		if (not valid)
 		{
-			// When boons and banes cancel out, no adjustments are made to the rolls.
-			std::copy(Dicerolls.begin(), Dicerolls.begin() + baseDiceCount, selectedRolls.begin());
+			metrics::recordValidationFailure(metrics::RollKind::TARGET);
 		}
+		SelectedDice selected(valid ? baseDiceCount : 0, memory);
+		resolveTargetRollBatch(rng, { { &skillLevel, 1 }, { &difficultyLevel, 1 }, { &boons, 1 }, { &banes, 1 } },
+			{ { &result.success, 1 }, { &result.degree, 1 },
+			  { { &result.roll.total, 1 }, { &result.roll.critSuccess, 1 }, { &result.roll.critFailure, 1 }, selected.dice() } },
+			baseDiceCount, diceSides, minValue, memory.resource);
+		selected.storeInto(result.roll.rolls);
 
 		// Check for critical success or failure
-		bool critSuccess = std::all_of(selectedRolls.begin(), selectedRolls.end(), [diceSides](int roll) { return roll == diceSides; });
-		bool critFailure = std::all_of(selectedRolls.begin(), selectedRolls.end(), [minValue](int roll) { return roll == minValue; });
+		result.critSuccess = result.roll.critSuccess;
+		result.critFailure = result.roll.critFailure;
 
-		// Calculate the total roll including the skill level.
-		int total = std::accumulate(selectedRolls.begin(), selectedRolls.end(), skillLevel);
+		return result;
+	}	//End of targetRoll
 
-		// Return the result structure.
-		return { total, selectedRolls, critSuccess, critFailure };
-	}//End of skillRoll
+	// Function: rollDice, skillRoll, opposedRoll, targetRoll (PackedDice, PrefetchedDice)
+	// Same rules as the RngContext overloads; only the source of the dice differs.
+	std::vector<int> rollDice(PackedDice& dice, int rollCount, int diceSides, int minValue)
+	{
+		return rollDiceFrom(dice, rollCount, diceSides, minValue);
+	}
 
-	// Function: opposedRoll
-	// Performs an opposed roll between two contestants.
-	OpposedRollResult opposedRoll(int attackerSkillLevel, int defenderSkillLevel,
+	SkillRollResult skillRoll(PackedDice& dice, int skillLevel, int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		return skillRollFrom(dice, skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
+
+	OpposedRollResult opposedRoll(PackedDice& dice, int attackerSkillLevel, int defenderSkillLevel,
 		int attackerBoons, int attackerBanes,
 		int defenderBoons, int defenderBanes,
 		int baseDiceCount, int diceSides, int minValue)
 	{
-		// Perform skill rolls for both contestants
-		SkillRollResult attackerResult = skillRoll(attackerSkillLevel, attackerBoons, attackerBanes, baseDiceCount, diceSides, minValue);
-		SkillRollResult defenderResult = skillRoll(defenderSkillLevel, defenderBoons, defenderBanes, baseDiceCount, diceSides, minValue);
+		return opposedRollFrom(dice, attackerSkillLevel, defenderSkillLevel, attackerBoons, attackerBanes,
+			defenderBoons, defenderBanes, baseDiceCount, diceSides, minValue);
+	}
+
+	TargetRollResult targetRoll(PackedDice& dice, int skillLevel, int difficultyLevel,
+		int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return targetRollFrom(dice, skillLevel, difficultyLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
+
+	std::vector<int> rollDice(PrefetchedDice& dice, int rollCount, int diceSides, int minValue)
+	{
+		return rollDiceFrom(dice, rollCount, diceSides, minValue);
+	}
+
+	SkillRollResult skillRoll(PrefetchedDice& dice, int skillLevel, int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		return skillRollFrom(dice, skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}
 
-		// Initialize result variables
-		Winner winner = Winner::TIE;
-		int degree = 0;
-		bool critWin = false;
-		bool critLoss = false;
+	OpposedRollResult opposedRoll(PrefetchedDice& dice, int attackerSkillLevel, int defenderSkillLevel,
+		int attackerBoons, int attackerBanes,
+		int defenderBoons, int defenderBanes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return opposedRollFrom(dice, attackerSkillLevel, defenderSkillLevel, attackerBoons, attackerBanes,
+			defenderBoons, defenderBanes, baseDiceCount, diceSides, minValue);
+	}
 
-		// Determine winner based on totals
-		if (attackerResult.total > defenderResult.total)
+	TargetRollResult targetRoll(PrefetchedDice& dice, int skillLevel, int difficultyLevel,
+		int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return targetRollFrom(dice, skillLevel, difficultyLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	}//End of PackedDice and PrefetchedDice overloads
+
+	// Function: rollDiceBatch
+	// Fills a caller-owned buffer with dice rolls without allocating.
+	bool rollDiceBatch(std::span<int> dice, int diceSides, int minValue)
+	{
+		return rollDiceBatch(defaultRngContext(), dice, diceSides, minValue);
+	}
+
+	bool rollDiceBatch(RngContext& rng, std::span<int> dice, int diceSides, int minValue)
+	{
+		// Validate input parameters
+		if (diceSides < minValue)
 		{
-			winner = Winner::ATTACKER;
+			return false;
 		}
-		else if (defenderResult.total > attackerResult.total)
+
+		Kernels::generateDice(Kernels::activeKernelTable(), rng, dice, minValue, diceSides);
+
+		return true;
+	}//End of rollDiceBatch
+
+	// Function: skillRollBatch
+	// Performs N skill rolls sharing one dice configuration.
+	bool skillRollBatch(const SkillRollBatchInput& input, const SkillRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return skillRollBatch(defaultRngContext(), input, output, baseDiceCount, diceSides, minValue);
+	}
+
+	bool skillRollBatch(RngContext& rng, const SkillRollBatchInput& input, const SkillRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		metrics::CallScope metricsScope(metrics::RollKind::SKILL_BATCH, input.skillLevels.size());
+		if (not resolveSkillRollBatch(rng, input, output, baseDiceCount, diceSides, minValue, std::pmr::new_delete_resource()))
 		{
-			winner = Winner::DEFENDER;
+			metrics::recordValidationFailure(metrics::RollKind::SKILL_BATCH);
+			return false;
 		}
-		else
+		return true;
+	}//End of skillRollBatch
+
+	// Function: resolveSkillRollBatch
+	// Validates and resolves a batch without recording the call.
+	static bool resolveSkillRollBatch(RngContext& rng, const SkillRollBatchInput& input, const SkillRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue, std::pmr::memory_resource* scratch)
+	{
+		const std::size_t count = input.skillLevels.size();
+		if (input.boons.size() != count or input.banes.size() != count or not fitsRows(output, count, baseDiceCount))
 		{
-			// If totals are the same, compare skill levels
-			if (attackerSkillLevel > defenderSkillLevel)
-			{
-				winner = Winner::ATTACKER;
-			}
-			else if (defenderSkillLevel > attackerSkillLevel)
-			{
-				winner = Winner::DEFENDER;
-			}
+			return false;
 		}
 
-		// Adjust the winner based on critical successes and failures
-		if (attackerResult.critSuccess and defenderResult.critSuccess)
+		if (not isValidSkillConfig(baseDiceCount, diceSides, minValue))
 		{
-			// Both crit: Winner stays as determined by total or skill comparison
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				storeSkillRoll(output, i, { input.skillLevels[i], false, false }, nullptr, baseDiceCount);
+			}
+			return false;
 		}
-		else if (attackerResult.critSuccess)
+
+		const Kernels::KernelTable& kernels = Kernels::activeKernelTable();
+		PoolSizes sizes;
+		addPoolSizes(sizes, input.boons, input.banes, baseDiceCount);
+		DiceFeed feed(rng, kernels, minValue, diceSides, sizes, scratch);
+
+		for (std::size_t i = 0; i < count; ++i)
 		{
-			winner = Winner::ATTACKER;
-			critWin = true;
+			int* pool = feed.take(poolSize(input.boons[i], input.banes[i], baseDiceCount));
+			SkillRollOutcome outcome = resolveSkillRoll(kernels, pool,
+				input.skillLevels[i], input.boons[i], input.banes[i], baseDiceCount, diceSides, minValue);
+			storeSkillRoll(output, i, outcome, pool, baseDiceCount);
 		}
-		else if (defenderResult.critSuccess)
+
+		return true;
+	}//End of resolveSkillRollBatch
+
+	// Function: opposedRollBatch
+	// Performs N opposed rolls sharing one dice configuration.
+	bool opposedRollBatch(const OpposedRollBatchInput& input, const OpposedRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return opposedRollBatch(defaultRngContext(), input, output, baseDiceCount, diceSides, minValue);
+	}
+
+	bool opposedRollBatch(RngContext& rng, const OpposedRollBatchInput& input, const OpposedRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		metrics::CallScope metricsScope(metrics::RollKind::OPPOSED_BATCH, input.attackerSkillLevels.size());
+		if (not resolveOpposedRollBatch(rng, input, output, baseDiceCount, diceSides, minValue, std::pmr::new_delete_resource()))
 		{
-			winner = Winner::DEFENDER;
-			critWin = true;
+			metrics::recordValidationFailure(metrics::RollKind::OPPOSED_BATCH);
+			return false;
 		}
-		else if (attackerResult.critFailure && defenderResult.critFailure)
+		return true;
+	}//End of opposedRollBatch
+
+	// Function: resolveOpposedRollBatch
+	// Validates and resolves a batch without recording the call.
+	static bool resolveOpposedRollBatch(RngContext& rng, const OpposedRollBatchInput& input, const OpposedRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue, std::pmr::memory_resource* scratch)
+	{
+		const std::size_t count = input.attackerSkillLevels.size();
+		if (input.defenderSkillLevels.size() != count
+			or input.attackerBoons.size() != count or input.attackerBanes.size() != count
+			or input.defenderBoons.size() != count or input.defenderBanes.size() != count
+			or not fitsRows(output.winners, count) or not fitsRows(output.degrees, count)
+			or not fitsRows(output.critWins, count) or not fitsRows(output.critLosses, count)
+			or not fitsRows(output.attackerRolls, count, baseDiceCount)
+			or not fitsRows(output.defenderRolls, count, baseDiceCount))
 		{
-			// Both fumble: Winner stays as determined by total or skill comparison
+			return false;
 		}
-		else if (attackerResult.critFailure)
+
+		const bool valid = isValidSkillConfig(baseDiceCount, diceSides, minValue);
+		const Kernels::KernelTable& kernels = Kernels::activeKernelTable();
+		PoolSizes sizes;
+		if (valid)
 		{
-			winner = Winner::DEFENDER;
-			critLoss = true;
+			addPoolSizes(sizes, input.attackerBoons, input.attackerBanes, baseDiceCount);
+			addPoolSizes(sizes, input.defenderBoons, input.defenderBanes, baseDiceCount);
 		}
-		else if (defenderResult.critFailure)
+		DiceFeed feed(rng, kernels, minValue, diceSides, sizes, scratch);
+
+		for (std::size_t i = 0; i < count; ++i)
 		{
-			winner = Winner::ATTACKER;
-			critLoss = true;
+			// Invalid configurations resolve both sides as skillRoll's invalid roll.
+			// Each side's dice are stored before the next take() reuses the feed buffer.
+			SkillRollOutcome attacker{ input.attackerSkillLevels[i], false, false };
+			SkillRollOutcome defender{ input.defenderSkillLevels[i], false, false };
+			const int* attackerDice = nullptr;
+			const int* defenderDice = nullptr;
+			if (valid)
+			{
+				int* pool = feed.take(poolSize(input.attackerBoons[i], input.attackerBanes[i], baseDiceCount));
+				attacker = resolveSkillRoll(kernels, pool, input.attackerSkillLevels[i],
+					input.attackerBoons[i], input.attackerBanes[i], baseDiceCount, diceSides, minValue);
+				attackerDice = pool;
+			}
+			storeSkillRoll(output.attackerRolls, i, attacker, attackerDice, baseDiceCount);
+			if (valid)
+			{
+				int* pool = feed.take(poolSize(input.defenderBoons[i], input.defenderBanes[i], baseDiceCount));
+				defender = resolveSkillRoll(kernels, pool, input.defenderSkillLevels[i],
+					input.defenderBoons[i], input.defenderBanes[i], baseDiceCount, diceSides, minValue);
+				defenderDice = pool;
+			}
+			storeSkillRoll(output.defenderRolls, i, defender, defenderDice, baseDiceCount);
+
+			OpposedOutcome outcome = decideOpposedOutcome(
+				input.attackerSkillLevels[i], attacker.total, attacker.critSuccess, attacker.critFailure,
+				input.defenderSkillLevels[i], defender.total, defender.critSuccess, defender.critFailure);
+
+			if (not output.winners.empty()) output.winners[i] = outcome.winner;
+			if (not output.degrees.empty()) output.degrees[i] = outcome.degree;
+			if (not output.critWins.empty()) output.critWins[i] = outcome.critWin;
+			if (not output.critLosses.empty()) output.critLosses[i] = outcome.critLoss;
 		}
 
-		// Calculate the degree of difference
-		degree = std::abs(attackerResult.total - defenderResult.total) / DIFFICULTY_SCALING_FACTOR;
+		return valid;
+	}//End of resolveOpposedRollBatch
 
-		// Return the result
-		return { winner, degree, attackerResult, defenderResult, critWin, critLoss };
-	}//End of opposedRoll
+	// Function: targetRollBatch
+	// Performs N target rolls sharing one dice configuration.
+	bool targetRollBatch(const TargetRollBatchInput& input, const TargetRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		return targetRollBatch(defaultRngContext(), input, output, baseDiceCount, diceSides, minValue);
+	}
 
-	// Function: targetRoll
-	// Rolls against a target number to determine success or failure.
-	TargetRollResult targetRoll(int skillLevel, int difficultyLevel,
-		int boons, int banes,
+	bool targetRollBatch(RngContext& rng, const TargetRollBatchInput& input, const TargetRollBatchOutput& output,
 		int baseDiceCount, int diceSides, int minValue)
 	{
-		// Calculate the target number as difficultyLevel * DIFFICULTY_SCALING_FACTOR
-		int targetNumber = difficultyLevel * DIFFICULTY_SCALING_FACTOR;
+		metrics::CallScope metricsScope(metrics::RollKind::TARGET_BATCH, input.skillLevels.size());
+		if (not resolveTargetRollBatch(rng, input, output, baseDiceCount, diceSides, minValue, std::pmr::new_delete_resource()))
+		{
+			metrics::recordValidationFailure(metrics::RollKind::TARGET_BATCH);
+			return false;
+		}
+		return true;
+	}//End of targetRollBatch
 
-		// Perform the skill roll
-		SkillRollResult roll = skillRoll(skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+	// Function: resolveTargetRollBatch
+	// Validates and resolves a batch without recording the call.
+	static bool resolveTargetRollBatch(RngContext& rng, const TargetRollBatchInput& input, const TargetRollBatchOutput& output,
+		int baseDiceCount, int diceSides, int minValue, std::pmr::memory_resource* scratch)
+	{
+		const std::size_t count = input.skillLevels.size();
+		if (input.difficultyLevels.size() != count or input.boons.size() != count or input.banes.size() != count
+			or not fitsRows(output.successes, count) or not fitsRows(output.degrees, count)
+			or not fitsRows(output.rolls, count, baseDiceCount))
+		{
+			return false;
+		}
 
-		// Determine success or failure
-		bool success = roll.total >= targetNumber;
-		int degree = (roll.total - targetNumber) / DIFFICULTY_SCALING_FACTOR;
+		const bool valid = isValidSkillConfig(baseDiceCount, diceSides, minValue);
+		const Kernels::KernelTable& kernels = Kernels::activeKernelTable();
+		PoolSizes sizes;
+		if (valid)
+		{
+			addPoolSizes(sizes, input.boons, input.banes, baseDiceCount);
+		}
+		DiceFeed feed(rng, kernels, minValue, diceSides, sizes, scratch);
 
-		// Check for critical success or failure
-		bool critSuccess = roll.critSuccess;
-		bool critFailure = roll.critFailure;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			SkillRollOutcome roll{ input.skillLevels[i], false, false };
+			const int* dice = nullptr;
+			if (valid)
+			{
+				int* pool = feed.take(poolSize(input.boons[i], input.banes[i], baseDiceCount));
+				roll = resolveSkillRoll(kernels, pool, input.skillLevels[i],
+					input.boons[i], input.banes[i], baseDiceCount, diceSides, minValue);
+				dice = pool;
+			}
 
-		// Return the result in a TargetRollResult struct
-		return { success, degree, roll, critSuccess, critFailure };
-	}	//End of targetRoll
+			// Calculate the target number as difficultyLevel * DIFFICULTY_SCALING_FACTOR
+			int targetNumber = input.difficultyLevels[i] * DIFFICULTY_SCALING_FACTOR;
+
+			// Determine success or failure
+			if (not output.successes.empty()) output.successes[i] = roll.total >= targetNumber;
+			if (not output.degrees.empty()) output.degrees[i] = (roll.total - targetNumber) / DIFFICULTY_SCALING_FACTOR;
+			storeSkillRoll(output.rolls, i, roll, dice, baseDiceCount);
+		}
+
+		return valid;
+	}//End of resolveTargetRollBatch
 }//End of Namespace Core
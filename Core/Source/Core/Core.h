@@ -6,6 +6,13 @@
 #include <stdexcept>
 #include <random>
 #include <numeric>
+#include <memory_resource>
+#include <span>
+
+#include "DiceRolls.h"
+#include "DicePrefetcher.h"
+#include "PackedDice.h"
+#include "Rng.h"
 
 //Core.h
 namespace Core
@@ -20,12 +27,15 @@ namespace Core
 	constexpr int DEFAULT_SKILL_LEVEL = 0;        // Default skill level modifier
 	constexpr int DIFFICULTY_SCALING_FACTOR = 4;  // Multiplier for degree calculation and target number scaling
 
+	// Every roll function has an overload taking an RngContext as its first parameter. The overloads
+	// without one draw from the calling thread's defaultRngContext().
+
 	// Structure: SkillRollResult
 	// Encapsulates the result of a skill roll.
 	struct SkillRollResult
 	{
 		int total;                   // Total roll value including skill level
-		std::vector<int> rolls;      // Individual dice rolls used in the calculation
+		DiceRolls rolls;             // Individual dice rolls used in the calculation (inline for up to 8 dice)
 		bool critSuccess;            // True if all selected dice rolled the maximum value
 		bool critFailure;            // True if all selected dice rolled the minimum value
 	};
@@ -69,6 +79,137 @@ namespace Core
 		bool critFailure;   // True if the roll is a critical failure
 	};
 
+	// Roll results stay within a cache line so they can be passed and copied cheaply.
+	static_assert(sizeof(OpposedRollResult) <= 64, "OpposedRollResult should fit in a cache line");
+	static_assert(sizeof(TargetRollResult) <= 64, "TargetRollResult should fit in a cache line");
+
+	// Structure: SkillRollBatchInput
+	// Structure-of-arrays view over N skill roll parameter sets.
+	// All spans must have the same length N.
+	struct SkillRollBatchInput
+	{
+		std::span<const int> skillLevels; // Skill level added to each roll total
+		std::span<const int> boons;       // Boons for each roll
+		std::span<const int> banes;       // Banes for each roll
+	};
+
+	// Structure: SkillRollBatchOutput
+	// Caller-owned structure-of-arrays storage for N skill roll results.
+	// Any span may be left empty to skip that field. Non-empty spans must hold at least N entries,
+	// except dice, which holds baseDiceCount selected dice per roll (row-major, N * baseDiceCount).
+	struct SkillRollBatchOutput
+	{
+		std::span<int> totals;       // Total roll value including skill level
+		std::span<bool> critSuccess; // True if all selected dice rolled the maximum value
+		std::span<bool> critFailure; // True if all selected dice rolled the minimum value
+		std::span<int> dice;         // Selected dice, baseDiceCount per roll (best first when boons or banes apply)
+	};
+
+	// Structure: OpposedRollBatchInput
+	// Structure-of-arrays view over N opposed roll parameter sets.
+	// All spans must have the same length N.
+	struct OpposedRollBatchInput
+	{
+		std::span<const int> attackerSkillLevels; // Skill level of each attacker
+		std::span<const int> defenderSkillLevels; // Skill level of each defender
+		std::span<const int> attackerBoons;       // Boons for each attacker
+		std::span<const int> attackerBanes;       // Banes for each attacker
+		std::span<const int> defenderBoons;       // Boons for each defender
+		std::span<const int> defenderBanes;       // Banes for each defender
+	};
+
+	// Structure: OpposedRollBatchOutput
+	// Caller-owned structure-of-arrays storage for N opposed roll results.
+	// Any span may be left empty to skip that field. Non-empty spans must hold at least N entries.
+	struct OpposedRollBatchOutput
+	{
+		std::span<Winner> winners;         // Winner of each opposed roll
+		std::span<int> degrees;            // Difference between the totals divided by DIFFICULTY_SCALING_FACTOR
+		std::span<bool> critWins;          // True if the winner was decided by a critical success
+		std::span<bool> critLosses;        // True if the loser was decided by a critical failure
+		SkillRollBatchOutput attackerRolls; // Optional details of each attacker's roll
+		SkillRollBatchOutput defenderRolls; // Optional details of each defender's roll
+	};
+
+	// Structure: TargetRollBatchInput
+	// Structure-of-arrays view over N target roll parameter sets.
+	// All spans must have the same length N.
+	struct TargetRollBatchInput
+	{
+		std::span<const int> skillLevels;      // Skill level added to each roll total
+		std::span<const int> difficultyLevels; // Difficulty level (1-10) of each roll
+		std::span<const int> boons;            // Boons for each roll
+		std::span<const int> banes;            // Banes for each roll
+	};
+
+	// Structure: TargetRollBatchOutput
+	// Caller-owned structure-of-arrays storage for N target roll results.
+	// Any span may be left empty to skip that field. Non-empty spans must hold at least N entries.
+	struct TargetRollBatchOutput
+	{
+		std::span<bool> successes; // True if the roll meets or exceeds the target number
+		std::span<int> degrees;    // Degree of success (positive) or failure (negative)
+		SkillRollBatchOutput rolls; // Details of each roll (totals, crit flags, optional dice)
+	};
+
+	// Structure: OpposedOutcome
+	// Winner, degree and crit flags derived from two resolved skill rolls.
+	struct OpposedOutcome
+	{
+		Winner winner; // Winner of the opposed roll (ATTACKER, DEFENDER, or TIE)
+		int degree;    // Difference between the two totals divided by DIFFICULTY_SCALING_FACTOR
+		bool critWin;  // True if the winner was decided by a critical success
+		bool critLoss; // True if the loser was decided by a critical failure
+	};
+
+	// Function: decideOpposedOutcome
+	// Applies the opposed roll rules to two resolved skill rolls: higher total wins, ties go to the
+	// higher skill level, and a lone critical success or critical failure overrides the result.
+	//
+	// Returns:
+	// - An OpposedOutcome with the winner, degree and crit flags.
+	constexpr OpposedOutcome decideOpposedOutcome(
+		int attackerSkillLevel, int attackerTotal, bool attackerCritSuccess, bool attackerCritFailure,
+		int defenderSkillLevel, int defenderTotal, bool defenderCritSuccess, bool defenderCritFailure)
+	{
+		OpposedOutcome outcome{ Winner::TIE, 0, false, false };
+
+		// Determine winner based on totals, falling back to skill levels on a tie
+		if (attackerTotal > defenderTotal or (attackerTotal == defenderTotal and attackerSkillLevel > defenderSkillLevel))
+		{
+			outcome.winner = Winner::ATTACKER;
+		}
+		else if (defenderTotal > attackerTotal or (attackerTotal == defenderTotal and defenderSkillLevel > attackerSkillLevel))
+		{
+			outcome.winner = Winner::DEFENDER;
+		}
+
+		// Adjust the winner based on critical successes and failures.
+		// Both crit or both fumble: the winner stays as determined by total or skill comparison.
+		if (attackerCritSuccess and defenderCritSuccess)
+		{
+		}
+		else if (attackerCritSuccess or defenderCritSuccess)
+		{
+			outcome.winner = attackerCritSuccess ? Winner::ATTACKER : Winner::DEFENDER;
+			outcome.critWin = true;
+		}
+		else if (attackerCritFailure and defenderCritFailure)
+		{
+		}
+		else if (attackerCritFailure or defenderCritFailure)
+		{
+			outcome.winner = attackerCritFailure ? Winner::DEFENDER : Winner::ATTACKER;
+			outcome.critLoss = true;
+		}
+
+		// Calculate the degree of difference
+		int difference = attackerTotal - defenderTotal;
+		outcome.degree = (difference < 0 ? -difference : difference) / DIFFICULTY_SCALING_FACTOR;
+
+		return outcome;
+	}
+
 	// Function: rollDice
 	// Rolls a specified number of dice and returns the results.
 	//
@@ -80,6 +221,7 @@ namespace Core
 	// Returns:
 	// - A vector containing the results of the rolls, or an empty vector if the parameters are invalid.
 	std::vector<int> rollDice(int rollCount = DEFAULT_ROLL_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	std::vector<int> rollDice(RngContext& rng, int rollCount = DEFAULT_ROLL_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
 
 	// Function: skillRoll
 	// Performs a skill roll, including adjustments for boons and banes.
@@ -95,6 +237,7 @@ namespace Core
 	// Returns:
 	// - A SkillRollResult struct with the total, critSuccess, and critFailure.
 	SkillRollResult skillRoll(int skillLevel = DEFAULT_SKILL_LEVEL, int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES, int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	SkillRollResult skillRoll(RngContext& rng, int skillLevel = DEFAULT_SKILL_LEVEL, int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES, int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
 
 	// Function: opposedRoll
 	// Performs an opposed roll between two contestants.
@@ -125,6 +268,13 @@ namespace Core
 		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
 		int diceSides = DEFAULT_DICE_SIDES,
 		int minValue = DEFAULT_MIN_VALUE);
+	OpposedRollResult opposedRoll(RngContext& rng,
+		int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+		int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+		int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES,
+		int minValue = DEFAULT_MIN_VALUE);
 
 	// Function: targetRoll
 	// Performs a roll against a specified difficulty level.
@@ -150,4 +300,162 @@ namespace Core
 		int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
 		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
 		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	TargetRollResult targetRoll(RngContext& rng, int skillLevel, int difficultyLevel,
+		int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	class Arena;
+
+	// Structure: RollMemory
+	// Memory of the polymorphic-allocator overloads below, and what DiceRolls spilled there do with their
+	// blocks. Converts implicitly from a resource, whose blocks are returned as std::pmr containers would,
+	// and from an Arena, whose blocks are left alone so results may be destroyed after the arena is reset.
+	// Spell out BlockRelease::NONE for other resources that outlive the results and never free.
+	struct RollMemory
+	{
+		RollMemory(std::pmr::memory_resource* resource, BlockRelease release = BlockRelease::DEALLOCATE)
+			: resource(resource), release(release)
+		{
+		}
+		RollMemory(Arena* arena);
+
+		std::pmr::memory_resource* resource;
+		BlockRelease release;
+	};
+
+	// Polymorphic-allocator overloads: same rolls as above, but any memory they need (the rollDice vector,
+	// scratch space for large pools, and dice that do not fit inline in a DiceRolls) comes from `memory`,
+	// typically a Core::Arena reset once per turn. The same RngContext and parameters give the same results.
+	std::pmr::vector<int> rollDice(std::pmr::memory_resource* resource, int rollCount = DEFAULT_ROLL_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	std::pmr::vector<int> rollDice(RngContext& rng, std::pmr::memory_resource* resource, int rollCount = DEFAULT_ROLL_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	SkillRollResult skillRoll(RollMemory memory, int skillLevel = DEFAULT_SKILL_LEVEL, int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES, int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	SkillRollResult skillRoll(RngContext& rng, RollMemory memory, int skillLevel = DEFAULT_SKILL_LEVEL, int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES, int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	OpposedRollResult opposedRoll(RollMemory memory,
+		int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+		int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+		int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES,
+		int minValue = DEFAULT_MIN_VALUE);
+	OpposedRollResult opposedRoll(RngContext& rng, RollMemory memory,
+		int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+		int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+		int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES,
+		int minValue = DEFAULT_MIN_VALUE);
+	TargetRollResult targetRoll(RollMemory memory, int skillLevel, int difficultyLevel,
+		int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	TargetRollResult targetRoll(RngContext& rng, RollMemory memory, int skillLevel, int difficultyLevel,
+		int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	// PackedDice overloads: same rules and distributions as above, with the dice extracted several to a
+	// random word (see PackedDice.h). Dice sequences differ from the RngContext overloads.
+	std::vector<int> rollDice(PackedDice& dice, int rollCount = DEFAULT_ROLL_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	SkillRollResult skillRoll(PackedDice& dice, int skillLevel = DEFAULT_SKILL_LEVEL, int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES, int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	OpposedRollResult opposedRoll(PackedDice& dice,
+		int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+		int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+		int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES,
+		int minValue = DEFAULT_MIN_VALUE);
+	TargetRollResult targetRoll(PackedDice& dice, int skillLevel, int difficultyLevel,
+		int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	// PrefetchedDice overloads: the same again, with the dice popped from a ring a background thread keeps
+	// filled (see DicePrefetcher.h). Dice sequences follow PackedDice while the ring never runs dry.
+	std::vector<int> rollDice(PrefetchedDice& dice, int rollCount = DEFAULT_ROLL_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	SkillRollResult skillRoll(PrefetchedDice& dice, int skillLevel = DEFAULT_SKILL_LEVEL, int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES, int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	OpposedRollResult opposedRoll(PrefetchedDice& dice,
+		int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+		int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+		int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES,
+		int minValue = DEFAULT_MIN_VALUE);
+	TargetRollResult targetRoll(PrefetchedDice& dice, int skillLevel, int difficultyLevel,
+		int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	// Function: rollDiceBatch
+	// Fills a caller-owned buffer with dice rolls without allocating.
+	//
+	// Parameters:
+	// - dice: Destination for the rolls; one die is rolled per element.
+	// - diceSides: Number of sides on each die (default: DEFAULT_DICE_SIDES).
+	// - minValue: Minimum value each die can roll (default: DEFAULT_MIN_VALUE).
+	//
+	// Returns:
+	// - True if the buffer was filled, false if the parameters are invalid.
+	bool rollDiceBatch(std::span<int> dice, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	bool rollDiceBatch(RngContext& rng, std::span<int> dice, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	// Function: skillRollBatch
+	// Performs N skill rolls sharing one dice configuration, writing the results into caller-owned storage.
+	// No memory is allocated per roll.
+	//
+	// Parameters:
+	// - input: Skill level, boons and banes for each roll.
+	// - output: Destination spans for totals, crit flags and (optionally) the selected dice.
+	// - baseDiceCount: Number of main dice rolled (default: DEFAULT_BASE_DICE_COUNT).
+	// - diceSides: Number of sides on each die (default: DEFAULT_DICE_SIDES).
+	// - minValue: Minimum value each die can roll (default: DEFAULT_MIN_VALUE).
+	//
+	// Returns:
+	// - True if every roll was resolved. False if the spans are mis-sized (nothing is written) or the
+	//   dice configuration is invalid (each roll is written as skillRoll reports an invalid roll, without dice).
+	bool skillRollBatch(const SkillRollBatchInput& input, const SkillRollBatchOutput& output,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	bool skillRollBatch(RngContext& rng, const SkillRollBatchInput& input, const SkillRollBatchOutput& output,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	// Function: opposedRollBatch
+	// Performs N opposed rolls sharing one dice configuration, writing the results into caller-owned storage.
+	// Each row rolls the attacker first, then the defender, exactly as opposedRoll does.
+	//
+	// Parameters:
+	// - input: Skill levels, boons and banes for each attacker and defender.
+	// - output: Destination spans for winners, degrees, crit flags and optional per-contestant details.
+	// - baseDiceCount: Number of main dice rolled by each contestant (default: DEFAULT_BASE_DICE_COUNT).
+	// - diceSides: Number of sides on each die (default: DEFAULT_DICE_SIDES).
+	// - minValue: Minimum value each die can roll (default: DEFAULT_MIN_VALUE).
+	//
+	// Returns:
+	// - Same convention as skillRollBatch.
+	bool opposedRollBatch(const OpposedRollBatchInput& input, const OpposedRollBatchOutput& output,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	bool opposedRollBatch(RngContext& rng, const OpposedRollBatchInput& input, const OpposedRollBatchOutput& output,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	// Function: targetRollBatch
+	// Performs N target rolls sharing one dice configuration, writing the results into caller-owned storage.
+	//
+	// Parameters:
+	// - input: Skill level, difficulty level, boons and banes for each roll.
+	// - output: Destination spans for success flags, degrees and optional roll details.
+	// - baseDiceCount: Number of main dice rolled (default: DEFAULT_BASE_DICE_COUNT).
+	// - diceSides: Number of sides on each die (default: DEFAULT_DICE_SIDES).
+	// - minValue: Minimum value each die can roll (default: DEFAULT_MIN_VALUE).
+	//
+	// Returns:
+	// - Same convention as skillRollBatch.
+	bool targetRollBatch(const TargetRollBatchInput& input, const TargetRollBatchOutput& output,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+	bool targetRollBatch(RngContext& rng, const TargetRollBatchInput& input, const TargetRollBatchOutput& output,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
 }//End of Namespace Core
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include "Core.h"
+
+//Dice.h
+namespace Core
+{
+	// Class: Dice
+	// Skill, opposed and target rolls for one dice configuration fixed at compile time.
+	//
+	// The configuration is checked once by static_assert instead of on every call, the kept dice are
+	// selected by a fully unrolled insertion into a BaseDiceCount-sized array (no pool buffer, whatever
+	// the number of boons or banes), and the crit checks compare the total against constants.
+	// Results, including the order of the selected dice, match the runtime-parameter functions for the
+	// same configuration and RngContext state, so either path can replay the other. Every roll function
+	// also accepts a PackedDice, which draws identically distributed dice from far fewer random words, or a
+	// PrefetchedDice, which pops dice generated ahead by a background thread.
+	//
+	// Example:
+	//   Core::SkillRollResult roll = Core::Dice<3, 6, 1>::skillRoll(rng, skillLevel, boons, banes);
+	template <int BaseDiceCount, int DiceSides, int MinValue>
+	class Dice
+	{
+		static_assert(BaseDiceCount > 0, "Dice needs at least one base die");
+		static_assert(DiceSides > 0 and MinValue <= DiceSides, "Dice needs 0 < DiceSides and MinValue <= DiceSides");
+
+	public:
+		static constexpr int BASE_DICE_COUNT = BaseDiceCount;
+		static constexpr int DICE_SIDES = DiceSides;
+		static constexpr int MIN_VALUE = MinValue;
+		static constexpr int CRIT_SUCCESS_TOTAL = BaseDiceCount * DiceSides; // Every kept die shows DiceSides
+		static constexpr int CRIT_FAILURE_TOTAL = BaseDiceCount * MinValue;  // Every kept die shows MinValue
+
+		// Function: skillRoll
+		// Performs a skill roll; same rules as Core::skillRoll.
+		static SkillRollResult skillRoll(RngContext& rng, int skillLevel = DEFAULT_SKILL_LEVEL,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return rollSkill(rng, skillLevel, boons, banes);
+		}
+
+		static SkillRollResult skillRoll(PackedDice& dice, int skillLevel = DEFAULT_SKILL_LEVEL,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return rollSkill(dice, skillLevel, boons, banes);
+		}
+
+		static SkillRollResult skillRoll(PrefetchedDice& dice, int skillLevel = DEFAULT_SKILL_LEVEL,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return rollSkill(dice, skillLevel, boons, banes);
+		}
+
+		static SkillRollResult skillRoll(int skillLevel = DEFAULT_SKILL_LEVEL, int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return skillRoll(defaultRngContext(), skillLevel, boons, banes);
+		}//End of skillRoll
+
+		// Function: opposedRoll
+		// Performs an opposed roll; same rules as Core::opposedRoll. The attacker rolls first.
+		static OpposedRollResult opposedRoll(RngContext& rng,
+			int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+			int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+			int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES)
+		{
+			return rollOpposed(rng, attackerSkillLevel, defenderSkillLevel, attackerBoons, attackerBanes, defenderBoons, defenderBanes);
+		}
+
+		static OpposedRollResult opposedRoll(PackedDice& dice,
+			int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+			int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+			int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES)
+		{
+			return rollOpposed(dice, attackerSkillLevel, defenderSkillLevel, attackerBoons, attackerBanes, defenderBoons, defenderBanes);
+		}
+
+		static OpposedRollResult opposedRoll(PrefetchedDice& dice,
+			int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+			int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+			int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES)
+		{
+			return rollOpposed(dice, attackerSkillLevel, defenderSkillLevel, attackerBoons, attackerBanes, defenderBoons, defenderBanes);
+		}
+
+		static OpposedRollResult opposedRoll(
+			int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+			int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+			int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES)
+		{
+			return opposedRoll(defaultRngContext(), attackerSkillLevel, defenderSkillLevel,
+				attackerBoons, attackerBanes, defenderBoons, defenderBanes);
+		}//End of opposedRoll
+
+		// Function: targetRoll
+		// Performs a roll against a difficulty level; same rules as Core::targetRoll.
+		static TargetRollResult targetRoll(RngContext& rng, int skillLevel, int difficultyLevel,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return rollTarget(rng, skillLevel, difficultyLevel, boons, banes);
+		}
+
+		static TargetRollResult targetRoll(PackedDice& dice, int skillLevel, int difficultyLevel,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return rollTarget(dice, skillLevel, difficultyLevel, boons, banes);
+		}
+
+		static TargetRollResult targetRoll(PrefetchedDice& dice, int skillLevel, int difficultyLevel,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return rollTarget(dice, skillLevel, difficultyLevel, boons, banes);
+		}
+
+		static TargetRollResult targetRoll(int skillLevel, int difficultyLevel, int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return targetRoll(defaultRngContext(), skillLevel, difficultyLevel, boons, banes);
+		}//End of targetRoll
+
+	private:
+		static constexpr std::uint64_t RANGE = static_cast<std::uint64_t>(static_cast<std::int64_t>(DiceSides) - MinValue) + 1;
+		static constexpr std::uint32_t REJECT_THRESHOLD =
+			RANGE > UINT32_MAX ? 0 : static_cast<std::uint32_t>((std::uint64_t{ 1 } << 32) % RANGE);
+
+		// Function: rollSkill
+		// skillRoll for either dice source.
+		template <typename Source>
+		static SkillRollResult rollSkill(Source& source, int skillLevel, int boons, int banes)
+		{
+			std::array<int, BaseDiceCount> kept;
+			int total = rollKept(source, boons, banes, kept);
+
+			SkillRollResult result{ skillLevel + total, {}, total == CRIT_SUCCESS_TOTAL, total == CRIT_FAILURE_TOTAL };
+			result.rolls.assign(kept);
+			return result;
+		}
+
+		// Function: rollOpposed
+		// opposedRoll for either dice source.
+		template <typename Source>
+		static OpposedRollResult rollOpposed(Source& source, int attackerSkillLevel, int defenderSkillLevel,
+			int attackerBoons, int attackerBanes, int defenderBoons, int defenderBanes)
+		{
+			OpposedRollResult result{ Winner::TIE, 0,
+				rollSkill(source, attackerSkillLevel, attackerBoons, attackerBanes), {}, false, false };
+			result.defenderRoll = rollSkill(source, defenderSkillLevel, defenderBoons, defenderBanes);
+
+			OpposedOutcome outcome = decideOpposedOutcome(
+				attackerSkillLevel, result.attackerRoll.total, result.attackerRoll.critSuccess, result.attackerRoll.critFailure,
+				defenderSkillLevel, result.defenderRoll.total, result.defenderRoll.critSuccess, result.defenderRoll.critFailure);
+			result.winner = outcome.winner;
+			result.degree = outcome.degree;
+			result.critWin = outcome.critWin;
+			result.critLoss = outcome.critLoss;
+			return result;
+		}
+
+		// Function: rollTarget
+		// targetRoll for either dice source.
+		template <typename Source>
+		static TargetRollResult rollTarget(Source& source, int skillLevel, int difficultyLevel, int boons, int banes)
+		{
+			TargetRollResult result{ false, 0, rollSkill(source, skillLevel, boons, banes), false, false };
+
+			int targetNumber = difficultyLevel * DIFFICULTY_SCALING_FACTOR;
+			result.success = result.roll.total >= targetNumber;
+			result.degree = (result.roll.total - targetNumber) / DIFFICULTY_SCALING_FACTOR;
+			result.critSuccess = result.roll.critSuccess;
+			result.critFailure = result.roll.critFailure;
+			return result;
+		}
+
+		// Function: rollDie
+		// RngContext::uniform(MinValue, DiceSides) with the range and rejection threshold folded in.
+		static int rollDie(RngContext& rng)
+		{
+			if constexpr (RANGE > UINT32_MAX)
+			{
+				return static_cast<int>(static_cast<std::int64_t>(MinValue) + rng.next32());
+			}
+			else
+			{
+				std::uint64_t product = rng.next32() * RANGE;
+				while (static_cast<std::uint32_t>(product) < REJECT_THRESHOLD)
+				{
+					product = rng.next32() * RANGE;
+				}
+				return MinValue + static_cast<int>(product >> 32);
+			}
+		}
+
+		static int rollDie(PackedDice& dice)
+		{
+			return dice.roll(MinValue, DiceSides);
+		}
+
+		static int rollDie(PrefetchedDice& dice)
+		{
+			return dice.roll(MinValue, DiceSides);
+		}
+
+		// Function: insertKept
+		// Inserts `die` into `kept`, which holds the best dice so far ordered best first, if it beats the worst.
+		template <bool KeepHighest>
+		static void insertKept(std::array<int, BaseDiceCount>& kept, int die)
+		{
+			constexpr auto better = [](int a, int b) { return KeepHighest ? a > b : a < b; };
+			if (not better(die, kept[BaseDiceCount - 1]))
+			{
+				return;
+			}
+			int slot = BaseDiceCount - 1;
+			while (slot > 0 and better(die, kept[slot - 1]))
+			{
+				kept[slot] = kept[slot - 1];
+				--slot;
+			}
+			kept[slot] = die;
+		}
+
+		// Function: rollKept
+		// Rolls BaseDiceCount + |boons - banes| dice and leaves the selected ones in `kept` (best first when
+		// boons or banes apply, in roll order otherwise). Returns their sum.
+		template <typename Source>
+		static int rollKept(Source& source, int boons, int banes, std::array<int, BaseDiceCount>& kept)
+		{
+			for (int& die : kept)
+			{
+				die = rollDie(source);
+			}
+
+			if (boons > banes)
+			{
+				sortKept<true>(kept);
+				for (int extra = boons - banes; extra > 0; --extra)
+				{
+					insertKept<true>(kept, rollDie(source));
+				}
+			}
+			else if (banes > boons)
+			{
+				sortKept<false>(kept);
+				for (int extra = banes - boons; extra > 0; --extra)
+				{
+					insertKept<false>(kept, rollDie(source));
+				}
+			}
+
+			int total = 0;
+			for (int die : kept)
+			{
+				total += die;
+			}
+			return total;
+		}
+
+		// Function: sortKept
+		// Orders the first BaseDiceCount dice best first (insertion sort; unrolled for small counts).
+		template <bool KeepHighest>
+		static void sortKept(std::array<int, BaseDiceCount>& kept)
+		{
+			constexpr auto better = [](int a, int b) { return KeepHighest ? a > b : a < b; };
+			for (int i = 1; i < BaseDiceCount; ++i)
+			{
+				int die = kept[i];
+				int slot = i;
+				while (slot > 0 and better(die, kept[slot - 1]))
+				{
+					kept[slot] = kept[slot - 1];
+					--slot;
+				}
+				kept[slot] = die;
+			}
+		}
+	};
+
+	// The default configuration; the runtime-parameter roll functions dispatch to it when called with
+	// DEFAULT_BASE_DICE_COUNT, DEFAULT_DICE_SIDES and DEFAULT_MIN_VALUE.
+	using DefaultDice = Dice<DEFAULT_BASE_DICE_COUNT, DEFAULT_DICE_SIDES, DEFAULT_MIN_VALUE>;
+}//End of Namespace Core
@@ -0,0 +1,535 @@
+#include "DiceExpression.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "DiceKernels.h"
+
+namespace
+{
+	using Core::DicePlan;
+	using Core::DiceTerm;
+
+	// Dice a plain batch generates ahead: enough for MAX_TERMS full terms, so a block always holds a roll.
+	constexpr std::size_t BATCH_BLOCK_SIZE = static_cast<std::size_t>(DicePlan::MAX_TERMS) * DicePlan::MAX_DICE;
+
+	// Class: ExpressionParser
+	// Recursive-descent parser for the grammar in DiceExpression.h. Reports the first error only.
+	class ExpressionParser
+	{
+	public:
+		ExpressionParser(std::string_view text, std::string* error) : m_text(text), m_error(error) {}
+
+		// Function: parse
+		// Parses the whole expression into `terms` and `modifier`.
+		bool parse(std::vector<DiceTerm>& terms, int& modifier)
+		{
+			std::int64_t constant = 0;
+			int sign = 1;
+			if (peek() == '+' or peek() == '-')
+			{
+				sign = m_text[m_position++] == '-' ? -1 : 1;
+			}
+
+			while (true)
+			{
+				const char next = peek();
+				if (next != 'd' and not isDigit(next))
+				{
+					return fail("Expected a number or dice");
+				}
+
+				int value = 1;
+				if (isDigit(next) and not number(value, DicePlan::MAX_MODIFIER))
+				{
+					return false;
+				}
+				if (peek() == 'd')
+				{
+					DiceTerm term;
+					term.sign = sign;
+					if (value < 1 or value > DicePlan::MAX_DICE)
+					{
+						return fail("Dice count out of range");
+					}
+					term.count = value;
+					if (static_cast<int>(terms.size()) == DicePlan::MAX_TERMS)
+					{
+						return fail("Too many dice terms");
+					}
+					++m_position;
+					if (not diceTerm(term))
+					{
+						return false;
+					}
+					terms.push_back(term);
+				}
+				else
+				{
+					constant += sign * value;
+					if (constant < -DicePlan::MAX_MODIFIER or constant > DicePlan::MAX_MODIFIER)
+					{
+						return fail("Modifier out of range");
+					}
+				}
+
+				const char separator = peek();
+				if (separator == '\0')
+				{
+					break;
+				}
+				if (separator != '+' and separator != '-')
+				{
+					return fail("Expected '+' or '-'");
+				}
+				sign = separator == '-' ? -1 : 1;
+				++m_position;
+			}
+
+			modifier = static_cast<int>(constant);
+			return true;
+		}//End of parse
+
+	private:
+		static bool isDigit(char c) { return c >= '0' and c <= '9'; }
+
+		bool fail(const char* message)
+		{
+			if (m_error != nullptr)
+			{
+				*m_error = std::string(message) + " at position " + std::to_string(m_position);
+			}
+			return false;
+		}
+
+		// Function: peek
+		// Skips whitespace and returns the next character, or '\0' at the end.
+		char peek()
+		{
+			while (m_position < m_text.size() and (m_text[m_position] == ' ' or m_text[m_position] == '\t'))
+			{
+				++m_position;
+			}
+			return m_position < m_text.size() ? m_text[m_position] : '\0';
+		}
+
+		bool number(int& value, int limit)
+		{
+			if (not isDigit(peek()))
+			{
+				return fail("Expected a number");
+			}
+			std::int64_t parsed = 0;
+			while (m_position < m_text.size() and isDigit(m_text[m_position]))
+			{
+				parsed = parsed * 10 + (m_text[m_position++] - '0');
+				if (parsed > limit)
+				{
+					return fail("Number too large");
+				}
+			}
+			value = static_cast<int>(parsed);
+			return true;
+		}
+
+		// Function: diceTerm
+		// Parses the sides and modifiers of a term whose count and 'd' have been read.
+		bool diceTerm(DiceTerm& term)
+		{
+			if (not number(term.sides, DicePlan::MAX_SIDES))
+			{
+				return false;
+			}
+			if (term.sides < 1)
+			{
+				return fail("A die needs at least one side");
+			}
+			term.kept = term.count;
+
+			bool hasKeep = false;
+			bool hasReroll = false;
+			while (true)
+			{
+				const char next = peek();
+				if (next == '!')
+				{
+					if (term.explode)
+					{
+						return fail("Repeated '!'");
+					}
+					if (term.sides < 2)
+					{
+						return fail("A one-sided die cannot explode");
+					}
+					term.explode = true;
+					++m_position;
+				}
+				else if (next == 'r')
+				{
+					++m_position;
+					if (hasReroll)
+					{
+						return fail("Repeated reroll");
+					}
+					hasReroll = true;
+					if (not number(term.rerollAtMost, DicePlan::MAX_SIDES))
+					{
+						return false;
+					}
+					if (term.rerollAtMost < 1 or term.rerollAtMost >= term.sides)
+					{
+						return fail("Reroll value out of range");
+					}
+				}
+				else if (next == 'k' or next == 'd')
+				{
+					const bool drop = next == 'd';
+					++m_position;
+					bool highest = true;
+					if (m_position < m_text.size() and (m_text[m_position] == 'h' or m_text[m_position] == 'l'))
+					{
+						highest = m_text[m_position++] == 'h';
+					}
+					else if (drop)
+					{
+						return fail("Expected 'h' or 'l' after 'd'");
+					}
+					if (hasKeep)
+					{
+						return fail("Repeated keep or drop");
+					}
+					hasKeep = true;
+
+					int amount = 0;
+					if (not number(amount, DicePlan::MAX_DICE))
+					{
+						return false;
+					}
+					if (drop ? amount >= term.count : (amount < 1 or amount > term.count))
+					{
+						return fail(drop ? "Drops every die" : "Keep count out of range");
+					}
+					// Dropping the highest n keeps the lowest count - n
+					term.kept = drop ? term.count - amount : amount;
+					term.keepHighest = drop ? not highest : highest;
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			if (term.keepsAll())
+			{
+				term.keepHighest = true;
+			}
+			return true;
+		}//End of diceTerm
+
+		std::string_view m_text;
+		std::string* m_error;
+		std::size_t m_position = 0;
+	};
+
+	// Function: drawDie
+	// One die in [1, sides] from either source, the way RngContext::uniform and PackedDice::roll draw them.
+	int drawDie(Core::RngContext& rng, int sides) { return rng.uniform(1, sides); }
+	int drawDie(Core::PackedDice& dice, int sides) { return dice.roll(1, sides); }
+
+	// Structure: TermOutcome
+	// Sum and crit flags of one resolved term.
+	struct TermOutcome
+	{
+		int sum;
+		bool critSuccess;
+		bool critFailure;
+	};
+
+	// Function: resolveTerm
+	// Resolves a term from its first roll of dice in `pool`, drawing any rerolls and explosions from
+	// `source`. Leaves the kept dice in the first term.kept entries.
+	template <typename Source>
+	TermOutcome resolveTerm(Source& source, const Core::Kernels::KernelTable& kernels, const DiceTerm& term, int* pool)
+	{
+		int highest = 0;
+		int lowest = 0;
+		for (int i = 0; i < term.count; ++i)
+		{
+			if (pool[i] <= term.rerollAtMost)
+			{
+				pool[i] = drawDie(source, term.sides);
+			}
+			highest += pool[i] == term.sides;
+			lowest += pool[i] == 1;
+		}
+
+		if (term.explode)
+		{
+			for (int i = 0; i < term.count; ++i)
+			{
+				if (pool[i] != term.sides)
+				{
+					continue;
+				}
+				for (int extra = 0; extra < DicePlan::MAX_EXPLOSIONS; ++extra)
+				{
+					const int face = drawDie(source, term.sides);
+					pool[i] += face;
+					if (face != term.sides)
+					{
+						break;
+					}
+				}
+			}
+		}
+
+		if (not term.keepsAll())
+		{
+			kernels.selectKept(pool, term.count, term.kept, term.keepHighest);
+		}
+		int sum = 0;
+		for (int i = 0; i < term.kept; ++i)
+		{
+			sum += pool[i];
+		}
+
+		// The kept dice all show the highest face exactly when at least `kept` dice do and the kept ones
+		// come from the high end; from the low end, every die has to. Likewise for the lowest face.
+		return { sum,
+			highest >= (term.keepHighest ? term.kept : term.count),
+			lowest >= (term.keepHighest ? term.count : term.kept) };
+	}//End of resolveTerm
+
+	// Class: PlanCache
+	// Compiled plans by expression text. Plans are heap-allocated and never evicted, so pointers stay valid.
+	class PlanCache
+	{
+	public:
+		const DicePlan* get(std::string_view expression)
+		{
+			{
+				std::shared_lock lock(m_mutex);
+				auto found = m_plans.find(expression);
+				if (found != m_plans.end())
+				{
+					return found->second.get();
+				}
+			}
+
+			// Compile outside the lock; if another thread got there first, keep its plan.
+			std::optional<DicePlan> plan = DicePlan::compile(expression);
+			if (not plan)
+			{
+				return nullptr;
+			}
+			std::unique_lock lock(m_mutex);
+			return m_plans.try_emplace(std::string(expression), std::make_unique<DicePlan>(std::move(*plan))).first->second.get();
+		}
+
+	private:
+		struct StringHash
+		{
+			using is_transparent = void;
+			std::size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+		};
+
+		std::shared_mutex m_mutex;
+		std::unordered_map<std::string, std::unique_ptr<DicePlan>, StringHash, std::equal_to<>> m_plans;
+	};
+
+	PlanCache planCache;
+}
+
+//DiceExpression.cpp
+namespace Core
+{
+	// Function: compile
+	// Parses an expression into a plan.
+	std::optional<DicePlan> DicePlan::compile(std::string_view expression, std::string* error)
+	{
+		DicePlan plan;
+		ExpressionParser parser(expression, error);
+		if (not parser.parse(plan.m_terms, plan.m_modifier))
+		{
+			return std::nullopt;
+		}
+		plan.finish();
+		return plan;
+	}
+
+	const DicePlan* DicePlan::cached(std::string_view expression)
+	{
+		return planCache.get(expression);
+	}
+
+	// Function: skill
+	// Builds the skill roll plan. Dice showing minValue..diceSides become 1..faces, which shifts every kept
+	// die by minValue - 1; the shift moves into the modifier, so totals and crits are unchanged.
+	std::optional<DicePlan> DicePlan::skill(int skillLevel, int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		DicePlan plan;
+		plan.m_modifier = skillLevel;
+		if (baseDiceCount > 0 and diceSides > 0 and minValue <= diceSides)
+		{
+			const std::int64_t faces = static_cast<std::int64_t>(diceSides) - minValue + 1;
+			const std::int64_t pool = static_cast<std::int64_t>(baseDiceCount) + std::abs(static_cast<std::int64_t>(boons) - banes);
+			if (pool > MAX_DICE or faces > MAX_SIDES)
+			{
+				return std::nullopt;
+			}
+
+			DiceTerm term;
+			term.count = static_cast<int>(pool);
+			term.sides = static_cast<int>(faces);
+			term.kept = baseDiceCount;
+			term.keepHighest = boons >= banes;
+			plan.m_terms.push_back(term);
+			plan.m_modifier += baseDiceCount * (minValue - 1);
+		}
+		plan.finish();
+		return plan;
+	}//End of skill
+
+	// Function: finish
+	// Computes the canonical expression, the bounds of the total and the batch strategy.
+	void DicePlan::finish()
+	{
+		m_minTotal = m_maxTotal = m_modifier;
+		m_plain = true;
+		m_dicePerRoll = 0;
+		m_expression.clear();
+		for (const DiceTerm& term : m_terms)
+		{
+			const int highestDie = term.explode ? term.sides * (MAX_EXPLOSIONS + 1) : term.sides;
+			m_minTotal += term.sign > 0 ? term.kept : -term.kept * highestDie;
+			m_maxTotal += term.sign > 0 ? term.kept * highestDie : -term.kept;
+			m_plain = m_plain and not term.explode and term.rerollAtMost == 0 and term.sides == m_terms.front().sides;
+			m_dicePerRoll += term.count;
+
+			if (term.sign < 0 or not m_expression.empty())
+			{
+				m_expression += term.sign < 0 ? '-' : '+';
+			}
+			m_expression += std::to_string(term.count) + 'd' + std::to_string(term.sides);
+			if (term.rerollAtMost > 0)
+			{
+				m_expression += 'r' + std::to_string(term.rerollAtMost);
+			}
+			if (term.explode)
+			{
+				m_expression += '!';
+			}
+			if (not term.keepsAll())
+			{
+				m_expression += (term.keepHighest ? "kh" : "kl") + std::to_string(term.kept);
+			}
+		}
+
+		if (m_modifier != 0 or m_terms.empty())
+		{
+			if (m_modifier >= 0 and not m_expression.empty())
+			{
+				m_expression += '+';
+			}
+			m_expression += std::to_string(m_modifier);
+		}
+	}//End of finish
+
+	// Function: evaluate
+	// Rolls every term in order and adds up the signed sums.
+	template <typename Source>
+	DicePlanResult DicePlan::evaluate(Source& source) const
+	{
+		const Kernels::KernelTable& kernels = Kernels::activeKernelTable();
+		std::array<int, MAX_DICE> pool;
+		DicePlanResult result{ m_modifier, not m_terms.empty(), not m_terms.empty() };
+		for (const DiceTerm& term : m_terms)
+		{
+			for (int i = 0; i < term.count; ++i)
+			{
+				pool[i] = drawDie(source, term.sides);
+			}
+			TermOutcome outcome = resolveTerm(source, kernels, term, pool.data());
+			result.total += term.sign * outcome.sum;
+			result.critSuccess = result.critSuccess and outcome.critSuccess;
+			result.critFailure = result.critFailure and outcome.critFailure;
+		}
+		return result;
+	}//End of evaluate
+
+	DicePlanResult DicePlan::roll(RngContext& rng) const
+	{
+		return evaluate(rng);
+	}
+
+	DicePlanResult DicePlan::roll(PackedDice& dice) const
+	{
+		return evaluate(dice);
+	}
+
+	TargetRollResult DicePlan::rollTarget(RngContext& rng, int difficultyLevel) const
+	{
+		DicePlanResult roll = evaluate(rng);
+		int targetNumber = difficultyLevel * DIFFICULTY_SCALING_FACTOR;
+		return { roll.total >= targetNumber, (roll.total - targetNumber) / DIFFICULTY_SCALING_FACTOR,
+			{ roll.total, {}, roll.critSuccess, roll.critFailure }, roll.critSuccess, roll.critFailure };
+	}
+
+	// Function: rollBatch
+	// Plain plans whose terms share one die size draw a block of rolls' dice with one kernel call, which
+	// consumes the same words as rolling them one at a time; other plans evaluate row by row.
+	bool DicePlan::rollBatch(RngContext& rng, std::size_t count, const SkillRollBatchOutput& output) const
+	{
+		auto fits = [count](auto values) { return values.empty() or values.size() >= count; };
+		if (not fits(output.totals) or not fits(output.critSuccess) or not fits(output.critFailure) or not output.dice.empty())
+		{
+			return false;
+		}
+
+		auto store = [&output](std::size_t row, const DicePlanResult& result)
+		{
+			if (not output.totals.empty()) output.totals[row] = result.total;
+			if (not output.critSuccess.empty()) output.critSuccess[row] = result.critSuccess;
+			if (not output.critFailure.empty()) output.critFailure[row] = result.critFailure;
+		};
+
+		if (not m_plain or m_terms.empty())
+		{
+			for (std::size_t row = 0; row < count; ++row)
+			{
+				store(row, evaluate(rng));
+			}
+			return true;
+		}
+
+		const Kernels::KernelTable& kernels = Kernels::activeKernelTable();
+		const std::size_t dicePerRoll = static_cast<std::size_t>(m_dicePerRoll);
+		const std::size_t rowsPerBlock = BATCH_BLOCK_SIZE / dicePerRoll;
+		std::array<int, BATCH_BLOCK_SIZE> block;
+		for (std::size_t first = 0; first < count; first += rowsPerBlock)
+		{
+			const std::size_t rows = std::min(rowsPerBlock, count - first);
+			Kernels::generateDice(kernels, rng, { block.data(), rows * dicePerRoll }, 1, m_terms.front().sides);
+
+			int* dice = block.data();
+			for (std::size_t row = 0; row < rows; ++row)
+			{
+				DicePlanResult result{ m_modifier, true, true };
+				for (const DiceTerm& term : m_terms)
+				{
+					TermOutcome outcome = resolveTerm(rng, kernels, term, dice);
+					result.total += term.sign * outcome.sum;
+					result.critSuccess = result.critSuccess and outcome.critSuccess;
+					result.critFailure = result.critFailure and outcome.critFailure;
+					dice += term.count;
+				}
+				store(first + row, result);
+			}
+		}
+		return true;
+	}//End of rollBatch
+}//End of Namespace Core
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core.h"
+
+//DiceExpression.h
+// Dice expressions such as "4d6kh3+2", "3d6!" or "2d10kl1-1d4", compiled once into a DicePlan.
+//
+// Grammar (whitespace is ignored):
+//   expression := term (('+' | '-') term)*
+//   term       := [count] 'd' sides modifier* | number
+//   modifier   := 'kh' n | 'kl' n | 'k' n   keep the highest (kh, k) or lowest (kl) n dice
+//               | 'dh' n | 'dl' n           drop the highest or lowest n dice
+//               | 'r' n                     reroll, once, every die showing n or less
+//               | '!'                       a die showing its highest face rolls again and adds the result
+// Dice are numbered 1..sides. A reroll happens before a die explodes, and keep/drop compares the exploded
+// values. Each modifier may appear once per term.
+namespace Core
+{
+	// Structure: DiceTerm
+	// One group of identical dice in a plan, added to or subtracted from the total.
+	struct DiceTerm
+	{
+		int count = 1;            // Dice rolled
+		int sides = 6;            // Faces of each die, numbered 1..sides
+		int kept = 1;             // Dice kept; equal to count when the term keeps every die
+		bool keepHighest = true;  // Keep the highest dice (false: the lowest). Irrelevant when kept == count
+		int rerollAtMost = 0;     // Dice showing this or less are rerolled once (0: no rerolls)
+		bool explode = false;     // Dice showing `sides` roll again and add, up to MAX_EXPLOSIONS times
+		int sign = 1;             // +1 or -1
+
+		bool keepsAll() const { return kept == count; }
+	};
+
+	// Structure: DicePlanResult
+	// Total and crit flags of one evaluated plan.
+	// Crits follow skillRoll: critSuccess when every kept die of every term shows its highest face (before
+	// exploding), critFailure when every kept die shows 1. A plan without dice never crits.
+	struct DicePlanResult
+	{
+		int total;
+		bool critSuccess;
+		bool critFailure;
+	};
+
+	// Class: DicePlan
+	// A compiled dice expression: a short list of DiceTerm plus a flat modifier.
+	//
+	// Evaluating a plan never allocates and never parses; the dice of a term are rolled into a stack buffer
+	// and reduced with the dice kernels skillRoll uses. Plans are immutable, so one plan may be evaluated
+	// from any number of threads, each with its own RngContext.
+	//
+	// Dice are drawn with RngContext::uniform in term order, explosions and rerolls after the term's first
+	// roll of its dice, so the built-in skill() plan reproduces skillRoll's totals and crits from the same
+	// context.
+	//
+	// Example:
+	//   const Core::DicePlan* plan = Core::DicePlan::cached("4d6kh3+2");
+	//   Core::DicePlanResult result = plan->roll(rng);
+	class DicePlan
+	{
+	public:
+		static constexpr int MAX_DICE = 256;        // Dice one term may roll
+		static constexpr int MAX_SIDES = 1000;      // Faces one die may have
+		static constexpr int MAX_EXPLOSIONS = 8;    // Extra rolls one exploding die may add
+		static constexpr int MAX_TERMS = 16;        // Dice terms one plan may have
+		static constexpr int MAX_MODIFIER = 1000000; // Largest constant in an expression
+
+		// Function: compile
+		// Parses an expression into a plan.
+		//
+		// Returns:
+		// - The plan, or std::nullopt if the expression is malformed or exceeds a limit above, in which case
+		//   `error` (if given) describes the problem and where it is.
+		static std::optional<DicePlan> compile(std::string_view expression, std::string* error = nullptr);
+
+		// Function: cached
+		// Returns the plan compiled from `expression`, compiling it on first use. Lookups after the first
+		// cost one hash of the string. Plans live for the rest of the program. Thread-safe.
+		//
+		// Returns:
+		// - The plan, or nullptr if the expression does not compile.
+		static const DicePlan* cached(std::string_view expression);
+
+		// Function: skill
+		// The built-in plan for a skill roll: the pool skillRoll rolls for these boons and banes, keeping
+		// baseDiceCount dice from the same end, plus the skill level. Invalid configurations give skillRoll's
+		// invalid roll, a flat total of skillLevel.
+		//
+		// Returns:
+		// - The plan, or std::nullopt if the pool exceeds MAX_DICE or diceSides - minValue + 1 exceeds MAX_SIDES.
+		static std::optional<DicePlan> skill(int skillLevel = DEFAULT_SKILL_LEVEL,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+			int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+			int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+		// Function: expression
+		// The plan in canonical form, e.g. "4d6kh3+2" for " 4 d6 k3 + 1 + 1".
+		const std::string& expression() const { return m_expression; }
+
+		std::span<const DiceTerm> terms() const { return m_terms; }
+		int modifier() const { return m_modifier; }
+		int minTotal() const { return m_minTotal; }
+		int maxTotal() const { return m_maxTotal; }
+
+		// Function: roll
+		// Evaluates the plan once.
+		DicePlanResult roll(RngContext& rng) const;
+		DicePlanResult roll(PackedDice& dice) const;
+
+		// Function: rollTarget
+		// Evaluates the plan as targetRoll treats a skill roll: success when the total meets
+		// difficultyLevel * DIFFICULTY_SCALING_FACTOR. The result's roll has no dice.
+		TargetRollResult rollTarget(RngContext& rng, int difficultyLevel) const;
+
+		// Function: rollBatch
+		// Evaluates the plan `count` times into caller-owned spans, drawing the same dice as `count` calls of
+		// roll(). Plans without rerolls or explosions generate their dice in blocks through the dice kernels.
+		//
+		// Returns:
+		// - False if a non-empty span is shorter than `count` or output.dice is not empty (nothing is written).
+		bool rollBatch(RngContext& rng, std::size_t count, const SkillRollBatchOutput& output) const;
+
+	private:
+		DicePlan() = default;
+
+		// Function: finish
+		// Computes the canonical expression and the total's bounds once the terms are set.
+		void finish();
+
+		template <typename Source>
+		DicePlanResult evaluate(Source& source) const;
+
+		std::vector<DiceTerm> m_terms;
+		int m_modifier = 0;
+		int m_minTotal = 0;
+		int m_maxTotal = 0;
+		bool m_plain = true;     // No term rerolls or explodes
+		int m_dicePerRoll = 0;   // Dice a plain plan rolls per evaluation
+		std::string m_expression;
+	};
+}//End of Namespace Core
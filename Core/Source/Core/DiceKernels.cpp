@@ -0,0 +1,362 @@
+#include "DiceKernels.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CORE_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CORE_TARGET_AVX2
+#else
+#define CORE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+	using Core::Kernels::KeptSummary;
+
+	// Pools up to this size are selected with the sorting network.
+	constexpr int NETWORK_SIZE = 8;
+
+	// Comparator layers of the optimal 19-comparator, depth-6 sorting network for 8 inputs.
+	// Each layer lists (lower, upper) lane pairs; after a compare-exchange the lower lane holds the better die.
+	constexpr std::array<std::array<std::array<int, 2>, 4>, 6> NETWORK_LAYERS = { {
+		{ { { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 } } },
+		{ { { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } } },
+		{ { { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 } } },
+		{ { { 2, 4 }, { 3, 5 }, { 2, 4 }, { 3, 5 } } },
+		{ { { 1, 4 }, { 3, 6 }, { 1, 4 }, { 3, 6 } } },
+		{ { { 1, 2 }, { 3, 4 }, { 5, 6 }, { 5, 6 } } },
+	} }; // Shorter layers repeat a comparator; applying one twice is harmless.
+
+	// Function: rangeOf
+	// Number of faces between minValue and maxValue, as RngContext::uniform computes it.
+	std::uint64_t rangeOf(int minValue, int maxValue)
+	{
+		return static_cast<std::uint64_t>(static_cast<std::int64_t>(maxValue) - minValue) + 1;
+	}
+
+	// Function: rejectionThreshold
+	// Low product halves below this value are rejected to keep the reduction unbiased.
+	std::uint32_t rejectionThreshold(std::uint64_t range)
+	{
+		return static_cast<std::uint32_t>((std::uint64_t{ 1 } << 32) % range);
+	}
+
+	// Function: padValue
+	// Lane filler that sorts behind every real die.
+	int padValue(bool keepHighest)
+	{
+		return keepHighest ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+	}
+
+	// Function: partialSelect
+	// Selection for pools too large for the network.
+	void partialSelect(int* pool, int poolSize, int keptCount, bool keepHighest)
+	{
+		if (keepHighest)
+		{
+			std::partial_sort(pool, pool + keptCount, pool + poolSize, std::greater<int>());
+		}
+		else
+		{
+			std::partial_sort(pool, pool + keptCount, pool + poolSize);
+		}
+	}
+
+	// Function: scalarDiceFromWords
+	// Portable multiply-shift range reduction.
+	std::size_t scalarDiceFromWords(const std::uint32_t* words, std::size_t wordCount, int* dice, int minValue, int maxValue)
+	{
+		const std::uint64_t range = rangeOf(minValue, maxValue);
+		if (range > std::numeric_limits<std::uint32_t>::max())
+		{
+			for (std::size_t i = 0; i < wordCount; ++i)
+			{
+				dice[i] = static_cast<int>(static_cast<std::int64_t>(minValue) + words[i]);
+			}
+			return wordCount;
+		}
+
+		const std::uint32_t threshold = rejectionThreshold(range);
+		std::size_t produced = 0;
+		for (std::size_t i = 0; i < wordCount; ++i)
+		{
+			std::uint64_t product = words[i] * range;
+			if (static_cast<std::uint32_t>(product) >= threshold)
+			{
+				dice[produced++] = minValue + static_cast<int>(product >> 32);
+			}
+		}
+		return produced;
+	}
+
+	// Function: scalarSelectKept
+	// Portable sorting-network selection.
+	void scalarSelectKept(int* pool, int poolSize, int keptCount, bool keepHighest)
+	{
+		if (poolSize > NETWORK_SIZE)
+		{
+			partialSelect(pool, poolSize, keptCount, keepHighest);
+			return;
+		}
+
+		std::array<int, NETWORK_SIZE> lanes;
+		lanes.fill(padValue(keepHighest));
+		std::copy(pool, pool + poolSize, lanes.begin());
+
+		for (const auto& layer : NETWORK_LAYERS)
+		{
+			for (const auto& [lower, upper] : layer)
+			{
+				int low = std::min(lanes[lower], lanes[upper]);
+				int high = std::max(lanes[lower], lanes[upper]);
+				lanes[lower] = keepHighest ? high : low;
+				lanes[upper] = keepHighest ? low : high;
+			}
+		}
+
+		std::copy(lanes.begin(), lanes.begin() + poolSize, pool);
+	}
+
+	// Function: scalarSummarizeKept
+	// Portable total and crit flags.
+	KeptSummary scalarSummarizeKept(const int* kept, int keptCount, int diceSides, int minValue)
+	{
+		int total = 0;
+		int lowest = std::numeric_limits<int>::max();
+		int highest = std::numeric_limits<int>::min();
+		for (int i = 0; i < keptCount; ++i)
+		{
+			total += kept[i];
+			lowest = std::min(lowest, kept[i]);
+			highest = std::max(highest, kept[i]);
+		}
+
+		// Every die is within [minValue, diceSides], so all show diceSides exactly when the lowest does
+		return { total, lowest == diceSides, highest == minValue };
+	}
+
+	constexpr Core::Kernels::KernelTable SCALAR_KERNELS{
+		Core::Kernels::InstructionSet::SCALAR, scalarDiceFromWords, scalarSelectKept, scalarSummarizeKept };
+
+#ifdef CORE_KERNELS_X86
+	// Function: avx2DiceFromWords
+	// Eight words per step; any step with a rejected lane is redone by the scalar kernel.
+	CORE_TARGET_AVX2 std::size_t avx2DiceFromWords(const std::uint32_t* words, std::size_t wordCount, int* dice, int minValue, int maxValue)
+	{
+		const std::uint64_t range = rangeOf(minValue, maxValue);
+		if (range > std::numeric_limits<std::uint32_t>::max())
+		{
+			return scalarDiceFromWords(words, wordCount, dice, minValue, maxValue);
+		}
+
+		const __m256i ranges = _mm256_set1_epi32(static_cast<int>(range));
+		const __m256i thresholds = _mm256_set1_epi32(static_cast<int>(rejectionThreshold(range)));
+		const __m256i offsets = _mm256_set1_epi32(minValue);
+
+		std::size_t produced = 0;
+		std::size_t i = 0;
+		for (; i + 8 <= wordCount; i += 8)
+		{
+			__m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+
+			// 32x32 -> 64-bit products of the even and odd lanes
+			__m256i evenProducts = _mm256_mul_epu32(values, ranges);
+			__m256i oddProducts = _mm256_mul_epu32(_mm256_srli_epi64(values, 32), ranges);
+			__m256i highs = _mm256_blend_epi32(_mm256_srli_epi64(evenProducts, 32), oddProducts, 0xAA);
+			__m256i lows = _mm256_blend_epi32(evenProducts, _mm256_slli_epi64(oddProducts, 32), 0xAA);
+
+			// Unsigned low >= threshold, lane by lane
+			__m256i accepted = _mm256_cmpeq_epi32(_mm256_max_epu32(lows, thresholds), lows);
+			if (_mm256_movemask_epi8(accepted) == -1)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dice + produced), _mm256_add_epi32(highs, offsets));
+				produced += 8;
+			}
+			else
+			{
+				produced += scalarDiceFromWords(words + i, 8, dice + produced, minValue, maxValue);
+			}
+		}
+
+		return produced + scalarDiceFromWords(words + i, wordCount - i, dice + produced, minValue, maxValue);
+	}
+
+	// Structure: Avx2Network
+	// Per-layer lane permutations and "takes the better die" masks for the AVX2 sorting network.
+	struct Avx2Network
+	{
+		std::array<std::array<int, NETWORK_SIZE>, NETWORK_LAYERS.size()> partners;
+		std::array<std::array<int, NETWORK_SIZE>, NETWORK_LAYERS.size()> lowerLanes;
+	};
+
+	constexpr Avx2Network makeAvx2Network()
+	{
+		Avx2Network network{};
+		for (std::size_t layer = 0; layer < NETWORK_LAYERS.size(); ++layer)
+		{
+			for (int lane = 0; lane < NETWORK_SIZE; ++lane)
+			{
+				network.partners[layer][lane] = lane;
+			}
+			for (const auto& [lower, upper] : NETWORK_LAYERS[layer])
+			{
+				network.partners[layer][lower] = upper;
+				network.partners[layer][upper] = lower;
+				network.lowerLanes[layer][lower] = -1;
+			}
+		}
+		return network;
+	}
+
+	constexpr Avx2Network AVX2_NETWORK = makeAvx2Network();
+
+	// Function: avx2SelectKept
+	// Sorting network on one register: each layer is a permute, a min, a max and a blend.
+	CORE_TARGET_AVX2 void avx2SelectKept(int* pool, int poolSize, int keptCount, bool keepHighest)
+	{
+		if (poolSize > NETWORK_SIZE)
+		{
+			partialSelect(pool, poolSize, keptCount, keepHighest);
+			return;
+		}
+
+		alignas(32) std::array<int, NETWORK_SIZE> lanes;
+		lanes.fill(padValue(keepHighest));
+		std::copy(pool, pool + poolSize, lanes.begin());
+
+		__m256i values = _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes.data()));
+		for (std::size_t layer = 0; layer < NETWORK_LAYERS.size(); ++layer)
+		{
+			__m256i partners = _mm256_permutevar8x32_epi32(values,
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(AVX2_NETWORK.partners[layer].data())));
+			__m256i lowerLanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(AVX2_NETWORK.lowerLanes[layer].data()));
+			__m256i low = _mm256_min_epi32(values, partners);
+			__m256i high = _mm256_max_epi32(values, partners);
+			values = keepHighest ? _mm256_blendv_epi8(low, high, lowerLanes) : _mm256_blendv_epi8(high, low, lowerLanes);
+		}
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes.data()), values);
+
+		std::copy(lanes.begin(), lanes.begin() + poolSize, pool);
+	}
+
+	// Function: avx2SummarizeKept
+	// Eight dice per step for large selections; small ones are cheaper in scalar code.
+	CORE_TARGET_AVX2 KeptSummary avx2SummarizeKept(const int* kept, int keptCount, int diceSides, int minValue)
+	{
+		if (keptCount < 8)
+		{
+			return scalarSummarizeKept(kept, keptCount, diceSides, minValue);
+		}
+
+		__m256i totals = _mm256_setzero_si256();
+		__m256i lowest = _mm256_set1_epi32(std::numeric_limits<int>::max());
+		__m256i highest = _mm256_set1_epi32(std::numeric_limits<int>::min());
+		int i = 0;
+		for (; i + 8 <= keptCount; i += 8)
+		{
+			__m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kept + i));
+			totals = _mm256_add_epi32(totals, values);
+			lowest = _mm256_min_epi32(lowest, values);
+			highest = _mm256_max_epi32(highest, values);
+		}
+
+		alignas(32) std::array<int, 8> lanes[3];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0].data()), totals);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1].data()), lowest);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2].data()), highest);
+
+		int total = 0;
+		int low = std::numeric_limits<int>::max();
+		int high = std::numeric_limits<int>::min();
+		for (int lane = 0; lane < 8; ++lane)
+		{
+			total += lanes[0][lane];
+			low = std::min(low, lanes[1][lane]);
+			high = std::max(high, lanes[2][lane]);
+		}
+		for (; i < keptCount; ++i)
+		{
+			total += kept[i];
+			low = std::min(low, kept[i]);
+			high = std::max(high, kept[i]);
+		}
+		return { total, low == diceSides, high == minValue };
+	}
+
+	constexpr Core::Kernels::KernelTable AVX2_KERNELS{
+		Core::Kernels::InstructionSet::AVX2, avx2DiceFromWords, avx2SelectKept, avx2SummarizeKept };
+#endif
+}
+
+//DiceKernels.cpp
+namespace Core::Kernels
+{
+	// Function: isSupported
+	// True if the running CPU can execute the given instruction set.
+	bool isSupported(InstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case InstructionSet::SCALAR:
+			return true;
+		case InstructionSet::AVX2:
+#if defined(CORE_KERNELS_X86) && defined(_MSC_VER) && !defined(__clang__)
+		{
+			int info[4];
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		}
+#elif defined(CORE_KERNELS_X86)
+			return __builtin_cpu_supports("avx2");
+#else
+			return false;
+#endif
+		}
+		return false;
+	}//End of isSupported
+
+	// Function: kernelTable
+	// Returns the kernels for an instruction set, or the scalar kernels if it is not supported.
+	const KernelTable& kernelTable(InstructionSet instructionSet)
+	{
+#ifdef CORE_KERNELS_X86
+		if (instructionSet == InstructionSet::AVX2 and isSupported(InstructionSet::AVX2))
+		{
+			return AVX2_KERNELS;
+		}
+#endif
+		return SCALAR_KERNELS;
+	}//End of kernelTable
+
+	// Function: activeKernelTable
+	// Returns the fastest kernels the running CPU supports.
+	const KernelTable& activeKernelTable()
+	{
+		static const KernelTable& active = kernelTable(InstructionSet::AVX2);
+		return active;
+	}//End of activeKernelTable
+
+	// Function: generateDice
+	// Fills `dice` from `rng`, consuming exactly the words RngContext::uniform would have consumed.
+	void generateDice(const KernelTable& kernels, RngContext& rng, std::span<int> dice, int minValue, int maxValue)
+	{
+		// Every die needs at least one word, so requesting one word per missing die never reads ahead
+		constexpr std::size_t WORD_BLOCK = 256;
+		std::array<std::uint32_t, WORD_BLOCK> words;
+
+		std::size_t produced = 0;
+		while (produced < dice.size())
+		{
+			std::size_t wanted = std::min(dice.size() - produced, WORD_BLOCK);
+			rng.fill(words.data(), wanted);
+			produced += kernels.diceFromWords(words.data(), wanted, dice.data() + produced, minValue, maxValue);
+		}
+	}//End of generateDice
+}//End of Namespace Core::Kernels
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "Rng.h"
+
+//DiceKernels.h
+// Inner loops of the batch roll paths, in a portable scalar version and an AVX2 version picked at runtime.
+// Both versions of every kernel produce identical output for identical input.
+namespace Core::Kernels
+{
+	// Enum: InstructionSet
+	// Instruction sets the kernels are implemented for.
+	enum class InstructionSet
+	{
+		SCALAR, // Portable C++
+		AVX2    // x86-64 AVX2, used when the CPU supports it
+	};
+
+	// Structure: KeptSummary
+	// Total and crit flags of a set of selected dice.
+	struct KeptSummary
+	{
+		int total;        // Sum of the selected dice
+		bool critSuccess; // True if every selected die shows diceSides
+		bool critFailure; // True if every selected die shows minValue
+	};
+
+	// Structure: KernelTable
+	// One implementation of each kernel.
+	struct KernelTable
+	{
+		InstructionSet instructionSet;
+
+		// Function: diceFromWords
+		// Maps 32-bit random words to dice in [minValue, maxValue] with multiply-shift range reduction.
+		// A word whose low product half falls below 2^32 mod range is rejected, exactly as
+		// RngContext::uniform rejects it, so the accepted words produce the same dice as calling uniform.
+		// Writes one die per accepted word and returns the number written (at most wordCount).
+		std::size_t (*diceFromWords)(const std::uint32_t* words, std::size_t wordCount, int* dice, int minValue, int maxValue);
+
+		// Function: selectKept
+		// Reorders pool so that its first keptCount entries are the keptCount highest (keepHighest) or lowest
+		// dice, ordered best first. Pools of up to 8 dice go through a sorting network.
+		void (*selectKept)(int* pool, int poolSize, int keptCount, bool keepHighest);
+
+		// Function: summarizeKept
+		// Computes the total and both crit flags of the selected dice in one pass.
+		KeptSummary (*summarizeKept)(const int* kept, int keptCount, int diceSides, int minValue);
+	};
+
+	// Function: isSupported
+	// True if the running CPU can execute the given instruction set.
+	bool isSupported(InstructionSet instructionSet);
+
+	// Function: kernelTable
+	// Returns the kernels for an instruction set, or the scalar kernels if it is not supported.
+	const KernelTable& kernelTable(InstructionSet instructionSet);
+
+	// Function: activeKernelTable
+	// Returns the fastest kernels the running CPU supports, detected once.
+	const KernelTable& activeKernelTable();
+
+	// Function: generateDice
+	// Fills `dice` from `rng`, consuming exactly the words RngContext::uniform would have consumed.
+	void generateDice(const KernelTable& kernels, RngContext& rng, std::span<int> dice, int minValue, int maxValue);
+}//End of Namespace Core::Kernels
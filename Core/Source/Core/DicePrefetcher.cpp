@@ -0,0 +1,122 @@
+#include "DicePrefetcher.h"
+
+#include <algorithm>
+#include <bit>
+
+//DicePrefetcher.cpp
+namespace Core
+{
+	DicePrefetcher::DicePrefetcher()
+		: m_producer([this] { producerLoop(); })
+	{
+	}
+
+	DicePrefetcher::~DicePrefetcher()
+	{
+		m_stopping.store(true);
+		requestRefill();
+		m_producer.join();
+	}
+
+	void DicePrefetcher::add(PrefetchedDice* dice)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_rings.push_back(dice);
+		}
+		requestRefill();
+	}
+
+	// Function: remove
+	// Unregisters a ring. Taking the mutex waits out a producer pass that may be filling it.
+	void DicePrefetcher::remove(PrefetchedDice* dice)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_rings.erase(std::find(m_rings.begin(), m_rings.end(), dice));
+	}
+
+	void DicePrefetcher::requestRefill()
+	{
+		m_demand.fetch_add(1, std::memory_order_release);
+		m_demand.notify_one();
+	}
+
+	// Function: producerLoop
+	// Fills every ring, then sleeps until a consumer asks for more. Demand raised during a pass is
+	// noticed by the next wait, which returns at once.
+	void DicePrefetcher::producerLoop()
+	{
+		std::uint64_t served = 0;
+		while (not m_stopping.load())
+		{
+			m_demand.wait(served, std::memory_order_acquire);
+			served = m_demand.load(std::memory_order_acquire);
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (PrefetchedDice* dice : m_rings)
+			{
+				dice->produce();
+			}
+		}
+	}//End of producerLoop
+
+	PrefetchedDice::PrefetchedDice(DicePrefetcher& prefetcher, const RngContext& rng, int minValue, int maxValue, std::size_t capacity)
+		: m_prefetcher(prefetcher), m_minValue(minValue), m_maxValue(maxValue),
+		  m_mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1), m_lowWater((m_mask + 1) / 2),
+		  m_ring(new int[m_mask + 1]), m_fallback(RngContext(rng.seed(), ~rng.streamId())), m_source(rng)
+	{
+		m_prefetcher.add(this);
+	}
+
+	PrefetchedDice::~PrefetchedDice()
+	{
+		m_prefetcher.remove(this);
+	}
+
+	// Function: produce
+	// Generates straight into the free part of the ring, in at most two contiguous pieces.
+	void PrefetchedDice::produce()
+	{
+		const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+		const std::uint64_t head = m_head.load(std::memory_order_acquire);
+		const std::uint64_t capacity = m_mask + 1;
+		const std::uint64_t free = capacity - (tail - head);
+		if (free == 0)
+		{
+			return;
+		}
+
+		const std::uint64_t start = tail & m_mask;
+		const std::uint64_t first = std::min(free, capacity - start);
+		m_source.fill({ m_ring.get() + start, first }, m_minValue, m_maxValue);
+		m_source.fill({ m_ring.get(), free - first }, m_minValue, m_maxValue);
+
+		m_tail.store(tail + free, std::memory_order_release);
+		m_produced.store(m_produced.load(std::memory_order_relaxed) + free, std::memory_order_relaxed);
+	}//End of produce
+
+	// Function: rollInline
+	// Consumer-side fallback for an empty ring or another range. An empty ring also wakes the producer.
+	int PrefetchedDice::rollInline(int minValue, int maxValue)
+	{
+		if (minValue == m_minValue and maxValue == m_maxValue)
+		{
+			requestRefill();
+		}
+		m_underflows.store(m_underflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		return m_fallback.roll(minValue, maxValue);
+	}
+
+	PrefetchStats PrefetchedDice::stats() const
+	{
+		PrefetchStats stats;
+		stats.capacity = static_cast<std::size_t>(m_mask + 1);
+		const std::uint64_t head = m_head.load(std::memory_order_acquire);
+		stats.occupancy = static_cast<std::size_t>(m_tail.load(std::memory_order_acquire) - head);
+		stats.popped = m_popped.load(std::memory_order_relaxed);
+		stats.underflows = m_underflows.load(std::memory_order_relaxed);
+		stats.produced = m_produced.load(std::memory_order_relaxed);
+		stats.refillRequests = m_refillRequests.load(std::memory_order_relaxed);
+		return stats;
+	}
+}//End of Namespace Core
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "PackedDice.h"
+#include "Rng.h"
+
+//DicePrefetcher.h
+// Background dice generation for latency-critical threads. A DicePrefetcher runs one producer thread that
+// keeps the ring buffer of every registered PrefetchedDice topped up; the consumer thread owning a
+// PrefetchedDice then only pops ready-made dice, and its roll functions do no random number work unless
+// the ring runs dry.
+namespace Core
+{
+	class PrefetchedDice;
+
+	// Class: DicePrefetcher
+	// The producer thread shared by any number of PrefetchedDice.
+	//
+	// The producer sleeps on an atomic counter until a consumer's ring falls to half full, then refills
+	// every ring that has room. Consumers signal at most once per refill, so popping stays free of locks
+	// and system calls.
+	class DicePrefetcher
+	{
+	public:
+		DicePrefetcher();
+		~DicePrefetcher();
+
+		DicePrefetcher(const DicePrefetcher&) = delete;
+		DicePrefetcher& operator=(const DicePrefetcher&) = delete;
+
+	private:
+		friend class PrefetchedDice;
+
+		void add(PrefetchedDice* dice);
+		void remove(PrefetchedDice* dice);
+		void requestRefill();
+		void producerLoop();
+
+		std::mutex m_mutex;                    // Guards m_rings; held by the producer while it fills them
+		std::vector<PrefetchedDice*> m_rings;
+		std::atomic<std::uint64_t> m_demand{ 0 }; // Bumped by consumers needing dice; the producer waits on it
+		std::atomic<bool> m_stopping{ false };
+		std::thread m_producer;
+	};
+
+	// Structure: PrefetchStats
+	// Counters of one PrefetchedDice. Safe to read from any thread.
+	struct PrefetchStats
+	{
+		std::size_t capacity = 0;      // Dice the ring holds
+		std::size_t occupancy = 0;     // Dice ready in the ring
+		std::uint64_t popped = 0;      // Dice taken from the ring
+		std::uint64_t underflows = 0;  // Dice generated inline because the ring was empty or the range differed
+		std::uint64_t produced = 0;    // Dice the producer has pushed
+		std::uint64_t refillRequests = 0; // Times the consumer woke the producer
+	};
+
+	// Class: PrefetchedDice
+	// Dice source for one consumer thread, fed through a lock-free single-producer/single-consumer ring.
+	//
+	// The ring holds dice of one range, fixed at construction. Rolls of that range pop from it; rolls of
+	// another range, or made while the ring is empty, are generated inline from a fallback PackedDice so the
+	// caller never waits. The producer draws from `rng` through its own PackedDice, so the ring's dice are the
+	// same sequence PackedDice(rng) would give; fallback dice come from stream ~rng.streamId() of the same
+	// seed. A run is reproducible when stats().underflows stays 0.
+	//
+	// Pass it to the PrefetchedDice overloads of rollDice, skillRoll, opposedRoll and targetRoll. Only the
+	// owning thread may roll; stats() may be read from anywhere. Destroy it before its DicePrefetcher.
+	//
+	// Example:
+	//   Core::DicePrefetcher prefetcher;
+	//   Core::PrefetchedDice dice(prefetcher, Core::RngContext(seed));
+	//   Core::SkillRollResult roll = Core::skillRoll(dice, skillLevel, boons, banes);
+	class PrefetchedDice
+	{
+	public:
+		static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+
+		// Constructor: capacity is rounded up to a power of two. Registers with the prefetcher, which fills
+		// the ring in the background.
+		PrefetchedDice(DicePrefetcher& prefetcher, const RngContext& rng,
+			int minValue = 1, int maxValue = 6, std::size_t capacity = DEFAULT_CAPACITY);
+		~PrefetchedDice();
+
+		PrefetchedDice(const PrefetchedDice&) = delete;
+		PrefetchedDice& operator=(const PrefetchedDice&) = delete;
+
+		// Function: roll
+		// Pops one die in [minValue, maxValue], or generates it inline if the ring cannot supply it.
+		int roll(int minValue, int maxValue)
+		{
+			if (minValue == m_minValue and maxValue == m_maxValue)
+			{
+				const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+				if (m_cachedTail - head <= m_lowWater)
+				{
+					// Low or empty as last seen: pick up whatever the producer has published since
+					m_cachedTail = m_tail.load(std::memory_order_acquire);
+				}
+				if (head != m_cachedTail)
+				{
+					const int die = m_ring[head & m_mask];
+					m_head.store(head + 1, std::memory_order_release);
+					m_popped.store(m_popped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+					if (m_cachedTail - head - 1 <= m_lowWater)
+					{
+						requestRefill();
+					}
+					return die;
+				}
+			}
+			return rollInline(minValue, maxValue);
+		}
+
+		// Function: fill
+		// Fills `dice` as repeated roll() calls would.
+		void fill(std::span<int> dice, int minValue, int maxValue)
+		{
+			for (int& die : dice)
+			{
+				die = roll(minValue, maxValue);
+			}
+		}
+
+		// Function: stats
+		// Snapshot of the ring's counters.
+		PrefetchStats stats() const;
+
+	private:
+		friend class DicePrefetcher;
+
+		int rollInline(int minValue, int maxValue);
+
+		// Function: requestRefill
+		// Wakes the producer, at most once for each tail it has published, so a consumer below the low-water
+		// mark signals once per refill rather than once per pop.
+		void requestRefill()
+		{
+			if (m_requestedTail != m_cachedTail)
+			{
+				m_requestedTail = m_cachedTail;
+				m_refillRequests.store(m_refillRequests.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+				m_prefetcher.requestRefill();
+			}
+		}
+
+		// Function: produce
+		// Producer side: pushes dice until the ring is full. Called with the prefetcher's mutex held.
+		void produce();
+
+		DicePrefetcher& m_prefetcher;
+		const int m_minValue;
+		const int m_maxValue;
+		const std::uint64_t m_mask;      // Capacity - 1
+		const std::uint64_t m_lowWater;  // Occupancy at or below which the consumer asks for a refill
+		std::unique_ptr<int[]> m_ring;
+
+		// Consumer side
+		alignas(64) std::atomic<std::uint64_t> m_head{ 0 }; // Next die to pop
+		std::uint64_t m_cachedTail = 0;                      // Last tail the consumer read
+		std::uint64_t m_requestedTail = ~std::uint64_t{ 0 }; // Tail seen at the last refill request
+		std::atomic<std::uint64_t> m_popped{ 0 };
+		std::atomic<std::uint64_t> m_underflows{ 0 };
+		std::atomic<std::uint64_t> m_refillRequests{ 0 };
+		PackedDice m_fallback;
+
+		// Producer side
+		alignas(64) std::atomic<std::uint64_t> m_tail{ 0 }; // Next slot to fill
+		std::atomic<std::uint64_t> m_produced{ 0 };
+		PackedDice m_source;
+	};
+}//End of Namespace Core
@@ -0,0 +1,38 @@
+#include "DiceRolls.h"
+
+#include <algorithm>
+#include <new>
+
+//DiceRolls.cpp
+namespace Core
+{
+	// Function: assignHeap
+	// Spills `dice` to a block from `resource`. The object must not own a block already. A block that is
+	// not to be released is never read again, as its resource may have recycled it by then.
+	void DiceRolls::assignHeap(std::span<const int> dice, std::pmr::memory_resource* resource, BlockRelease blockRelease)
+	{
+		void* memory = resource->allocate(sizeof(HeapHeader) + dice.size() * sizeof(int), alignof(HeapHeader));
+		HeapHeader* block = new (memory) HeapHeader{ dice.size(), resource };
+		std::copy(dice.begin(), dice.end(), reinterpret_cast<int*>(block + 1));
+
+		std::memcpy(m_storage, &block, sizeof(block));
+		m_onHeap = true;
+		m_inlineSize = 0;
+		m_releasesBlock = blockRelease == BlockRelease::DEALLOCATE;
+	}//End of assignHeap
+
+	// Function: releaseHeap
+	// Returns the spilled block to its resource, unless it was assigned with BlockRelease::NONE, and leaves
+	// the object empty.
+	void DiceRolls::releaseHeap()
+	{
+		if (m_releasesBlock)
+		{
+			HeapHeader* block = heapBlock();
+			block->resource->deallocate(block, sizeof(HeapHeader) + block->size * sizeof(int), alignof(HeapHeader));
+		}
+		m_onHeap = false;
+		m_releasesBlock = false;
+		m_inlineSize = 0;
+	}//End of releaseHeap
+}//End of Namespace Core
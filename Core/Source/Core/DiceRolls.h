@@ -0,0 +1,230 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+//DiceRolls.h
+namespace Core
+{
+	// Enum: BlockRelease
+	// What a spilled DiceRolls does with its block when it is destroyed or reassigned.
+	enum class BlockRelease : std::uint8_t
+	{
+		DEALLOCATE, // Return it to its resource, as std::pmr containers do
+		NONE        // Leave it alone: the resource frees nothing individually (an Arena, for instance)
+	};
+
+	// Class: DiceRolls
+	// Read-only sequence of dice values stored inline in 16 bytes.
+	//
+	// Up to INLINE_CAPACITY dice whose values span at most 256 consecutive integers (any ordinary die) are
+	// kept as 8-bit offsets from a base value, so copying a roll result is a flat 16-byte copy with no
+	// allocation. Larger selections spill to a block from a std::pmr::memory_resource (new/delete unless
+	// one is given), which destructors return to it. Like std::pmr containers, copies allocate from the
+	// default resource; moves take over the block. A block assigned with BlockRelease::NONE is never
+	// touched again once written, so such a result may be destroyed (but not read) after its resource has
+	// been reset or destroyed.
+	// Iterates like a std::vector<int>: range-for, begin()/end(), size(), empty() and operator[].
+	class DiceRolls
+	{
+	public:
+		static constexpr std::size_t INLINE_CAPACITY = 8;
+
+		// Class: Iterator
+		// Random-access iterator yielding die values by value.
+		class Iterator
+		{
+		public:
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = int;
+			using difference_type = std::ptrdiff_t;
+			using pointer = void;
+			using reference = int;
+
+			Iterator() = default;
+			Iterator(const DiceRolls* rolls, std::size_t index) : m_rolls(rolls), m_index(index) {}
+
+			int operator*() const { return (*m_rolls)[m_index]; }
+			int operator[](difference_type offset) const { return (*m_rolls)[m_index + offset]; }
+			Iterator& operator++() { ++m_index; return *this; }
+			Iterator operator++(int) { Iterator previous = *this; ++m_index; return previous; }
+			Iterator& operator--() { --m_index; return *this; }
+			Iterator operator--(int) { Iterator previous = *this; --m_index; return previous; }
+			Iterator& operator+=(difference_type offset) { m_index += offset; return *this; }
+			Iterator& operator-=(difference_type offset) { m_index -= offset; return *this; }
+			Iterator operator+(difference_type offset) const { return Iterator(m_rolls, m_index + offset); }
+			Iterator operator-(difference_type offset) const { return Iterator(m_rolls, m_index - offset); }
+			friend Iterator operator+(difference_type offset, const Iterator& it) { return it + offset; }
+			difference_type operator-(const Iterator& other) const
+			{
+				return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+			}
+			bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+			auto operator<=>(const Iterator& other) const { return m_index <=> other.m_index; }
+
+		private:
+			const DiceRolls* m_rolls = nullptr;
+			std::size_t m_index = 0;
+		};
+
+		DiceRolls() = default;
+		DiceRolls(std::initializer_list<int> dice) { assign(std::span<const int>(dice.begin(), dice.size())); }
+		explicit DiceRolls(std::span<const int> dice) { assign(dice); }
+		DiceRolls(std::span<const int> dice, std::pmr::memory_resource* resource, BlockRelease blockRelease = BlockRelease::DEALLOCATE)
+		{
+			assign(dice, resource, blockRelease);
+		}
+
+		DiceRolls(const DiceRolls& other)
+		{
+			if (other.m_onHeap)
+			{
+				assignHeap(std::span<const int>(other.heapDice(), other.size()), std::pmr::get_default_resource(), BlockRelease::DEALLOCATE);
+			}
+			else
+			{
+				std::memcpy(static_cast<void*>(this), &other, sizeof(DiceRolls));
+			}
+		}
+
+		DiceRolls(DiceRolls&& other) noexcept
+		{
+			std::memcpy(static_cast<void*>(this), &other, sizeof(DiceRolls));
+			other.m_onHeap = false;
+			other.m_inlineSize = 0;
+		}
+
+		DiceRolls& operator=(const DiceRolls& other)
+		{
+			if (this != &other)
+			{
+				DiceRolls copy(other);
+				*this = std::move(copy);
+			}
+			return *this;
+		}
+
+		DiceRolls& operator=(DiceRolls&& other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+				std::memcpy(static_cast<void*>(this), &other, sizeof(DiceRolls));
+				other.m_onHeap = false;
+				other.m_inlineSize = 0;
+			}
+			return *this;
+		}
+
+		~DiceRolls() { release(); }
+
+		// Function: assign
+		// Replaces the contents with `dice`, storing them inline whenever they fit and spilling them to a
+		// block from `resource` otherwise; `blockRelease` says whether that block goes back to `resource`.
+		void assign(std::span<const int> dice, std::pmr::memory_resource* resource = std::pmr::new_delete_resource(),
+			BlockRelease blockRelease = BlockRelease::DEALLOCATE)
+		{
+			release();
+			if (dice.size() <= INLINE_CAPACITY)
+			{
+				int lowest = 0;
+				int highest = 0;
+				for (std::size_t i = 0; i < dice.size(); ++i)
+				{
+					lowest = i == 0 or dice[i] < lowest ? dice[i] : lowest;
+					highest = i == 0 or dice[i] > highest ? dice[i] : highest;
+				}
+				if (static_cast<std::int64_t>(highest) - lowest <= UINT8_MAX)
+				{
+					m_base = lowest;
+					m_inlineSize = static_cast<std::uint8_t>(dice.size());
+					for (std::size_t i = 0; i < dice.size(); ++i)
+					{
+						m_storage[i] = static_cast<std::uint8_t>(static_cast<std::int64_t>(dice[i]) - lowest);
+					}
+					return;
+				}
+			}
+			assignHeap(dice, resource, blockRelease);
+		}
+
+		std::size_t size() const { return m_onHeap ? heapHeader().size : m_inlineSize; }
+		bool empty() const { return size() == 0; }
+
+		int operator[](std::size_t index) const
+		{
+			return m_onHeap ? heapDice()[index] : m_base + m_storage[index];
+		}
+
+		Iterator begin() const { return Iterator(this, 0); }
+		Iterator end() const { return Iterator(this, size()); }
+
+		// Function: isInline
+		// True if the dice are stored inline (copies do not allocate).
+		bool isInline() const { return not m_onHeap; }
+
+		std::vector<int> toVector() const { return std::vector<int>(begin(), end()); }
+
+		friend bool operator==(const DiceRolls& a, const DiceRolls& b)
+		{
+			if (a.size() != b.size())
+			{
+				return false;
+			}
+			for (std::size_t i = 0; i < a.size(); ++i)
+			{
+				if (a[i] != b[i])
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+	private:
+		// Structure: HeapHeader
+		// Precedes the dice in a spilled block.
+		struct HeapHeader
+		{
+			std::size_t size;
+			std::pmr::memory_resource* resource; // Owner of the block, read only if m_releasesBlock is set
+		};
+
+		void assignHeap(std::span<const int> dice, std::pmr::memory_resource* resource, BlockRelease blockRelease);
+		void release()
+		{
+			if (m_onHeap)
+			{
+				releaseHeap();
+			}
+		}
+		void releaseHeap();
+
+		HeapHeader* heapBlock() const
+		{
+			HeapHeader* block;
+			std::memcpy(&block, m_storage, sizeof(block));
+			return block;
+		}
+		const HeapHeader& heapHeader() const { return *heapBlock(); }
+		const int* heapDice() const { return reinterpret_cast<const int*>(heapBlock() + 1); }
+
+		// Inline: INLINE_CAPACITY offsets from m_base. Spilled: the HeapHeader pointer, copied in bytewise
+		// so the class keeps 4-byte alignment and a roll result fits in as little space as possible.
+		alignas(4) std::uint8_t m_storage[INLINE_CAPACITY] = {};
+		int m_base = 0;
+		std::uint8_t m_inlineSize = 0;
+		bool m_onHeap = false;
+		bool m_releasesBlock = false; // Spilled with BlockRelease::DEALLOCATE
+	};
+
+	static_assert(sizeof(DiceRolls) == 16, "DiceRolls is meant to stay 16 bytes");
+}//End of Namespace Core
@@ -0,0 +1,664 @@
+#include "Distribution.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+	using Core::Distribution::SkillRollPmf;
+	using Core::Distribution::TargetRollOdds;
+	using Core::Distribution::OpposedRollOdds;
+
+	// Structure: KeyHash
+	// Hash for the fixed-size integer tuples and the expressions used as cache keys.
+	struct KeyHash
+	{
+		std::size_t operator()(const std::string& key) const
+		{
+			return std::hash<std::string>{}(key);
+		}
+
+		template <std::size_t N>
+		std::size_t operator()(const std::array<int, N>& key) const
+		{
+			std::size_t hash = 0;
+			for (int value : key)
+			{
+				hash ^= std::hash<int>{}(value) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+			}
+			return hash;
+		}
+	};
+
+	// Class: MemoCache
+	// Thread-safe memo table. Values are heap-allocated and never evicted, so references stay valid.
+	template <typename Key, typename Value>
+	class MemoCache
+	{
+	public:
+		template <typename Compute>
+		const Value& get(const Key& key, Compute&& compute)
+		{
+			{
+				std::shared_lock lock(m_mutex);
+				auto found = m_values.find(key);
+				if (found != m_values.end())
+				{
+					return *found->second;
+				}
+			}
+
+			// Compute outside the lock; if another thread got there first, keep its value.
+			auto value = std::make_unique<Value>(compute());
+			std::unique_lock lock(m_mutex);
+			return *m_values.try_emplace(key, std::move(value)).first->second;
+		}
+
+	private:
+		std::shared_mutex m_mutex;
+		std::unordered_map<Key, std::unique_ptr<Value>, KeyHash> m_values;
+	};
+
+	// Function: binomialPmf
+	// Probabilities of 0..trials successes for Binomial(trials, probability).
+	void binomialPmf(int trials, double probability, std::vector<double>& out)
+	{
+		out.assign(trials + 1, 0.0);
+		if (probability >= 1.0)
+		{
+			out[trials] = 1.0;
+			return;
+		}
+		if (probability <= 0.0)
+		{
+			out[0] = 1.0;
+			return;
+		}
+
+		double logP = std::log(probability);
+		double logQ = std::log1p(-probability);
+		for (int successes = 0; successes <= trials; ++successes)
+		{
+			double logChoose = std::lgamma(trials + 1.0) - std::lgamma(successes + 1.0) - std::lgamma(trials - successes + 1.0);
+			out[successes] = std::exp(logChoose + successes * logP + (trials - successes) * logQ);
+		}
+	}
+
+	// Function: keptSumPmf
+	// PMF of the sum of the kept dice when `keptCount` of `poolSize` independent dice are kept from the
+	// high end (keepHighest) or the low end. facePmf[v] is the probability that a die shows offset v.
+	//
+	// Faces are visited starting from the kept end. Each of the dice not yet placed shows the current face
+	// with its probability divided by the mass of the faces left to visit (1 / r for r uniform faces),
+	// independently. The state is (dice placed, sum of kept dice); the number kept so far is
+	// min(placed, keptCount).
+	std::vector<double> keptSumPmf(int poolSize, int keptCount, const std::vector<double>& facePmf, bool keepHighest)
+	{
+		const int faces = static_cast<int>(facePmf.size());
+		const int maxSum = keptCount * (faces - 1);
+		std::vector<std::vector<double>> states(poolSize + 1, std::vector<double>(maxSum + 1, 0.0));
+		std::vector<std::vector<double>> next = states;
+		std::vector<double> binomial;
+		states[0][0] = 1.0;
+
+		std::vector<double> remainingMass(faces + 1, 0.0);
+		for (int step = faces - 1; step >= 0; --step)
+		{
+			remainingMass[step] = remainingMass[step + 1] + facePmf[keepHighest ? faces - 1 - step : step];
+		}
+
+		for (int step = 0; step < faces; ++step)
+		{
+			const int face = keepHighest ? faces - 1 - step : step;
+			const double probability = remainingMass[step] > 0.0 ? facePmf[face] / remainingMass[step] : 0.0;
+			for (auto& row : next)
+			{
+				std::fill(row.begin(), row.end(), 0.0);
+			}
+
+			for (int placed = 0; placed <= poolSize; ++placed)
+			{
+				const int remaining = poolSize - placed;
+				binomialPmf(remaining, probability, binomial);
+				for (int sum = 0; sum <= maxSum; ++sum)
+				{
+					double mass = states[placed][sum];
+					if (mass == 0.0)
+					{
+						continue;
+					}
+					for (int count = 0; count <= remaining; ++count)
+					{
+						int kept = std::min(placed + count, keptCount) - std::min(placed, keptCount);
+						next[placed + count][sum + kept * face] += mass * binomial[count];
+					}
+				}
+			}
+			std::swap(states, next);
+		}
+
+		return states[poolSize];
+	}
+
+	// Function: computeSkillRollPmf
+	// Builds the SkillRollPmf for one dice configuration.
+	SkillRollPmf computeSkillRollPmf(int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		// Same validation as skillRoll: an invalid roll totals the skill level with no crits.
+		if (baseDiceCount <= 0 or diceSides <= 0 or minValue > diceSides)
+		{
+			return { 0, { 1.0 }, 0.0, 0.0 };
+		}
+
+		int poolSize = baseDiceCount + std::abs(boons - banes);
+		int faces = diceSides - minValue + 1;
+		SkillRollPmf result{ baseDiceCount * minValue, keptSumPmf(poolSize, baseDiceCount, std::vector<double>(faces, 1.0 / faces), boons >= banes), 0.0, 0.0 };
+		result.critSuccess = result.pmf.back();
+		result.critFailure = result.pmf.front();
+		return result;
+	}
+
+	// Function: computeTargetRollOdds
+	// Builds TargetRollOdds from a PMF, where `offset` is skillLevel minus the target number.
+	TargetRollOdds computeTargetRollOdds(const SkillRollPmf& roll, int offset)
+	{
+		TargetRollOdds odds{ 0.0, roll.critSuccess, roll.critFailure, (roll.minTotal + offset) / Core::DIFFICULTY_SCALING_FACTOR, {} };
+		odds.degrees.assign((roll.maxTotal() + offset) / Core::DIFFICULTY_SCALING_FACTOR - odds.minDegree + 1, 0.0);
+
+		for (int total = roll.minTotal; total <= roll.maxTotal(); ++total)
+		{
+			double probability = roll.probability(total);
+			int margin = total + offset;
+			if (margin >= 0)
+			{
+				odds.success += probability;
+			}
+			odds.degrees[margin / Core::DIFFICULTY_SCALING_FACTOR - odds.minDegree] += probability;
+		}
+
+		return odds;
+	}
+
+	// Function: computeOpposedRollOdds
+	// Builds OpposedRollOdds by applying decideOpposedOutcome to every pair of totals.
+	// `skillDifference` is the attacker's skill level minus the defender's.
+	OpposedRollOdds computeOpposedRollOdds(const SkillRollPmf& attacker, const SkillRollPmf& defender,
+		int skillDifference, bool valid)
+	{
+		OpposedRollOdds odds{ 0.0, 0.0, 0.0, 0.0, 0.0, {} };
+		const int attackerCritSuccessTotal = attacker.maxTotal();
+		const int defenderCritSuccessTotal = defender.maxTotal();
+
+		for (int attackerTotal = attacker.minTotal; attackerTotal <= attacker.maxTotal(); ++attackerTotal)
+		{
+			double attackerProbability = attacker.probability(attackerTotal);
+			if (attackerProbability == 0.0)
+			{
+				continue;
+			}
+
+			for (int defenderTotal = defender.minTotal; defenderTotal <= defender.maxTotal(); ++defenderTotal)
+			{
+				double probability = attackerProbability * defender.probability(defenderTotal);
+				if (probability == 0.0)
+				{
+					continue;
+				}
+
+				Core::OpposedOutcome outcome = Core::decideOpposedOutcome(
+					skillDifference, attackerTotal + skillDifference,
+					valid and attackerTotal == attackerCritSuccessTotal, valid and attackerTotal == attacker.minTotal,
+					0, defenderTotal,
+					valid and defenderTotal == defenderCritSuccessTotal, valid and defenderTotal == defender.minTotal);
+
+				switch (outcome.winner)
+				{
+				case Core::Winner::ATTACKER: odds.attacker += probability; break;
+				case Core::Winner::DEFENDER: odds.defender += probability; break;
+				case Core::Winner::TIE: odds.tie += probability; break;
+				}
+				if (outcome.critWin) odds.critWin += probability;
+				if (outcome.critLoss) odds.critLoss += probability;
+
+				if (outcome.degree >= static_cast<int>(odds.degrees.size()))
+				{
+					odds.degrees.resize(outcome.degree + 1, 0.0);
+				}
+				odds.degrees[outcome.degree] += probability;
+			}
+		}
+
+		return odds;
+	}
+
+	// Function: convolve
+	// PMF of the sum of two independent offsets.
+	std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b)
+	{
+		std::vector<double> sum(a.size() + b.size() - 1, 0.0);
+		for (std::size_t i = 0; i < a.size(); ++i)
+		{
+			if (a[i] == 0.0)
+			{
+				continue;
+			}
+			for (std::size_t j = 0; j < b.size(); ++j)
+			{
+				sum[i + j] += a[i] * b[j];
+			}
+		}
+		return sum;
+	}
+
+	// Function: binomialTail
+	// Probability of at least `atLeast` successes in Binomial(trials, probability).
+	double binomialTail(int trials, double probability, int atLeast)
+	{
+		std::vector<double> binomial;
+		binomialPmf(trials, probability, binomial);
+		double tail = 0.0;
+		for (int successes = atLeast; successes <= trials; ++successes)
+		{
+			tail += binomial[successes];
+		}
+		return tail;
+	}
+
+	// Function: dieFacePmf
+	// Distribution of a term's die after its reroll, as offsets 0..sides-1 from a face of 1.
+	std::vector<double> dieFacePmf(const Core::DiceTerm& term)
+	{
+		const double rerolled = static_cast<double>(term.rerollAtMost) / term.sides;
+		std::vector<double> faces(term.sides);
+		for (int face = 1; face <= term.sides; ++face)
+		{
+			faces[face - 1] = (face > term.rerollAtMost ? 1.0 / term.sides : 0.0) + rerolled / term.sides;
+		}
+		return faces;
+	}
+
+	// Function: dieValuePmf
+	// Distribution of a term's die value, with explosions added, as offsets from a value of 1.
+	std::vector<double> dieValuePmf(const Core::DiceTerm& term, const std::vector<double>& faces)
+	{
+		if (not term.explode)
+		{
+			return faces;
+		}
+
+		// Each explosion adds one more uniform die; the last one allowed stops even on the highest face
+		std::vector<double> values(static_cast<std::size_t>(term.sides) * (Core::DicePlan::MAX_EXPLOSIONS + 1), 0.0);
+		std::copy(faces.begin(), faces.end() - 1, values.begin());
+		double mass = faces.back();
+		int base = term.sides;
+		for (int extra = 1; extra <= Core::DicePlan::MAX_EXPLOSIONS; ++extra)
+		{
+			const double share = mass / term.sides;
+			for (int face = 1; face < term.sides; ++face)
+			{
+				values[base + face - 1] += share;
+			}
+			if (extra == Core::DicePlan::MAX_EXPLOSIONS)
+			{
+				values[base + term.sides - 1] += share;
+			}
+			mass = share;
+			base += term.sides;
+		}
+		return values;
+	}
+
+	// Function: dicePlanWork
+	// Multiply-adds computeDicePlanPmf would take for a plan, mirroring its loops: one convolution per die
+	// of a keep-all term, the kept-sum state sweep otherwise, then the convolution into the running total.
+	// Counted in doubles so extreme plans cannot overflow the estimate.
+	double dicePlanWork(const Core::DicePlan& plan)
+	{
+		double work = 0.0;
+		double totalWidth = 1.0;
+		for (const Core::DiceTerm& term : plan.terms())
+		{
+			const double values = static_cast<double>(term.sides) * (term.explode ? Core::DicePlan::MAX_EXPLOSIONS + 1 : 1);
+			const double count = term.count;
+			double sumWidth;
+			if (term.keepsAll())
+			{
+				// Die d convolves a sum of d * (values - 1) + 1 offsets with the die's values
+				work += values * (count + (values - 1.0) * count * (count - 1.0) / 2.0);
+				sumWidth = count * (values - 1.0) + 1.0;
+			}
+			else
+			{
+				sumWidth = term.kept * (values - 1.0) + 1.0;
+				work += values * sumWidth * (count + 1.0) * (count + 2.0) / 2.0;
+			}
+			work += totalWidth * sumWidth;
+			totalWidth += sumWidth - 1.0;
+		}
+		return work;
+	}
+
+	// Function: computeDicePlanPmf
+	// Builds the SkillRollPmf of a plan's totals, convolving the terms' sums and multiplying their
+	// independent crit probabilities.
+	SkillRollPmf computeDicePlanPmf(const Core::DicePlan& plan)
+	{
+		const double crit = plan.terms().empty() ? 0.0 : 1.0;
+		SkillRollPmf result{ plan.modifier(), { 1.0 }, crit, crit };
+		for (const Core::DiceTerm& term : plan.terms())
+		{
+			const std::vector<double> faces = dieFacePmf(term);
+			const std::vector<double> values = dieValuePmf(term, faces);
+
+			std::vector<double> sums;
+			if (term.keepsAll())
+			{
+				sums = { 1.0 };
+				for (int die = 0; die < term.count; ++die)
+				{
+					sums = convolve(sums, values);
+				}
+			}
+			else
+			{
+				sums = keptSumPmf(term.count, term.kept, values, term.keepHighest);
+			}
+
+			// Offsets count from a sum of `kept` ones; a subtracted term runs the other way
+			int minSum = term.kept;
+			if (term.sign < 0)
+			{
+				std::reverse(sums.begin(), sums.end());
+				minSum = -(term.kept + static_cast<int>(sums.size()) - 1);
+			}
+			result.pmf = convolve(result.pmf, sums);
+			result.minTotal += minSum;
+
+			// Same conditions as the evaluator's crit flags (see resolveTerm in DiceExpression.cpp)
+			result.critSuccess *= binomialTail(term.count, faces.back(), term.keepHighest ? term.kept : term.count);
+			result.critFailure *= binomialTail(term.count, faces.front(), term.keepHighest ? term.count : term.kept);
+		}
+		return result;
+	}//End of computeDicePlanPmf
+
+	// Structure: MatrixCell
+	// Winner probabilities of one opposedMatrix table entry.
+	struct MatrixCell
+	{
+		float attacker;
+		float defender;
+		float tie;
+	};
+
+	// Rows and columns of one opposedMatrix tile: the defenders' columns of a tile stay in L1 while its
+	// rows are filled.
+	constexpr std::size_t MATRIX_TILE_ROWS = 32;
+	constexpr std::size_t MATRIX_TILE_COLUMNS = 2048;
+
+	// Function: computeMatrixCell
+	// Winner probabilities of an opposed roll with the attacker `skillDifference` levels above the
+	// defender, in time linear in the range of totals. `defenderCdf[k]` is the probability of a defender
+	// total below defender.minTotal + k. Only extreme totals are crits, so the defender's interior totals
+	// are settled by the attacker's crit flags or by the CDF; its two extreme totals go through
+	// decideOpposedOutcome as computeOpposedRollOdds does.
+	MatrixCell computeMatrixCell(const SkillRollPmf& attacker, const SkillRollPmf& defender,
+		const std::vector<double>& defenderCdf, int skillDifference, bool valid)
+	{
+		const int low = defender.minTotal;
+		const int high = defender.maxTotal();
+		auto interiorMass = [&](int first, int last)
+			{
+				first = std::max(first, low + 1);
+				last = std::min(last, high - 1);
+				return first > last ? 0.0 : defenderCdf[last - low + 1] - defenderCdf[first - low];
+			};
+
+		double attackerWins = 0.0;
+		double defenderWins = 0.0;
+		double ties = 0.0;
+		for (int attackerTotal = attacker.minTotal; attackerTotal <= attacker.maxTotal(); ++attackerTotal)
+		{
+			const double probability = attacker.probability(attackerTotal);
+			if (probability == 0.0)
+			{
+				continue;
+			}
+			const bool critSuccess = valid and attackerTotal == attacker.maxTotal();
+			const bool critFailure = valid and attackerTotal == attacker.minTotal;
+
+			if (critSuccess)
+			{
+				attackerWins += probability * interiorMass(low + 1, high - 1);
+			}
+			else if (critFailure)
+			{
+				defenderWins += probability * interiorMass(low + 1, high - 1);
+			}
+			else
+			{
+				// Higher total wins; equal totals go to the higher skill level
+				const int total = attackerTotal + skillDifference;
+				attackerWins += probability * interiorMass(low + 1, skillDifference > 0 ? total : total - 1);
+				defenderWins += probability * interiorMass(skillDifference < 0 ? total : total + 1, high - 1);
+				if (skillDifference == 0)
+				{
+					ties += probability * interiorMass(total, total);
+				}
+			}
+
+			for (int defenderTotal : { low, high })
+			{
+				Core::OpposedOutcome outcome = Core::decideOpposedOutcome(
+					skillDifference, attackerTotal + skillDifference, critSuccess, critFailure,
+					0, defenderTotal, valid and defenderTotal == high, valid and defenderTotal == low);
+				const double both = probability * defender.probability(defenderTotal);
+				switch (outcome.winner)
+				{
+				case Core::Winner::ATTACKER: attackerWins += both; break;
+				case Core::Winner::DEFENDER: defenderWins += both; break;
+				case Core::Winner::TIE: ties += both; break;
+				}
+				if (low == high)
+				{
+					break;
+				}
+			}
+		}
+		return { static_cast<float>(attackerWins), static_cast<float>(defenderWins), static_cast<float>(ties) };
+	}//End of computeMatrixCell
+
+	// Function: indexNets
+	// Collects the distinct net boons of `side` into `nets`, sorted, and each combatant's index into it.
+	void indexNets(const Core::SkillRollBatchInput& side, std::vector<int>& nets, std::vector<std::uint32_t>& indices)
+	{
+		indices.resize(side.skillLevels.size());
+		for (std::size_t i = 0; i < indices.size(); ++i)
+		{
+			nets.push_back(side.boons[i] - side.banes[i]);
+		}
+		std::sort(nets.begin(), nets.end());
+		nets.erase(std::unique(nets.begin(), nets.end()), nets.end());
+		for (std::size_t i = 0; i < indices.size(); ++i)
+		{
+			indices[i] = static_cast<std::uint32_t>(std::lower_bound(nets.begin(), nets.end(), side.boons[i] - side.banes[i]) - nets.begin());
+		}
+	}
+
+	MemoCache<std::array<int, 4>, SkillRollPmf> skillRollCache;
+	MemoCache<std::array<int, 5>, TargetRollOdds> targetRollCache;
+	MemoCache<std::array<int, 6>, OpposedRollOdds> opposedRollCache;
+	MemoCache<std::string, SkillRollPmf> dicePlanCache;
+	MemoCache<std::string, TargetRollOdds> planTargetCache;
+}
+
+//Distribution.cpp
+namespace Core::Distribution
+{
+	// Function: skillRoll
+	// Returns the exact distribution of skillRoll totals for the given dice configuration.
+	const SkillRollPmf& skillRoll(int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		// Only the net boons/banes affect the pool
+		int net = boons - banes;
+		return skillRollCache.get({ net, baseDiceCount, diceSides, minValue }, [&]()
+			{
+				return computeSkillRollPmf(std::max(net, 0), std::max(-net, 0), baseDiceCount, diceSides, minValue);
+			});
+	}//End of skillRoll
+
+	// Function: targetRoll
+	// Returns the exact outcome probabilities of Core::targetRoll.
+	const TargetRollOdds& targetRoll(int skillLevel, int difficultyLevel,
+		int boons, int banes, int baseDiceCount, int diceSides, int minValue)
+	{
+		// Outcomes depend only on how far the skill level sits from the target number
+		int offset = skillLevel - difficultyLevel * DIFFICULTY_SCALING_FACTOR;
+		return targetRollCache.get({ offset, boons - banes, baseDiceCount, diceSides, minValue }, [&]()
+			{
+				return computeTargetRollOdds(skillRoll(boons, banes, baseDiceCount, diceSides, minValue), offset);
+			});
+	}//End of targetRoll
+
+	// Function: opposedRoll
+	// Returns the exact outcome probabilities of Core::opposedRoll.
+	const OpposedRollOdds& opposedRoll(int attackerSkillLevel, int defenderSkillLevel,
+		int attackerBoons, int attackerBanes,
+		int defenderBoons, int defenderBanes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		// Totals and the tie-break only depend on the difference between the skill levels
+		int skillDifference = attackerSkillLevel - defenderSkillLevel;
+		return opposedRollCache.get(
+			{ skillDifference, attackerBoons - attackerBanes, defenderBoons - defenderBanes, baseDiceCount, diceSides, minValue },
+			[&]()
+			{
+				bool valid = baseDiceCount > 0 and diceSides > 0 and minValue <= diceSides;
+				return computeOpposedRollOdds(
+					skillRoll(attackerBoons, attackerBanes, baseDiceCount, diceSides, minValue),
+					skillRoll(defenderBoons, defenderBanes, baseDiceCount, diceSides, minValue),
+					skillDifference, valid);
+			});
+	}//End of opposedRoll
+
+	// Function: opposedMatrix
+	// Builds a table of odds per pair of distinct nets, then fills the matrix from it tile by tile.
+	bool opposedMatrix(const SkillRollBatchInput& attackers, const SkillRollBatchInput& defenders,
+		const OpposedMatrixOutput& output, int baseDiceCount, int diceSides, int minValue, ThreadPool* pool)
+	{
+		const std::size_t rows = attackers.skillLevels.size();
+		const std::size_t columns = defenders.skillLevels.size();
+		const std::size_t cells = rows * columns;
+		if (attackers.boons.size() != rows or attackers.banes.size() != rows
+			or defenders.boons.size() != columns or defenders.banes.size() != columns)
+		{
+			return false;
+		}
+		for (std::span<float> matrix : { output.attacker, output.defender, output.tie })
+		{
+			if (not matrix.empty() and matrix.size() < cells)
+			{
+				return false;
+			}
+		}
+		if (cells == 0)
+		{
+			return true;
+		}
+
+		std::vector<int> attackerNets, defenderNets;
+		std::vector<std::uint32_t> attackerIndices, defenderIndices;
+		indexNets(attackers, attackerNets, attackerIndices);
+		indexNets(defenders, defenderNets, defenderIndices);
+
+		// Every net shares the range of totals, so beyond a difference of width + 1 one side always has the
+		// higher total and only crits can change the outcome
+		const bool valid = baseDiceCount > 0 and diceSides > 0 and minValue <= diceSides;
+		const SkillRollPmf& plain = skillRoll(0, 0, baseDiceCount, diceSides, minValue);
+		const int reach = plain.maxTotal() - plain.minTotal + 1;
+		const std::size_t differences = 2 * static_cast<std::size_t>(reach) + 1;
+		const std::size_t netPairs = attackerNets.size() * defenderNets.size();
+
+		ThreadPool& workers = pool != nullptr ? *pool : ThreadPool::shared();
+		std::vector<MatrixCell> table(netPairs * differences);
+		workers.parallelFor(netPairs, [&](std::size_t pair, unsigned)
+			{
+				const SkillRollPmf& attacker = skillRoll(attackerNets[pair / defenderNets.size()], 0, baseDiceCount, diceSides, minValue);
+				const SkillRollPmf& defender = skillRoll(defenderNets[pair % defenderNets.size()], 0, baseDiceCount, diceSides, minValue);
+				std::vector<double> defenderCdf(defender.pmf.size() + 1, 0.0);
+				for (std::size_t k = 0; k < defender.pmf.size(); ++k)
+				{
+					defenderCdf[k + 1] = defenderCdf[k] + defender.pmf[k];
+				}
+				for (std::size_t difference = 0; difference < differences; ++difference)
+				{
+					table[pair * differences + difference] = computeMatrixCell(attacker, defender, defenderCdf,
+						static_cast<int>(difference) - reach, valid);
+				}
+			});
+
+		float* attackerWins = output.attacker.empty() ? nullptr : output.attacker.data();
+		float* defenderWins = output.defender.empty() ? nullptr : output.defender.data();
+		float* ties = output.tie.empty() ? nullptr : output.tie.data();
+		const std::size_t rowTiles = (rows + MATRIX_TILE_ROWS - 1) / MATRIX_TILE_ROWS;
+		workers.parallelFor(rowTiles, [&](std::size_t tile, unsigned)
+			{
+				const std::size_t firstRow = tile * MATRIX_TILE_ROWS;
+				const std::size_t lastRow = std::min(firstRow + MATRIX_TILE_ROWS, rows);
+				for (std::size_t firstColumn = 0; firstColumn < columns; firstColumn += MATRIX_TILE_COLUMNS)
+				{
+					const std::size_t lastColumn = std::min(firstColumn + MATRIX_TILE_COLUMNS, columns);
+					for (std::size_t row = firstRow; row < lastRow; ++row)
+					{
+						const MatrixCell* rowTable = table.data() + attackerIndices[row] * defenderNets.size() * differences;
+						const std::int64_t skillLevel = attackers.skillLevels[row];
+						for (std::size_t column = firstColumn; column < lastColumn; ++column)
+						{
+							const std::int64_t difference = std::clamp<std::int64_t>(
+								skillLevel - defenders.skillLevels[column], -reach, reach);
+							const MatrixCell& cell = rowTable[defenderIndices[column] * differences + static_cast<std::size_t>(difference + reach)];
+							const std::size_t index = row * columns + column;
+							if (attackerWins) attackerWins[index] = cell.attacker;
+							if (defenderWins) defenderWins[index] = cell.defender;
+							if (ties) ties[index] = cell.tie;
+						}
+					}
+				}
+			});
+		return true;
+	}//End of opposedMatrix
+
+	// Function: dicePlan
+	// Returns the exact distribution of a compiled plan's totals, or null if it is over MAX_DICE_PLAN_WORK.
+	// The estimate is checked before the cache so an unaffordable plan never occupies a worker.
+	const SkillRollPmf* dicePlan(const DicePlan& plan)
+	{
+		if (dicePlanWork(plan) > MAX_DICE_PLAN_WORK)
+		{
+			return nullptr;
+		}
+		return &dicePlanCache.get(plan.expression(), [&]()
+			{
+				return computeDicePlanPmf(plan);
+			});
+	}
+
+	// Function: targetRoll
+	// Returns the exact outcome probabilities of DicePlan::rollTarget, or null if dicePlan cannot compute them.
+	const TargetRollOdds* targetRoll(const DicePlan& plan, int difficultyLevel)
+	{
+		const SkillRollPmf* roll = dicePlan(plan);
+		if (roll == nullptr)
+		{
+			return nullptr;
+		}
+		return &planTargetCache.get(plan.expression() + '@' + std::to_string(difficultyLevel), [&]()
+			{
+				return computeTargetRollOdds(*roll, -difficultyLevel * DIFFICULTY_SCALING_FACTOR);
+			});
+	}
+}//End of Namespace Core::Distribution
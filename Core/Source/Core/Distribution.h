@@ -0,0 +1,169 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "Core.h"
+#include "DiceExpression.h"
+#include "ThreadPool.h"
+
+//Distribution.h
+// Exact outcome probabilities for skillRoll, targetRoll, opposedRoll and compiled dice expressions.
+//
+// A skill roll keeps the highest (boons) or lowest (banes) baseDiceCount of a pool of dice, so its total is
+// an order statistic sum. Distribution computes that PMF exactly by walking the die faces from the kept end
+// and distributing the pool over each face with a conditional binomial. Because every selected die is at
+// most diceSides, "all selected dice show diceSides" is the same event as "the selected dice sum to
+// baseDiceCount * diceSides", so the crit probabilities fall out of the PMF's endpoints.
+//
+// Every result is memoized, so repeated queries cost one hash lookup. Returned references stay valid for
+// the lifetime of the program. All functions are thread-safe.
+namespace Core::Distribution
+{
+	// Structure: SkillRollPmf
+	// Probability mass function of skillRoll totals for a skill level of 0.
+	// Add the skill level to every total to get the distribution for another skill level.
+	struct SkillRollPmf
+	{
+		int minTotal;                    // Smallest possible total (pmf[0] is its probability)
+		std::vector<double> pmf;         // pmf[i] is the probability of a total of minTotal + i
+		double critSuccess;              // Probability that all selected dice roll the maximum value
+		double critFailure;              // Probability that all selected dice roll the minimum value
+
+		int maxTotal() const { return minTotal + static_cast<int>(pmf.size()) - 1; }
+
+		// Function: probability
+		// Probability of a total of exactly `total` (skill level 0).
+		double probability(int total) const
+		{
+			return total < minTotal or total > maxTotal() ? 0.0 : pmf[total - minTotal];
+		}
+	};
+
+	// Structure: TargetRollOdds
+	// Exact outcome probabilities of a targetRoll.
+	struct TargetRollOdds
+	{
+		double success;              // Probability that the total meets or exceeds the target number
+		double critSuccess;          // Probability of a critical success
+		double critFailure;          // Probability of a critical failure
+		int minDegree;               // Lowest possible degree (degrees[0] is its probability)
+		std::vector<double> degrees; // degrees[i] is the probability of a degree of minDegree + i
+
+		// Function: degreeProbability
+		// Probability of a degree of exactly `degree`.
+		double degreeProbability(int degree) const
+		{
+			int index = degree - minDegree;
+			return index < 0 or index >= static_cast<int>(degrees.size()) ? 0.0 : degrees[index];
+		}
+	};
+
+	// Structure: OpposedRollOdds
+	// Exact outcome probabilities of an opposedRoll, with the skill tie-break and crit overrides applied.
+	struct OpposedRollOdds
+	{
+		double attacker;             // Probability that the winner is ATTACKER
+		double defender;             // Probability that the winner is DEFENDER
+		double tie;                  // Probability that the winner is TIE
+		double critWin;              // Probability that the winner was decided by a critical success
+		double critLoss;             // Probability that the loser was decided by a critical failure
+		std::vector<double> degrees; // degrees[i] is the probability of a degree of i
+	};
+
+	// Function: skillRoll
+	// Returns the exact distribution of skillRoll totals (skill level 0) for the given dice configuration.
+	// Invalid configurations return the distribution of skillRoll's invalid roll: a total of 0 with no crits.
+	//
+	// Parameters:
+	// - boons: Extra dice rolled, keeping the highest rolls (default: DEFAULT_BOONS).
+	// - banes: Extra dice rolled, keeping the lowest rolls (default: DEFAULT_BANES).
+	// - baseDiceCount: Number of main dice rolled (default: DEFAULT_BASE_DICE_COUNT).
+	// - diceSides: Number of sides on each die (default: DEFAULT_DICE_SIDES).
+	// - minValue: Minimum value each die can roll (default: DEFAULT_MIN_VALUE).
+	//
+	// Returns:
+	// - A reference to the memoized SkillRollPmf.
+	const SkillRollPmf& skillRoll(int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	// Function: targetRoll
+	// Returns the exact success, crit and degree probabilities of Core::targetRoll with the same parameters.
+	//
+	// Returns:
+	// - A reference to the memoized TargetRollOdds.
+	const TargetRollOdds& targetRoll(int skillLevel, int difficultyLevel,
+		int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	// Function: opposedRoll
+	// Returns the exact winner, crit and degree probabilities of Core::opposedRoll with the same parameters.
+	//
+	// Returns:
+	// - A reference to the memoized OpposedRollOdds.
+	const OpposedRollOdds& opposedRoll(
+		int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+		int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+		int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES,
+		int minValue = DEFAULT_MIN_VALUE);
+
+	// Structure: OpposedMatrixOutput
+	// Caller-owned attackers x defenders matrices, row-major: cell (i, j) at index i * defenders + j is
+	// attacker i against defender j. Empty spans are skipped. Single precision halves the memory a large
+	// matrix takes and the bandwidth filling it, and keeps about seven significant digits.
+	struct OpposedMatrixOutput
+	{
+		std::span<float> attacker; // Probability that the winner is ATTACKER
+		std::span<float> defender; // Probability that the winner is DEFENDER
+		std::span<float> tie;      // Probability that the winner is TIE
+	};
+
+	// Function: opposedMatrix
+	// Fills the exact opposedRoll winner probabilities of every attacker against every defender.
+	//
+	// An opposed roll only depends on the skill difference and each side's net boons, and once the
+	// difference exceeds the width of the totals' range the tie-break can no longer come into play. The
+	// combatants are therefore collapsed to their distinct net boons, and one table of odds is built for
+	// each pair of nets over the skill differences that matter, from the totals' PMF and CDF in time linear
+	// in the range. Filling a cell is then a table lookup; rows are filled in cache-sized tiles across the pool.
+	//
+	// Parameters:
+	// - attackers, defenders: Skill level, boons and banes of each combatant.
+	// - output: Destination matrices; non-empty spans must hold attackers * defenders cells.
+	// - baseDiceCount, diceSides, minValue: Dice configuration, as for opposedRoll.
+	// - pool: Pool to fill the rows on, or ThreadPool::shared() if null.
+	//
+	// Returns:
+	// - False if an input's spans differ in length or an output span is too small; nothing is written then.
+	bool opposedMatrix(const SkillRollBatchInput& attackers, const SkillRollBatchInput& defenders,
+		const OpposedMatrixOutput& output,
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT,
+		int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE,
+		ThreadPool* pool = nullptr);
+
+	// Work limit of dicePlan, in multiply-adds (about a second). The cost grows with the square of a term's
+	// dice times faces, so plans the compiler accepts, such as 64d1000! or 128d1000kh64, can need hours.
+	constexpr double MAX_DICE_PLAN_WORK = 1e9;
+
+	// Function: dicePlan
+	// Returns the exact distribution of a plan's totals, modifier included, with the probabilities of its
+	// crits. Kept terms are order statistic sums as above, over the distribution of one die after rerolls and
+	// explosions; terms are then convolved together. Memoized by the plan's canonical expression.
+	//
+	// Returns:
+	// - A pointer to the memoized SkillRollPmf; its totals already include the modifier.
+	// - Null if the estimated work exceeds MAX_DICE_PLAN_WORK; sample with DicePlan::roll instead.
+	const SkillRollPmf* dicePlan(const DicePlan& plan);
+
+	// Function: targetRoll
+	// Returns the exact outcome probabilities of DicePlan::rollTarget.
+	//
+	// Returns:
+	// - A pointer to the memoized TargetRollOdds.
+	// - Null if dicePlan returns null for the plan.
+	const TargetRollOdds* targetRoll(const DicePlan& plan, int difficultyLevel);
+}//End of Namespace Core::Distribution
@@ -0,0 +1,200 @@
+#include "Encounter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+
+namespace
+{
+	// Function: slice
+	// Rows [first, first + count) of an optional output span holding `width` values per row.
+	template <typename T>
+	std::span<T> slice(std::span<T> values, std::size_t first, std::size_t count, std::size_t width = 1)
+	{
+		return values.empty() ? values : values.subspan(first * width, count * width);
+	}
+
+	Core::SkillRollBatchOutput slice(const Core::SkillRollBatchOutput& output, std::size_t first, std::size_t count, int baseDiceCount)
+	{
+		return { slice(output.totals, first, count), slice(output.critSuccess, first, count),
+			slice(output.critFailure, first, count), slice(output.dice, first, count, static_cast<std::size_t>(std::max(baseDiceCount, 0))) };
+	}
+
+	// Function: fits
+	// True if an optional output span is empty or holds at least `rows` rows of `width` values.
+	template <typename T>
+	bool fits(std::span<T> values, std::size_t rows, std::size_t width = 1)
+	{
+		return values.empty() or values.size() >= rows * width;
+	}
+
+	bool fits(const Core::SkillRollBatchOutput& output, std::size_t rows, int baseDiceCount)
+	{
+		return fits(output.totals, rows) and fits(output.critSuccess, rows) and fits(output.critFailure, rows)
+			and (baseDiceCount <= 0 or fits(output.dice, rows, static_cast<std::size_t>(baseDiceCount)));
+	}
+}
+
+//Encounter.cpp
+namespace Core
+{
+	Encounter::Encounter(std::size_t reserveCombatants)
+	{
+		m_skillLevels.reserve(reserveCombatants);
+		m_boons.reserve(reserveCombatants);
+		m_banes.reserve(reserveCombatants);
+		m_conditions.reserve(reserveCombatants);
+	}
+
+	// Function: addCombatant
+	// Appends a combatant to every column.
+	CombatantId Encounter::addCombatant(int skillLevel, int boons, int banes, std::uint32_t conditions)
+	{
+		m_skillLevels.push_back(skillLevel);
+		m_boons.push_back(boons);
+		m_banes.push_back(banes);
+		m_conditions.push_back(conditions);
+		return static_cast<CombatantId>(m_skillLevels.size() - 1);
+	}//End of addCombatant
+
+	// Function: setConditionEffect
+	// Records the boons and banes of one condition bit.
+	bool Encounter::setConditionEffect(unsigned condition, int boons, int banes)
+	{
+		if (condition >= MAX_CONDITIONS)
+		{
+			return false;
+		}
+		m_conditionEffects[condition] = { boons, banes };
+		m_hasConditionEffects = false;
+		for (const ConditionEffect& effect : m_conditionEffects)
+		{
+			m_hasConditionEffects = m_hasConditionEffects or effect.boons != 0 or effect.banes != 0;
+		}
+		return true;
+	}//End of setConditionEffect
+
+	// Function: effectiveBoons
+	// Boons plus those granted by the combatant's conditions.
+	int Encounter::effectiveBoons(CombatantId id) const
+	{
+		int boons = m_boons[id];
+		for (std::uint32_t bits = m_conditions[id]; bits != 0; bits &= bits - 1)
+		{
+			boons += m_conditionEffects[std::countr_zero(bits)].boons;
+		}
+		return boons;
+	}//End of effectiveBoons
+
+	// Function: effectiveBanes
+	// Banes plus those added by the combatant's conditions.
+	int Encounter::effectiveBanes(CombatantId id) const
+	{
+		int banes = m_banes[id];
+		for (std::uint32_t bits = m_conditions[id]; bits != 0; bits &= bits - 1)
+		{
+			banes += m_conditionEffects[std::countr_zero(bits)].banes;
+		}
+		return banes;
+	}//End of effectiveBanes
+
+	// Function: applyConditions
+	// Folds every combatant's conditions into the effective boons and banes columns.
+	void Encounter::applyConditions()
+	{
+		m_effectiveBoons.resize(size());
+		m_effectiveBanes.resize(size());
+		for (CombatantId id = 0; id < size(); ++id)
+		{
+			m_effectiveBoons[id] = effectiveBoons(id);
+			m_effectiveBanes[id] = effectiveBanes(id);
+		}
+	}//End of applyConditions
+
+	// Function: resolveRound
+	// Gathers the pairings into batch columns and resolves them chunk by chunk.
+	bool Encounter::resolveRound(RngContext& rng, std::span<const Pairing> pairings, const OpposedRollBatchOutput& output,
+		ThreadPool* pool, int baseDiceCount, int diceSides, int minValue)
+	{
+		const std::size_t count = pairings.size();
+		if (not fits(output.winners, count) or not fits(output.degrees, count)
+			or not fits(output.critWins, count) or not fits(output.critLosses, count)
+			or not fits(output.attackerRolls, count, baseDiceCount) or not fits(output.defenderRolls, count, baseDiceCount))
+		{
+			return false;
+		}
+		for (const Pairing& pairing : pairings)
+		{
+			if (pairing.attacker >= size() or pairing.defender >= size())
+			{
+				return false;
+			}
+		}
+
+		// Effective boons and banes are computed once per combatant, not once per pairing
+		const int* boons = m_boons.data();
+		const int* banes = m_banes.data();
+		if (m_hasConditionEffects)
+		{
+			applyConditions();
+			boons = m_effectiveBoons.data();
+			banes = m_effectiveBanes.data();
+		}
+
+		m_attackerSkillLevels.resize(count);
+		m_defenderSkillLevels.resize(count);
+		m_attackerBoons.resize(count);
+		m_attackerBanes.resize(count);
+		m_defenderBoons.resize(count);
+		m_defenderBanes.resize(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const CombatantId attacker = pairings[i].attacker;
+			const CombatantId defender = pairings[i].defender;
+			m_attackerSkillLevels[i] = m_skillLevels[attacker];
+			m_defenderSkillLevels[i] = m_skillLevels[defender];
+			m_attackerBoons[i] = boons[attacker];
+			m_attackerBanes[i] = banes[attacker];
+			m_defenderBoons[i] = boons[defender];
+			m_defenderBanes[i] = banes[defender];
+		}
+
+		const std::uint64_t roundSeed = rng.next64();
+		const std::size_t chunkCount = (count + ROUND_CHUNK - 1) / ROUND_CHUNK;
+		std::atomic<bool> valid{ true };
+		auto resolveChunk = [&](std::size_t chunk, unsigned) {
+			const std::size_t first = chunk * ROUND_CHUNK;
+			const std::size_t rows = std::min(ROUND_CHUNK, count - first);
+			OpposedRollBatchInput input{
+				std::span<const int>(m_attackerSkillLevels).subspan(first, rows),
+				std::span<const int>(m_defenderSkillLevels).subspan(first, rows),
+				std::span<const int>(m_attackerBoons).subspan(first, rows),
+				std::span<const int>(m_attackerBanes).subspan(first, rows),
+				std::span<const int>(m_defenderBoons).subspan(first, rows),
+				std::span<const int>(m_defenderBanes).subspan(first, rows) };
+			OpposedRollBatchOutput chunkOutput{ slice(output.winners, first, rows), slice(output.degrees, first, rows),
+				slice(output.critWins, first, rows), slice(output.critLosses, first, rows),
+				slice(output.attackerRolls, first, rows, baseDiceCount), slice(output.defenderRolls, first, rows, baseDiceCount) };
+
+			RngContext chunkRng(roundSeed, chunk);
+			if (not opposedRollBatch(chunkRng, input, chunkOutput, baseDiceCount, diceSides, minValue))
+			{
+				valid.store(false, std::memory_order_relaxed);
+			}
+		};
+
+		if (pool and chunkCount > 1)
+		{
+			pool->parallelFor(chunkCount, resolveChunk);
+		}
+		else
+		{
+			for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+			{
+				resolveChunk(chunk, 0);
+			}
+		}
+
+		return valid.load(std::memory_order_relaxed);
+	}//End of resolveRound
+}//End of Namespace Core
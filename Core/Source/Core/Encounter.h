@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Core.h"
+#include "ThreadPool.h"
+
+//Encounter.h
+namespace Core
+{
+	using CombatantId = std::uint32_t;
+
+	// Maximum number of distinct conditions (bits of a combatant's conditions mask)
+	constexpr unsigned MAX_CONDITIONS = 32;
+
+	// Structure: Pairing
+	// One opposed roll of a round: the attacker's and defender's combatant ids.
+	struct Pairing
+	{
+		CombatantId attacker;
+		CombatantId defender;
+	};
+
+	// Structure: ConditionEffect
+	// Boons and banes a condition adds to every roll of a combatant that has it.
+	struct ConditionEffect
+	{
+		int boons = 0;
+		int banes = 0;
+	};
+
+	// Class: Encounter
+	// Combatants of a skirmish stored as structure-of-arrays, resolving a whole round of opposed rolls per call.
+	//
+	// A round first folds every combatant's conditions into effective boons and banes (once per combatant),
+	// then gathers the pairings into batch input arrays and resolves them with opposedRollBatch, in chunks
+	// that run in parallel when a ThreadPool is given. All scratch storage is owned by the encounter and
+	// reused, so a round allocates nothing once the encounter has seen its largest round.
+	//
+	// Each round draws one value from the caller's RngContext and resolves chunk c on stream c of that
+	// value, so results are identical with or without a pool and for any pool size.
+	class Encounter
+	{
+	public:
+		explicit Encounter(std::size_t reserveCombatants = 0);
+
+		// Function: addCombatant
+		// Adds a combatant and returns its id (ids are assigned 0, 1, 2, ...).
+		CombatantId addCombatant(int skillLevel, int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES, std::uint32_t conditions = 0);
+
+		std::size_t size() const { return m_skillLevels.size(); }
+
+		void setSkillLevel(CombatantId id, int skillLevel) { m_skillLevels[id] = skillLevel; }
+		void setBoons(CombatantId id, int boons) { m_boons[id] = boons; }
+		void setBanes(CombatantId id, int banes) { m_banes[id] = banes; }
+		void setConditions(CombatantId id, std::uint32_t conditions) { m_conditions[id] = conditions; }
+		void addConditions(CombatantId id, std::uint32_t conditions) { m_conditions[id] |= conditions; }
+		void removeConditions(CombatantId id, std::uint32_t conditions) { m_conditions[id] &= ~conditions; }
+
+		std::span<const int> skillLevels() const { return m_skillLevels; }
+		std::span<const int> boons() const { return m_boons; }
+		std::span<const int> banes() const { return m_banes; }
+		std::span<const std::uint32_t> conditions() const { return m_conditions; }
+
+		// Function: setConditionEffect
+		// Sets the boons and banes granted by condition bit `condition` (0 to MAX_CONDITIONS - 1).
+		// Returns false if the bit is out of range.
+		bool setConditionEffect(unsigned condition, int boons, int banes);
+
+		// Function: effectiveBoons
+		// A combatant's boons including those granted by its conditions.
+		int effectiveBoons(CombatantId id) const;
+
+		// Function: effectiveBanes
+		// A combatant's banes including those added by its conditions.
+		int effectiveBanes(CombatantId id) const;
+
+		// Function: resolveRound
+		// Resolves every pairing as opposedRoll(attacker, defender) with effective boons and banes, writing
+		// row i of `output` for pairings[i]. Any output span may be left empty.
+		//
+		// Parameters:
+		// - rng: Source of the round's stream seed (advanced by two words).
+		// - pairings: Attacker and defender of each opposed roll.
+		// - output: Destination spans, each empty or holding at least pairings.size() entries.
+		// - pool: Optional thread pool for resolving chunks in parallel.
+		// - baseDiceCount, diceSides, minValue: Dice configuration, as for opposedRoll.
+		//
+		// Returns:
+		// - True if the round was resolved. False if a pairing names an unknown combatant or an output span
+		//   is too small (nothing is written), or the dice configuration is invalid (as opposedRollBatch).
+		bool resolveRound(RngContext& rng, std::span<const Pairing> pairings, const OpposedRollBatchOutput& output,
+			ThreadPool* pool = nullptr,
+			int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	private:
+		static constexpr std::size_t ROUND_CHUNK = 2048; // Pairings per parallel task
+
+		void applyConditions();
+
+		std::vector<int> m_skillLevels;
+		std::vector<int> m_boons;
+		std::vector<int> m_banes;
+		std::vector<std::uint32_t> m_conditions;
+		std::array<ConditionEffect, MAX_CONDITIONS> m_conditionEffects{};
+		bool m_hasConditionEffects = false;
+
+		// Round scratch, reused between rounds
+		std::vector<int> m_effectiveBoons;
+		std::vector<int> m_effectiveBanes;
+		std::vector<int> m_attackerSkillLevels;
+		std::vector<int> m_defenderSkillLevels;
+		std::vector<int> m_attackerBoons;
+		std::vector<int> m_attackerBanes;
+		std::vector<int> m_defenderBoons;
+		std::vector<int> m_defenderBanes;
+	};
+}//End of Namespace Core
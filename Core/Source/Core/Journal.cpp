@@ -0,0 +1,435 @@
+#include "Journal.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Varint.h"
+
+namespace
+{
+	constexpr std::uint8_t KIND_MASK = 0x03;
+	constexpr std::uint8_t NEW_CONTEXT = 0x04;
+	constexpr std::uint8_t POSITION_JUMP = 0x08;
+	constexpr std::uint8_t CUSTOM_DICE = 0x10;
+	constexpr std::uint8_t SAME_PARAMETERS = 0x20;
+	constexpr std::uint8_t KNOWN_BITS = KIND_MASK | NEW_CONTEXT | POSITION_JUMP | CUSTOM_DICE | SAME_PARAMETERS;
+
+	// Function: parameterCount
+	// Number of parameters recorded for a roll kind.
+	constexpr std::size_t parameterCount(Core::JournalRollKind kind)
+	{
+		switch (kind)
+		{
+		case Core::JournalRollKind::SKILL:
+			return 3;
+		case Core::JournalRollKind::OPPOSED:
+			return 6;
+		default:
+			return 4;
+		}
+	}
+
+	using Core::Varint::zigzag;
+	using Core::Varint::unzigzag;
+
+	bool getInt(std::span<const std::uint8_t> bytes, std::size_t& offset, int& value)
+	{
+		std::uint64_t encoded;
+		if (not Core::Varint::get(bytes, offset, encoded))
+		{
+			return false;
+		}
+		std::int64_t decoded = unzigzag(encoded);
+		if (decoded < INT32_MIN or decoded > INT32_MAX)
+		{
+			return false;
+		}
+		value = static_cast<int>(decoded);
+		return true;
+	}
+}
+
+//Journal.cpp
+namespace Core
+{
+	JournalWriter::~JournalWriter()
+	{
+		close();
+	}
+
+	// Function: open
+	// Writes the magic and starts the writer thread.
+	bool JournalWriter::open(const std::string& path)
+	{
+		close();
+
+		m_file = std::fopen(path.c_str(), "wb");
+		if (not m_file)
+		{
+			return false;
+		}
+		if (std::fwrite(JOURNAL_MAGIC.data(), 1, JOURNAL_MAGIC.size(), m_file) != JOURNAL_MAGIC.size())
+		{
+			std::fclose(m_file);
+			m_file = nullptr;
+			return false;
+		}
+
+		m_buffer.resize(BUFFER_BYTES);
+		m_used = 0;
+		m_hasContext = false;
+		m_hasLastParameters = false;
+		m_stopping = false;
+		m_failed = false;
+		m_thread = std::thread(&JournalWriter::writerLoop, this);
+		return true;
+	}//End of open
+
+	// Function: close
+	// Drains the buffers, stops the writer thread and closes the file.
+	bool JournalWriter::close()
+	{
+		if (not m_file)
+		{
+			return true;
+		}
+
+		flush();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_one();
+		m_thread.join();
+
+		bool ok = not m_failed and std::fclose(m_file) == 0;
+		m_file = nullptr;
+		m_spare.clear();
+		return ok;
+	}//End of close
+
+	// Function: flush
+	// Submits the partial buffer and waits for the writer thread to go idle.
+	void JournalWriter::flush()
+	{
+		if (not m_file)
+		{
+			return;
+		}
+		if (m_used > 0)
+		{
+			submitBuffer();
+		}
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_drained.wait(lock, [this] { return m_pending.empty() and not m_writing; });
+		if (std::fflush(m_file) != 0)
+		{
+			m_failed = true;
+		}
+	}//End of flush
+
+	bool JournalWriter::failed() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_failed;
+	}
+
+	SkillRollResult JournalWriter::skillRoll(RngContext& rng, int skillLevel, int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		const std::uint64_t start = rng.position();
+		SkillRollResult result = Core::skillRoll(rng, skillLevel, boons, banes, baseDiceCount, diceSides, minValue);
+		const int parameters[] = { skillLevel, boons, banes };
+		record(JournalRollKind::SKILL, rng, start, parameters, baseDiceCount, diceSides, minValue);
+		return result;
+	}
+
+	OpposedRollResult JournalWriter::opposedRoll(RngContext& rng, int attackerSkillLevel, int defenderSkillLevel,
+		int attackerBoons, int attackerBanes, int defenderBoons, int defenderBanes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		const std::uint64_t start = rng.position();
+		OpposedRollResult result = Core::opposedRoll(rng, attackerSkillLevel, defenderSkillLevel,
+			attackerBoons, attackerBanes, defenderBoons, defenderBanes, baseDiceCount, diceSides, minValue);
+		const int parameters[] = { attackerSkillLevel, defenderSkillLevel, attackerBoons, attackerBanes, defenderBoons, defenderBanes };
+		record(JournalRollKind::OPPOSED, rng, start, parameters, baseDiceCount, diceSides, minValue);
+		return result;
+	}
+
+	TargetRollResult JournalWriter::targetRoll(RngContext& rng, int skillLevel, int difficultyLevel, int boons, int banes,
+		int baseDiceCount, int diceSides, int minValue)
+	{
+		const std::uint64_t start = rng.position();
+		TargetRollResult result = Core::targetRoll(rng, skillLevel, difficultyLevel, boons, banes, baseDiceCount, diceSides, minValue);
+		const int parameters[] = { skillLevel, difficultyLevel, boons, banes };
+		record(JournalRollKind::TARGET, rng, start, parameters, baseDiceCount, diceSides, minValue);
+		return result;
+	}
+
+	// Function: record
+	// Encodes one roll relative to the previous one into the current buffer.
+	void JournalWriter::record(JournalRollKind kind, const RngContext& rng, std::uint64_t startPosition,
+		std::span<const int> parameters, int baseDiceCount, int diceSides, int minValue)
+	{
+		if (not m_file)
+		{
+			return;
+		}
+		if (m_used + MAX_RECORD_BYTES > BUFFER_BYTES)
+		{
+			submitBuffer();
+		}
+
+		std::uint8_t* const begin = m_buffer.data() + m_used;
+		std::uint8_t* out = begin + 1;
+		std::uint8_t header = static_cast<std::uint8_t>(kind);
+
+		if (not m_hasContext or rng.seed() != m_seed or rng.streamId() != m_streamId)
+		{
+			header |= NEW_CONTEXT;
+			out = Varint::put(out, rng.seed());
+			out = Varint::put(out, rng.streamId());
+			out = Varint::put(out, startPosition);
+			m_hasContext = true;
+			m_seed = rng.seed();
+			m_streamId = rng.streamId();
+		}
+		else if (startPosition != m_endPosition)
+		{
+			header |= POSITION_JUMP;
+			out = Varint::put(out, zigzag(static_cast<std::int64_t>(startPosition - m_endPosition)));
+		}
+
+		if (baseDiceCount != DEFAULT_BASE_DICE_COUNT or diceSides != DEFAULT_DICE_SIDES or minValue != DEFAULT_MIN_VALUE)
+		{
+			header |= CUSTOM_DICE;
+			out = Varint::put(out, zigzag(baseDiceCount));
+			out = Varint::put(out, zigzag(diceSides));
+			out = Varint::put(out, zigzag(minValue));
+		}
+
+		if (m_hasLastParameters and kind == m_lastKind
+			and std::equal(parameters.begin(), parameters.end(), m_lastParameters.begin()))
+		{
+			header |= SAME_PARAMETERS;
+		}
+		else
+		{
+			for (std::size_t i = 0; i < parameters.size(); ++i)
+			{
+				out = Varint::put(out, zigzag(parameters[i]));
+				m_lastParameters[i] = parameters[i];
+			}
+			m_lastKind = kind;
+			m_hasLastParameters = true;
+		}
+
+		const std::uint64_t endPosition = rng.position();
+		out = Varint::put(out, endPosition - startPosition);
+		m_endPosition = endPosition;
+
+		*begin = header;
+		m_used = static_cast<std::size_t>(out - m_buffer.data());
+	}//End of record
+
+	// Function: submitBuffer
+	// Hands the current buffer to the writer thread and continues in a recycled one.
+	void JournalWriter::submitBuffer()
+	{
+		m_buffer.resize(m_used);
+		std::vector<std::uint8_t> next;
+		{
+			// Bound memory if the file cannot keep up: wait for the writer rather than queue without limit
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_drained.wait(lock, [this] { return m_pending.size() < MAX_PENDING_BUFFERS; });
+			m_pending.push_back(std::move(m_buffer));
+			if (not m_spare.empty())
+			{
+				next = std::move(m_spare.back());
+				m_spare.pop_back();
+			}
+		}
+		m_wake.notify_one();
+
+		m_buffer = std::move(next);
+		m_buffer.resize(BUFFER_BYTES);
+		m_used = 0;
+	}//End of submitBuffer
+
+	// Function: writerLoop
+	// Writes submitted buffers in order until close() stops the thread.
+	void JournalWriter::writerLoop()
+	{
+		std::vector<std::vector<std::uint8_t>> batch;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true)
+		{
+			m_wake.wait(lock, [this] { return not m_pending.empty() or m_stopping; });
+			if (m_pending.empty())
+			{
+				break;
+			}
+			batch.swap(m_pending);
+			m_writing = true;
+			bool failed = m_failed;
+			lock.unlock();
+
+			for (std::vector<std::uint8_t>& buffer : batch)
+			{
+				if (not failed and std::fwrite(buffer.data(), 1, buffer.size(), m_file) != buffer.size())
+				{
+					failed = true;
+				}
+			}
+
+			lock.lock();
+			m_failed = failed;
+			for (std::vector<std::uint8_t>& buffer : batch)
+			{
+				m_spare.push_back(std::move(buffer));
+			}
+			batch.clear();
+			m_writing = false;
+			m_drained.notify_all();
+		}
+	}//End of writerLoop
+
+	// Function: open
+	// Maps the journal and checks its magic.
+	bool JournalReader::open(const std::string& path)
+	{
+		m_rng.reset();
+		if (not m_file.open(path))
+		{
+			return false;
+		}
+		std::span<const std::uint8_t> bytes = m_file.bytes();
+		if (bytes.size() < JOURNAL_MAGIC.size() or std::memcmp(bytes.data(), JOURNAL_MAGIC.data(), JOURNAL_MAGIC.size()) != 0)
+		{
+			m_file.close();
+			return false;
+		}
+		rewind();
+		return true;
+	}//End of open
+
+	void JournalReader::rewind()
+	{
+		m_offset = JOURNAL_MAGIC.size();
+		m_corrupt = false;
+		m_hasContext = false;
+		m_previous = {};
+	}
+
+	// Function: next
+	// Decodes one record, filling in the fields it omits from the previous entry.
+	bool JournalReader::next(JournalEntry& entry)
+	{
+		std::span<const std::uint8_t> bytes = m_file.bytes();
+		if (m_corrupt or m_offset >= bytes.size())
+		{
+			return false;
+		}
+
+		std::size_t offset = m_offset;
+		const std::uint8_t header = bytes[offset++];
+		const auto kind = static_cast<JournalRollKind>(header & KIND_MASK);
+		bool ok = (header & ~KNOWN_BITS) == 0 and (header & KIND_MASK) <= static_cast<std::uint8_t>(JournalRollKind::TARGET);
+
+		JournalEntry decoded{};
+		decoded.kind = kind;
+		decoded.baseDiceCount = DEFAULT_BASE_DICE_COUNT;
+		decoded.diceSides = DEFAULT_DICE_SIDES;
+		decoded.minValue = DEFAULT_MIN_VALUE;
+
+		if (ok and (header & NEW_CONTEXT))
+		{
+			ok = Varint::get(bytes, offset, decoded.seed) and Varint::get(bytes, offset, decoded.streamId)
+				and Varint::get(bytes, offset, decoded.position);
+		}
+		else if (ok and m_hasContext)
+		{
+			decoded.seed = m_seed;
+			decoded.streamId = m_streamId;
+			decoded.position = m_endPosition;
+			std::uint64_t delta = 0;
+			if (header & POSITION_JUMP)
+			{
+				ok = Varint::get(bytes, offset, delta);
+			}
+			decoded.position += static_cast<std::uint64_t>(unzigzag(delta));
+		}
+		else
+		{
+			ok = false;
+		}
+
+		if (ok and (header & CUSTOM_DICE))
+		{
+			ok = getInt(bytes, offset, decoded.baseDiceCount) and getInt(bytes, offset, decoded.diceSides)
+				and getInt(bytes, offset, decoded.minValue);
+		}
+
+		if (ok and (header & SAME_PARAMETERS))
+		{
+			ok = m_previous.kind == kind and m_offset > JOURNAL_MAGIC.size();
+			decoded.parameters = m_previous.parameters;
+		}
+		else
+		{
+			for (std::size_t i = 0; ok and i < parameterCount(kind); ++i)
+			{
+				ok = getInt(bytes, offset, decoded.parameters[i]);
+			}
+		}
+
+		ok = ok and Varint::get(bytes, offset, decoded.wordCount);
+		if (not ok)
+		{
+			m_corrupt = true;
+			return false;
+		}
+
+		m_offset = offset;
+		m_hasContext = true;
+		m_seed = decoded.seed;
+		m_streamId = decoded.streamId;
+		m_endPosition = decoded.position + decoded.wordCount;
+		m_previous = decoded;
+		entry = decoded;
+		return true;
+	}//End of next
+
+	// Function: contextFor
+	// Returns the replay context positioned at the entry's start, reusing it when the entry continues it.
+	RngContext& JournalReader::contextFor(const JournalEntry& entry)
+	{
+		if (not m_rng or m_rng->seed() != entry.seed or m_rng->streamId() != entry.streamId)
+		{
+			m_rng.emplace(entry.seed, entry.streamId);
+		}
+		if (m_rng->position() != entry.position)
+		{
+			m_rng->seek(entry.position);
+		}
+		return *m_rng;
+	}//End of contextFor
+
+	SkillRollResult JournalReader::replaySkillRoll(const JournalEntry& entry)
+	{
+		const std::array<int, 6>& p = entry.parameters;
+		return Core::skillRoll(contextFor(entry), p[0], p[1], p[2], entry.baseDiceCount, entry.diceSides, entry.minValue);
+	}
+
+	OpposedRollResult JournalReader::replayOpposedRoll(const JournalEntry& entry)
+	{
+		const std::array<int, 6>& p = entry.parameters;
+		return Core::opposedRoll(contextFor(entry), p[0], p[1], p[2], p[3], p[4], p[5], entry.baseDiceCount, entry.diceSides, entry.minValue);
+	}
+
+	TargetRollResult JournalReader::replayTargetRoll(const JournalEntry& entry)
+	{
+		const std::array<int, 6>& p = entry.parameters;
+		return Core::targetRoll(contextFor(entry), p[0], p[1], p[2], p[3], entry.baseDiceCount, entry.diceSides, entry.minValue);
+	}
+}//End of Namespace Core
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core.h"
+#include "MappedFile.h"
+
+//Journal.h
+// Append-only binary log of the rolls a session made, and deterministic replay of it.
+//
+// Rolls are a pure function of their parameters and the RngContext state (seed, stream id, position), so
+// the journal stores only those, never the dice. A record is a header byte followed by LEB128 varints
+// (signed values zigzag-encoded):
+//
+//   header:   bits 0-1 kind (skill, opposed, target); bit 2 NEW_CONTEXT; bit 3 POSITION_JUMP;
+//             bit 4 CUSTOM_DICE; bit 5 SAME_PARAMETERS
+//   NEW_CONTEXT:      seed, stream id, absolute position       (the roll used a different context)
+//   POSITION_JUMP:    signed position delta                    (the context was seeked since its last roll)
+//   CUSTOM_DICE:      baseDiceCount, diceSides, minValue       (otherwise the defaults)
+//   not SAME_PARAMETERS: the roll's parameters                 (3 for skill, 6 for opposed, 4 for target)
+//   always:           words the roll consumed                  (so entries decode without replaying them)
+//
+// A session rolling on one context costs two bytes per repeated roll and a few bytes otherwise.
+// The file starts with the 8-byte JOURNAL_MAGIC.
+namespace Core
+{
+	// Identifies the journal format and version
+	constexpr std::array<std::uint8_t, 8> JOURNAL_MAGIC = { 'C', 'O', 'R', 'E', 'J', 'N', 'L', 1 };
+
+	// Enum: JournalRollKind
+	// Roll function a journal entry records.
+	enum class JournalRollKind : std::uint8_t
+	{
+		SKILL,   // skillRoll(skillLevel, boons, banes)
+		OPPOSED, // opposedRoll(attackerSkillLevel, defenderSkillLevel, attackerBoons, attackerBanes, defenderBoons, defenderBanes)
+		TARGET   // targetRoll(skillLevel, difficultyLevel, boons, banes)
+	};
+
+	// Structure: JournalEntry
+	// One decoded roll: the roll function, its parameters and the context state it started from.
+	struct JournalEntry
+	{
+		JournalRollKind kind;
+		std::uint64_t seed;            // RngContext seed
+		std::uint64_t streamId;        // RngContext stream id
+		std::uint64_t position;        // RngContext position before the roll
+		std::uint64_t wordCount;       // Words the roll consumed
+		std::array<int, 6> parameters; // Roll parameters in declaration order (unused entries are 0)
+		int baseDiceCount;
+		int diceSides;
+		int minValue;
+	};
+
+	// Class: JournalWriter
+	// Journals rolls made through it while returning their results as the Core roll functions do.
+	//
+	// Records are encoded into a 64 KiB buffer; full buffers are handed to a background thread that
+	// writes them, so the rolling thread never waits on the file. A writer is not thread-safe: use one per
+	// thread (each with its own file) or synchronize externally.
+	class JournalWriter
+	{
+	public:
+		JournalWriter() = default;
+		~JournalWriter();
+
+		JournalWriter(const JournalWriter&) = delete;
+		JournalWriter& operator=(const JournalWriter&) = delete;
+
+		// Function: open
+		// Creates (or truncates) the journal file and starts the writer thread.
+		//
+		// Returns:
+		// - True if the file was created.
+		bool open(const std::string& path);
+
+		// Function: close
+		// Writes everything journaled so far and closes the file.
+		//
+		// Returns:
+		// - True if every record reached the file.
+		bool close();
+
+		// Function: flush
+		// Waits until every record journaled so far has been written to the file.
+		void flush();
+
+		bool isOpen() const { return m_file != nullptr; }
+
+		// Function: failed
+		// True if a write to the file failed; later records are discarded.
+		bool failed() const;
+
+		// Journaled versions of the Core roll functions. Results are identical to calling them directly.
+		SkillRollResult skillRoll(RngContext& rng, int skillLevel = DEFAULT_SKILL_LEVEL,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+			int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+		OpposedRollResult opposedRoll(RngContext& rng,
+			int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+			int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+			int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES,
+			int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+		TargetRollResult targetRoll(RngContext& rng, int skillLevel, int difficultyLevel,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES,
+			int baseDiceCount = DEFAULT_BASE_DICE_COUNT, int diceSides = DEFAULT_DICE_SIDES, int minValue = DEFAULT_MIN_VALUE);
+
+	private:
+		static constexpr std::size_t BUFFER_BYTES = std::size_t{ 64 } << 10;
+		static constexpr std::size_t MAX_PENDING_BUFFERS = 64;
+		static constexpr std::size_t MAX_RECORD_BYTES = 1 + 4 * 10 + 3 * 5 + 6 * 5;
+
+		void record(JournalRollKind kind, const RngContext& rng, std::uint64_t startPosition,
+			std::span<const int> parameters, int baseDiceCount, int diceSides, int minValue);
+		void submitBuffer();
+		void writerLoop();
+
+		std::FILE* m_file = nullptr;
+
+		// Encoder state (rolling thread only)
+		std::vector<std::uint8_t> m_buffer;
+		std::size_t m_used = 0;
+		bool m_hasContext = false;
+		std::uint64_t m_seed = 0;
+		std::uint64_t m_streamId = 0;
+		std::uint64_t m_endPosition = 0;   // Context position after the last journaled roll
+		JournalRollKind m_lastKind = JournalRollKind::SKILL;
+		std::array<int, 6> m_lastParameters{};
+		bool m_hasLastParameters = false;
+
+		// Hand-off to the writer thread
+		std::thread m_thread;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_drained;
+		std::vector<std::vector<std::uint8_t>> m_pending; // Full buffers waiting to be written
+		std::vector<std::vector<std::uint8_t>> m_spare;   // Written buffers ready for reuse
+		bool m_writing = false;
+		bool m_stopping = false;
+		bool m_failed = false;
+	};
+
+	// Class: JournalReader
+	// Iterates a journal file in place (memory-mapped) and replays its rolls.
+	class JournalReader
+	{
+	public:
+		// Function: open
+		// Maps a journal file and positions the reader at its first entry.
+		//
+		// Returns:
+		// - True if the file exists and starts with JOURNAL_MAGIC.
+		bool open(const std::string& path);
+
+		// Function: next
+		// Decodes the next entry.
+		//
+		// Returns:
+		// - True if an entry was decoded; false at the end of the journal or if it is corrupt (see corrupt()).
+		bool next(JournalEntry& entry);
+
+		// Function: rewind
+		// Moves back to the first entry.
+		void rewind();
+
+		// Function: corrupt
+		// True if decoding stopped at a malformed or truncated record.
+		bool corrupt() const { return m_corrupt; }
+
+		// Replays an entry of the matching kind, reproducing the original result exactly. Consecutive
+		// entries of one context reuse the reader's RngContext instead of seeking it.
+		SkillRollResult replaySkillRoll(const JournalEntry& entry);
+		OpposedRollResult replayOpposedRoll(const JournalEntry& entry);
+		TargetRollResult replayTargetRoll(const JournalEntry& entry);
+
+	private:
+		RngContext& contextFor(const JournalEntry& entry);
+
+		MappedFile m_file;
+		std::size_t m_offset = 0;
+		bool m_corrupt = false;
+
+		// Decoder state carried between records
+		bool m_hasContext = false;
+		std::uint64_t m_seed = 0;
+		std::uint64_t m_streamId = 0;
+		std::uint64_t m_endPosition = 0;
+		JournalEntry m_previous{};
+
+		std::optional<RngContext> m_rng; // Replay context
+	};
+}//End of Namespace Core
@@ -0,0 +1,122 @@
+#include "MappedFile.h"
+
+#include <cstdio>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CORE_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//MappedFile.cpp
+namespace Core
+{
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			m_copy = std::move(other.m_copy);
+			m_data = other.m_isMapped ? other.m_data : m_copy.data();
+			m_size = other.m_size;
+			m_isOpen = other.m_isOpen;
+			m_isMapped = other.m_isMapped;
+			other.m_data = nullptr;
+			other.m_size = 0;
+			other.m_isOpen = false;
+			other.m_isMapped = false;
+		}
+		return *this;
+	}
+
+	// Function: open
+	// Maps the file where possible, otherwise reads it into memory.
+	bool MappedFile::open(const std::string& path)
+	{
+		close();
+
+#ifdef CORE_HAS_MMAP
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat info;
+		if (fstat(fd, &info) == 0)
+		{
+			m_size = static_cast<std::size_t>(info.st_size);
+			if (m_size == 0)
+			{
+				::close(fd);
+				m_isOpen = true;
+				return true;
+			}
+			void* region = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (region != MAP_FAILED)
+			{
+				::close(fd);
+				m_data = static_cast<const std::uint8_t*>(region);
+				m_isMapped = true;
+				m_isOpen = true;
+				return true;
+			}
+		}
+		::close(fd);
+		m_size = 0;
+#endif
+
+		// Fallback: read the whole file
+		std::FILE* file = std::fopen(path.c_str(), "rb");
+		if (not file)
+		{
+			return false;
+		}
+		std::uint8_t block[1 << 16];
+		std::size_t count;
+		while ((count = std::fread(block, 1, sizeof(block), file)) > 0)
+		{
+			m_copy.insert(m_copy.end(), block, block + count);
+		}
+		bool readFailed = std::ferror(file) != 0;
+		std::fclose(file);
+		if (readFailed)
+		{
+			m_copy.clear();
+			return false;
+		}
+		m_data = m_copy.data();
+		m_size = m_copy.size();
+		m_isOpen = true;
+		return true;
+	}//End of open
+
+	// Function: close
+	// Releases the mapping or the owned copy.
+	void MappedFile::close()
+	{
+#ifdef CORE_HAS_MMAP
+		if (m_isMapped)
+		{
+			munmap(const_cast<std::uint8_t*>(m_data), m_size);
+		}
+#endif
+		m_copy.clear();
+		m_data = nullptr;
+		m_size = 0;
+		m_isOpen = false;
+		m_isMapped = false;
+	}//End of close
+}//End of Namespace Core
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+//MappedFile.h
+namespace Core
+{
+	// Class: MappedFile
+	// Read-only view of a whole file. On POSIX systems the file is memory-mapped, so the bytes are read
+	// from the page cache without copying; elsewhere it is read into an owned buffer.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// Function: open
+		// Maps `path`, replacing any file already open.
+		//
+		// Returns:
+		// - True if the file was opened; false if it does not exist or cannot be read.
+		bool open(const std::string& path);
+
+		// Function: close
+		// Unmaps the file. Spans returned by bytes() become invalid.
+		void close();
+
+		bool isOpen() const { return m_isOpen; }
+		std::span<const std::uint8_t> bytes() const { return { m_data, m_size }; }
+
+	private:
+		const std::uint8_t* m_data = nullptr;
+		std::size_t m_size = 0;
+		bool m_isOpen = false;
+		bool m_isMapped = false;        // True if m_data is an mmap'ed region
+		std::vector<std::uint8_t> m_copy; // Contents when the file could not be mapped
+	};
+}//End of Namespace Core
@@ -0,0 +1,172 @@
+#include "Metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <vector>
+
+//Metrics.cpp
+namespace Core::metrics
+{
+	std::uint64_t Snapshot::skillRolls() const
+	{
+		std::uint64_t rolls = 0;
+		for (std::uint64_t count : poolSizes)
+		{
+			rolls += count;
+		}
+		return rolls;
+	}
+
+	// Function: latencyPercentile
+	// Walks the latency histogram to the bucket containing the requested rank.
+	std::uint64_t Snapshot::latencyPercentile(double p) const
+	{
+		std::uint64_t samples = 0;
+		for (std::uint64_t count : latencies)
+		{
+			samples += count;
+		}
+		if (samples == 0)
+		{
+			return 0;
+		}
+
+		const double rank = std::clamp(p, 0.0, 1.0) * static_cast<double>(samples);
+		std::uint64_t seen = 0;
+		for (std::size_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket)
+		{
+			seen += latencies[bucket];
+			if (static_cast<double>(seen) >= rank and latencies[bucket] != 0)
+			{
+				return std::uint64_t{ 2 } << bucket;
+			}
+		}
+		return std::uint64_t{ 2 } << (LATENCY_BUCKETS - 1);
+	}//End of latencyPercentile
+
+#if CORE_ENABLE_METRICS
+	namespace
+	{
+		std::uint64_t valueOf(std::uint64_t counter) { return counter; }
+		std::uint64_t valueOf(const std::atomic<std::uint64_t>& counter) { return counter.load(std::memory_order_relaxed); }
+
+		template <typename Counter, std::size_t N>
+		void addArray(std::array<std::uint64_t, N>& into, const std::array<Counter, N>& from)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				into[i] += valueOf(from[i]);
+			}
+		}
+
+		// Function: addCounters
+		// Adds every counter and histogram bucket of `from` to `into`.
+		template <typename Counter>
+		void addCounters(Counters<std::uint64_t>& into, const Counters<Counter>& from)
+		{
+			addArray(into.calls, from.calls);
+			addArray(into.rows, from.rows);
+			addArray(into.validationFailures, from.validationFailures);
+			addArray(into.poolSizes, from.poolSizes);
+			addArray(into.netModifiers, from.netModifiers);
+			addArray(into.diceTotals, from.diceTotals);
+			into.critSuccesses += valueOf(from.critSuccesses);
+			into.critFailures += valueOf(from.critFailures);
+			addArray(into.latencies, from.latencies);
+		}
+
+		// Structure: Registry
+		// Live shards and the merged counters of threads that have exited.
+		struct Registry
+		{
+			std::mutex mutex;
+			std::vector<Detail::Shard*> shards;
+			Counters<std::uint64_t> retired;
+		};
+
+		// Never destroyed, so threads exiting during static destruction can still retire their shards
+		Registry& registry()
+		{
+			static Registry* instance = new Registry;
+			return *instance;
+		}
+
+		// Class: ShardOwner
+		// Retires the thread's shard into the registry when the thread exits.
+		class ShardOwner
+		{
+		public:
+			~ShardOwner()
+			{
+				if (not m_shard)
+				{
+					return;
+				}
+				Registry& shared = registry();
+				{
+					std::lock_guard<std::mutex> lock(shared.mutex);
+					addCounters(shared.retired, *m_shard);
+					shared.shards.erase(std::find(shared.shards.begin(), shared.shards.end(), m_shard));
+				}
+				Detail::t_shard = nullptr;
+				delete m_shard;
+			}
+
+			void own(Detail::Shard* shard) { m_shard = shard; }
+
+		private:
+			Detail::Shard* m_shard = nullptr;
+		};
+	}
+
+	namespace Detail
+	{
+		Shard* registerThread()
+		{
+			thread_local ShardOwner owner;
+
+			Shard* shard = new Shard;
+			{
+				Registry& shared = registry();
+				std::lock_guard<std::mutex> lock(shared.mutex);
+				shared.shards.push_back(shard);
+			}
+			owner.own(shard);
+			t_shard = shard;
+			return shard;
+		}
+	}
+
+	// Function: recordLatency
+	// Adds the sampled call's duration to the latency histogram.
+	void CallScope::recordLatency()
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - m_start;
+		const auto nanoseconds = static_cast<std::uint64_t>(std::max<std::int64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), 1));
+		const std::size_t bucket = std::min<std::size_t>(std::bit_width(nanoseconds) - 1, LATENCY_BUCKETS - 1);
+		Detail::bump(m_shard->latencies[bucket]);
+	}//End of recordLatency
+
+	// Function: snapshot
+	// Sums the retired counters and every live shard.
+	Snapshot snapshot()
+	{
+		Snapshot merged;
+		Registry& shared = registry();
+		std::lock_guard<std::mutex> lock(shared.mutex);
+		addCounters(merged, shared.retired);
+		for (const Detail::Shard* shard : shared.shards)
+		{
+			addCounters(merged, *shard);
+		}
+		return merged;
+	}//End of snapshot
+#else
+	Snapshot snapshot()
+	{
+		return {};
+	}
+#endif
+}//End of Namespace Core::metrics
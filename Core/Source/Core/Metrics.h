@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+//Metrics.h
+// Hot-path instrumentation of the Core roll functions.
+//
+// Every thread records into its own shard of counters and histograms, registered on first use. The roll
+// functions only load and store their own shard's words (no locked instructions, no shared cache lines);
+// snapshot() sums every shard with relaxed loads, plus the totals of threads that have exited.
+//
+// Building with CORE_ENABLE_METRICS=0 (CMake option CORE_ENABLE_METRICS) compiles the instrumentation out:
+// the recording functions become empty and snapshot() returns zeros.
+#ifndef CORE_ENABLE_METRICS
+#define CORE_ENABLE_METRICS 1
+#endif
+
+namespace Core::metrics
+{
+	constexpr bool ENABLED = CORE_ENABLE_METRICS != 0;
+
+	// Enum: RollKind
+	// Entry point a call counter belongs to.
+	enum class RollKind : std::uint8_t
+	{
+		SKILL,
+		OPPOSED,
+		TARGET,
+		SKILL_BATCH,
+		OPPOSED_BATCH,
+		TARGET_BATCH
+	};
+	constexpr std::size_t ROLL_KIND_COUNT = 6;
+
+	constexpr std::size_t POOL_SIZE_BUCKETS = 17;        // Dice rolled: 0 .. 15, last bucket 16 or more
+	constexpr int NET_MODIFIER_LIMIT = 8;                // boons - banes is clamped to [-8, 8]
+	constexpr std::size_t NET_MODIFIER_BUCKETS = 2 * NET_MODIFIER_LIMIT + 1;
+	constexpr std::size_t DICE_TOTAL_BUCKETS = 64;       // Sum of the selected dice, clamped to [0, 63]
+	constexpr std::size_t LATENCY_BUCKETS = 32;          // Bucket b holds [2^b, 2^(b+1)) ns; bucket 0 also holds 0
+	constexpr std::uint64_t LATENCY_SAMPLE_INTERVAL = 64; // One in this many calls per thread is timed
+
+	// Structure: Counters
+	// Counters and histograms of all roll functions. Counter is std::uint64_t in snapshots and an atomic
+	// word in the per-thread shards.
+	template <typename Counter>
+	struct Counters
+	{
+		std::array<Counter, ROLL_KIND_COUNT> calls{};              // Calls per entry point
+		std::array<Counter, ROLL_KIND_COUNT> rows{};               // Rolls requested per entry point
+		std::array<Counter, ROLL_KIND_COUNT> validationFailures{}; // Calls rejected or resolved as invalid
+		std::array<Counter, POOL_SIZE_BUCKETS> poolSizes{};        // Dice rolled per skill roll
+		std::array<Counter, NET_MODIFIER_BUCKETS> netModifiers{};  // boons - banes per skill roll, offset by NET_MODIFIER_LIMIT
+		std::array<Counter, DICE_TOTAL_BUCKETS> diceTotals{};      // Selected dice sum per skill roll (total without skill level)
+		Counter critSuccesses{};
+		Counter critFailures{};
+		std::array<Counter, LATENCY_BUCKETS> latencies{};          // Sampled call durations
+	};
+
+	// Structure: Snapshot
+	// Sum of every thread's counters at the time of the snapshot. Each opposed roll counts as two skill
+	// rolls in the per-roll histograms.
+	struct Snapshot : Counters<std::uint64_t>
+	{
+		std::uint64_t callCount(RollKind kind) const { return calls[static_cast<std::size_t>(kind)]; }
+		std::uint64_t rowCount(RollKind kind) const { return rows[static_cast<std::size_t>(kind)]; }
+		std::uint64_t failureCount(RollKind kind) const { return validationFailures[static_cast<std::size_t>(kind)]; }
+
+		// Function: skillRolls
+		// Skill rolls resolved (sum of the pool size histogram).
+		std::uint64_t skillRolls() const;
+
+		// Function: latencyPercentile
+		// Upper bound of the latency bucket holding percentile `p` (0 to 1) of the samples, in nanoseconds,
+		// or 0 if nothing was sampled.
+		std::uint64_t latencyPercentile(double p) const;
+	};
+
+	// Function: snapshot
+	// Merges the counters of every thread. Safe to call while other threads roll; their latest increments
+	// may or may not be included.
+	Snapshot snapshot();
+
+#if CORE_ENABLE_METRICS
+	namespace Detail
+	{
+		// Structure: Shard
+		// One thread's counters. Only the owning thread writes them.
+		struct alignas(64) Shard : Counters<std::atomic<std::uint64_t>>
+		{
+			std::uint64_t ticks = 0; // Calls seen, for latency sampling (owner thread only)
+		};
+
+		// Shard of the calling thread, or null before its first recorded call
+		inline thread_local Shard* t_shard = nullptr;
+
+		// Function: registerThread
+		// Creates and registers the calling thread's shard.
+		Shard* registerThread();
+
+		inline Shard& shard()
+		{
+			Shard* shard = t_shard;
+			if (shard == nullptr) [[unlikely]]
+			{
+				shard = registerThread();
+			}
+			return *shard;
+		}
+
+		// Function: bump
+		// Single-writer increment: a plain load and store, never a locked read-modify-write.
+		inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+		}
+
+		template <typename T>
+		constexpr std::size_t clampIndex(T value, T low, T high)
+		{
+			return static_cast<std::size_t>((value < low ? low : value > high ? high : value) - low);
+		}
+	}
+
+	// Class: CallScope
+	// Counts one call of a roll function and times one in LATENCY_SAMPLE_INTERVAL of them. Place it first
+	// in the function so the sample covers the whole call.
+	class CallScope
+	{
+	public:
+		explicit CallScope(RollKind kind, std::size_t rows = 1)
+		{
+			Detail::Shard& shard = Detail::shard();
+			Detail::bump(shard.calls[static_cast<std::size_t>(kind)]);
+			Detail::bump(shard.rows[static_cast<std::size_t>(kind)], rows);
+			if ((++shard.ticks & (LATENCY_SAMPLE_INTERVAL - 1)) == 0) [[unlikely]]
+			{
+				m_shard = &shard;
+				m_start = std::chrono::steady_clock::now();
+			}
+		}
+
+		~CallScope()
+		{
+			if (m_shard) [[unlikely]]
+			{
+				recordLatency();
+			}
+		}
+
+		CallScope(const CallScope&) = delete;
+		CallScope& operator=(const CallScope&) = delete;
+
+	private:
+		void recordLatency();
+
+		Detail::Shard* m_shard = nullptr;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	// Function: recordValidationFailure
+	// Counts a call rejected by parameter checks.
+	inline void recordValidationFailure(RollKind kind)
+	{
+		Detail::bump(Detail::shard().validationFailures[static_cast<std::size_t>(kind)]);
+	}
+
+	// Function: recordSkillRoll
+	// Records one resolved skill roll: its modifiers, pool size, selected dice sum and crit flags.
+	inline void recordSkillRoll(int boons, int banes, int poolSize, int diceTotal, bool critSuccess, bool critFailure)
+	{
+		Detail::Shard& shard = Detail::shard();
+		Detail::bump(shard.poolSizes[Detail::clampIndex(poolSize, 0, static_cast<int>(POOL_SIZE_BUCKETS) - 1)]);
+		Detail::bump(shard.netModifiers[Detail::clampIndex(boons - banes, -NET_MODIFIER_LIMIT, NET_MODIFIER_LIMIT)]);
+		Detail::bump(shard.diceTotals[Detail::clampIndex(diceTotal, 0, static_cast<int>(DICE_TOTAL_BUCKETS) - 1)]);
+		Detail::bump(shard.critSuccesses, critSuccess);
+		Detail::bump(shard.critFailures, critFailure);
+	}
+#else
+	class CallScope
+	{
+	public:
+		explicit CallScope(RollKind, std::size_t = 1) {}
+	};
+
+	inline void recordValidationFailure(RollKind) {}
+	inline void recordSkillRoll(int, int, int, int, bool, bool) {}
+#endif
+}//End of Namespace Core::metrics
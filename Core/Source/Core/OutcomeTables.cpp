@@ -0,0 +1,68 @@
+#include "OutcomeTables.h"
+
+#include "Dice.h"
+
+//OutcomeTables.cpp
+namespace Core::OutcomeTables
+{
+	// Function: sampleSkillTotal
+	// Draws a kept total from the alias table of a tabulated net boons value.
+	int sampleSkillTotal(RngContext& rng, int netBoons)
+	{
+		const std::uint64_t pools = skillCounts(netBoons).pools;
+		const AliasTable& table = ALIAS_TABLES[netBoons + MAX_NET_BOONS];
+
+		std::uint32_t draw = static_cast<std::uint32_t>(rng.uniform(0, static_cast<int>(pools * TOTAL_COUNT) - 1));
+		std::uint32_t column = static_cast<std::uint32_t>(draw / pools);
+		std::uint32_t weight = static_cast<std::uint32_t>(draw % pools);
+		return MIN_TOTAL + (weight < table.thresholds[column] ? static_cast<int>(column) : table.aliases[column]);
+	}//End of sampleSkillTotal
+
+	// Function: sampleTargetRoll
+	// Draws a targetRoll outcome from the tables.
+	TargetRollResult sampleTargetRoll(RngContext& rng, int skillLevel, int difficultyLevel, int boons, int banes)
+	{
+		if (not isTabulated(boons - banes))
+		{
+			return DefaultDice::targetRoll(rng, skillLevel, difficultyLevel, boons, banes);
+		}
+
+		int keptTotal = sampleSkillTotal(rng, boons - banes);
+		TargetRollResult result{ false, 0, { skillLevel + keptTotal, {}, keptTotal == MAX_TOTAL, keptTotal == MIN_TOTAL }, false, false };
+
+		int targetNumber = difficultyLevel * DIFFICULTY_SCALING_FACTOR;
+		result.success = result.roll.total >= targetNumber;
+		result.degree = (result.roll.total - targetNumber) / DIFFICULTY_SCALING_FACTOR;
+		result.critSuccess = result.roll.critSuccess;
+		result.critFailure = result.roll.critFailure;
+		return result;
+	}//End of sampleTargetRoll
+
+	// Function: sampleOpposedRoll
+	// Draws an opposedRoll outcome from the tables.
+	OpposedRollResult sampleOpposedRoll(RngContext& rng, int attackerSkillLevel, int defenderSkillLevel,
+		int attackerBoons, int attackerBanes, int defenderBoons, int defenderBanes)
+	{
+		if (not isTabulated(attackerBoons - attackerBanes) or not isTabulated(defenderBoons - defenderBanes))
+		{
+			return DefaultDice::opposedRoll(rng, attackerSkillLevel, defenderSkillLevel,
+				attackerBoons, attackerBanes, defenderBoons, defenderBanes);
+		}
+
+		int attackerKept = sampleSkillTotal(rng, attackerBoons - attackerBanes);
+		int defenderKept = sampleSkillTotal(rng, defenderBoons - defenderBanes);
+		OpposedRollResult result{ Winner::TIE, 0,
+			{ attackerSkillLevel + attackerKept, {}, attackerKept == MAX_TOTAL, attackerKept == MIN_TOTAL },
+			{ defenderSkillLevel + defenderKept, {}, defenderKept == MAX_TOTAL, defenderKept == MIN_TOTAL },
+			false, false };
+
+		OpposedOutcome outcome = decideOpposedOutcome(
+			attackerSkillLevel, result.attackerRoll.total, result.attackerRoll.critSuccess, result.attackerRoll.critFailure,
+			defenderSkillLevel, result.defenderRoll.total, result.defenderRoll.critSuccess, result.defenderRoll.critFailure);
+		result.winner = outcome.winner;
+		result.degree = outcome.degree;
+		result.critWin = outcome.critWin;
+		result.critLoss = outcome.critLoss;
+		return result;
+	}//End of sampleOpposedRoll
+}//End of Namespace Core::OutcomeTables
@@ -0,0 +1,363 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Core.h"
+
+//OutcomeTables.h
+// Compile-time outcome tables for the default dice configuration (DEFAULT_BASE_DICE_COUNT dice of
+// DEFAULT_DICE_SIDES sides starting at DEFAULT_MIN_VALUE, i.e. 3d6).
+//
+// Every entry is an exact integer count of equally likely dice pools, so probabilities are exact fractions.
+// Counts of kept totals are tabulated per net boons (boons - banes) in [-MAX_NET_BOONS, MAX_NET_BOONS];
+// target and opposed odds are answered from prefix sums over those counts in O(1), and the sampling
+// functions draw a kept total from a per-net alias table with one random draw instead of rolling the dice.
+// Odds queries require isTabulated(net) (use Distribution beyond it); sampling falls back to DefaultDice.
+namespace Core::OutcomeTables
+{
+	constexpr int BASE_DICE = DEFAULT_BASE_DICE_COUNT;
+	constexpr int FACES = DEFAULT_DICE_SIDES - DEFAULT_MIN_VALUE + 1;
+	constexpr int MIN_TOTAL = BASE_DICE * DEFAULT_MIN_VALUE;  // Every kept die shows DEFAULT_MIN_VALUE
+	constexpr int MAX_TOTAL = BASE_DICE * DEFAULT_DICE_SIDES; // Every kept die shows DEFAULT_DICE_SIDES
+	constexpr int TOTAL_COUNT = MAX_TOTAL - MIN_TOTAL + 1;
+	constexpr int MAX_NET_BOONS = 6; // Largest |boons - banes| tabulated; FACES^(BASE_DICE + 6) * TOTAL_COUNT fits one 32-bit draw
+	constexpr int NET_COUNT = 2 * MAX_NET_BOONS + 1;
+	constexpr int MAX_POOL = BASE_DICE + MAX_NET_BOONS;
+
+	// Structure: SkillCounts
+	// Kept totals of one net boons value, as counts out of `pools` equally likely dice pools.
+	struct SkillCounts
+	{
+		std::uint64_t pools;                                // FACES^(pool size)
+		std::array<std::uint64_t, TOTAL_COUNT> counts;      // counts[t] pools keep a total of MIN_TOTAL + t
+		std::array<std::uint64_t, TOTAL_COUNT + 1> atLeast; // atLeast[t] pools keep a total of MIN_TOTAL + t or more
+	};
+
+	// Structure: TargetOdds
+	// Exact targetRoll outcome counts out of `pools`.
+	struct TargetOdds
+	{
+		std::uint64_t pools;       // Equally likely dice pools
+		std::uint64_t success;     // Pools meeting or exceeding the target number
+		std::uint64_t critSuccess; // Pools rolling a critical success
+		std::uint64_t critFailure; // Pools rolling a critical failure
+
+		constexpr double probability(std::uint64_t count) const { return static_cast<double>(count) / static_cast<double>(pools); }
+	};
+
+	// Structure: OpposedOdds
+	// Exact opposedRoll outcome counts out of `pools` (pairs of attacker and defender pools).
+	struct OpposedOdds
+	{
+		std::uint64_t pools;        // Equally likely pairs of dice pools
+		std::uint64_t attackerWins; // Pairs won by the attacker
+		std::uint64_t defenderWins; // Pairs won by the defender
+		std::uint64_t ties;         // Pairs ending in a tie
+		std::uint64_t critWins;     // Pairs whose winner was decided by a critical success
+		std::uint64_t critLosses;   // Pairs whose loser was decided by a critical failure
+
+		constexpr double probability(std::uint64_t count) const { return static_cast<double>(count) / static_cast<double>(pools); }
+	};
+
+	// Structure: OpposedPairCounts
+	// Outcome counts of one (attacker net, defender net) pair, independent of the skill levels.
+	// Pairs with exactly one critical success, or no critical success and exactly one critical failure,
+	// are decided by the crit. Every other pair is "plain" and decided by the kept totals, whose
+	// difference (attacker - defender) is tabulated as a suffix sum.
+	struct OpposedPairCounts
+	{
+		static constexpr int DIFFERENCE_COUNT = 2 * (MAX_TOTAL - MIN_TOTAL) + 1;
+
+		std::uint64_t pools;
+		std::uint64_t attackerCritWins;   // Attacker alone rolled a critical success
+		std::uint64_t defenderCritWins;   // Defender alone rolled a critical success
+		std::uint64_t attackerCritLosses; // No critical success, attacker alone rolled a critical failure
+		std::uint64_t defenderCritLosses; // No critical success, defender alone rolled a critical failure
+		std::array<std::uint64_t, DIFFERENCE_COUNT + 1> plainAtLeast; // plainAtLeast[d] plain pairs differ by d - (MAX_TOTAL - MIN_TOTAL) or more
+	};
+
+	// Structure: AliasTable
+	// Walker/Vose alias table over the kept totals of one net boons value, in exact integer weights.
+	// A draw x uniform in [0, TOTAL_COUNT * pools) picks column x / pools, which yields MIN_TOTAL + column
+	// if x % pools is below its threshold and MIN_TOTAL + alias otherwise.
+	struct AliasTable
+	{
+		std::array<std::uint32_t, TOTAL_COUNT> thresholds;
+		std::array<std::uint8_t, TOTAL_COUNT> aliases;
+	};
+
+	namespace Detail
+	{
+		constexpr std::uint64_t power(std::uint64_t base, int exponent)
+		{
+			std::uint64_t result = 1;
+			for (int i = 0; i < exponent; ++i)
+			{
+				result *= base;
+			}
+			return result;
+		}
+
+		constexpr std::uint64_t choose(int n, int k)
+		{
+			std::uint64_t result = 1;
+			for (int i = 1; i <= k; ++i)
+			{
+				result = result * (n - k + i) / i;
+			}
+			return result;
+		}
+
+		// Function: skillCounts
+		// Counts the kept totals of a pool of BASE_DICE + |netBoons| dice by walking the faces from the kept
+		// end and distributing the remaining dice over each face with a binomial coefficient.
+		constexpr SkillCounts skillCounts(int netBoons)
+		{
+			const int poolSize = BASE_DICE + (netBoons < 0 ? -netBoons : netBoons);
+			const bool keepHighest = netBoons >= 0;
+
+			// ways[used][kept][sum]: pools assigning `used` dice so far, `kept` of them kept, summing to `sum`
+			using Ways = std::array<std::array<std::array<std::uint64_t, MAX_TOTAL + 1>, BASE_DICE + 1>, MAX_POOL + 1>;
+			Ways ways{};
+			ways[0][0][0] = 1;
+			for (int step = 0; step < FACES; ++step)
+			{
+				const int face = keepHighest ? DEFAULT_DICE_SIDES - step : DEFAULT_MIN_VALUE + step;
+				Ways next{};
+				for (int used = 0; used <= poolSize; ++used)
+				{
+					for (int kept = 0; kept <= BASE_DICE; ++kept)
+					{
+						for (int sum = 0; sum <= MAX_TOTAL; ++sum)
+						{
+							if (ways[used][kept][sum] == 0)
+							{
+								continue;
+							}
+							for (int count = 0; used + count <= poolSize; ++count)
+							{
+								int keptNow = kept + count < BASE_DICE ? kept + count : BASE_DICE;
+								next[used + count][keptNow][sum + face * (keptNow - kept)] +=
+									ways[used][kept][sum] * choose(poolSize - used, count);
+							}
+						}
+					}
+				}
+				ways = next;
+			}
+
+			SkillCounts result{ power(FACES, poolSize), {}, {} };
+			for (int t = 0; t < TOTAL_COUNT; ++t)
+			{
+				result.counts[t] = ways[poolSize][BASE_DICE][MIN_TOTAL + t];
+			}
+			for (int t = TOTAL_COUNT - 1; t >= 0; --t)
+			{
+				result.atLeast[t] = result.atLeast[t + 1] + result.counts[t];
+			}
+			return result;
+		}
+
+		constexpr std::array<SkillCounts, NET_COUNT> buildSkillTable()
+		{
+			std::array<SkillCounts, NET_COUNT> table{};
+			for (int net = -MAX_NET_BOONS; net <= MAX_NET_BOONS; ++net)
+			{
+				table[net + MAX_NET_BOONS] = skillCounts(net);
+			}
+			return table;
+		}
+
+		// Function: aliasTable
+		// Builds an exact alias table with Vose's method: every column holds `pools` units of weight.
+		constexpr AliasTable aliasTable(const SkillCounts& skill)
+		{
+			std::array<std::uint64_t, TOTAL_COUNT> weights{};
+			std::array<int, TOTAL_COUNT> small{};
+			std::array<int, TOTAL_COUNT> large{};
+			int smallCount = 0;
+			int largeCount = 0;
+			for (int t = 0; t < TOTAL_COUNT; ++t)
+			{
+				weights[t] = skill.counts[t] * TOTAL_COUNT;
+				(weights[t] < skill.pools ? small[smallCount++] : large[largeCount++]) = t;
+			}
+
+			AliasTable table{};
+			for (int t = 0; t < TOTAL_COUNT; ++t)
+			{
+				table.thresholds[t] = static_cast<std::uint32_t>(skill.pools);
+				table.aliases[t] = static_cast<std::uint8_t>(t);
+			}
+			while (smallCount > 0 and largeCount > 0)
+			{
+				int lower = small[--smallCount];
+				int upper = large[--largeCount];
+				table.thresholds[lower] = static_cast<std::uint32_t>(weights[lower]);
+				table.aliases[lower] = static_cast<std::uint8_t>(upper);
+				weights[upper] -= skill.pools - weights[lower];
+				(weights[upper] < skill.pools ? small[smallCount++] : large[largeCount++]) = upper;
+			}
+			return table;
+		}
+	}//End of Namespace Detail
+
+	// Kept total counts for every tabulated net boons value, indexed by net + MAX_NET_BOONS.
+	inline constexpr std::array<SkillCounts, NET_COUNT> SKILL_TABLE = Detail::buildSkillTable();
+
+	namespace Detail
+	{
+		constexpr OpposedPairCounts opposedPairCounts(const SkillCounts& attacker, const SkillCounts& defender)
+		{
+			constexpr int LAST = TOTAL_COUNT - 1;
+			OpposedPairCounts result{ attacker.pools * defender.pools, 0, 0, 0, 0, {} };
+			std::array<std::uint64_t, OpposedPairCounts::DIFFERENCE_COUNT> plain{};
+			for (int a = 0; a < TOTAL_COUNT; ++a)
+			{
+				for (int d = 0; d < TOTAL_COUNT; ++d)
+				{
+					std::uint64_t pairs = attacker.counts[a] * defender.counts[d];
+					if (a == LAST and d != LAST) result.attackerCritWins += pairs;
+					else if (d == LAST and a != LAST) result.defenderCritWins += pairs;
+					else if (a == 0 and d != 0 and d != LAST) result.attackerCritLosses += pairs;
+					else if (d == 0 and a != 0 and a != LAST) result.defenderCritLosses += pairs;
+					else plain[a - d + LAST] += pairs;
+				}
+			}
+			for (int i = OpposedPairCounts::DIFFERENCE_COUNT - 1; i >= 0; --i)
+			{
+				result.plainAtLeast[i] = result.plainAtLeast[i + 1] + plain[i];
+			}
+			return result;
+		}
+
+		constexpr std::array<OpposedPairCounts, NET_COUNT * NET_COUNT> buildOpposedTable()
+		{
+			std::array<OpposedPairCounts, NET_COUNT * NET_COUNT> table{};
+			for (int a = 0; a < NET_COUNT; ++a)
+			{
+				for (int d = 0; d < NET_COUNT; ++d)
+				{
+					table[a * NET_COUNT + d] = opposedPairCounts(SKILL_TABLE[a], SKILL_TABLE[d]);
+				}
+			}
+			return table;
+		}
+
+		constexpr std::array<AliasTable, NET_COUNT> buildAliasTables()
+		{
+			std::array<AliasTable, NET_COUNT> tables{};
+			for (int net = 0; net < NET_COUNT; ++net)
+			{
+				tables[net] = aliasTable(SKILL_TABLE[net]);
+			}
+			return tables;
+		}
+
+		// Function: atLeast
+		// Pools of `skill` keeping a total of `total` or more, for any total.
+		constexpr std::uint64_t atLeast(const SkillCounts& skill, int total)
+		{
+			if (total <= MIN_TOTAL) return skill.pools;
+			if (total > MAX_TOTAL) return 0;
+			return skill.atLeast[total - MIN_TOTAL];
+		}
+	}//End of Namespace Detail
+
+	// Opposed pair counts indexed by (attacker net + MAX_NET_BOONS) * NET_COUNT + defender net + MAX_NET_BOONS.
+	inline constexpr std::array<OpposedPairCounts, NET_COUNT * NET_COUNT> OPPOSED_TABLE = Detail::buildOpposedTable();
+
+	// Alias tables for sampling a kept total, indexed by net + MAX_NET_BOONS.
+	inline constexpr std::array<AliasTable, NET_COUNT> ALIAS_TABLES = Detail::buildAliasTables();
+
+	static_assert(SKILL_TABLE[MAX_NET_BOONS].counts[0] == 1 and SKILL_TABLE[MAX_NET_BOONS].atLeast[0] == 216,
+		"3d6 rolls a total of 3 in exactly 1 of 216 pools");
+
+	// Function: isTabulated
+	// True if a net boons value (boons - banes) is covered by the tables.
+	constexpr bool isTabulated(int netBoons)
+	{
+		return netBoons >= -MAX_NET_BOONS and netBoons <= MAX_NET_BOONS;
+	}
+
+	// Function: skillCounts
+	// Kept total counts for a tabulated net boons value.
+	constexpr const SkillCounts& skillCounts(int netBoons)
+	{
+		return SKILL_TABLE[netBoons + MAX_NET_BOONS];
+	}
+
+	// Function: targetOdds
+	// Exact success and crit counts of targetRoll(skillLevel, difficultyLevel) with a tabulated net boons value.
+	constexpr TargetOdds targetOdds(int skillLevel, int difficultyLevel, int netBoons)
+	{
+		const SkillCounts& skill = skillCounts(netBoons);
+		int targetNumber = difficultyLevel * DIFFICULTY_SCALING_FACTOR;
+		return { skill.pools, Detail::atLeast(skill, targetNumber - skillLevel),
+			skill.counts[TOTAL_COUNT - 1], skill.counts[0] };
+	}
+
+	// Function: targetDegreeCount
+	// Pools giving targetRoll(skillLevel, difficultyLevel) a degree of exactly `degree`, out of
+	// skillCounts(netBoons).pools. The degree truncates toward zero, so degree 0 covers seven margins.
+	constexpr std::uint64_t targetDegreeCount(int skillLevel, int difficultyLevel, int netBoons, int degree)
+	{
+		const SkillCounts& skill = skillCounts(netBoons);
+		int offset = skillLevel - difficultyLevel * DIFFICULTY_SCALING_FACTOR;
+		int lowestMargin = degree > 0 ? degree * DIFFICULTY_SCALING_FACTOR : degree * DIFFICULTY_SCALING_FACTOR - (DIFFICULTY_SCALING_FACTOR - 1);
+		int highestMargin = degree < 0 ? degree * DIFFICULTY_SCALING_FACTOR : degree * DIFFICULTY_SCALING_FACTOR + (DIFFICULTY_SCALING_FACTOR - 1);
+		return Detail::atLeast(skill, lowestMargin - offset) - Detail::atLeast(skill, highestMargin - offset + 1);
+	}
+
+	// Function: opposedOdds
+	// Exact winner and crit counts of opposedRoll with tabulated net boons values for both sides.
+	// Only the difference of the skill levels matters.
+	constexpr OpposedOdds opposedOdds(int attackerSkillLevel, int defenderSkillLevel, int attackerNetBoons, int defenderNetBoons)
+	{
+		constexpr int SPREAD = MAX_TOTAL - MIN_TOTAL;
+		const OpposedPairCounts& pair = OPPOSED_TABLE[(attackerNetBoons + MAX_NET_BOONS) * NET_COUNT + defenderNetBoons + MAX_NET_BOONS];
+		const int skillDifference = attackerSkillLevel - defenderSkillLevel;
+
+		// A plain pair is won by the attacker when its kept total difference plus the skill difference is
+		// positive, or zero with the higher skill level on the attacker's side.
+		auto plainAtLeast = [&pair](long long difference) {
+			if (difference <= -SPREAD) return pair.plainAtLeast[0];
+			if (difference > SPREAD) return std::uint64_t{ 0 };
+			return pair.plainAtLeast[difference + SPREAD];
+		};
+		long long firstWinning = -static_cast<long long>(skillDifference) + (skillDifference > 0 ? 0 : 1);
+		std::uint64_t plainAttacker = plainAtLeast(firstWinning);
+		std::uint64_t plainTies = skillDifference == 0 ? plainAtLeast(0) - plainAtLeast(1) : 0;
+		std::uint64_t plainTotal = pair.plainAtLeast[0];
+
+		OpposedOdds odds{};
+		odds.pools = pair.pools;
+		odds.attackerWins = plainAttacker + pair.attackerCritWins + pair.defenderCritLosses;
+		odds.ties = plainTies;
+		odds.defenderWins = (plainTotal - plainAttacker - plainTies) + pair.defenderCritWins + pair.attackerCritLosses;
+		odds.critWins = pair.attackerCritWins + pair.defenderCritWins;
+		odds.critLosses = pair.attackerCritLosses + pair.defenderCritLosses;
+		return odds;
+	}
+
+	// Function: sampleSkillTotal
+	// Draws the kept total (skill level 0) of a skill roll with a tabulated net boons value from its alias
+	// table, using one random draw (plus the rare redraw of RngContext::uniform's rejection step).
+	int sampleSkillTotal(RngContext& rng, int netBoons);
+
+	// Function: sampleTargetRoll
+	// Draws the outcome of targetRoll without rolling individual dice: the result has the same distribution
+	// as Core::targetRoll with the default configuration, but roll.rolls is left empty. Net boons outside the
+	// tables fall back to rolling the dice.
+	TargetRollResult sampleTargetRoll(RngContext& rng, int skillLevel, int difficultyLevel,
+		int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES);
+
+	// Function: sampleOpposedRoll
+	// Draws the outcome of opposedRoll without rolling individual dice, one draw per contestant (attacker
+	// first). Both roll.rolls are left empty. Net boons outside the tables fall back to rolling the dice.
+	OpposedRollResult sampleOpposedRoll(RngContext& rng,
+		int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+		int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+		int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES);
+}//End of Namespace Core::OutcomeTables
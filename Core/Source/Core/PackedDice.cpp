@@ -0,0 +1,146 @@
+#include "PackedDice.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	// Function: multiply
+	// Full 128-bit product of two 64-bit values.
+	inline void multiply(std::uint64_t a, std::uint64_t b, std::uint64_t& high, std::uint64_t& low)
+	{
+#if defined(__SIZEOF_INT128__)
+		__extension__ using Product = unsigned __int128;
+		const Product product = static_cast<Product>(a) * b;
+		high = static_cast<std::uint64_t>(product >> 64);
+		low = static_cast<std::uint64_t>(product);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		low = _umul128(a, b, &high);
+#else
+		const std::uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+		const std::uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+		const std::uint64_t lowLow = aLow * bLow;
+		const std::uint64_t middle = aHigh * bLow + (lowLow >> 32);
+		const std::uint64_t middle2 = aLow * bHigh + (middle & 0xFFFFFFFF);
+		high = aHigh * bHigh + (middle >> 32) + (middle2 >> 32);
+		low = (middle2 << 32) | (lowLow & 0xFFFFFFFF);
+#endif
+	}
+}
+
+//PackedDice.cpp
+namespace Core
+{
+	// Function: dicePerWord
+	// Powers of two split the word into bit fields with nothing to reject. Other ranges try every k with
+	// range^k <= 2^64 and keep the one with the most dice per drawn word, k * (1 - (2^64 mod range^k) / 2^64).
+	unsigned PackedDice::dicePerWord(std::uint64_t range)
+	{
+		if (range <= 1)
+		{
+			return MAX_DICE_PER_WORD;
+		}
+		if (std::has_single_bit(range))
+		{
+			return std::min<unsigned>(64 / static_cast<unsigned>(std::countr_zero(range)), MAX_DICE_PER_WORD);
+		}
+
+		unsigned best = 1;
+		double bestRate = 0.0;
+		std::uint64_t power = 1;
+		for (unsigned k = 1; power <= UINT64_MAX / range; ++k)
+		{
+			power *= range;
+			const double rejected = static_cast<double>((0 - power) % power) / 18446744073709551616.0;
+			const double rate = k * (1.0 - rejected);
+			if (rate > bestRate)
+			{
+				best = k;
+				bestRate = rate;
+			}
+		}
+		return best;
+	}//End of dicePerWord
+
+	// Function: configure
+	// Switches to a new range, dropping the dice buffered for the old one.
+	void PackedDice::configure(int minValue, int maxValue)
+	{
+		m_minValue = minValue;
+		m_maxValue = maxValue;
+		m_range = static_cast<std::uint64_t>(static_cast<std::int64_t>(maxValue) - minValue) + 1;
+		m_dicePerWord = dicePerWord(m_range);
+
+		// range^k wraps to 0 only when it is exactly 2^64, a power of two that needs no rejection
+		std::uint64_t power = 1;
+		for (unsigned i = 0; i < m_dicePerWord; ++i)
+		{
+			power *= m_range;
+		}
+		m_rejectBelow = power == 0 or m_range <= 1 ? 0 : (0 - power) % power;
+		discard();
+	}//End of configure
+
+	// Function: extractWord
+	// Writes the next accepted word's m_dicePerWord die offsets to `offsets`, drawing words until one passes
+	// the rejection test.
+	template <typename Offset>
+	void PackedDice::extractWord(Offset* offsets, std::int64_t base)
+	{
+		if (m_range <= 1)
+		{
+			std::fill(offsets, offsets + m_dicePerWord, static_cast<Offset>(base)); // A one-faced die needs no entropy
+			return;
+		}
+
+		std::uint64_t word;
+		do
+		{
+			word = m_rng.next64();
+			++m_wordsDrawn;
+			for (unsigned i = 0; i < m_dicePerWord; ++i)
+			{
+				std::uint64_t die;
+				multiply(word, m_range, die, word);
+				offsets[i] = static_cast<Offset>(base + static_cast<std::int64_t>(die));
+			}
+		} while (word < m_rejectBelow);
+	}//End of extractWord
+
+	// Function: refill
+	// Buffers the dice of the next accepted word.
+	void PackedDice::refill()
+	{
+		extractWord(m_buffer.data(), 0);
+		m_next = 0;
+		m_count = m_dicePerWord;
+	}//End of refill
+
+	// Function: fill
+	// Drains the buffer, then extracts whole words straight into `dice` and buffers the last partial one.
+	void PackedDice::fill(std::span<int> dice, int minValue, int maxValue)
+	{
+		if (minValue != m_minValue or maxValue != m_maxValue)
+		{
+			configure(minValue, maxValue);
+		}
+		std::size_t written = 0;
+		while (written < dice.size() and m_next < m_count)
+		{
+			dice[written++] = static_cast<int>(static_cast<std::int64_t>(m_minValue) + m_buffer[m_next++]);
+		}
+		while (dice.size() - written >= m_dicePerWord)
+		{
+			extractWord(dice.data() + written, m_minValue);
+			written += m_dicePerWord;
+		}
+		while (written < dice.size())
+		{
+			dice[written++] = roll(minValue, maxValue);
+		}
+	}//End of fill
+}//End of Namespace Core
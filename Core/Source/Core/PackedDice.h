@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "Rng.h"
+
+//PackedDice.h
+namespace Core
+{
+	// Class: PackedDice
+	// Dice source that extracts several dice from each 64-bit word of an RngContext, where RngContext::uniform
+	// spends a whole 32-bit word on every die.
+	//
+	// A refill draws one 64-bit word u and chains k multiplications by the die's range r: each step's high
+	// half is a die and its low half feeds the next step. This is Lemire's multiply-shift reduction to the
+	// range r^k, with the k base-r digits of the result read off as they are produced, so one rejection test
+	// against 2^64 mod r^k per word keeps every die exactly uniform and independent. k is chosen per range
+	// to maximize the accepted dice per word: 22.6 d6 on average (k = 23, 1.5% rejected), 16 d16, 13.7 d20.
+	//
+	// Dice left over from a word are kept for the next call with the same range. A different range discards
+	// them. Results therefore depend on the order and ranges of the calls, not just on the RngContext
+	// position, so rolls made through a PackedDice cannot be replayed by seeking (see Journal.h).
+	//
+	// Example:
+	//   Core::PackedDice dice(Core::RngContext(seed));
+	//   Core::SkillRollResult roll = Core::skillRoll(dice, skillLevel, boons, banes);
+	class PackedDice
+	{
+	public:
+		explicit PackedDice(const RngContext& rng) : m_rng(rng) {}
+
+		// Function: rng
+		// The context the words are drawn from. Drawing from it directly does not disturb buffered dice.
+		RngContext& rng() { return m_rng; }
+
+		// Function: roll
+		// Returns one unbiased die in [minValue, maxValue]. Requires minValue <= maxValue.
+		int roll(int minValue, int maxValue)
+		{
+			if (minValue != m_minValue or maxValue != m_maxValue)
+			{
+				configure(minValue, maxValue);
+			}
+			if (m_next == m_count)
+			{
+				refill();
+			}
+			return static_cast<int>(static_cast<std::int64_t>(m_minValue) + m_buffer[m_next++]);
+		}
+
+		// Function: fill
+		// Fills `dice` with unbiased dice in [minValue, maxValue], as repeated roll() calls would.
+		void fill(std::span<int> dice, int minValue, int maxValue);
+
+		// Function: discard
+		// Drops the buffered dice, so the next roll starts from a fresh word.
+		void discard() { m_next = m_count = 0; }
+
+		// Function: wordsDrawn
+		// 64-bit words drawn from rng() by this source, including rejected ones.
+		std::uint64_t wordsDrawn() const { return m_wordsDrawn; }
+
+		// Function: dicePerWord
+		// Dice extracted from each accepted word for a range, as configure() chooses it.
+		static unsigned dicePerWord(std::uint64_t range);
+
+	private:
+		static constexpr unsigned MAX_DICE_PER_WORD = 64;
+
+		void configure(int minValue, int maxValue);
+		void refill();
+		template <typename Offset>
+		void extractWord(Offset* offsets, std::int64_t base);
+
+		RngContext m_rng;
+		int m_minValue = 0;
+		int m_maxValue = -1;              // Not configured yet
+		std::uint64_t m_range = 0;        // Faces per die
+		unsigned m_dicePerWord = 0;       // k
+		std::uint64_t m_rejectBelow = 0;  // 2^64 mod range^k: final low halves below it are rejected
+		std::array<std::uint32_t, MAX_DICE_PER_WORD> m_buffer{}; // Die offsets from m_minValue
+		unsigned m_next = 0;              // Next unused die in m_buffer
+		unsigned m_count = 0;             // Dice in m_buffer
+		std::uint64_t m_wordsDrawn = 0;
+	};
+}//End of Namespace Core
@@ -0,0 +1,24 @@
+#include "Rng.h"
+
+#include <random>
+
+//Rng.cpp
+namespace Core
+{
+	// Function: fromEntropy
+	// Creates a context seeded from std::random_device.
+	RngContext RngContext::fromEntropy()
+	{
+		std::random_device rd;
+		std::uint64_t seed = (std::uint64_t{ rd() } << 32) | rd();
+		return RngContext(seed);
+	}//End of fromEntropy
+
+	// Function: defaultRngContext
+	// Returns the calling thread's context.
+	RngContext& defaultRngContext()
+	{
+		thread_local RngContext context = RngContext::fromEntropy();
+		return context;
+	}//End of defaultRngContext
+}//End of Namespace Core
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+//Rng.h
+namespace Core
+{
+	// Class: Philox4x32
+	// Counter-based random number generator (Philox4x32-10, Salmon et al., "Parallel Random Numbers:
+	// As Easy as 1, 2, 3", SC 2011). Each 128-bit output block is a pure function of a 64-bit key and a
+	// 128-bit counter, so any block of any stream can be computed without generating the ones before it.
+	class Philox4x32
+	{
+	public:
+		using Block = std::array<std::uint32_t, 4>;
+		using Key = std::array<std::uint32_t, 2>;
+
+		// Function: generate
+		// Computes the output block for the given counter and key.
+		static constexpr Block generate(Block counter, Key key)
+		{
+			for (int round = 0; round < ROUNDS; ++round)
+			{
+				std::uint64_t product0 = std::uint64_t{ MULTIPLIER_0 } * counter[0];
+				std::uint64_t product1 = std::uint64_t{ MULTIPLIER_1 } * counter[2];
+				counter = {
+					static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+					static_cast<std::uint32_t>(product1),
+					static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+					static_cast<std::uint32_t>(product0) };
+				key[0] += WEYL_0;
+				key[1] += WEYL_1;
+			}
+			return counter;
+		}
+
+	private:
+		static constexpr int ROUNDS = 10;
+		static constexpr std::uint32_t MULTIPLIER_0 = 0xD2511F53;
+		static constexpr std::uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+		static constexpr std::uint32_t WEYL_0 = 0x9E3779B9;
+		static constexpr std::uint32_t WEYL_1 = 0xBB67AE85;
+	};
+
+	// Class: RngContext
+	// Explicit random state accepted by every roll function.
+	// A context is identified by (seed, stream id) and advances one 32-bit word at a time. Contexts sharing
+	// a seed but with different stream ids produce independent sequences, so one master seed can hand out
+	// a stream per thread or per job; results depend only on the seed and stream ids, never on how the work
+	// was scheduled. A context must not be shared between threads without external synchronization.
+	//
+	// Satisfies the UniformRandomBitGenerator requirements, so it also works with <random> distributions.
+	class RngContext
+	{
+	public:
+		using result_type = std::uint32_t;
+
+		explicit RngContext(std::uint64_t seed, std::uint64_t streamId = 0)
+			: m_seed(seed), m_streamId(streamId)
+		{
+		}
+
+		// Function: fromEntropy
+		// Creates a context seeded from std::random_device, for callers that do not need reproducibility.
+		static RngContext fromEntropy();
+
+		// Function: stream
+		// Returns a fresh context on stream `streamId` of this context's seed.
+		RngContext stream(std::uint64_t streamId) const { return RngContext(m_seed, streamId); }
+
+		std::uint64_t seed() const { return m_seed; }
+		std::uint64_t streamId() const { return m_streamId; }
+
+		// Function: position
+		// Number of 32-bit words consumed from this stream so far.
+		std::uint64_t position() const { return m_block * WORDS_PER_BLOCK - (WORDS_PER_BLOCK - m_index); }
+
+		// Function: seek
+		// Moves the context to `position` words from the start of its stream.
+		void seek(std::uint64_t position)
+		{
+			m_block = position / WORDS_PER_BLOCK;
+			m_index = WORDS_PER_BLOCK;
+			if (position % WORDS_PER_BLOCK != 0)
+			{
+				refill();
+				m_index = static_cast<unsigned>(position % WORDS_PER_BLOCK);
+			}
+		}
+
+		// Function: next32
+		// Returns the next 32-bit word of the stream.
+		std::uint32_t next32()
+		{
+			if (m_index == WORDS_PER_BLOCK)
+			{
+				refill();
+			}
+			return m_buffer[m_index++];
+		}
+
+		// Function: next64
+		// Returns the next two words of the stream as one 64-bit value (first word in the high half).
+		std::uint64_t next64()
+		{
+			std::uint64_t high = next32();
+			return (high << 32) | next32();
+		}
+
+		// Function: fill
+		// Fills `words` with the next words of the stream, as repeated next32() calls would.
+		void fill(std::uint32_t* words, std::size_t count)
+		{
+			std::size_t written = 0;
+			while (written < count and m_index < WORDS_PER_BLOCK)
+			{
+				words[written++] = m_buffer[m_index++];
+			}
+			while (count - written >= WORDS_PER_BLOCK)
+			{
+				refill();
+				for (std::uint32_t word : m_buffer)
+				{
+					words[written++] = word;
+				}
+				m_index = WORDS_PER_BLOCK;
+			}
+			while (written < count)
+			{
+				words[written++] = next32();
+			}
+		}
+
+		// Function: uniform
+		// Returns an unbiased integer in [minValue, maxValue] using Lemire's multiply-shift method with
+		// rejection. Requires minValue <= maxValue.
+		int uniform(int minValue, int maxValue)
+		{
+			std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(maxValue) - minValue) + 1;
+			std::uint32_t word = next32();
+			if (range > std::numeric_limits<std::uint32_t>::max())
+			{
+				return static_cast<int>(static_cast<std::int64_t>(minValue) + word);
+			}
+
+			std::uint64_t product = word * range;
+			std::uint32_t low = static_cast<std::uint32_t>(product);
+			if (low < range)
+			{
+				std::uint32_t threshold = static_cast<std::uint32_t>((std::uint64_t{ 1 } << 32) % range);
+				while (low < threshold)
+				{
+					product = next32() * range;
+					low = static_cast<std::uint32_t>(product);
+				}
+			}
+			return minValue + static_cast<int>(product >> 32);
+		}
+
+		result_type operator()() { return next32(); }
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	private:
+		static constexpr unsigned WORDS_PER_BLOCK = 4;
+
+		void refill()
+		{
+			m_buffer = Philox4x32::generate(
+				{ static_cast<std::uint32_t>(m_block), static_cast<std::uint32_t>(m_block >> 32),
+				  static_cast<std::uint32_t>(m_streamId), static_cast<std::uint32_t>(m_streamId >> 32) },
+				{ static_cast<std::uint32_t>(m_seed), static_cast<std::uint32_t>(m_seed >> 32) });
+			++m_block;
+			m_index = 0;
+		}
+
+		std::uint64_t m_seed;                 // Master seed (Philox key)
+		std::uint64_t m_streamId;             // Stream id (high half of the Philox counter)
+		std::uint64_t m_block = 0;            // Index of the next block to generate
+		Philox4x32::Block m_buffer{};         // Current output block
+		unsigned m_index = WORDS_PER_BLOCK;   // Next unread word in m_buffer
+	};
+
+	// Function: defaultRngContext
+	// Returns the calling thread's context, used by roll functions called without an explicit one.
+	// Each thread's context is seeded from std::random_device on first use; reseed it by assignment,
+	// e.g. Core::defaultRngContext() = Core::RngContext(seed).
+	RngContext& defaultRngContext();
+}//End of Namespace Core
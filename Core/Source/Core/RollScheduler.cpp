@@ -0,0 +1,329 @@
+#include "RollScheduler.h"
+
+#include <array>
+#include <new>
+
+namespace
+{
+	using Core::CoroutineFramePool;
+
+	constexpr std::size_t SIZE_CLASSES = CoroutineFramePool::MAX_POOLED_BYTES / CoroutineFramePool::SIZE_CLASS_BYTES;
+
+	// Structure: FreeFrame
+	// Link stored in the first bytes of a frame while it sits in a free list.
+	struct FreeFrame
+	{
+		FreeFrame* next;
+	};
+
+	// Class: FrameCache
+	// One thread's free lists, returned to operator new when the thread exits.
+	class FrameCache
+	{
+	public:
+		~FrameCache()
+		{
+			for (FreeFrame*& head : m_heads)
+			{
+				while (head)
+				{
+					::operator delete(std::exchange(head, head->next));
+				}
+			}
+		}
+
+		FreeFrame*& head(std::size_t sizeClass) { return m_heads[sizeClass]; }
+		std::uint64_t upstreamAllocations = 0;
+
+	private:
+		std::array<FreeFrame*, SIZE_CLASSES> m_heads{};
+	};
+
+	thread_local FrameCache frameCache;
+
+	std::size_t sizeClass(std::size_t bytes)
+	{
+		return (bytes - 1) / CoroutineFramePool::SIZE_CLASS_BYTES;
+	}
+
+	// Function: ensureFlags
+	// Grows a bool buffer (which std::vector<bool> cannot provide) to at least `count` entries.
+	void ensureFlags(std::unique_ptr<bool[]>& flags, std::size_t& capacity, std::size_t count)
+	{
+		if (capacity < count)
+		{
+			flags = std::make_unique<bool[]>(count);
+			capacity = count;
+		}
+	}
+}
+
+//RollScheduler.cpp
+namespace Core
+{
+	void* CoroutineFramePool::allocate(std::size_t bytes)
+	{
+		if (bytes == 0 or bytes > MAX_POOLED_BYTES)
+		{
+			return ::operator new(bytes);
+		}
+		FreeFrame*& head = frameCache.head(sizeClass(bytes));
+		if (head)
+		{
+			return std::exchange(head, head->next);
+		}
+		++frameCache.upstreamAllocations;
+		return ::operator new((sizeClass(bytes) + 1) * SIZE_CLASS_BYTES);
+	}
+
+	void CoroutineFramePool::deallocate(void* frame, std::size_t bytes) noexcept
+	{
+		if (bytes == 0 or bytes > MAX_POOLED_BYTES)
+		{
+			::operator delete(frame);
+			return;
+		}
+		FreeFrame*& head = frameCache.head(sizeClass(bytes));
+		head = ::new (frame) FreeFrame{ head };
+	}
+
+	std::uint64_t CoroutineFramePool::upstreamAllocations()
+	{
+		return frameCache.upstreamAllocations;
+	}
+
+	RollScheduler::RollScheduler(RngContext rng, RollSchedulerOptions options)
+		: m_rng(rng), m_options(options)
+	{
+	}
+
+	RollScheduler::~RollScheduler()
+	{
+		for (Slot& slot : m_slots)
+		{
+			if (slot.handle)
+			{
+				slot.handle.destroy();
+			}
+		}
+	}
+
+	void RollScheduler::spawn(RollTask task)
+	{
+		std::uint32_t slot;
+		if (m_freeSlots.empty())
+		{
+			slot = static_cast<std::uint32_t>(m_slots.size());
+			m_slots.emplace_back();
+		}
+		else
+		{
+			slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		m_slots[slot].handle = std::exchange(task.m_handle, nullptr);
+		m_slots[slot].handle.promise().slot = slot;
+		++m_live;
+	}
+
+	// Function: tick
+	// Gathers the requests in slot order, resolves them by kind, then resumes every waiting task.
+	std::size_t RollScheduler::tick()
+	{
+		m_skillRequests.clear();
+		m_opposedRequests.clear();
+		m_targetRequests.clear();
+		m_runnable.clear();
+		for (std::uint32_t slot = 0; slot < m_slots.size(); ++slot)
+		{
+			RollRequest* request = std::exchange(m_slots[slot].request, nullptr);
+			if (not m_slots[slot].handle)
+			{
+				continue;
+			}
+			m_runnable.push_back(slot);
+			if (not request)
+			{
+				continue;
+			}
+			switch (request->kind)
+			{
+			case RollKind::SKILL: m_skillRequests.push_back(static_cast<SkillRollRequest*>(request)); break;
+			case RollKind::OPPOSED: m_opposedRequests.push_back(static_cast<OpposedRollRequest*>(request)); break;
+			case RollKind::TARGET: m_targetRequests.push_back(static_cast<TargetRollRequest*>(request)); break;
+			}
+		}
+		resolveSkillRolls();
+		resolveOpposedRolls();
+		resolveTargetRolls();
+
+		if (m_options.pool != nullptr and m_options.pool->size() > 1)
+		{
+			m_options.pool->parallelFor(m_runnable.size(), [this](std::size_t index, unsigned)
+				{
+					m_slots[m_runnable[index]].handle.resume();
+				});
+		}
+		else
+		{
+			for (std::uint32_t slot : m_runnable)
+			{
+				m_slots[slot].handle.resume();
+			}
+		}
+
+		for (std::uint32_t slot : m_runnable)
+		{
+			if (m_slots[slot].handle.done())
+			{
+				m_slots[slot].handle.destroy();
+				m_slots[slot] = {};
+				m_freeSlots.push_back(slot);
+				--m_live;
+			}
+		}
+		return m_live;
+	}//End of tick
+
+	std::uint64_t RollScheduler::run()
+	{
+		std::uint64_t ticks = 0;
+		while (m_live > 0)
+		{
+			tick();
+			++ticks;
+		}
+		return ticks;
+	}
+
+	// Function: resolveSkillRolls
+	// One skillRollBatch over the tick's skill requests, through column buffers reused across ticks.
+	void RollScheduler::resolveSkillRolls()
+	{
+		const std::size_t rows = m_skillRequests.size();
+		if (rows == 0)
+		{
+			return;
+		}
+		m_inputs.resize(3 * rows);
+		m_outputs.resize(rows);
+		ensureFlags(m_flags, m_flagCapacity, 2 * rows);
+		int* skillLevels = m_inputs.data();
+		int* boons = skillLevels + rows;
+		int* banes = boons + rows;
+		for (std::size_t row = 0; row < rows; ++row)
+		{
+			skillLevels[row] = m_skillRequests[row]->skillLevel;
+			boons[row] = m_skillRequests[row]->boons;
+			banes[row] = m_skillRequests[row]->banes;
+		}
+
+		bool* critSuccess = m_flags.get();
+		bool* critFailure = critSuccess + rows;
+		skillRollBatch(m_rng, { { skillLevels, rows }, { boons, rows }, { banes, rows } },
+			{ { m_outputs.data(), rows }, { critSuccess, rows }, { critFailure, rows }, {} },
+			m_options.baseDiceCount, m_options.diceSides, m_options.minValue);
+
+		for (std::size_t row = 0; row < rows; ++row)
+		{
+			m_skillRequests[row]->result = { m_outputs[row], {}, critSuccess[row], critFailure[row] };
+		}
+		m_rollsResolved += rows;
+	}//End of resolveSkillRolls
+
+	void RollScheduler::resolveOpposedRolls()
+	{
+		const std::size_t rows = m_opposedRequests.size();
+		if (rows == 0)
+		{
+			return;
+		}
+		m_inputs.resize(6 * rows);
+		m_outputs.resize(3 * rows);
+		m_winners.resize(rows);
+		ensureFlags(m_flags, m_flagCapacity, 6 * rows);
+		int* attackerSkillLevels = m_inputs.data();
+		int* defenderSkillLevels = attackerSkillLevels + rows;
+		int* attackerBoons = defenderSkillLevels + rows;
+		int* attackerBanes = attackerBoons + rows;
+		int* defenderBoons = attackerBanes + rows;
+		int* defenderBanes = defenderBoons + rows;
+		for (std::size_t row = 0; row < rows; ++row)
+		{
+			const OpposedRollRequest& request = *m_opposedRequests[row];
+			attackerSkillLevels[row] = request.attackerSkillLevel;
+			defenderSkillLevels[row] = request.defenderSkillLevel;
+			attackerBoons[row] = request.attackerBoons;
+			attackerBanes[row] = request.attackerBanes;
+			defenderBoons[row] = request.defenderBoons;
+			defenderBanes[row] = request.defenderBanes;
+		}
+
+		int* degrees = m_outputs.data();
+		int* attackerTotals = degrees + rows;
+		int* defenderTotals = attackerTotals + rows;
+		bool* critWins = m_flags.get();
+		bool* critLosses = critWins + rows;
+		bool* attackerCritSuccess = critLosses + rows;
+		bool* attackerCritFailure = attackerCritSuccess + rows;
+		bool* defenderCritSuccess = attackerCritFailure + rows;
+		bool* defenderCritFailure = defenderCritSuccess + rows;
+		opposedRollBatch(m_rng,
+			{ { attackerSkillLevels, rows }, { defenderSkillLevels, rows }, { attackerBoons, rows }, { attackerBanes, rows },
+			  { defenderBoons, rows }, { defenderBanes, rows } },
+			{ { m_winners.data(), rows }, { degrees, rows }, { critWins, rows }, { critLosses, rows },
+			  { { attackerTotals, rows }, { attackerCritSuccess, rows }, { attackerCritFailure, rows }, {} },
+			  { { defenderTotals, rows }, { defenderCritSuccess, rows }, { defenderCritFailure, rows }, {} } },
+			m_options.baseDiceCount, m_options.diceSides, m_options.minValue);
+
+		for (std::size_t row = 0; row < rows; ++row)
+		{
+			m_opposedRequests[row]->result = { m_winners[row], degrees[row],
+				{ attackerTotals[row], {}, attackerCritSuccess[row], attackerCritFailure[row] },
+				{ defenderTotals[row], {}, defenderCritSuccess[row], defenderCritFailure[row] },
+				critWins[row], critLosses[row] };
+		}
+		m_rollsResolved += rows;
+	}//End of resolveOpposedRolls
+
+	void RollScheduler::resolveTargetRolls()
+	{
+		const std::size_t rows = m_targetRequests.size();
+		if (rows == 0)
+		{
+			return;
+		}
+		m_inputs.resize(4 * rows);
+		m_outputs.resize(2 * rows);
+		ensureFlags(m_flags, m_flagCapacity, 3 * rows);
+		int* skillLevels = m_inputs.data();
+		int* difficultyLevels = skillLevels + rows;
+		int* boons = difficultyLevels + rows;
+		int* banes = boons + rows;
+		for (std::size_t row = 0; row < rows; ++row)
+		{
+			const TargetRollRequest& request = *m_targetRequests[row];
+			skillLevels[row] = request.skillLevel;
+			difficultyLevels[row] = request.difficultyLevel;
+			boons[row] = request.boons;
+			banes[row] = request.banes;
+		}
+
+		int* degrees = m_outputs.data();
+		int* totals = degrees + rows;
+		bool* successes = m_flags.get();
+		bool* critSuccess = successes + rows;
+		bool* critFailure = critSuccess + rows;
+		targetRollBatch(m_rng,
+			{ { skillLevels, rows }, { difficultyLevels, rows }, { boons, rows }, { banes, rows } },
+			{ { successes, rows }, { degrees, rows }, { { totals, rows }, { critSuccess, rows }, { critFailure, rows }, {} } },
+			m_options.baseDiceCount, m_options.diceSides, m_options.minValue);
+
+		for (std::size_t row = 0; row < rows; ++row)
+		{
+			m_targetRequests[row]->result = { successes[row], degrees[row],
+				{ totals[row], {}, critSuccess[row], critFailure[row] }, critSuccess[row], critFailure[row] };
+		}
+		m_rollsResolved += rows;
+	}//End of resolveTargetRolls
+}//End of Namespace Core
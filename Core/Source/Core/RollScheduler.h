@@ -0,0 +1,266 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Core.h"
+#include "ThreadPool.h"
+
+//RollScheduler.h
+// Coroutine layer over the batch roll paths, for game logic written as many small sequential scripts.
+//
+// A script is a coroutine returning RollTask that co_awaits the scheduler's roll operations:
+//   Core::RollTask duel(Core::RollScheduler& scheduler, Entity& entity)
+//   {
+//       Core::SkillRollResult roll = co_await scheduler.skillRoll(entity.skill, entity.boons);
+//       ...
+//   }
+//   scheduler.spawn(duel(scheduler, entity));
+//   scheduler.run();
+// Each tick the scheduler resolves every roll the suspended scripts asked for with one batch call per kind
+// of roll, then resumes the scripts with their results. A script awaits one roll per tick, so N scripts
+// cost one batch of N rolls per tick rather than N scalar calls.
+namespace Core
+{
+	// Class: CoroutineFramePool
+	// Recycles coroutine frames through per-thread free lists, one per 64-byte size class up to
+	// MAX_POOLED_BYTES; larger frames go straight to operator new. Once a workload has created as many
+	// tasks at once as it will, creating and destroying tasks no longer touches the heap.
+	class CoroutineFramePool
+	{
+	public:
+		static constexpr std::size_t SIZE_CLASS_BYTES = 64;
+		static constexpr std::size_t MAX_POOLED_BYTES = 4096;
+
+		static void* allocate(std::size_t bytes);
+		static void deallocate(void* frame, std::size_t bytes) noexcept;
+
+		// Function: upstreamAllocations
+		// Frames the calling thread has taken from operator new rather than its free lists.
+		static std::uint64_t upstreamAllocations();
+	};
+
+	// Class: RollTask
+	// Coroutine type of a script run by a RollScheduler. A task is created suspended and does nothing until
+	// RollScheduler::spawn takes it over. Scripts may only co_await the scheduler's roll operations (or
+	// std::suspend_always, which simply waits for the next tick), and must not throw.
+	class RollTask
+	{
+	public:
+		struct promise_type
+		{
+			RollTask get_return_object() { return RollTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+			void return_void() noexcept {}
+			void unhandled_exception() noexcept { std::terminate(); }
+
+			static void* operator new(std::size_t bytes) { return CoroutineFramePool::allocate(bytes); }
+			static void operator delete(void* frame, std::size_t bytes) noexcept { CoroutineFramePool::deallocate(frame, bytes); }
+
+			std::uint32_t slot = 0; // Index of the task in its scheduler
+		};
+
+		RollTask(RollTask&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+		RollTask& operator=(RollTask&& other) noexcept
+		{
+			if (this != &other)
+			{
+				if (m_handle) m_handle.destroy();
+				m_handle = std::exchange(other.m_handle, nullptr);
+			}
+			return *this;
+		}
+		~RollTask()
+		{
+			if (m_handle) m_handle.destroy();
+		}
+
+	private:
+		friend class RollScheduler;
+
+		explicit RollTask(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+		std::coroutine_handle<promise_type> m_handle;
+	};
+
+	// Enum: RollKind
+	// Kind of roll a suspended task is waiting for.
+	enum class RollKind : std::uint8_t
+	{
+		SKILL,
+		OPPOSED,
+		TARGET
+	};
+
+	// Structure: RollRequest
+	// Parameters and result of one awaited roll, kept in the awaiting coroutine's frame.
+	struct RollRequest
+	{
+		RollKind kind;
+	};
+
+	struct SkillRollRequest : RollRequest
+	{
+		int skillLevel;
+		int boons;
+		int banes;
+		SkillRollResult result;
+	};
+
+	struct OpposedRollRequest : RollRequest
+	{
+		int attackerSkillLevel;
+		int defenderSkillLevel;
+		int attackerBoons;
+		int attackerBanes;
+		int defenderBoons;
+		int defenderBanes;
+		OpposedRollResult result;
+	};
+
+	struct TargetRollRequest : RollRequest
+	{
+		int skillLevel;
+		int difficultyLevel;
+		int boons;
+		int banes;
+		TargetRollResult result;
+	};
+
+	class RollScheduler;
+
+	// Class: RollAwaiter
+	// Awaitable returned by the scheduler's roll operations. Suspending records a pointer to the request,
+	// which lives in the coroutine frame, so awaiting allocates nothing.
+	template <typename Request>
+	class RollAwaiter
+	{
+	public:
+		RollAwaiter(RollScheduler& scheduler, const Request& request) : m_scheduler(scheduler), m_request(request) {}
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<RollTask::promise_type> task) noexcept;
+		auto await_resume() noexcept { return std::move(m_request.result); }
+
+	private:
+		RollScheduler& m_scheduler;
+		Request m_request;
+	};
+
+	// Structure: RollSchedulerOptions
+	// Dice configuration of every roll a scheduler resolves, and where scripts are resumed.
+	struct RollSchedulerOptions
+	{
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT;
+		int diceSides = DEFAULT_DICE_SIDES;
+		int minValue = DEFAULT_MIN_VALUE;
+		ThreadPool* pool = nullptr; // Resume scripts across this pool, or on the calling thread if null
+	};
+
+	// Class: RollScheduler
+	// Runs RollTask scripts in ticks, resolving their awaited rolls in batches.
+	//
+	// Requests are gathered in task order and resolved on the scheduler's RngContext, so results depend only
+	// on the seed and the scripts, never on the pool or the order scripts happened to run in. With a pool,
+	// scripts of one tick run concurrently and must only touch state of their own. Awaited skill rolls (and
+	// the rolls inside opposed and target results) report totals and crit flags but no dice.
+	// Not thread-safe: spawn, tick and run are called from one thread, never from inside a script.
+	class RollScheduler
+	{
+	public:
+		explicit RollScheduler(RngContext rng, RollSchedulerOptions options = {});
+		~RollScheduler();
+
+		RollScheduler(const RollScheduler&) = delete;
+		RollScheduler& operator=(const RollScheduler&) = delete;
+
+		RollAwaiter<SkillRollRequest> skillRoll(int skillLevel = DEFAULT_SKILL_LEVEL,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return { *this, { { RollKind::SKILL }, skillLevel, boons, banes, {} } };
+		}
+
+		RollAwaiter<OpposedRollRequest> opposedRoll(
+			int attackerSkillLevel = DEFAULT_SKILL_LEVEL, int defenderSkillLevel = DEFAULT_SKILL_LEVEL,
+			int attackerBoons = DEFAULT_BOONS, int attackerBanes = DEFAULT_BANES,
+			int defenderBoons = DEFAULT_BOONS, int defenderBanes = DEFAULT_BANES)
+		{
+			return { *this, { { RollKind::OPPOSED }, attackerSkillLevel, defenderSkillLevel,
+				attackerBoons, attackerBanes, defenderBoons, defenderBanes, {} } };
+		}
+
+		RollAwaiter<TargetRollRequest> targetRoll(int skillLevel, int difficultyLevel,
+			int boons = DEFAULT_BOONS, int banes = DEFAULT_BANES)
+		{
+			return { *this, { { RollKind::TARGET }, skillLevel, difficultyLevel, boons, banes, {} } };
+		}
+
+		// Function: spawn
+		// Takes over a task; it starts running on the next tick.
+		void spawn(RollTask task);
+
+		// Function: tick
+		// Resolves every pending roll in one batch per kind, then resumes each waiting task until its next
+		// await or its end. Finished tasks are destroyed.
+		//
+		// Returns:
+		// - The number of tasks still alive.
+		std::size_t tick();
+
+		// Function: run
+		// Ticks until every task has finished.
+		//
+		// Returns:
+		// - The number of ticks taken.
+		std::uint64_t run();
+
+		std::size_t size() const { return m_live; }
+		std::uint64_t rollsResolved() const { return m_rollsResolved; }
+
+	private:
+		template <typename Request>
+		friend class RollAwaiter;
+
+		// Structure: Slot
+		// One task and the roll it waits for, if any.
+		struct Slot
+		{
+			std::coroutine_handle<RollTask::promise_type> handle;
+			RollRequest* request = nullptr;
+		};
+
+		void resolveSkillRolls();
+		void resolveOpposedRolls();
+		void resolveTargetRolls();
+
+		RngContext m_rng;
+		RollSchedulerOptions m_options;
+		std::vector<Slot> m_slots;
+		std::vector<std::uint32_t> m_freeSlots;
+		std::vector<std::uint32_t> m_runnable;
+		std::size_t m_live = 0;
+		std::uint64_t m_rollsResolved = 0;
+
+		// Requests of the current tick by kind, in task order, and the batch buffers they are resolved through
+		std::vector<SkillRollRequest*> m_skillRequests;
+		std::vector<OpposedRollRequest*> m_opposedRequests;
+		std::vector<TargetRollRequest*> m_targetRequests;
+		std::vector<int> m_inputs;
+		std::vector<int> m_outputs;
+		std::unique_ptr<bool[]> m_flags;
+		std::size_t m_flagCapacity = 0;
+		std::vector<Winner> m_winners;
+	};
+
+	template <typename Request>
+	void RollAwaiter<Request>::await_suspend(std::coroutine_handle<RollTask::promise_type> task) noexcept
+	{
+		m_scheduler.m_slots[task.promise().slot].request = &m_request;
+	}
+}//End of Namespace Core
@@ -0,0 +1,374 @@
+#include "Roster.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+	constexpr std::array<char, 8> ROSTER_MAGIC = { 'C', 'R', 'O', 'S', 'T', 'E', 'R', '\0' };
+	constexpr std::uint32_t ROSTER_VERSION = 1;
+	constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+	constexpr std::uint64_t COLUMN_ALIGNMENT = 64;
+
+	// Structure: FileHeader
+	// First 64 bytes of a roster file. Offsets are from the start of the file.
+	struct FileHeader
+	{
+		std::array<char, 8> magic;
+		std::uint32_t version;
+		std::uint32_t byteOrder;   // BYTE_ORDER_MARK as the writer stored it
+		std::uint64_t recordCount;
+		std::uint32_t skillCount;  // Directory entries following the header
+		std::uint32_t reserved;
+		std::uint64_t idsOffset;
+		std::uint64_t tagsOffset;
+		std::uint64_t boonsOffset;
+		std::uint64_t banesOffset;
+	};
+	static_assert(sizeof(FileHeader) == 64, "The roster header is one cache line");
+
+	// Structure: SkillEntry
+	// Directory entry of one skill column.
+	struct SkillEntry
+	{
+		std::array<char, Core::Roster::MAX_SKILL_NAME + 1> name; // NUL-terminated
+		std::uint64_t offset;
+	};
+	static_assert(sizeof(SkillEntry) == 32);
+
+	std::uint64_t alignColumn(std::uint64_t offset)
+	{
+		return (offset + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT;
+	}
+
+	// Function: validColumn
+	// True if a column of `bytes` bytes at `offset` is aligned and lies inside a file of `fileSize` bytes.
+	bool validColumn(std::uint64_t offset, std::uint64_t bytes, std::uint64_t fileSize)
+	{
+		return offset % COLUMN_ALIGNMENT == 0 and offset <= fileSize and bytes <= fileSize - offset;
+	}
+
+	// Function: writeColumn
+	// Pads the file to `offset`, then writes the column.
+	bool writeColumn(std::FILE* file, std::uint64_t& position, std::uint64_t offset, const void* data, std::size_t bytes)
+	{
+		static constexpr std::array<std::uint8_t, COLUMN_ALIGNMENT> PADDING{};
+		const std::size_t padding = static_cast<std::size_t>(offset - position);
+		position = offset + bytes;
+		return std::fwrite(PADDING.data(), 1, padding, file) == padding
+			and (bytes == 0 or std::fwrite(data, 1, bytes, file) == bytes);
+	}
+
+	// Structure: SweepScratch
+	// One worker's gathered parameters and results for a chunk, on its own cache lines.
+	struct alignas(64) SweepScratch
+	{
+		void reserve(std::size_t rows)
+		{
+			if (records.size() < rows)
+			{
+				records.resize(rows);
+				skillLevels.resize(rows);
+				difficultyLevels.resize(rows);
+				boons.resize(rows);
+				banes.resize(rows);
+				totals.resize(rows);
+				degrees.resize(rows);
+				successes = std::make_unique<bool[]>(rows);
+				critSuccess = std::make_unique<bool[]>(rows);
+				critFailure = std::make_unique<bool[]>(rows);
+			}
+		}
+
+		std::vector<std::size_t> records; // Roster index of each gathered row
+		std::vector<int> skillLevels;
+		std::vector<int> difficultyLevels;
+		std::vector<int> boons;
+		std::vector<int> banes;
+		std::vector<int> totals;
+		std::vector<int> degrees;
+		std::unique_ptr<bool[]> successes;
+		std::unique_ptr<bool[]> critSuccess;
+		std::unique_ptr<bool[]> critFailure;
+	};
+
+	// Function: fitsRoster
+	// True if an optional output span is empty or covers every record.
+	template <typename T>
+	bool fitsRoster(std::span<T> values, std::size_t records)
+	{
+		return values.empty() or values.size() >= records;
+	}
+
+	bool fitsRoster(const Core::SkillRollBatchOutput& output, std::size_t records)
+	{
+		return fitsRoster(output.totals, records) and fitsRoster(output.critSuccess, records)
+			and fitsRoster(output.critFailure, records) and output.dice.empty();
+	}
+
+	// Function: gatherChunk
+	// Copies the selected records of [begin, end) into the scratch rows and returns how many there are.
+	// The loop reads the columns front to back and keeps no branch on the filter, so it streams.
+	std::size_t gatherChunk(const Core::Roster& roster, const Core::RosterQuery& query, std::size_t begin, std::size_t end,
+		SweepScratch& scratch)
+	{
+		const std::uint32_t* tags = roster.tags().data();
+		const std::int8_t* levels = roster.skillLevels(static_cast<std::size_t>(query.skill)).data();
+		const std::int8_t* boons = roster.boons().data();
+		const std::int8_t* banes = roster.banes().data();
+
+		std::size_t rows = 0;
+		for (std::size_t record = begin; record < end; ++record)
+		{
+			scratch.records[rows] = record;
+			scratch.skillLevels[rows] = levels[record];
+			scratch.boons[rows] = boons[record] + query.boons;
+			scratch.banes[rows] = banes[record] + query.banes;
+			rows += (tags[record] & query.requiredTags) == query.requiredTags;
+		}
+		return rows;
+	}
+
+	// Function: runSweep
+	// Splits the roster into chunks across the pool; resolveChunk(rng, begin, end, scratch, stats) rolls one.
+	template <typename ResolveChunk>
+	void runSweep(const Core::Roster& roster, const Core::RosterSweepOptions& options, Core::Stats::RollStats& stats,
+		ResolveChunk&& resolveChunk)
+	{
+		Core::ThreadPool& pool = options.pool != nullptr ? *options.pool : Core::ThreadPool::shared();
+		const std::size_t chunkSize = std::max<std::uint32_t>(options.chunkSize, 1);
+		const std::size_t chunks = (roster.size() + chunkSize - 1) / chunkSize;
+
+		std::vector<SweepScratch> scratch(pool.size());
+		Core::Stats::ShardedStats shards(pool.size());
+		pool.parallelFor(chunks, [&](std::size_t chunk, unsigned worker)
+			{
+				const std::size_t begin = chunk * chunkSize;
+				const std::size_t end = std::min(begin + chunkSize, roster.size());
+				scratch[worker].reserve(chunkSize);
+				Core::RngContext rng(options.seed, chunk);
+				resolveChunk(rng, begin, end, scratch[worker], shards.shard(worker));
+			});
+		stats = shards.merged();
+	}
+}
+
+//Roster.cpp
+namespace Core
+{
+	// Function: writeRoster
+	// Lays the columns out after the header and directory, each on a 64-byte boundary.
+	bool writeRoster(const std::string& path, const RosterColumns& columns)
+	{
+		const std::size_t records = columns.ids.size();
+		if (columns.tags.size() != records or columns.boons.size() != records or columns.banes.size() != records
+			or columns.skillNames.size() != columns.skillLevels.size())
+		{
+			return false;
+		}
+		for (std::size_t skill = 0; skill < columns.skillNames.size(); ++skill)
+		{
+			const std::string& name = columns.skillNames[skill];
+			if (name.empty() or name.size() > Roster::MAX_SKILL_NAME or name.find('\0') != std::string::npos
+				or columns.skillLevels[skill].size() != records
+				or std::count(columns.skillNames.begin(), columns.skillNames.end(), name) != 1)
+			{
+				return false;
+			}
+		}
+
+		FileHeader header{};
+		header.magic = ROSTER_MAGIC;
+		header.version = ROSTER_VERSION;
+		header.byteOrder = BYTE_ORDER_MARK;
+		header.recordCount = records;
+		header.skillCount = static_cast<std::uint32_t>(columns.skillNames.size());
+		header.idsOffset = alignColumn(sizeof(FileHeader) + columns.skillNames.size() * sizeof(SkillEntry));
+		header.tagsOffset = alignColumn(header.idsOffset + records * sizeof(std::uint64_t));
+		header.boonsOffset = alignColumn(header.tagsOffset + records * sizeof(std::uint32_t));
+		header.banesOffset = alignColumn(header.boonsOffset + records);
+
+		std::vector<SkillEntry> directory(columns.skillNames.size());
+		std::uint64_t next = alignColumn(header.banesOffset + records);
+		for (std::size_t skill = 0; skill < directory.size(); ++skill)
+		{
+			directory[skill] = {};
+			std::memcpy(directory[skill].name.data(), columns.skillNames[skill].data(), columns.skillNames[skill].size());
+			directory[skill].offset = next;
+			next = alignColumn(next + records);
+		}
+
+		std::FILE* file = std::fopen(path.c_str(), "wb");
+		if (not file)
+		{
+			return false;
+		}
+		std::uint64_t position = 0;
+		bool ok = writeColumn(file, position, 0, &header, sizeof(header))
+			and writeColumn(file, position, position, directory.data(), directory.size() * sizeof(SkillEntry))
+			and writeColumn(file, position, header.idsOffset, columns.ids.data(), records * sizeof(std::uint64_t))
+			and writeColumn(file, position, header.tagsOffset, columns.tags.data(), records * sizeof(std::uint32_t))
+			and writeColumn(file, position, header.boonsOffset, columns.boons.data(), records)
+			and writeColumn(file, position, header.banesOffset, columns.banes.data(), records);
+		for (std::size_t skill = 0; ok and skill < directory.size(); ++skill)
+		{
+			ok = writeColumn(file, position, directory[skill].offset, columns.skillLevels[skill].data(), records);
+		}
+		return std::fclose(file) == 0 and ok;
+	}//End of writeRoster
+
+	// Function: open
+	// Checks the header and that every column lies inside the file; the records themselves are not read.
+	bool Roster::open(const std::string& path)
+	{
+		close();
+		if (not m_file.open(path))
+		{
+			return false;
+		}
+
+		const std::span<const std::uint8_t> bytes = m_file.bytes();
+		FileHeader header;
+		if (bytes.size() < sizeof(header))
+		{
+			close();
+			return false;
+		}
+		std::memcpy(&header, bytes.data(), sizeof(header));
+
+		const std::uint64_t fileSize = bytes.size();
+		const std::uint64_t records = header.recordCount;
+		const std::uint64_t directoryBytes = std::uint64_t{ header.skillCount } * sizeof(SkillEntry);
+		bool valid = header.magic == ROSTER_MAGIC and header.version == ROSTER_VERSION
+			and header.byteOrder == BYTE_ORDER_MARK and records <= fileSize
+			and directoryBytes <= fileSize - sizeof(header)
+			and validColumn(header.idsOffset, records * sizeof(std::uint64_t), fileSize)
+			and validColumn(header.tagsOffset, records * sizeof(std::uint32_t), fileSize)
+			and validColumn(header.boonsOffset, records, fileSize)
+			and validColumn(header.banesOffset, records, fileSize);
+
+		for (std::uint32_t skill = 0; valid and skill < header.skillCount; ++skill)
+		{
+			SkillEntry entry;
+			std::memcpy(&entry, bytes.data() + sizeof(header) + skill * sizeof(SkillEntry), sizeof(entry));
+			const char* name = reinterpret_cast<const char*>(bytes.data() + sizeof(header) + skill * sizeof(SkillEntry));
+			const std::size_t length = std::find(entry.name.begin(), entry.name.end(), '\0') - entry.name.begin();
+			valid = length > 0 and length <= MAX_SKILL_NAME and validColumn(entry.offset, records, fileSize);
+			if (valid)
+			{
+				m_skills.push_back({ std::string_view(name, length), reinterpret_cast<const std::int8_t*>(bytes.data() + entry.offset) });
+			}
+		}
+		if (not valid)
+		{
+			close();
+			return false;
+		}
+
+		m_size = static_cast<std::size_t>(records);
+		m_ids = reinterpret_cast<const std::uint64_t*>(bytes.data() + header.idsOffset);
+		m_tags = reinterpret_cast<const std::uint32_t*>(bytes.data() + header.tagsOffset);
+		m_boons = reinterpret_cast<const std::int8_t*>(bytes.data() + header.boonsOffset);
+		m_banes = reinterpret_cast<const std::int8_t*>(bytes.data() + header.banesOffset);
+		return true;
+	}//End of open
+
+	void Roster::close()
+	{
+		m_file.close();
+		m_size = 0;
+		m_ids = nullptr;
+		m_tags = nullptr;
+		m_boons = nullptr;
+		m_banes = nullptr;
+		m_skills.clear();
+	}
+
+	int Roster::findSkill(std::string_view name) const
+	{
+		for (std::size_t skill = 0; skill < m_skills.size(); ++skill)
+		{
+			if (m_skills[skill].name == name)
+			{
+				return static_cast<int>(skill);
+			}
+		}
+		return -1;
+	}
+
+	// Function: targetRollSweep
+	// Gathers each chunk's selected records, resolves them as one batch, then scatters and tallies.
+	bool targetRollSweep(const Roster& roster, const RosterQuery& query, int difficultyLevel, Stats::RollStats& stats,
+		const TargetRollBatchOutput& output, const RosterSweepOptions& options)
+	{
+		const std::size_t records = roster.size();
+		if (not roster.isOpen() or query.skill < 0 or static_cast<std::size_t>(query.skill) >= roster.skillCount()
+			or not fitsRoster(output.successes, records) or not fitsRoster(output.degrees, records)
+			or not fitsRoster(output.rolls, records))
+		{
+			return false;
+		}
+
+		runSweep(roster, options, stats, [&](RngContext& rng, std::size_t begin, std::size_t end, SweepScratch& scratch, Stats::RollStats& shard)
+			{
+				const std::size_t rows = gatherChunk(roster, query, begin, end, scratch);
+				std::fill_n(scratch.difficultyLevels.begin(), rows, difficultyLevel);
+				targetRollBatch(rng,
+					{ { scratch.skillLevels.data(), rows }, { scratch.difficultyLevels.data(), rows },
+					  { scratch.boons.data(), rows }, { scratch.banes.data(), rows } },
+					{ { scratch.successes.get(), rows }, { scratch.degrees.data(), rows },
+					  { { scratch.totals.data(), rows }, { scratch.critSuccess.get(), rows }, { scratch.critFailure.get(), rows }, {} } },
+					options.baseDiceCount, options.diceSides, options.minValue);
+
+				for (std::size_t row = 0; row < rows; ++row)
+				{
+					const std::size_t record = scratch.records[row];
+					if (not output.successes.empty()) output.successes[record] = scratch.successes[row];
+					if (not output.degrees.empty()) output.degrees[record] = scratch.degrees[row];
+					if (not output.rolls.totals.empty()) output.rolls.totals[record] = scratch.totals[row];
+					if (not output.rolls.critSuccess.empty()) output.rolls.critSuccess[record] = scratch.critSuccess[row];
+					if (not output.rolls.critFailure.empty()) output.rolls.critFailure[record] = scratch.critFailure[row];
+
+					const bool critSuccess = scratch.critSuccess[row];
+					const bool critFailure = scratch.critFailure[row];
+					shard.add(TargetRollResult{ scratch.successes[row], scratch.degrees[row],
+						{ scratch.totals[row], {}, critSuccess, critFailure }, critSuccess, critFailure });
+				}
+			});
+		return true;
+	}//End of targetRollSweep
+
+	bool skillRollSweep(const Roster& roster, const RosterQuery& query, Stats::RollStats& stats,
+		const SkillRollBatchOutput& output, const RosterSweepOptions& options)
+	{
+		const std::size_t records = roster.size();
+		if (not roster.isOpen() or query.skill < 0 or static_cast<std::size_t>(query.skill) >= roster.skillCount()
+			or not fitsRoster(output, records))
+		{
+			return false;
+		}
+
+		runSweep(roster, options, stats, [&](RngContext& rng, std::size_t begin, std::size_t end, SweepScratch& scratch, Stats::RollStats& shard)
+			{
+				const std::size_t rows = gatherChunk(roster, query, begin, end, scratch);
+				skillRollBatch(rng,
+					{ { scratch.skillLevels.data(), rows }, { scratch.boons.data(), rows }, { scratch.banes.data(), rows } },
+					{ { scratch.totals.data(), rows }, { scratch.critSuccess.get(), rows }, { scratch.critFailure.get(), rows }, {} },
+					options.baseDiceCount, options.diceSides, options.minValue);
+
+				for (std::size_t row = 0; row < rows; ++row)
+				{
+					const std::size_t record = scratch.records[row];
+					if (not output.totals.empty()) output.totals[record] = scratch.totals[row];
+					if (not output.critSuccess.empty()) output.critSuccess[record] = scratch.critSuccess[row];
+					if (not output.critFailure.empty()) output.critFailure[record] = scratch.critFailure[row];
+
+					shard.add(SkillRollResult{ scratch.totals[row], {}, scratch.critSuccess[row], scratch.critFailure[row] });
+				}
+			});
+		return true;
+	}//End of skillRollSweep
+}//End of Namespace Core
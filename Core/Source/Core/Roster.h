@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core.h"
+#include "MappedFile.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+
+//Roster.h
+// Columnar binary store of character records, read in place through a memory mapping.
+//
+// A roster file is a 64-byte header, a directory of named skill columns, and one column per field, each
+// starting on a 64-byte boundary:
+//   ids     std::uint64_t per record
+//   tags    std::uint32_t per record, a bit mask of roles or factions to filter on
+//   boons   std::int8_t per record, standing boons
+//   banes   std::int8_t per record, standing banes
+//   skills  std::int8_t per record for every skill column
+// Values are stored in the writer's byte order, which the header records; a file from a machine of the
+// other byte order is rejected. Opening checks the header and the column bounds only, so it costs the same
+// for ten records or ten million, and columns are paged in as sweeps touch them.
+namespace Core
+{
+	// Structure: RosterColumns
+	// Caller-owned columns to write as a roster. Every span must have the same length.
+	struct RosterColumns
+	{
+		std::span<const std::uint64_t> ids;
+		std::span<const std::uint32_t> tags;
+		std::span<const std::int8_t> boons;
+		std::span<const std::int8_t> banes;
+		std::vector<std::string> skillNames;                 // At most Roster::MAX_SKILL_NAME characters, unique
+		std::vector<std::span<const std::int8_t>> skillLevels; // One column per entry of skillNames
+	};
+
+	// Function: writeRoster
+	// Writes `columns` to `path` in the roster format, replacing any existing file.
+	//
+	// Returns:
+	// - True on success; false if the columns are inconsistent or the file cannot be written.
+	bool writeRoster(const std::string& path, const RosterColumns& columns);
+
+	// Class: Roster
+	// A roster file opened in place. Column spans point into the mapping and stay valid until the roster
+	// is closed, reopened or destroyed.
+	class Roster
+	{
+	public:
+		static constexpr std::size_t MAX_SKILL_NAME = 23;
+
+		// Function: open
+		// Maps a roster file, replacing any roster already open.
+		//
+		// Returns:
+		// - True if the file exists and is a well-formed roster of this machine's byte order.
+		bool open(const std::string& path);
+		void close();
+
+		bool isOpen() const { return m_file.isOpen(); }
+		std::size_t size() const { return m_size; }
+
+		std::span<const std::uint64_t> ids() const { return { m_ids, m_size }; }
+		std::span<const std::uint32_t> tags() const { return { m_tags, m_size }; }
+		std::span<const std::int8_t> boons() const { return { m_boons, m_size }; }
+		std::span<const std::int8_t> banes() const { return { m_banes, m_size }; }
+
+		std::size_t skillCount() const { return m_skills.size(); }
+		std::string_view skillName(std::size_t skill) const { return m_skills[skill].name; }
+		std::span<const std::int8_t> skillLevels(std::size_t skill) const { return { m_skills[skill].levels, m_size }; }
+
+		// Function: findSkill
+		// Index of the skill column called `name`, or -1 if there is none.
+		int findSkill(std::string_view name) const;
+
+	private:
+		struct SkillColumn
+		{
+			std::string_view name;
+			const std::int8_t* levels;
+		};
+
+		MappedFile m_file;
+		std::size_t m_size = 0;
+		const std::uint64_t* m_ids = nullptr;
+		const std::uint32_t* m_tags = nullptr;
+		const std::int8_t* m_boons = nullptr;
+		const std::int8_t* m_banes = nullptr;
+		std::vector<SkillColumn> m_skills;
+	};
+
+	// Structure: RosterQuery
+	// Which records a sweep rolls for, and with what. Each selected record rolls its level in `skill` with
+	// its standing boons and banes plus the query's.
+	struct RosterQuery
+	{
+		int skill = 0;                  // Skill column index (see Roster::findSkill)
+		std::uint32_t requiredTags = 0; // Only records whose tags include every one of these bits roll
+		int boons = 0;                  // Situational boons added to every record's standing boons
+		int banes = 0;                  // Situational banes added to every record's standing banes
+	};
+
+	// Structure: RosterSweepOptions
+	// Dice configuration, seeding and parallelism of a sweep.
+	struct RosterSweepOptions
+	{
+		std::uint64_t seed = 0;          // Chunk i rolls on stream i of this seed
+		std::uint32_t chunkSize = 4096;  // Records per chunk
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT;
+		int diceSides = DEFAULT_DICE_SIDES;
+		int minValue = DEFAULT_MIN_VALUE;
+		ThreadPool* pool = nullptr;      // Pool to run on, or ThreadPool::shared() if null
+	};
+
+	// Function: targetRollSweep
+	// Rolls targetRoll against `difficultyLevel` for every selected record of the roster.
+	//
+	// The roster is cut into chunks of chunkSize records, spread across the pool. A worker gathers a chunk's
+	// selected records from the columns into its own scratch rows, resolves them with one targetRollBatch
+	// call, then scatters the results and folds them into its own Stats shard. Every chunk rolls on its own
+	// stream, so results depend only on the roster, query and options, never on the thread count.
+	//
+	// Parameters:
+	// - output: Optional per-record results, indexed like the roster's columns; rows of unselected records
+	//   are left untouched. Non-empty spans must hold roster.size() entries; output.rolls.dice must be empty.
+	// - stats: Receives the merged outcome statistics of the selected records.
+	//
+	// Returns:
+	// - False if the roster is not open, the skill index is out of range or the output spans are mis-sized;
+	//   nothing is rolled then.
+	bool targetRollSweep(const Roster& roster, const RosterQuery& query, int difficultyLevel, Stats::RollStats& stats,
+		const TargetRollBatchOutput& output = {}, const RosterSweepOptions& options = {});
+
+	// Function: skillRollSweep
+	// Rolls skillRoll for every selected record of the roster, as targetRollSweep does.
+	bool skillRollSweep(const Roster& roster, const RosterQuery& query, Stats::RollStats& stats,
+		const SkillRollBatchOutput& output = {}, const RosterSweepOptions& options = {});
+}//End of Namespace Core
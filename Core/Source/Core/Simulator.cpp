@@ -0,0 +1,698 @@
+#include "Simulator.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+#include "DiceKernels.h"
+#include "Distribution.h"
+
+namespace
+{
+	// Function: addDegree
+	// Adds `count` trials with the given degree to a tally's histogram, growing it as needed.
+	void addDegree(Core::SimulationReport& tally, int degree, std::uint64_t count)
+	{
+		if (tally.degreeCounts.empty())
+		{
+			tally.minDegree = degree;
+		}
+		if (degree < tally.minDegree)
+		{
+			tally.degreeCounts.insert(tally.degreeCounts.begin(), tally.minDegree - degree, 0);
+			tally.minDegree = degree;
+		}
+		std::size_t index = static_cast<std::size_t>(degree - tally.minDegree);
+		if (index >= tally.degreeCounts.size())
+		{
+			tally.degreeCounts.resize(index + 1, 0);
+		}
+		tally.degreeCounts[index] += count;
+	}
+
+	// Function: record
+	// Adds one trial to a tally.
+	void record(Core::SimulationReport& tally, Core::Winner winner, int degree, bool critWin, bool critLoss)
+	{
+		++tally.trials;
+		tally.attackerWins += winner == Core::Winner::ATTACKER;
+		tally.defenderWins += winner == Core::Winner::DEFENDER;
+		tally.ties += winner == Core::Winner::TIE;
+		tally.critWins += critWin;
+		tally.critLosses += critLoss;
+		addDegree(tally, degree, 1);
+	}
+
+	// Function: merge
+	// Adds one tally into another and clears the source.
+	void merge(Core::SimulationReport& into, Core::SimulationReport& from)
+	{
+		into.trials += from.trials;
+		into.attackerWins += from.attackerWins;
+		into.defenderWins += from.defenderWins;
+		into.ties += from.ties;
+		into.critWins += from.critWins;
+		into.critLosses += from.critLosses;
+		for (std::size_t i = 0; i < from.degreeCounts.size(); ++i)
+		{
+			if (from.degreeCounts[i] != 0)
+			{
+				addDegree(into, from.minDegree + static_cast<int>(i), from.degreeCounts[i]);
+			}
+		}
+		from = {};
+	}
+
+	// Function: intervalsMet
+	// True once every outcome rate is known to within the requested interval width.
+	bool intervalsMet(const Core::SimulationReport& report, const Core::SimulationOptions& options)
+	{
+		for (std::uint64_t count : { report.attackerWins, report.defenderWins, report.ties, report.critWins, report.critLosses })
+		{
+			if (report.intervalWidth(count, options.confidenceZ) > options.targetIntervalWidth)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Structure: WorkerScratch
+	// Per-worker structure-of-arrays buffers for one work item of batched rolls.
+	struct WorkerScratch
+	{
+		std::vector<int> skillLevels, otherSkillLevels, boons, banes, otherBoons, otherBanes;
+		std::vector<Core::Winner> winners;
+		std::vector<int> degrees;
+		std::unique_ptr<bool[]> critWins, critLosses, successes; // std::vector<bool> cannot back a std::span<bool>
+	};
+
+	// Rates an estimate covers: ATTACKER, DEFENDER and TIE outcomes, then critWin and critLoss
+	constexpr std::size_t ESTIMATE_EVENTS = 5;
+
+	// Fewest trials a non-empty stratum gets, so that its variance can be measured
+	constexpr std::uint64_t MIN_STRATUM_TRIALS = 16;
+
+	// Crit patterns of one side's roll, mutually exclusive: a roll that is both (single-faced dice) is a
+	// critical success
+	enum CritPattern
+	{
+		CRIT_SUCCESS,
+		CRIT_FAILURE,
+		NEITHER,
+		CRIT_PATTERNS
+	};
+
+	// Structure: EstimatorSetup
+	// An opposed scenario with the pool sizes its trials roll.
+	struct EstimatorSetup
+	{
+		Core::OpposedScenario scenario;
+		bool valid;       // False for an invalid dice configuration: no dice are rolled, totals are the skill levels
+		int faces;        // Faces per die
+		int attackerPool; // Dice the attacker rolls
+		int defenderPool; // Dice the defender rolls
+	};
+
+	EstimatorSetup makeSetup(const Core::OpposedScenario& scenario)
+	{
+		const bool valid = scenario.baseDiceCount > 0 and scenario.diceSides > 0 and scenario.minValue <= scenario.diceSides;
+		if (not valid)
+		{
+			return { scenario, false, 1, 0, 0 };
+		}
+		return { scenario, true, scenario.diceSides - scenario.minValue + 1,
+			scenario.baseDiceCount + std::abs(scenario.attackerBoons - scenario.attackerBanes),
+			scenario.baseDiceCount + std::abs(scenario.defenderBoons - scenario.defenderBanes) };
+	}
+
+	// Function: summarizePool
+	// Selects and sums the kept dice of a rolled pool, as resolveSkillRoll in Core.cpp does.
+	Core::Kernels::KeptSummary summarizePool(const EstimatorSetup& setup, int* pool, int poolSize, int boons, int banes)
+	{
+		if (not setup.valid)
+		{
+			return { 0, false, false };
+		}
+		const Core::Kernels::KernelTable& kernels = Core::Kernels::activeKernelTable();
+		if (boons != banes)
+		{
+			kernels.selectKept(pool, poolSize, setup.scenario.baseDiceCount, boons > banes);
+		}
+		return kernels.summarizeKept(pool, setup.scenario.baseDiceCount, setup.scenario.diceSides, setup.scenario.minValue);
+	}
+
+	Core::OpposedOutcome decideTrial(const EstimatorSetup& setup,
+		const Core::Kernels::KeptSummary& attacker, const Core::Kernels::KeptSummary& defender)
+	{
+		const Core::OpposedScenario& scenario = setup.scenario;
+		return Core::decideOpposedOutcome(
+			scenario.attackerSkillLevel, scenario.attackerSkillLevel + attacker.total, attacker.critSuccess, attacker.critFailure,
+			scenario.defenderSkillLevel, scenario.defenderSkillLevel + defender.total, defender.critSuccess, defender.critFailure);
+	}
+
+	// Function: unitInterval
+	// Uniform double in [0, 1) from the top 53 bits of two words.
+	double unitInterval(Core::RngContext& rng)
+	{
+		return static_cast<double>(rng.next64() >> 11) * 0x1p-53;
+	}
+
+	// Structure: OutcomeSums
+	// Weighted sums of one work item's (or stratum's, or replicate's) trials, combined in a fixed order.
+	struct OutcomeSums
+	{
+		void add(const Core::OpposedOutcome& outcome, double weight)
+		{
+			const std::array<bool, ESTIMATE_EVENTS> events = { outcome.winner == Core::Winner::ATTACKER,
+				outcome.winner == Core::Winner::DEFENDER, outcome.winner == Core::Winner::TIE, outcome.critWin, outcome.critLoss };
+			++trials;
+			weights += weight;
+			weightSquares += weight * weight;
+			for (std::size_t event = 0; event < ESTIMATE_EVENTS; ++event)
+			{
+				if (events[event])
+				{
+					sums[event] += weight;
+					squares[event] += weight * weight;
+				}
+			}
+		}
+
+		void merge(const OutcomeSums& other)
+		{
+			trials += other.trials;
+			weights += other.weights;
+			weightSquares += other.weightSquares;
+			for (std::size_t event = 0; event < ESTIMATE_EVENTS; ++event)
+			{
+				sums[event] += other.sums[event];
+				squares[event] += other.squares[event];
+			}
+		}
+
+		std::uint64_t trials = 0;
+		double weights = 0.0;
+		double weightSquares = 0.0;
+		std::array<double, ESTIMATE_EVENTS> sums{};    // Sum of the weights of the trials with each outcome
+		std::array<double, ESTIMATE_EVENTS> squares{}; // Sum of their squared weights
+	};
+
+	// Function: varianceOfMean
+	// Sample variance of `count` values with the given sum and sum of squares, divided by count.
+	double varianceOfMean(double sum, double squares, std::uint64_t count)
+	{
+		if (count < 2)
+		{
+			return 0.0;
+		}
+		const double n = static_cast<double>(count);
+		return std::max(0.0, squares - sum * sum / n) / (n - 1.0) / n;
+	}
+
+	Core::Estimate makeEstimate(double value, double variance, std::uint64_t trials, double confidenceZ)
+	{
+		Core::Estimate estimate;
+		estimate.value = value;
+		estimate.standardError = std::sqrt(variance);
+		estimate.lower = std::clamp(value - confidenceZ * estimate.standardError, 0.0, 1.0);
+		estimate.upper = std::clamp(value + confidenceZ * estimate.standardError, 0.0, 1.0);
+
+		// A plain estimate of p from n trials has variance p(1 - p) / n
+		const double p = std::clamp(value, 0.0, 1.0);
+		estimate.effectiveSampleSize = variance > 0.0 ? p * (1.0 - p) / variance
+			: p > 0.0 and p < 1.0 ? std::numeric_limits<double>::infinity() : static_cast<double>(trials);
+		return estimate;
+	}
+
+	// Function: setEstimates
+	// Fills the report's five estimates from their values and variances.
+	void setEstimates(Core::EstimateReport& report, const std::array<double, ESTIMATE_EVENTS>& values,
+		const std::array<double, ESTIMATE_EVENTS>& variances, double confidenceZ)
+	{
+		Core::Estimate* estimates[ESTIMATE_EVENTS] = { &report.attackerWin, &report.defenderWin, &report.tie,
+			&report.critWin, &report.critLoss };
+		for (std::size_t event = 0; event < ESTIMATE_EVENTS; ++event)
+		{
+			*estimates[event] = makeEstimate(values[event], variances[event], report.trials, confidenceZ);
+		}
+	}
+
+	// Structure: EstimatorScratch
+	// One worker's dice pools, on its own cache lines.
+	struct alignas(64) EstimatorScratch
+	{
+		std::vector<int> attacker;
+		std::vector<int> defender;
+	};
+
+	// Function: runEstimatorItems
+	// Runs runItem(item, scratch, sums) for every work item across the pool, each into its own sums.
+	template <typename RunItem>
+	std::vector<OutcomeSums> runEstimatorItems(Core::ThreadPool& pool, const EstimatorSetup& setup, std::size_t items,
+		RunItem&& runItem)
+	{
+		std::vector<EstimatorScratch> scratch(pool.size());
+		for (EstimatorScratch& buffers : scratch)
+		{
+			buffers.attacker.resize(static_cast<std::size_t>(setup.attackerPool));
+			buffers.defender.resize(static_cast<std::size_t>(setup.defenderPool));
+		}
+		std::vector<OutcomeSums> sums(items);
+		pool.parallelFor(items, [&](std::size_t item, unsigned worker)
+			{
+				runItem(item, scratch[worker], sums[item]);
+			});
+		return sums;
+	}
+
+	// Function: estimateWeighted
+	// PLAIN and IMPORTANCE: independent trials, each weighted by the likelihood ratio of its dice.
+	//
+	// A tilted die is drawn from q = (1 - tilt) * uniform + tilt * (half on each extreme face). Tilting every
+	// die would inflate the weights of the side whose crit is not in play, so a trial is drawn from an equal
+	// mixture of three components: plain dice, the attacker's dice tilted, or the defender's dice tilted.
+	// With r the product of q / p over a side's dice, the weight p / q_mix is 3 / (1 + r_attacker + r_defender):
+	// never above 3, and tiny exactly where a side's rare extreme faces come up.
+	void estimateWeighted(Core::EstimateReport& report, const EstimatorSetup& setup, const Core::SimulationOptions& options,
+		Core::ThreadPool& pool, bool tilted)
+	{
+		const Core::OpposedScenario& scenario = setup.scenario;
+		const double tilt = tilted and setup.faces > 1 ? std::clamp(options.extremeTilt, 0.0, 0.99) : 0.0;
+		const double extremeRatio = (1.0 - tilt) + tilt * setup.faces / 2.0;
+		const double interiorRatio = 1.0 - tilt;
+
+		const std::uint64_t trialsPerItem = options.trialsPerItem;
+		const std::size_t items = static_cast<std::size_t>((options.maxTrials + trialsPerItem - 1) / trialsPerItem);
+		std::vector<OutcomeSums> sums = runEstimatorItems(pool, setup, items, [&](std::size_t item, EstimatorScratch& scratch, OutcomeSums& tally)
+			{
+				Core::RngContext rng(options.seed, item);
+				// Draws a side's dice, tilted or not, and returns the product of q / p over them
+				auto drawPool = [&](std::vector<int>& dice, bool tiltPool)
+					{
+						double ratio = 1.0;
+						for (int& die : dice)
+						{
+							if (tiltPool and unitInterval(rng) < tilt)
+							{
+								die = (rng.next32() & 1) ? scenario.diceSides : scenario.minValue;
+							}
+							else
+							{
+								die = rng.uniform(scenario.minValue, scenario.diceSides);
+							}
+							ratio *= die == scenario.minValue or die == scenario.diceSides ? extremeRatio : interiorRatio;
+						}
+						return ratio;
+					};
+
+				const std::uint64_t trials = std::min(trialsPerItem, options.maxTrials - item * trialsPerItem);
+				for (std::uint64_t trial = 0; trial < trials; ++trial)
+				{
+					const int component = tilt > 0.0 ? rng.uniform(0, 2) : 0;
+					const double attackerRatio = drawPool(scratch.attacker, component == 1);
+					const double defenderRatio = drawPool(scratch.defender, component == 2);
+					const double weight = tilt > 0.0 ? 3.0 / (1.0 + attackerRatio + defenderRatio) : 1.0;
+					tally.add(decideTrial(setup,
+						summarizePool(setup, scratch.attacker.data(), setup.attackerPool, scenario.attackerBoons, scenario.attackerBanes),
+						summarizePool(setup, scratch.defender.data(), setup.defenderPool, scenario.defenderBoons, scenario.defenderBanes)),
+						weight);
+				}
+			});
+
+		OutcomeSums total;
+		for (const OutcomeSums& item : sums)
+		{
+			total.merge(item);
+		}
+		report.trials = total.trials;
+		report.weightEffectiveSampleSize = total.weightSquares > 0.0 ? total.weights * total.weights / total.weightSquares : 0.0;
+
+		std::array<double, ESTIMATE_EVENTS> values{}, variances{};
+		for (std::size_t event = 0; event < ESTIMATE_EVENTS and total.trials > 0; ++event)
+		{
+			values[event] = total.sums[event] / total.trials;
+			variances[event] = varianceOfMean(total.sums[event], total.squares[event], total.trials);
+		}
+		setEstimates(report, values, variances, options.confidenceZ);
+	}//End of estimateWeighted
+
+	// Function: estimateStratified
+	// STRATIFIED: nine strata, one per pairing of crit patterns, each allotted trials in proportion to its
+	// exact probability (at least MIN_STRATUM_TRIALS) and combined as sum P_h * mean_h.
+	void estimateStratified(Core::EstimateReport& report, const EstimatorSetup& setup, const Core::SimulationOptions& options,
+		Core::ThreadPool& pool)
+	{
+		const Core::OpposedScenario& scenario = setup.scenario;
+		auto patternProbabilities = [&](int boons, int banes)
+			{
+				const Core::Distribution::SkillRollPmf& roll = Core::Distribution::skillRoll(boons, banes,
+					scenario.baseDiceCount, scenario.diceSides, scenario.minValue);
+				const double critFailure = setup.faces == 1 ? 0.0 : roll.critFailure;
+				return std::array<double, CRIT_PATTERNS>{ roll.critSuccess, critFailure,
+					std::max(0.0, 1.0 - roll.critSuccess - critFailure) };
+			};
+		const auto attackerPatterns = patternProbabilities(scenario.attackerBoons, scenario.attackerBanes);
+		const auto defenderPatterns = patternProbabilities(scenario.defenderBoons, scenario.defenderBanes);
+
+		// Work items never straddle strata; item i still rolls on stream i
+		struct StratumItem
+		{
+			std::size_t stratum;
+			std::uint64_t trials;
+		};
+		std::array<double, CRIT_PATTERNS * CRIT_PATTERNS> probabilities{};
+		std::vector<StratumItem> items;
+		for (std::size_t stratum = 0; stratum < probabilities.size(); ++stratum)
+		{
+			probabilities[stratum] = attackerPatterns[stratum / CRIT_PATTERNS] * defenderPatterns[stratum % CRIT_PATTERNS];
+			if (probabilities[stratum] <= 0.0)
+			{
+				continue;
+			}
+			std::uint64_t remaining = std::max<std::uint64_t>(MIN_STRATUM_TRIALS,
+				static_cast<std::uint64_t>(std::llround(probabilities[stratum] * static_cast<double>(options.maxTrials))));
+			while (remaining > 0)
+			{
+				const std::uint64_t trials = std::min<std::uint64_t>(remaining, options.trialsPerItem);
+				items.push_back({ stratum, trials });
+				remaining -= trials;
+			}
+		}
+
+		// Conditional draw of one side: crit patterns fix the kept dice, NEITHER rejects crit rolls
+		auto drawSide = [&](Core::RngContext& rng, CritPattern pattern, std::vector<int>& dice, int boons, int banes)
+			{
+				switch (pattern)
+				{
+				case CRIT_SUCCESS:
+					return Core::Kernels::KeptSummary{ scenario.baseDiceCount * scenario.diceSides, true, setup.faces == 1 };
+				case CRIT_FAILURE:
+					return Core::Kernels::KeptSummary{ scenario.baseDiceCount * scenario.minValue, false, true };
+				default:
+					for (;;)
+					{
+						for (int& die : dice)
+						{
+							die = rng.uniform(scenario.minValue, scenario.diceSides);
+						}
+						Core::Kernels::KeptSummary summary = summarizePool(setup, dice.data(), static_cast<int>(dice.size()), boons, banes);
+						if (not summary.critSuccess and not summary.critFailure)
+						{
+							return summary;
+						}
+					}
+				}
+			};
+
+		std::vector<OutcomeSums> sums = runEstimatorItems(pool, setup, items.size(), [&](std::size_t item, EstimatorScratch& scratch, OutcomeSums& tally)
+			{
+				Core::RngContext rng(options.seed, item);
+				const CritPattern attackerPattern = static_cast<CritPattern>(items[item].stratum / CRIT_PATTERNS);
+				const CritPattern defenderPattern = static_cast<CritPattern>(items[item].stratum % CRIT_PATTERNS);
+				for (std::uint64_t trial = 0; trial < items[item].trials; ++trial)
+				{
+					const Core::Kernels::KeptSummary attacker = drawSide(rng, attackerPattern, scratch.attacker, scenario.attackerBoons, scenario.attackerBanes);
+					const Core::Kernels::KeptSummary defender = drawSide(rng, defenderPattern, scratch.defender, scenario.defenderBoons, scenario.defenderBanes);
+					tally.add(decideTrial(setup, attacker, defender), 1.0);
+				}
+			});
+
+		std::array<OutcomeSums, CRIT_PATTERNS * CRIT_PATTERNS> strata;
+		for (std::size_t item = 0; item < items.size(); ++item)
+		{
+			strata[items[item].stratum].merge(sums[item]);
+		}
+
+		std::array<double, ESTIMATE_EVENTS> values{}, variances{};
+		double weightSquares = 0.0;
+		for (std::size_t stratum = 0; stratum < strata.size(); ++stratum)
+		{
+			const OutcomeSums& tally = strata[stratum];
+			if (tally.trials == 0)
+			{
+				continue;
+			}
+			const double probability = probabilities[stratum];
+			report.trials += tally.trials;
+			weightSquares += probability * probability / static_cast<double>(tally.trials);
+			for (std::size_t event = 0; event < ESTIMATE_EVENTS; ++event)
+			{
+				values[event] += probability * tally.sums[event] / static_cast<double>(tally.trials);
+				variances[event] += probability * probability * varianceOfMean(tally.sums[event], tally.squares[event], tally.trials);
+			}
+		}
+		// Each trial of stratum h stands for P_h / n_h of the probability mass
+		report.weightEffectiveSampleSize = weightSquares > 0.0 ? 1.0 / weightSquares : 0.0;
+		setEstimates(report, values, variances, options.confidenceZ);
+	}//End of estimateStratified
+
+	// Function: estimateQuasiRandom
+	// QUASI_RANDOM: point k of replicate r sets die j to the face of frac(shift_rj + k * alpha_j), where
+	// alpha_j = phi^-(j + 1) for the generalized golden ratio phi of the dimension (Roberts' R-sequence).
+	// Shifts are uniform per replicate, so each replicate mean is unbiased and their spread gives the error.
+	void estimateQuasiRandom(Core::EstimateReport& report, const EstimatorSetup& setup, const Core::SimulationOptions& options,
+		Core::ThreadPool& pool)
+	{
+		const Core::OpposedScenario& scenario = setup.scenario;
+		const std::size_t dimensions = static_cast<std::size_t>(setup.attackerPool + setup.defenderPool);
+
+		// phi is the positive root of x^(d + 1) = x + 1
+		double phi = 2.0;
+		for (int iteration = 0; iteration < 64; ++iteration)
+		{
+			phi = std::pow(1.0 + phi, 1.0 / (static_cast<double>(dimensions) + 1.0));
+		}
+		std::vector<double> alphas(dimensions);
+		for (std::size_t dimension = 0; dimension < dimensions; ++dimension)
+		{
+			alphas[dimension] = std::fmod(std::pow(1.0 / phi, static_cast<double>(dimension + 1)), 1.0);
+		}
+
+		const std::uint64_t replicates = std::max<std::uint32_t>(options.quasiRandomReplicates, 2);
+		const std::uint64_t pointsPerReplicate = std::max<std::uint64_t>(options.maxTrials / replicates, 1);
+		const std::uint64_t trialsPerItem = options.trialsPerItem;
+		const std::uint64_t itemsPerReplicate = (pointsPerReplicate + trialsPerItem - 1) / trialsPerItem;
+		std::vector<OutcomeSums> sums = runEstimatorItems(pool, setup, static_cast<std::size_t>(replicates * itemsPerReplicate),
+			[&](std::size_t item, EstimatorScratch& scratch, OutcomeSums& tally)
+			{
+				// Every item of a replicate draws the same shifts from the replicate's stream
+				Core::RngContext rng(options.seed, item / itemsPerReplicate);
+				std::vector<double> shifts(dimensions);
+				for (double& shift : shifts)
+				{
+					shift = unitInterval(rng);
+				}
+
+				const std::uint64_t firstPoint = (item % itemsPerReplicate) * trialsPerItem;
+				const std::uint64_t lastPoint = std::min(firstPoint + trialsPerItem, pointsPerReplicate);
+				for (std::uint64_t point = firstPoint; point < lastPoint; ++point)
+				{
+					for (std::size_t dimension = 0; dimension < dimensions; ++dimension)
+					{
+						const double u = std::fmod(shifts[dimension] + static_cast<double>(point + 1) * alphas[dimension], 1.0);
+						const int face = std::min(static_cast<int>(u * setup.faces), setup.faces - 1);
+						int& die = dimension < scratch.attacker.size() ? scratch.attacker[dimension] : scratch.defender[dimension - scratch.attacker.size()];
+						die = scenario.minValue + face;
+					}
+					tally.add(decideTrial(setup,
+						summarizePool(setup, scratch.attacker.data(), setup.attackerPool, scenario.attackerBoons, scenario.attackerBanes),
+						summarizePool(setup, scratch.defender.data(), setup.defenderPool, scenario.defenderBoons, scenario.defenderBanes)),
+						1.0);
+				}
+			});
+
+		// Spread of the replicate means
+		std::array<double, ESTIMATE_EVENTS> means{}, meanSquares{};
+		for (std::uint64_t replicate = 0; replicate < replicates; ++replicate)
+		{
+			OutcomeSums tally;
+			for (std::uint64_t item = 0; item < itemsPerReplicate; ++item)
+			{
+				tally.merge(sums[static_cast<std::size_t>(replicate * itemsPerReplicate + item)]);
+			}
+			report.trials += tally.trials;
+			for (std::size_t event = 0; event < ESTIMATE_EVENTS; ++event)
+			{
+				const double mean = tally.sums[event] / static_cast<double>(tally.trials);
+				means[event] += mean;
+				meanSquares[event] += mean * mean;
+			}
+		}
+
+		std::array<double, ESTIMATE_EVENTS> values{}, variances{};
+		for (std::size_t event = 0; event < ESTIMATE_EVENTS; ++event)
+		{
+			values[event] = means[event] / static_cast<double>(replicates);
+			variances[event] = varianceOfMean(means[event], meanSquares[event], replicates);
+		}
+		report.weightEffectiveSampleSize = static_cast<double>(report.trials);
+		setEstimates(report, values, variances, options.confidenceZ);
+	}//End of estimateQuasiRandom
+}
+
+//Simulator.cpp
+namespace Core
+{
+	Simulator::Simulator(SimulationOptions options, ThreadPool* pool)
+		: m_options(options), m_pool(pool ? *pool : ThreadPool::shared())
+	{
+		m_options.trialsPerItem = std::max<std::uint32_t>(m_options.trialsPerItem, 1);
+	}
+
+	// Function: run
+	// Simulates an opposedRoll scenario through opposedRollBatch.
+	SimulationReport Simulator::run(const OpposedScenario& scenario)
+	{
+		const std::size_t capacity = m_options.trialsPerItem;
+		std::vector<WorkerScratch> scratch(m_pool.size());
+		for (WorkerScratch& buffers : scratch)
+		{
+			buffers.skillLevels.assign(capacity, scenario.attackerSkillLevel);
+			buffers.otherSkillLevels.assign(capacity, scenario.defenderSkillLevel);
+			buffers.boons.assign(capacity, scenario.attackerBoons);
+			buffers.banes.assign(capacity, scenario.attackerBanes);
+			buffers.otherBoons.assign(capacity, scenario.defenderBoons);
+			buffers.otherBanes.assign(capacity, scenario.defenderBanes);
+			buffers.winners.resize(capacity);
+			buffers.degrees.resize(capacity);
+			buffers.critWins = std::make_unique<bool[]>(capacity);
+			buffers.critLosses = std::make_unique<bool[]>(capacity);
+		}
+
+		return runItems([&](RngContext& rng, std::uint32_t trials, unsigned worker, SimulationReport& tally)
+			{
+				WorkerScratch& buffers = scratch[worker];
+				opposedRollBatch(rng,
+					{ { buffers.skillLevels.data(), trials }, { buffers.otherSkillLevels.data(), trials },
+					  { buffers.boons.data(), trials }, { buffers.banes.data(), trials },
+					  { buffers.otherBoons.data(), trials }, { buffers.otherBanes.data(), trials } },
+					{ { buffers.winners.data(), trials }, { buffers.degrees.data(), trials },
+					  { buffers.critWins.get(), trials }, { buffers.critLosses.get(), trials }, {}, {} },
+					scenario.baseDiceCount, scenario.diceSides, scenario.minValue);
+
+				for (std::uint32_t i = 0; i < trials; ++i)
+				{
+					record(tally, buffers.winners[i], buffers.degrees[i], buffers.critWins[i], buffers.critLosses[i]);
+				}
+			});
+	}//End of run
+
+	// Function: run
+	// Simulates a targetRoll scenario through targetRollBatch.
+	SimulationReport Simulator::run(const TargetScenario& scenario)
+	{
+		const std::size_t capacity = m_options.trialsPerItem;
+		std::vector<WorkerScratch> scratch(m_pool.size());
+		for (WorkerScratch& buffers : scratch)
+		{
+			buffers.skillLevels.assign(capacity, scenario.skillLevel);
+			buffers.otherSkillLevels.assign(capacity, scenario.difficultyLevel);
+			buffers.boons.assign(capacity, scenario.boons);
+			buffers.banes.assign(capacity, scenario.banes);
+			buffers.degrees.resize(capacity);
+			buffers.successes = std::make_unique<bool[]>(capacity);
+			buffers.critWins = std::make_unique<bool[]>(capacity);
+			buffers.critLosses = std::make_unique<bool[]>(capacity);
+		}
+
+		return runItems([&](RngContext& rng, std::uint32_t trials, unsigned worker, SimulationReport& tally)
+			{
+				WorkerScratch& buffers = scratch[worker];
+				targetRollBatch(rng,
+					{ { buffers.skillLevels.data(), trials }, { buffers.otherSkillLevels.data(), trials },
+					  { buffers.boons.data(), trials }, { buffers.banes.data(), trials } },
+					{ { buffers.successes.get(), trials }, { buffers.degrees.data(), trials },
+					  { {}, { buffers.critWins.get(), trials }, { buffers.critLosses.get(), trials }, {} } },
+					scenario.baseDiceCount, scenario.diceSides, scenario.minValue);
+
+				for (std::uint32_t i = 0; i < trials; ++i)
+				{
+					record(tally, buffers.successes[i] ? Winner::ATTACKER : Winner::DEFENDER,
+						buffers.degrees[i], buffers.critWins[i], buffers.critLosses[i]);
+				}
+			});
+	}//End of run
+
+	// Function: run
+	// Simulates a custom scenario, one callback per trial.
+	SimulationReport Simulator::run(const CustomScenario& scenario)
+	{
+		return runItems([&](RngContext& rng, std::uint32_t trials, unsigned, SimulationReport& tally)
+			{
+				for (std::uint32_t i = 0; i < trials; ++i)
+				{
+					TrialOutcome outcome = scenario(rng);
+					record(tally, outcome.winner, outcome.degree, outcome.critWin, outcome.critLoss);
+				}
+			});
+	}//End of run
+
+	// Function: estimate
+	// Dispatches to the estimator of the requested mode.
+	EstimateReport Simulator::estimate(const OpposedScenario& scenario, EstimatorMode mode)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const EstimatorSetup setup = makeSetup(scenario);
+		EstimateReport report;
+		report.mode = mode;
+		switch (mode)
+		{
+		case EstimatorMode::PLAIN: estimateWeighted(report, setup, m_options, m_pool, false); break;
+		case EstimatorMode::IMPORTANCE: estimateWeighted(report, setup, m_options, m_pool, true); break;
+		case EstimatorMode::STRATIFIED: estimateStratified(report, setup, m_options, m_pool); break;
+		case EstimatorMode::QUASI_RANDOM: estimateQuasiRandom(report, setup, m_options, m_pool); break;
+		}
+		report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return report;
+	}//End of estimate
+
+	// Function: runItems
+	// Spreads work items across the pool in checkpointed rounds and merges the per-worker tallies.
+	SimulationReport Simulator::runItems(const ItemRunner& runItem)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const std::uint64_t trialsPerItem = m_options.trialsPerItem;
+		const std::uint64_t totalItems = (m_options.maxTrials + trialsPerItem - 1) / trialsPerItem;
+		const std::uint64_t itemsPerCheck = m_options.targetIntervalWidth > 0.0
+			? std::max<std::uint32_t>(m_options.itemsPerCheck, 1) : totalItems;
+
+		// One tally per worker, each on its own cache lines
+		struct alignas(64) WorkerTally
+		{
+			SimulationReport report;
+		};
+		std::vector<WorkerTally> tallies(m_pool.size());
+
+		SimulationReport report;
+		for (std::uint64_t firstItem = 0; firstItem < totalItems; firstItem += itemsPerCheck)
+		{
+			const std::uint64_t roundItems = std::min(itemsPerCheck, totalItems - firstItem);
+			m_pool.parallelFor(roundItems, [&](std::size_t index, unsigned worker)
+				{
+					std::uint64_t item = firstItem + index;
+					std::uint64_t trials = std::min(trialsPerItem, m_options.maxTrials - item * trialsPerItem);
+					RngContext rng(m_options.seed, item);
+					runItem(rng, static_cast<std::uint32_t>(trials), worker, tallies[worker].report);
+				});
+
+			for (WorkerTally& tally : tallies)
+			{
+				merge(report, tally.report);
+			}
+
+			if (m_options.targetIntervalWidth > 0.0 and intervalsMet(report, m_options))
+			{
+				report.stoppedEarly = firstItem + roundItems < totalItems;
+				break;
+			}
+		}
+
+		report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		report.trialsPerSecond = report.seconds > 0.0 ? report.trials / report.seconds : 0.0;
+		return report;
+	}//End of runItems
+}//End of Namespace Core
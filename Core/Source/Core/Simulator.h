@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Core.h"
+#include "ThreadPool.h"
+
+//Simulator.h
+namespace Core
+{
+	// Structure: OpposedScenario
+	// The parameters of one opposedRoll call, repeated for every trial.
+	struct OpposedScenario
+	{
+		int attackerSkillLevel = DEFAULT_SKILL_LEVEL;
+		int defenderSkillLevel = DEFAULT_SKILL_LEVEL;
+		int attackerBoons = DEFAULT_BOONS;
+		int attackerBanes = DEFAULT_BANES;
+		int defenderBoons = DEFAULT_BOONS;
+		int defenderBanes = DEFAULT_BANES;
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT;
+		int diceSides = DEFAULT_DICE_SIDES;
+		int minValue = DEFAULT_MIN_VALUE;
+	};
+
+	// Structure: TargetScenario
+	// The parameters of one targetRoll call, repeated for every trial.
+	struct TargetScenario
+	{
+		int skillLevel = DEFAULT_SKILL_LEVEL;
+		int difficultyLevel = 1;
+		int boons = DEFAULT_BOONS;
+		int banes = DEFAULT_BANES;
+		int baseDiceCount = DEFAULT_BASE_DICE_COUNT;
+		int diceSides = DEFAULT_DICE_SIDES;
+		int minValue = DEFAULT_MIN_VALUE;
+	};
+
+	// Structure: TrialOutcome
+	// What one trial of a custom scenario reports.
+	// Target-style scenarios report success as ATTACKER, failure as DEFENDER, and critSuccess/critFailure
+	// as critWin/critLoss, which is how TargetScenario trials are tallied too.
+	struct TrialOutcome
+	{
+		Winner winner; // Winner of the trial
+		int degree;    // Degree of the trial (may be negative for target rolls)
+		bool critWin;  // True if the trial was decided by a critical success
+		bool critLoss; // True if the trial was decided by a critical failure
+	};
+
+	// Custom scenario: resolves one trial using only the given context, so results stay reproducible.
+	using CustomScenario = std::function<TrialOutcome(RngContext& rng)>;
+
+	// Structure: SimulationOptions
+	// Controls how many trials run and how they are spread across threads.
+	struct SimulationOptions
+	{
+		std::uint64_t seed = 0;                    // Master seed; work item i rolls on stream i
+		std::uint64_t maxTrials = 1'000'000;       // Upper bound on the number of trials
+		std::uint32_t trialsPerItem = 4096;        // Trials per work item
+		std::uint32_t itemsPerCheck = 64;          // Work items between early-stopping checks
+		double targetIntervalWidth = 0.0;          // Stop once every outcome rate's confidence interval is this narrow (0 = never)
+		double confidenceZ = 1.96;                 // Normal quantile of the confidence level (1.96 = 95%)
+		double extremeTilt = 0.75;                 // EstimatorMode::IMPORTANCE: share of each die's draws moved to its extreme faces
+		std::uint32_t quasiRandomReplicates = 16;  // EstimatorMode::QUASI_RANDOM: independently shifted point sets
+	};
+
+	// Structure: SimulationReport
+	// Merged tallies of a simulation run.
+	struct SimulationReport
+	{
+		std::uint64_t trials = 0;               // Trials run
+		std::uint64_t attackerWins = 0;         // ATTACKER outcomes (successes for target scenarios)
+		std::uint64_t defenderWins = 0;         // DEFENDER outcomes (failures for target scenarios)
+		std::uint64_t ties = 0;                 // TIE outcomes
+		std::uint64_t critWins = 0;             // Trials decided by a critical success
+		std::uint64_t critLosses = 0;           // Trials decided by a critical failure
+		int minDegree = 0;                      // Degree of degreeCounts[0]
+		std::vector<std::uint64_t> degreeCounts; // degreeCounts[i] counts trials with degree minDegree + i
+		double seconds = 0.0;                   // Wall-clock time of the run
+		double trialsPerSecond = 0.0;           // Throughput of the run
+		bool stoppedEarly = false;              // True if targetIntervalWidth was reached before maxTrials
+
+		double rate(std::uint64_t count) const { return trials == 0 ? 0.0 : static_cast<double>(count) / trials; }
+		double attackerWinRate() const { return rate(attackerWins); }
+		double defenderWinRate() const { return rate(defenderWins); }
+		double tieRate() const { return rate(ties); }
+		double critWinRate() const { return rate(critWins); }
+		double critLossRate() const { return rate(critLosses); }
+
+		// Function: intervalWidth
+		// Width of the normal-approximation confidence interval of rate(count).
+		double intervalWidth(std::uint64_t count, double confidenceZ = 1.96) const
+		{
+			if (trials == 0)
+			{
+				return 1.0;
+			}
+			double p = rate(count);
+			return 2.0 * confidenceZ * std::sqrt(p * (1.0 - p) / trials);
+		}
+	};
+
+	// Enum: EstimatorMode
+	// How Simulator::estimate draws and weighs its trials.
+	enum class EstimatorMode
+	{
+		PLAIN,        // Independent trials of equal weight, as run() draws them
+		IMPORTANCE,   // Dice drawn with their extreme faces favoured, each trial weighted by its likelihood ratio
+		STRATIFIED,   // Trials allotted to each pairing of the two sides' crit patterns by its exact probability
+		QUASI_RANDOM  // Randomly shifted low-discrepancy points in place of random dice
+	};
+
+	// Structure: Estimate
+	// One estimated probability with its sampling error.
+	struct Estimate
+	{
+		double value = 0.0;               // Estimated probability
+		double standardError = 0.0;       // Standard error of value
+		double lower = 0.0;               // Confidence interval at SimulationOptions::confidenceZ, within [0, 1]
+		double upper = 0.0;
+		double effectiveSampleSize = 0.0; // Plain trials giving the same standard error; infinite if there is none
+	};
+
+	// Structure: EstimateReport
+	// Estimated outcome rates of an opposed scenario.
+	struct EstimateReport
+	{
+		EstimatorMode mode = EstimatorMode::PLAIN;
+		std::uint64_t trials = 0;               // Trials run
+		Estimate attackerWin;
+		Estimate defenderWin;
+		Estimate tie;
+		Estimate critWin;
+		Estimate critLoss;
+		double weightEffectiveSampleSize = 0.0; // Kish's (sum w)^2 / sum w^2 over the trial weights; trials for unweighted modes
+		double seconds = 0.0;                   // Wall-clock time of the run
+	};
+
+	// Class: Simulator
+	// Runs large numbers of opposedRoll/targetRoll trials, or trials of a custom scenario, across a thread pool.
+	//
+	// Trials are grouped into work items of trialsPerItem trials; item i always rolls on stream i of the
+	// master seed, and each worker tallies into its own slot, merged only at checkpoints. Early-stopping
+	// checks happen every itemsPerCheck items, so a report depends only on the options and the scenario,
+	// never on the thread count or scheduling.
+	class Simulator
+	{
+	public:
+		// Constructor: runs on `pool`, or on ThreadPool::shared() if none is given.
+		explicit Simulator(SimulationOptions options = {}, ThreadPool* pool = nullptr);
+
+		SimulationReport run(const OpposedScenario& scenario);
+		SimulationReport run(const TargetScenario& scenario);
+		SimulationReport run(const CustomScenario& scenario);
+
+		// Function: estimate
+		// Estimates the outcome rates of an opposed scenario with fewer trials than run() needs for rare
+		// outcomes, running up to maxTrials trials (early stopping does not apply).
+		//
+		// - IMPORTANCE tilts dice towards their lowest and highest faces, giving extremeTilt of each die's
+		//   mass to them, and weighs each trial by the ratio of the true to the drawn probability of its
+		//   dice. A trial tilts the attacker's dice, the defender's or neither, in equal shares, which bounds
+		//   every weight by 3. Rare crits come up often and their estimates sharpen by orders of magnitude
+		//   for large pools or dice; common outcomes lose a little precision, as their effective sample
+		//   sizes show.
+		// - STRATIFIED splits each side's roll into critical success, critical failure and neither, whose
+		//   exact probabilities Distribution provides, and samples each of the nine pairings conditionally.
+		//   Crit outcomes are settled by the pattern alone, so their estimates carry no sampling error.
+		// - QUASI_RANDOM maps the points of an additive recurrence over the generalized golden ratio to the
+		//   dice, one dimension per die, and randomizes it with quasiRandomReplicates independent shifts;
+		//   the error comes from the spread of the replicate means.
+		//
+		// Trials are split into work items of trialsPerItem on their own streams and combined in item order,
+		// so reports depend only on the options and the scenario, never on the thread count.
+		EstimateReport estimate(const OpposedScenario& scenario, EstimatorMode mode);
+
+		const SimulationOptions& options() const { return m_options; }
+
+	private:
+		// Resolves `trials` trials on `rng` and adds them to the worker's tally.
+		using ItemRunner = std::function<void(RngContext& rng, std::uint32_t trials, unsigned worker, SimulationReport& tally)>;
+		SimulationReport runItems(const ItemRunner& runItem);
+
+		SimulationOptions m_options;
+		ThreadPool& m_pool;
+	};
+}//End of Namespace Core
@@ -0,0 +1,367 @@
+#include "Stats.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "Varint.h"
+
+namespace
+{
+	using Core::Stats::Wide;
+
+	// Format tag and version of RollStats::serialize
+	constexpr std::array<std::uint8_t, 4> STATS_HEADER = { 'C', 'S', 'T', 1 };
+
+	// Function: multiply
+	// Full 128-bit product of two 64-bit values, from 32-bit halves.
+	Wide multiply(std::uint64_t a, std::uint64_t b)
+	{
+		constexpr std::uint64_t LOW_HALF = 0xFFFFFFFFu;
+		const std::uint64_t lowLow = (a & LOW_HALF) * (b & LOW_HALF);
+		const std::uint64_t lowHigh = (a & LOW_HALF) * (b >> 32);
+		const std::uint64_t highLow = (a >> 32) * (b & LOW_HALF);
+		const std::uint64_t highHigh = (a >> 32) * (b >> 32);
+		const std::uint64_t middle = (lowLow >> 32) + (lowHigh & LOW_HALF) + (highLow & LOW_HALF);
+		return { (lowLow & LOW_HALF) | (middle << 32), highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32) };
+	}
+
+	// Function: multiply
+	// 128-bit value times a 64-bit value, wrapping modulo 2^128.
+	Wide multiply(const Wide& a, std::uint64_t b)
+	{
+		Wide product = multiply(a.low, b);
+		product.high += a.high * b;
+		return product;
+	}
+
+	Wide negate(const Wide& value)
+	{
+		Wide negated{ ~value.low, ~value.high };
+		negated.add(1);
+		return negated;
+	}
+
+	double toDouble(const Wide& value)
+	{
+		return static_cast<double>(value.high) * 18446744073709551616.0 + static_cast<double>(value.low);
+	}
+
+	// Function: toSignedDouble
+	// Reads a two's complement 128-bit value.
+	double toSignedDouble(const Wide& value)
+	{
+		return value.high >> 63 ? -toDouble(negate(value)) : toDouble(value);
+	}
+
+	void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value)
+	{
+		std::array<std::uint8_t, Core::Varint::MAX_BYTES> buffer;
+		out.insert(out.end(), buffer.data(), Core::Varint::put(buffer.data(), value));
+	}
+
+	void putWide(std::vector<std::uint8_t>& out, const Wide& value)
+	{
+		putVarint(out, value.low);
+		putVarint(out, value.high);
+	}
+
+	void putHistogram(std::vector<std::uint8_t>& out, const Core::Stats::Histogram& histogram)
+	{
+		putVarint(out, histogram.counts().size());
+		if (not histogram.empty())
+		{
+			putVarint(out, Core::Varint::zigzag(histogram.minValue()));
+			for (std::uint64_t count : histogram.counts())
+			{
+				putVarint(out, count);
+			}
+		}
+	}
+
+	void putMoments(std::vector<std::uint8_t>& out, const Core::Stats::Moments& moments)
+	{
+		putVarint(out, moments.count());
+		putWide(out, moments.sum());
+		putWide(out, moments.sumSquares());
+	}
+
+	// Class: StatsReader
+	// Sequential reader over serialized RollStats. Every read fails once one has.
+	class StatsReader
+	{
+	public:
+		explicit StatsReader(std::span<const std::uint8_t> bytes) : m_bytes(bytes) {}
+
+		bool finished() const { return m_ok and m_offset == m_bytes.size(); }
+
+		bool header()
+		{
+			m_ok = m_bytes.size() >= STATS_HEADER.size() and std::equal(STATS_HEADER.begin(), STATS_HEADER.end(), m_bytes.begin());
+			m_offset = STATS_HEADER.size();
+			return m_ok;
+		}
+
+		bool varint(std::uint64_t& value)
+		{
+			m_ok = m_ok and Core::Varint::get(m_bytes, m_offset, value);
+			return m_ok;
+		}
+
+		bool wide(Wide& value)
+		{
+			return varint(value.low) and varint(value.high);
+		}
+
+		bool histogram(Core::Stats::Histogram& histogram)
+		{
+			std::uint64_t bins = 0;
+			if (not varint(bins))
+			{
+				return false;
+			}
+			if (bins == 0)
+			{
+				histogram = {};
+				return true;
+			}
+
+			// Each bin takes at least one byte, which bounds the allocation by the input size
+			std::uint64_t encodedMin = 0;
+			if (not varint(encodedMin) or bins > m_bytes.size() - m_offset)
+			{
+				return m_ok = false;
+			}
+			const std::int64_t minValue = Core::Varint::unzigzag(encodedMin);
+			if (minValue < INT_MIN or minValue + static_cast<std::int64_t>(bins) - 1 > INT_MAX)
+			{
+				return m_ok = false;
+			}
+
+			std::vector<std::uint64_t> counts(static_cast<std::size_t>(bins));
+			for (std::uint64_t& count : counts)
+			{
+				if (not varint(count))
+				{
+					return false;
+				}
+			}
+			histogram.restore(static_cast<int>(minValue), std::move(counts));
+			return true;
+		}
+
+		bool moments(Core::Stats::Moments& moments)
+		{
+			std::uint64_t count = 0;
+			Wide sum;
+			Wide sumSquares;
+			if (not varint(count) or not wide(sum) or not wide(sumSquares))
+			{
+				return false;
+			}
+			moments.restore(count, sum, sumSquares);
+			return true;
+		}
+
+	private:
+		std::span<const std::uint8_t> m_bytes;
+		std::size_t m_offset = 0;
+		bool m_ok = true;
+	};
+}
+
+//Stats.cpp
+namespace Core::Stats
+{
+	double Moments::mean() const
+	{
+		return m_count == 0 ? 0.0 : toSignedDouble(m_sum) / static_cast<double>(m_count);
+	}
+
+	// Function: variance
+	// With q the mean rounded to an integer, sum((x - q)^2) = sumSquares - 2q * sum + n * q^2 is a small
+	// non-negative integer that the 128-bit wrap-around arithmetic gets exactly, whatever the size of the
+	// intermediate terms. Moving from q to the true mean subtracts (sum - n * q)^2 / n, a term no larger than
+	// n / 4, so no significant digits cancel.
+	double Moments::variance() const
+	{
+		if (m_count < 2)
+		{
+			return 0.0;
+		}
+
+		const std::int64_t rounded = std::llround(mean());
+		const std::uint64_t magnitude = static_cast<std::uint64_t>(rounded < 0 ? -rounded : rounded);
+		Wide twiceRoundedSum = multiply(m_sum, 2 * magnitude);
+		if (rounded < 0)
+		{
+			twiceRoundedSum = negate(twiceRoundedSum);
+		}
+
+		Wide squaredDeviations = m_sumSquares;
+		squaredDeviations.add(negate(twiceRoundedSum));
+		squaredDeviations.add(multiply(m_count, magnitude * magnitude));
+
+		Wide offset = m_sum;
+		offset.add(negate(multiply(Wide{ static_cast<std::uint64_t>(rounded), rounded < 0 ? ~std::uint64_t{ 0 } : 0 }, m_count)));
+		const double shift = toSignedDouble(offset);
+
+		const double n = static_cast<double>(m_count);
+		return std::max(0.0, toDouble(squaredDeviations) - shift * shift / n) / (n - 1.0);
+	}//End of variance
+
+	double Moments::standardDeviation() const
+	{
+		return std::sqrt(variance());
+	}
+
+	void Histogram::merge(const Histogram& other)
+	{
+		if (other.empty())
+		{
+			return;
+		}
+		extend(other.m_minValue);
+		extend(other.maxValue());
+		const std::size_t offset = static_cast<std::size_t>(static_cast<std::int64_t>(other.m_minValue) - m_minValue);
+		for (std::size_t i = 0; i < other.m_counts.size(); ++i)
+		{
+			m_counts[offset + i] += other.m_counts[i];
+		}
+		m_total += other.m_total;
+	}
+
+	void Histogram::restore(int minValue, std::vector<std::uint64_t> counts)
+	{
+		m_minValue = counts.empty() ? 0 : minValue;
+		m_counts = std::move(counts);
+		m_total = 0;
+		for (std::uint64_t count : m_counts)
+		{
+			m_total += count;
+		}
+	}
+
+	// Function: extend
+	// Grows the bins to cover `value`, keeping the existing counts in place.
+	void Histogram::extend(int value)
+	{
+		if (m_counts.empty())
+		{
+			m_minValue = value;
+			m_counts.assign(1, 0);
+			return;
+		}
+		if (value < m_minValue)
+		{
+			m_counts.insert(m_counts.begin(), static_cast<std::size_t>(static_cast<std::int64_t>(m_minValue) - value), 0);
+			m_minValue = value;
+		}
+		else if (value > maxValue())
+		{
+			m_counts.resize(static_cast<std::size_t>(static_cast<std::int64_t>(value) - m_minValue + 1), 0);
+		}
+	}//End of extend
+
+	void RollStats::add(const SkillRollResult& roll)
+	{
+		++rolls;
+		critWins += roll.critSuccess;
+		critLosses += roll.critFailure;
+		totals.add(roll.total);
+		totalMoments.add(roll.total);
+	}
+
+	void RollStats::add(const TargetRollResult& roll)
+	{
+		addOutcome(roll.success ? Winner::ATTACKER : Winner::DEFENDER, roll.degree, roll.critSuccess, roll.critFailure);
+		totals.add(roll.roll.total);
+		totalMoments.add(roll.roll.total);
+	}
+
+	void RollStats::add(const OpposedRollResult& roll)
+	{
+		addOutcome(roll.winner, roll.degree, roll.critWin, roll.critLoss);
+		for (const SkillRollResult* contestant : { &roll.attackerRoll, &roll.defenderRoll })
+		{
+			totals.add(contestant->total);
+			totalMoments.add(contestant->total);
+		}
+	}
+
+	void RollStats::addOutcome(Winner winner, int degree, bool critWin, bool critLoss)
+	{
+		++rolls;
+		++winners[static_cast<std::size_t>(winner)];
+		critWins += critWin;
+		critLosses += critLoss;
+		degrees.add(degree);
+		degreeMoments.add(degree);
+	}
+
+	void RollStats::merge(const RollStats& other)
+	{
+		rolls += other.rolls;
+		for (std::size_t i = 0; i < winners.size(); ++i)
+		{
+			winners[i] += other.winners[i];
+		}
+		critWins += other.critWins;
+		critLosses += other.critLosses;
+		totals.merge(other.totals);
+		degrees.merge(other.degrees);
+		totalMoments.merge(other.totalMoments);
+		degreeMoments.merge(other.degreeMoments);
+	}
+
+	void RollStats::serialize(std::vector<std::uint8_t>& out) const
+	{
+		out.insert(out.end(), STATS_HEADER.begin(), STATS_HEADER.end());
+		putVarint(out, rolls);
+		for (std::uint64_t count : winners)
+		{
+			putVarint(out, count);
+		}
+		putVarint(out, critWins);
+		putVarint(out, critLosses);
+		putHistogram(out, totals);
+		putHistogram(out, degrees);
+		putMoments(out, totalMoments);
+		putMoments(out, degreeMoments);
+	}
+
+	bool RollStats::deserialize(std::span<const std::uint8_t> bytes, RollStats& stats)
+	{
+		StatsReader reader(bytes);
+		if (not reader.header() or not reader.varint(stats.rolls))
+		{
+			return false;
+		}
+		for (std::uint64_t& count : stats.winners)
+		{
+			reader.varint(count);
+		}
+		reader.varint(stats.critWins);
+		reader.varint(stats.critLosses);
+		reader.histogram(stats.totals);
+		reader.histogram(stats.degrees);
+		reader.moments(stats.totalMoments);
+		reader.moments(stats.degreeMoments);
+		return reader.finished();
+	}
+
+	ShardedStats::ShardedStats(unsigned shards)
+		: m_shards(std::max(shards, 1u))
+	{
+	}
+
+	RollStats ShardedStats::merged() const
+	{
+		RollStats total;
+		for (const Shard& shard : m_shards)
+		{
+			total.merge(shard.stats);
+		}
+		return total;
+	}
+}//End of Namespace Core::Stats
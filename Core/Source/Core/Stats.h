@@ -0,0 +1,236 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Core.h"
+
+//Stats.h
+// Mergeable accumulators for the results the roll functions produce, for simulations split across
+// threads, processes or machines.
+//
+// Every accumulator holds integers only: counts, exact histograms, and the count, sum and sum of squares of
+// its samples in 128-bit wrap-around arithmetic. Merging adds those integers, so it is exact, associative
+// and commutative; any reduction tree over the same shards gives identical accumulators and identical
+// serialized bytes. Means and variances are derived when asked for, from the exact sums (see Moments).
+//
+// Example, one shard per ThreadPool worker:
+//   Core::Stats::ShardedStats shards(pool.size());
+//   pool.parallelFor(count, [&](std::size_t index, unsigned worker) { shards.shard(worker).add(roll(index)); });
+//   std::vector<std::uint8_t> bytes;
+//   shards.merged().serialize(bytes); // a few hundred bytes, whatever the number of rolls
+namespace Core::Stats
+{
+	// Structure: Wide
+	// Unsigned 128-bit integer with wrap-around addition, portable to compilers without __int128.
+	struct Wide
+	{
+		std::uint64_t low = 0;
+		std::uint64_t high = 0;
+
+		void add(std::uint64_t value)
+		{
+			low += value;
+			high += low < value;
+		}
+
+		// Function: addSigned
+		// Adds a sign-extended value, so sums of negative samples stay exact in two's complement.
+		void addSigned(std::int64_t value)
+		{
+			add(static_cast<std::uint64_t>(value));
+			high += value < 0 ? ~std::uint64_t{ 0 } : 0;
+		}
+
+		void add(const Wide& other)
+		{
+			add(other.low);
+			high += other.high;
+		}
+
+		bool operator==(const Wide&) const = default;
+	};
+
+	// Class: Moments
+	// Count, mean and variance of integer samples.
+	//
+	// The sums are kept exactly, so the variance never suffers the cancellation of the textbook
+	// sum-of-squares formula, and merging is exact where Welford/Chan updates in floating point would
+	// depend on the order of the merges. Exact for up to 2^64 samples of any int.
+	class Moments
+	{
+	public:
+		void add(int value)
+		{
+			++m_count;
+			m_sum.addSigned(value);
+			m_sumSquares.add(static_cast<std::uint64_t>(static_cast<std::int64_t>(value) * value));
+		}
+
+		void merge(const Moments& other)
+		{
+			m_count += other.m_count;
+			m_sum.add(other.m_sum);
+			m_sumSquares.add(other.m_sumSquares);
+		}
+
+		std::uint64_t count() const { return m_count; }
+		const Wide& sum() const { return m_sum; }
+		const Wide& sumSquares() const { return m_sumSquares; }
+
+		// Function: mean
+		// Mean of the samples, or 0 without samples.
+		double mean() const;
+
+		// Function: variance
+		// Sample variance (divided by count - 1), or 0 with fewer than two samples. Computed from the exact
+		// sum of squared deviations from the rounded mean, so it is accurate for any spread of values.
+		double variance() const;
+
+		double standardDeviation() const;
+
+		// Function: restore
+		// Sets the raw state, as read back by RollStats::deserialize.
+		void restore(std::uint64_t count, const Wide& sum, const Wide& sumSquares)
+		{
+			m_count = count;
+			m_sum = sum;
+			m_sumSquares = sumSquares;
+		}
+
+		bool operator==(const Moments&) const = default;
+
+	private:
+		std::uint64_t m_count = 0;
+		Wide m_sum;        // Sum of the samples, two's complement
+		Wide m_sumSquares; // Sum of the squared samples
+	};
+
+	// Class: Histogram
+	// Exact counts of integer values over the contiguous range between the smallest and largest value
+	// seen. Suited to the narrow ranges of totals and degrees: memory and merge cost grow with the range,
+	// not with the number of samples.
+	class Histogram
+	{
+	public:
+		void add(int value, std::uint64_t count = 1)
+		{
+			if (m_counts.empty() or value < m_minValue or value > maxValue())
+			{
+				extend(value);
+			}
+			m_counts[static_cast<std::size_t>(static_cast<std::int64_t>(value) - m_minValue)] += count;
+			m_total += count;
+		}
+
+		void merge(const Histogram& other);
+
+		bool empty() const { return m_counts.empty(); }
+		std::uint64_t total() const { return m_total; }
+		int minValue() const { return m_minValue; }
+		int maxValue() const { return m_minValue + static_cast<int>(m_counts.size()) - 1; }
+
+		// Function: counts
+		// counts()[i] is the number of samples equal to minValue() + i.
+		std::span<const std::uint64_t> counts() const { return m_counts; }
+
+		// Function: count
+		// Number of samples equal to `value`.
+		std::uint64_t count(int value) const
+		{
+			return empty() or value < m_minValue or value > maxValue()
+				? 0 : m_counts[static_cast<std::size_t>(static_cast<std::int64_t>(value) - m_minValue)];
+		}
+
+		// Function: restore
+		// Sets the raw state, as read back by RollStats::deserialize.
+		void restore(int minValue, std::vector<std::uint64_t> counts);
+
+		bool operator==(const Histogram&) const = default;
+
+	private:
+		// Function: extend
+		// Grows the range to include `value`.
+		void extend(int value);
+
+		int m_minValue = 0;
+		std::vector<std::uint64_t> m_counts;
+		std::uint64_t m_total = 0;
+	};
+
+	// Structure: RollStats
+	// Everything the roll functions report, accumulated over any number of rolls.
+	//
+	// Skill rolls add their total and count their crits as critWins/critLosses. Target rolls also count
+	// success as ATTACKER and failure as DEFENDER, as Simulator tallies them, and add their degree. Opposed
+	// rolls add their winner and degree, and both contestants' totals, so each counts as two skill rolls in
+	// the totals, as in metrics::Snapshot.
+	struct RollStats
+	{
+		std::uint64_t rolls = 0;                 // Results added
+		std::array<std::uint64_t, 3> winners{};  // Outcomes by Winner (TIE, ATTACKER, DEFENDER)
+		std::uint64_t critWins = 0;              // Critical successes (decided by one, for opposed rolls)
+		std::uint64_t critLosses = 0;            // Critical failures (decided by one, for opposed rolls)
+		Histogram totals;                        // Skill roll totals
+		Histogram degrees;                       // Target and opposed degrees
+		Moments totalMoments;                    // Mean and variance of the totals
+		Moments degreeMoments;                   // Mean and variance of the degrees
+
+		void add(const SkillRollResult& roll);
+		void add(const TargetRollResult& roll);
+		void add(const OpposedRollResult& roll);
+
+		// Function: addOutcome
+		// Adds an outcome given by its parts, such as a custom Simulator trial.
+		void addOutcome(Winner winner, int degree, bool critWin, bool critLoss);
+
+		std::uint64_t winnerCount(Winner winner) const { return winners[static_cast<std::size_t>(winner)]; }
+
+		// Function: merge
+		// Adds another accumulator's rolls to this one. Exact, associative and commutative.
+		void merge(const RollStats& other);
+
+		// Function: serialize
+		// Appends the compact binary form: a 4-byte header, then LEB128 varints. Histogram bins with small
+		// counts take one byte each.
+		void serialize(std::vector<std::uint8_t>& out) const;
+
+		// Function: deserialize
+		// Reads an accumulator written by serialize from the whole of `bytes`.
+		//
+		// Returns:
+		// - False if the bytes are truncated, corrupt, have trailing data or come from another format
+		//   version. `stats` is unspecified then.
+		static bool deserialize(std::span<const std::uint8_t> bytes, RollStats& stats);
+
+		bool operator==(const RollStats&) const = default;
+	};
+
+	// Class: ShardedStats
+	// One RollStats per worker, each on its own cache lines, for accumulating from several threads without
+	// locks or atomics. Workers only touch shard(worker), with worker ids as ThreadPool hands them out;
+	// merged() is read once the workers are done.
+	class ShardedStats
+	{
+	public:
+		explicit ShardedStats(unsigned shards);
+
+		RollStats& shard(unsigned worker) { return m_shards[worker].stats; }
+		unsigned size() const { return static_cast<unsigned>(m_shards.size()); }
+
+		// Function: merged
+		// Sum of every shard.
+		RollStats merged() const;
+
+	private:
+		struct alignas(64) Shard
+		{
+			RollStats stats;
+		};
+
+		std::vector<Shard> m_shards;
+	};
+}//End of Namespace Core::Stats
@@ -0,0 +1,239 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace
+{
+	constexpr std::uint64_t pack(std::uint64_t begin, std::uint64_t end) { return (end << 32) | begin; }
+	constexpr std::uint64_t beginOf(std::uint64_t bounds) { return bounds & 0xFFFFFFFFull; }
+	constexpr std::uint64_t endOf(std::uint64_t bounds) { return bounds >> 32; }
+
+	// The pool whose tasks this thread is running, if any, and its worker id there
+	thread_local const Core::ThreadPool* currentPool = nullptr;
+	thread_local unsigned currentWorker = 0;
+
+	// Class: WorkerScope
+	// Marks the thread as running tasks of `pool` as `worker`, restoring the previous marks on exit.
+	class WorkerScope
+	{
+	public:
+		WorkerScope(const Core::ThreadPool* pool, unsigned worker)
+			: m_pool(std::exchange(currentPool, pool)), m_worker(std::exchange(currentWorker, worker))
+		{
+		}
+		~WorkerScope()
+		{
+			currentPool = m_pool;
+			currentWorker = m_worker;
+		}
+
+		WorkerScope(const WorkerScope&) = delete;
+		WorkerScope& operator=(const WorkerScope&) = delete;
+
+	private:
+		const Core::ThreadPool* m_pool;
+		unsigned m_worker;
+	};
+}
+
+//ThreadPool.cpp
+namespace Core
+{
+	ThreadPool::ThreadPool(unsigned threadCount)
+		: m_slices(threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()))
+	{
+		for (unsigned worker = 1; worker < size(); ++worker)
+		{
+			m_threads.emplace_back([this, worker]() { workerLoop(worker); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	// Function: shared
+	// Process-wide pool sized to the hardware.
+	ThreadPool& ThreadPool::shared()
+	{
+		static ThreadPool pool;
+		return pool;
+	}//End of shared
+
+	// Function: parallelFor
+	// Runs task(index, worker) once for every index in [0, count).
+	void ThreadPool::parallelFor(std::size_t count, const Task& task)
+	{
+		// Called from one of this pool's tasks: the workers are busy with the outer loop, so run inline
+		// under the calling task's worker id, which no other running task has
+		if (currentPool == this)
+		{
+			const unsigned worker = currentWorker;
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				task(index, worker);
+			}
+			return;
+		}
+
+		std::lock_guard run(m_runMutex);
+
+		// Slices hold 32-bit bounds, so very large loops run in several rounds
+		constexpr std::size_t MAX_ROUND = std::numeric_limits<std::uint32_t>::max();
+		for (std::size_t first = 0; first < count; first += MAX_ROUND)
+		{
+			const std::size_t roundCount = std::min(count - first, MAX_ROUND);
+			Task roundTask = first == 0 ? task : [&task, first](std::size_t index, unsigned worker) { task(first + index, worker); };
+
+			for (unsigned worker = 0; worker < size(); ++worker)
+			{
+				std::uint64_t begin = roundCount * worker / size();
+				std::uint64_t end = roundCount * (worker + 1) / size();
+				m_slices[worker].bounds.store(pack(begin, end), std::memory_order_relaxed);
+			}
+
+			{
+				std::lock_guard lock(m_mutex);
+				m_task = &roundTask;
+				m_busyWorkers = size() - 1;
+				++m_generation;
+			}
+			m_wake.notify_all();
+
+			try
+			{
+				WorkerScope scope(this, 0);
+				runWorker(0);
+			}
+			catch (...)
+			{
+				cancel(std::current_exception());
+			}
+
+			// Workers still use roundTask until they report back, even when a task has thrown
+			std::unique_lock lock(m_mutex);
+			m_done.wait(lock, [this]() { return m_busyWorkers == 0; });
+			m_task = nullptr;
+			if (m_error)
+			{
+				std::rethrow_exception(std::exchange(m_error, nullptr));
+			}
+		}
+	}//End of parallelFor
+
+	// Function: cancel
+	// Records the first exception of a loop and empties every slice so workers stop taking new indices.
+	// Indices a worker has just stolen may still run.
+	void ThreadPool::cancel(std::exception_ptr error)
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			if (not m_error)
+			{
+				m_error = error;
+			}
+		}
+		for (Slice& slice : m_slices)
+		{
+			slice.bounds.store(pack(0, 0), std::memory_order_release);
+		}
+	}//End of cancel
+
+	// Function: workerLoop
+	// Body of each background thread: wait for a loop, help run it, report back.
+	void ThreadPool::workerLoop(unsigned worker)
+	{
+		std::uint64_t seenGeneration = 0;
+		std::unique_lock lock(m_mutex);
+		while (true)
+		{
+			m_wake.wait(lock, [&]() { return m_stopping or m_generation != seenGeneration; });
+			if (m_stopping)
+			{
+				return;
+			}
+			seenGeneration = m_generation;
+
+			lock.unlock();
+			try
+			{
+				WorkerScope scope(this, worker);
+				runWorker(worker);
+			}
+			catch (...)
+			{
+				cancel(std::current_exception());
+			}
+			lock.lock();
+
+			if (--m_busyWorkers == 0)
+			{
+				m_done.notify_one();
+			}
+		}
+	}//End of workerLoop
+
+	// Function: runWorker
+	// Drains this worker's slice, then keeps stealing until every slice is empty.
+	void ThreadPool::runWorker(unsigned worker)
+	{
+		std::size_t index;
+		do
+		{
+			while (takeIndex(worker, index))
+			{
+				(*m_task)(index, worker);
+			}
+		} while (stealInto(worker));
+	}//End of runWorker
+
+	// Function: takeIndex
+	// Pops the first index of this worker's slice.
+	bool ThreadPool::takeIndex(unsigned worker, std::size_t& index)
+	{
+		std::atomic<std::uint64_t>& bounds = m_slices[worker].bounds;
+		std::uint64_t current = bounds.load(std::memory_order_acquire);
+		while (beginOf(current) < endOf(current))
+		{
+			if (bounds.compare_exchange_weak(current, pack(beginOf(current) + 1, endOf(current)), std::memory_order_acq_rel))
+			{
+				index = static_cast<std::size_t>(beginOf(current));
+				return true;
+			}
+		}
+		return false;
+	}//End of takeIndex
+
+	// Function: stealInto
+	// Moves the back half of another worker's slice into this worker's (empty) slice.
+	bool ThreadPool::stealInto(unsigned worker)
+	{
+		for (unsigned offset = 1; offset < size(); ++offset)
+		{
+			std::atomic<std::uint64_t>& victim = m_slices[(worker + offset) % size()].bounds;
+			std::uint64_t current = victim.load(std::memory_order_acquire);
+			while (beginOf(current) < endOf(current))
+			{
+				std::uint64_t remaining = endOf(current) - beginOf(current);
+				std::uint64_t split = endOf(current) - (remaining + 1) / 2;
+				if (victim.compare_exchange_weak(current, pack(beginOf(current), split), std::memory_order_acq_rel))
+				{
+					m_slices[worker].bounds.store(pack(split, endOf(current)), std::memory_order_release);
+					return true;
+				}
+			}
+		}
+		return false;
+	}//End of stealInto
+}//End of Namespace Core
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//ThreadPool.h
+namespace Core
+{
+	// Class: ThreadPool
+	// Fixed set of worker threads running parallel loops with work stealing.
+	//
+	// parallelFor splits the index range into one contiguous slice per worker. Each worker takes indices
+	// from the front of its own slice; a worker whose slice runs dry steals the back half of another
+	// worker's slice. Slices are single atomic words, so neither taking nor stealing work takes a lock.
+	// The calling thread joins in as worker 0, so a pool of size 1 runs everything inline.
+	class ThreadPool
+	{
+	public:
+		// Task signature: (index, worker). Worker ids are in [0, size()) and unique among concurrently
+		// running tasks, so they can index per-worker scratch space without synchronization.
+		using Task = std::function<void(std::size_t index, unsigned worker)>;
+
+		// Constructor: threadCount of 0 uses std::thread::hardware_concurrency().
+		explicit ThreadPool(unsigned threadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// Function: size
+		// Number of workers, including the calling thread.
+		unsigned size() const { return static_cast<unsigned>(m_slices.size()); }
+
+		// Function: parallelFor
+		// Runs task(index, worker) once for every index in [0, count) and returns when all have finished.
+		// Calls from several threads at once are serialized.
+		//
+		// A call made from inside one of this pool's tasks (directly, or through Simulator, opposedMatrix
+		// and the like on the shared pool) runs its loop inline on the calling thread, under that task's
+		// worker id, rather than waiting for workers that are busy with the outer loop.
+		//
+		// If a task throws, the remaining indices are abandoned (a few already taken may still run), every
+		// worker is waited for, and the first exception is rethrown to the caller.
+		void parallelFor(std::size_t count, const Task& task);
+
+		// Function: shared
+		// Process-wide pool sized to the hardware, created on first use.
+		static ThreadPool& shared();
+
+	private:
+		// Structure: Slice
+		// A worker's remaining [begin, end) indices packed as (end << 32) | begin.
+		struct alignas(64) Slice
+		{
+			std::atomic<std::uint64_t> bounds{ 0 };
+		};
+
+		void workerLoop(unsigned worker);
+		void runWorker(unsigned worker);
+		bool takeIndex(unsigned worker, std::size_t& index);
+		bool stealInto(unsigned worker);
+		void cancel(std::exception_ptr error);
+
+		std::vector<Slice> m_slices;
+		std::vector<std::thread> m_threads;
+
+		std::mutex m_runMutex;                 // Serializes parallelFor calls
+		std::mutex m_mutex;                    // Guards the fields below
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		const Task* m_task = nullptr;
+		std::uint64_t m_generation = 0;
+		unsigned m_busyWorkers = 0;
+		std::exception_ptr m_error;            // First exception thrown by the current loop's tasks
+		bool m_stopping = false;
+	};
+}//End of Namespace Core
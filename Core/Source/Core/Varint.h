@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+//Varint.h
+// LEB128 variable-length integers, shared by the compact binary formats (Journal.h, Stats.h).
+// Values below 128 take one byte; signed values are zigzag-encoded first so small negatives stay small.
+namespace Core::Varint
+{
+	// The longest encoding of a 64-bit value
+	constexpr std::size_t MAX_BYTES = 10;
+
+	constexpr std::uint64_t zigzag(std::int64_t value)
+	{
+		return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+	}
+
+	constexpr std::int64_t unzigzag(std::uint64_t value)
+	{
+		return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+	}
+
+	// Function: put
+	// Writes `value` as LEB128 at `out` and returns the position after it. `out` needs MAX_BYTES of room.
+	inline std::uint8_t* put(std::uint8_t* out, std::uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			*out++ = static_cast<std::uint8_t>(value | 0x80);
+			value >>= 7;
+		}
+		*out++ = static_cast<std::uint8_t>(value);
+		return out;
+	}
+
+	// Function: get
+	// Decodes a LEB128 value at `offset`, advancing it. Returns false if the value is truncated or too long.
+	inline bool get(std::span<const std::uint8_t> bytes, std::size_t& offset, std::uint64_t& value)
+	{
+		// Nearly every field fits in one byte
+		if (offset < bytes.size() and bytes[offset] < 0x80)
+		{
+			value = bytes[offset++];
+			return true;
+		}
+		value = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7)
+		{
+			if (offset >= bytes.size())
+			{
+				return false;
+			}
+			std::uint8_t byte = bytes[offset++];
+			value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}//End of Namespace Core::Varint
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Protocol.h"
+
+//LoadGenerator.cpp
+// Load generator for the roll service. Each connection runs on its own thread and keeps `pipeline`
+// requests in flight; the latency of a request is the time from sending it to reading its response.
+//
+// Usage: RollLoad [--socket path | --tcp port] [--connections N] [--requests N] [--pipeline N] [--opposed percent]
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Structure: LoadOptions
+	struct LoadOptions
+	{
+		std::string socketPath = "/tmp/core-roll.sock";
+		int tcpPort = 0;
+		unsigned connections = 1;
+		std::uint32_t requests = 100000; // Per connection
+		std::uint32_t pipeline = 1;      // Requests in flight per connection
+		unsigned opposedPercent = 50;
+	};
+
+	bool parseLoadOptions(int argc, char** argv, LoadOptions& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string argument = argv[i];
+			if (i + 1 >= argc)
+			{
+				return false;
+			}
+			const char* value = argv[++i];
+
+			if (argument == "--socket") options.socketPath = value;
+			else if (argument == "--tcp") options.tcpPort = std::atoi(value);
+			else if (argument == "--connections") options.connections = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+			else if (argument == "--requests") options.requests = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+			else if (argument == "--pipeline") options.pipeline = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+			else if (argument == "--opposed") options.opposedPercent = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+			else return false;
+		}
+		return options.connections > 0 and options.pipeline > 0;
+	}
+
+	// Function: closeKeepingErrno
+	// Closes `fd` if it is open, leaving errno as the failure that led here set it.
+	void closeKeepingErrno(int fd)
+	{
+		if (fd >= 0)
+		{
+			const int error = errno;
+			::close(fd);
+			errno = error;
+		}
+	}
+
+	// Function: connectToService
+	// Opens a connection to the service, or returns -1 with errno set and nothing left open.
+	int connectToService(const LoadOptions& options)
+	{
+		if (options.tcpPort > 0)
+		{
+			int fd = socket(AF_INET, SOCK_STREAM, 0);
+			sockaddr_in address{};
+			address.sin_family = AF_INET;
+			address.sin_port = htons(static_cast<std::uint16_t>(options.tcpPort));
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			int noDelay = 1;
+			if (fd < 0 or connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+			{
+				closeKeepingErrno(fd);
+				return -1;
+			}
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+			return fd;
+		}
+
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		std::strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+		if (fd < 0 or connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+		{
+			closeKeepingErrno(fd);
+			return -1;
+		}
+		return fd;
+	}
+
+	// Function: makeRequest
+	// Request `id` of a connection: a deterministic mix of opposed and target rolls.
+	Protocol::Request makeRequest(std::uint32_t id, unsigned opposedPercent)
+	{
+		Protocol::Request request;
+		request.id = id;
+		if (id % 100 < opposedPercent)
+		{
+			request.kind = Protocol::RequestKind::OPPOSED;
+			request.parameters = { static_cast<std::int16_t>(id % 7), static_cast<std::int16_t>(id % 5),
+				static_cast<std::int16_t>(id % 3), 0, 0, static_cast<std::int16_t>(id % 2) };
+		}
+		else
+		{
+			request.kind = Protocol::RequestKind::TARGET;
+			request.parameters = { static_cast<std::int16_t>(id % 7), static_cast<std::int16_t>(id % 10 + 1),
+				static_cast<std::int16_t>(id % 2), static_cast<std::int16_t>(id % 3), 0, 0 };
+		}
+		return request;
+	}
+
+	// Structure: ConnectionResult
+	struct ConnectionResult
+	{
+		std::vector<std::uint32_t> latencies; // Nanoseconds per request
+		std::uint64_t errors = 0;
+		bool failed = false;
+		int error = 0; // errno of the failure, captured on the connection's own thread
+	};
+
+	// Function: fail
+	// Records a failed connection with the current errno (a connection closed by the service has none) and
+	// closes its socket.
+	void fail(ConnectionResult& result, int fd)
+	{
+		result.failed = true;
+		result.error = errno != 0 ? errno : ECONNRESET;
+		if (fd >= 0)
+		{
+			::close(fd);
+		}
+	}
+
+	// Function: runConnection
+	// Sends `requests` requests keeping `pipeline` in flight and records each one's latency.
+	void runConnection(const LoadOptions& options, ConnectionResult& result)
+	{
+		int fd = connectToService(options);
+		if (fd < 0)
+		{
+			fail(result, fd);
+			return;
+		}
+
+		std::vector<Clock::time_point> sentAt(options.requests);
+		result.latencies.reserve(options.requests);
+		std::vector<std::uint8_t> output;
+		std::vector<std::uint8_t> input(std::size_t{ 64 } << 10);
+		std::size_t inputUsed = 0;
+		std::uint32_t sent = 0;
+		std::uint32_t received = 0;
+
+		while (received < options.requests)
+		{
+			// Top the pipeline up in one write
+			output.clear();
+			const Clock::time_point now = Clock::now();
+			while (sent < options.requests and sent - received < options.pipeline)
+			{
+				output.resize(output.size() + Protocol::REQUEST_BYTES);
+				Protocol::encodeRequest(makeRequest(sent, options.opposedPercent), output.data() + output.size() - Protocol::REQUEST_BYTES);
+				sentAt[sent++] = now;
+			}
+			for (std::size_t offset = 0; offset < output.size();)
+			{
+				errno = 0;
+				ssize_t count = ::send(fd, output.data() + offset, output.size() - offset, MSG_NOSIGNAL);
+				if (count <= 0)
+				{
+					fail(result, fd);
+					return;
+				}
+				offset += static_cast<std::size_t>(count);
+			}
+
+			errno = 0;
+			ssize_t count = ::read(fd, input.data() + inputUsed, input.size() - inputUsed);
+			if (count <= 0)
+			{
+				fail(result, fd);
+				return;
+			}
+			inputUsed += static_cast<std::size_t>(count);
+
+			const Clock::time_point arrived = Clock::now();
+			std::size_t offset = 0;
+			for (; offset + Protocol::RESPONSE_BYTES <= inputUsed; offset += Protocol::RESPONSE_BYTES)
+			{
+				Protocol::Response response = Protocol::decodeResponse(input.data() + offset);
+				if (response.id != received or response.status != Protocol::Status::OK)
+				{
+					++result.errors; // Responses arrive in request order and every request is valid
+				}
+				result.latencies.push_back(static_cast<std::uint32_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(arrived - sentAt[received]).count()));
+				++received;
+			}
+			std::memmove(input.data(), input.data() + offset, inputUsed - offset);
+			inputUsed -= offset;
+		}
+		::close(fd);
+	}//End of runConnection
+}
+
+int main(int argc, char** argv)
+{
+	LoadOptions options;
+	if (not parseLoadOptions(argc, argv, options))
+	{
+		std::fprintf(stderr, "Usage: RollLoad [--socket path | --tcp port] [--connections N] [--requests N] [--pipeline N] [--opposed percent]\n");
+		return 2;
+	}
+
+	std::vector<ConnectionResult> results(options.connections);
+	std::vector<std::thread> threads;
+	const Clock::time_point start = Clock::now();
+	for (unsigned i = 0; i < options.connections; ++i)
+	{
+		threads.emplace_back(runConnection, std::cref(options), std::ref(results[i]));
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	std::vector<std::uint32_t> latencies;
+	std::uint64_t errors = 0;
+	for (const ConnectionResult& result : results)
+	{
+		if (result.failed)
+		{
+			std::fprintf(stderr, "A connection failed: %s\n", std::strerror(result.error));
+			return 1;
+		}
+		latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+		errors += result.errors;
+	}
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double p) {
+		return latencies.empty() ? 0.0 : latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(p * latencies.size()))] / 1000.0;
+	};
+
+	std::printf("%zu requests in %.3f s: %.0f requests/s, latency p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us, %llu errors\n",
+		latencies.size(), seconds, latencies.size() / seconds, percentile(0.50), percentile(0.99), percentile(0.999),
+		latencies.empty() ? 0.0 : latencies.back() / 1000.0, static_cast<unsigned long long>(errors));
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+//Protocol.h
+// Wire format of the roll service. Every frame has a fixed size and little-endian fields, so a stream is
+// split into frames without any length prefix and clients may pipeline any number of requests.
+//
+// Request (20 bytes):
+//   [0..3]   id            echoed in the response
+//   [4]      kind          RequestKind
+//   [5..7]   reserved      0
+//   [8..19]  6 x int16     OPPOSED: attackerSkill, defenderSkill, attackerBoons, attackerBanes, defenderBoons, defenderBanes
+//                          TARGET:  skill, difficulty, boons, banes, 0, 0
+// Response (16 bytes):
+//   [0..3]   id
+//   [4]      kind
+//   [5]      status        Status
+//   [6]      outcome       OPPOSED: 0 tie, 1 attacker, 2 defender; TARGET: 1 if successful
+//   [7]      flags         bit 0 critWin / critSuccess, bit 1 critLoss / critFailure
+//   [8..9]   degree        int16
+//   [10..13] 2 x int16     OPPOSED: attacker and defender totals; TARGET: total, 0
+//   [14..15] reserved      0
+// Responses to one connection are sent in request order.
+namespace Protocol
+{
+	constexpr std::size_t REQUEST_BYTES = 20;
+	constexpr std::size_t RESPONSE_BYTES = 16;
+
+	// Parameter limits; requests outside them are answered with Status::BAD_REQUEST
+	constexpr int MAX_SKILL_LEVEL = 1000;
+	constexpr int MAX_DIFFICULTY_LEVEL = 1000;
+	constexpr int MAX_MODIFIER = 64; // Boons and banes are 0 .. MAX_MODIFIER
+
+	enum class RequestKind : std::uint8_t
+	{
+		OPPOSED = 1,
+		TARGET = 2
+	};
+
+	enum class Status : std::uint8_t
+	{
+		OK = 0,
+		BAD_REQUEST = 1
+	};
+
+	constexpr std::uint8_t FLAG_CRIT_WIN = 0x01;  // critWin or critSuccess
+	constexpr std::uint8_t FLAG_CRIT_LOSS = 0x02; // critLoss or critFailure
+
+	// Structure: Request
+	struct Request
+	{
+		std::uint32_t id = 0;
+		RequestKind kind = RequestKind::TARGET;
+		std::array<std::int16_t, 6> parameters{};
+	};
+
+	// Structure: Response
+	struct Response
+	{
+		std::uint32_t id = 0;
+		RequestKind kind = RequestKind::TARGET;
+		Status status = Status::OK;
+		std::uint8_t outcome = 0;
+		std::uint8_t flags = 0;
+		std::int16_t degree = 0;
+		std::array<std::int16_t, 2> totals{};
+	};
+
+	namespace Detail
+	{
+		inline void put16(std::uint8_t* out, std::uint16_t value)
+		{
+			out[0] = static_cast<std::uint8_t>(value);
+			out[1] = static_cast<std::uint8_t>(value >> 8);
+		}
+
+		inline void put32(std::uint8_t* out, std::uint32_t value)
+		{
+			put16(out, static_cast<std::uint16_t>(value));
+			put16(out + 2, static_cast<std::uint16_t>(value >> 16));
+		}
+
+		inline std::uint16_t get16(const std::uint8_t* in)
+		{
+			return static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+		}
+
+		inline std::uint32_t get32(const std::uint8_t* in)
+		{
+			return get16(in) | (static_cast<std::uint32_t>(get16(in + 2)) << 16);
+		}
+	}
+
+	// Function: encodeRequest
+	// Writes REQUEST_BYTES bytes at `out`.
+	inline void encodeRequest(const Request& request, std::uint8_t* out)
+	{
+		Detail::put32(out, request.id);
+		out[4] = static_cast<std::uint8_t>(request.kind);
+		out[5] = out[6] = out[7] = 0;
+		for (std::size_t i = 0; i < request.parameters.size(); ++i)
+		{
+			Detail::put16(out + 8 + 2 * i, static_cast<std::uint16_t>(request.parameters[i]));
+		}
+	}
+
+	// Function: decodeRequest
+	// Reads REQUEST_BYTES bytes at `in`. The kind is not validated.
+	inline Request decodeRequest(const std::uint8_t* in)
+	{
+		Request request;
+		request.id = Detail::get32(in);
+		request.kind = static_cast<RequestKind>(in[4]);
+		for (std::size_t i = 0; i < request.parameters.size(); ++i)
+		{
+			request.parameters[i] = static_cast<std::int16_t>(Detail::get16(in + 8 + 2 * i));
+		}
+		return request;
+	}
+
+	// Function: encodeResponse
+	// Writes RESPONSE_BYTES bytes at `out`.
+	inline void encodeResponse(const Response& response, std::uint8_t* out)
+	{
+		Detail::put32(out, response.id);
+		out[4] = static_cast<std::uint8_t>(response.kind);
+		out[5] = static_cast<std::uint8_t>(response.status);
+		out[6] = response.outcome;
+		out[7] = response.flags;
+		Detail::put16(out + 8, static_cast<std::uint16_t>(response.degree));
+		Detail::put16(out + 10, static_cast<std::uint16_t>(response.totals[0]));
+		Detail::put16(out + 12, static_cast<std::uint16_t>(response.totals[1]));
+		Detail::put16(out + 14, 0);
+	}
+
+	// Function: decodeResponse
+	// Reads RESPONSE_BYTES bytes at `in`.
+	inline Response decodeResponse(const std::uint8_t* in)
+	{
+		Response response;
+		response.id = Detail::get32(in);
+		response.kind = static_cast<RequestKind>(in[4]);
+		response.status = static_cast<Status>(in[5]);
+		response.outcome = in[6];
+		response.flags = in[7];
+		response.degree = static_cast<std::int16_t>(Detail::get16(in + 8));
+		response.totals = { static_cast<std::int16_t>(Detail::get16(in + 10)), static_cast<std::int16_t>(Detail::get16(in + 12)) };
+		return response;
+	}
+
+	// Function: isValidRequest
+	// True if the kind is known and every parameter is within the limits above.
+	inline bool isValidRequest(const Request& request)
+	{
+		auto inRange = [](int value, int low, int high) { return value >= low and value <= high; };
+		const auto& p = request.parameters;
+		switch (request.kind)
+		{
+		case RequestKind::OPPOSED:
+			return inRange(p[0], -MAX_SKILL_LEVEL, MAX_SKILL_LEVEL) and inRange(p[1], -MAX_SKILL_LEVEL, MAX_SKILL_LEVEL)
+				and inRange(p[2], 0, MAX_MODIFIER) and inRange(p[3], 0, MAX_MODIFIER)
+				and inRange(p[4], 0, MAX_MODIFIER) and inRange(p[5], 0, MAX_MODIFIER);
+		case RequestKind::TARGET:
+			return inRange(p[0], -MAX_SKILL_LEVEL, MAX_SKILL_LEVEL) and inRange(p[1], -MAX_DIFFICULTY_LEVEL, MAX_DIFFICULTY_LEVEL)
+				and inRange(p[2], 0, MAX_MODIFIER) and inRange(p[3], 0, MAX_MODIFIER);
+		default:
+			return false;
+		}
+	}
+}//End of Namespace Protocol
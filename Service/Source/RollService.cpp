@@ -0,0 +1,495 @@
+#include "RollService.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+	constexpr int MAX_EVENTS = 256;
+	constexpr std::size_t READ_BYTES = std::size_t{ 64 } << 10;          // Input buffer per connection
+	constexpr std::size_t OUTPUT_BACKLOG_BYTES = std::size_t{ 4 } << 20; // Stop reading a client this far behind
+	constexpr std::size_t READ_BUDGET_BYTES = READ_BYTES;                 // Read per connection per wake-up
+
+	// Function: toInt16
+	// Narrows a result for the wire; request limits keep every result in range.
+	std::int16_t toInt16(int value)
+	{
+		return static_cast<std::int16_t>(std::clamp(value, -32768, 32767));
+	}
+}
+
+// Structure: Connection
+// A client's unparsed input and unsent responses.
+struct RollService::Connection
+{
+	int fd;
+	std::uint64_t serial;       // Distinguishes connections that reuse a file descriptor
+	std::vector<std::uint8_t> input = std::vector<std::uint8_t>(READ_BYTES);
+	std::size_t inputUsed = 0;
+	std::vector<std::uint8_t> output;
+	std::size_t outputSent = 0;
+	std::uint32_t interest = 0; // Events currently registered with epoll
+	bool dirty = false;         // True if listed in m_dirty
+	bool readClosed = false;    // The client has shut down its side; close once the output has drained
+};
+
+//RollService.cpp
+bool parseServiceOptions(int argc, char** argv, ServiceOptions& options)
+{
+	for (int i = 0; i < argc; ++i)
+	{
+		std::string argument = argv[i];
+		if (i + 1 >= argc)
+		{
+			return false; // Every option takes a value
+		}
+		const char* value = argv[++i];
+
+		if (argument == "--socket") options.socketPath = value;
+		else if (argument == "--tcp") options.tcpPort = std::atoi(value);
+		else if (argument == "--seed")
+		{
+			options.seed = std::strtoull(value, nullptr, 10);
+			options.hasSeed = true;
+		}
+		else return false;
+	}
+	return true;
+}//End of parseServiceOptions
+
+RollService::RollService(const ServiceOptions& options)
+	: m_options(options), m_rng(options.hasSeed ? Core::RngContext(options.seed) : Core::RngContext::fromEntropy())
+{
+	m_pending.reserve(MAX_BATCH);
+	for (std::vector<int>& column : m_opposedColumns) column.resize(MAX_BATCH);
+	for (std::vector<int>& column : m_targetColumns) column.resize(MAX_BATCH);
+	m_winners.resize(MAX_BATCH);
+	m_opposedDegrees.resize(MAX_BATCH);
+	m_attackerTotals.resize(MAX_BATCH);
+	m_defenderTotals.resize(MAX_BATCH);
+	m_targetDegrees.resize(MAX_BATCH);
+	m_targetTotals.resize(MAX_BATCH);
+	m_critWins = std::make_unique<bool[]>(MAX_BATCH);
+	m_critLosses = std::make_unique<bool[]>(MAX_BATCH);
+	m_successes = std::make_unique<bool[]>(MAX_BATCH);
+	m_critSuccesses = std::make_unique<bool[]>(MAX_BATCH);
+	m_critFailures = std::make_unique<bool[]>(MAX_BATCH);
+}
+
+RollService::~RollService()
+{
+	for (std::size_t fd = 0; fd < m_connections.size(); ++fd)
+	{
+		if (m_connections[fd])
+		{
+			::close(static_cast<int>(fd));
+		}
+	}
+	for (int fd : { m_unixListener, m_tcpListener, m_wakeFd, m_epoll })
+	{
+		if (fd >= 0)
+		{
+			::close(fd);
+		}
+	}
+	if (m_unixListener >= 0)
+	{
+		::unlink(m_options.socketPath.c_str());
+	}
+}
+
+// Function: start
+// Creates the epoll instance, the stop eventfd and the listening sockets.
+bool RollService::start()
+{
+	m_epoll = epoll_create1(EPOLL_CLOEXEC);
+	m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_epoll < 0 or m_wakeFd < 0)
+	{
+		std::perror("epoll/eventfd");
+		return false;
+	}
+
+	if (not m_options.socketPath.empty())
+	{
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		if (m_options.socketPath.size() >= sizeof(address.sun_path))
+		{
+			std::fprintf(stderr, "Socket path too long: %s\n", m_options.socketPath.c_str());
+			return false;
+		}
+		std::memcpy(address.sun_path, m_options.socketPath.c_str(), m_options.socketPath.size() + 1);
+		::unlink(m_options.socketPath.c_str()); // Remove a stale socket from an earlier run
+
+		m_unixListener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (m_unixListener < 0 or bind(m_unixListener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+			or listen(m_unixListener, SOMAXCONN) != 0)
+		{
+			std::fprintf(stderr, "Cannot listen on %s: %s\n", m_options.socketPath.c_str(), std::strerror(errno));
+			return false;
+		}
+	}
+
+	if (m_options.tcpPort > 0)
+	{
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(static_cast<std::uint16_t>(m_options.tcpPort));
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		int reuse = 1;
+
+		m_tcpListener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (m_tcpListener < 0 or setsockopt(m_tcpListener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0
+			or bind(m_tcpListener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+			or listen(m_tcpListener, SOMAXCONN) != 0)
+		{
+			std::fprintf(stderr, "Cannot listen on 127.0.0.1:%d: %s\n", m_options.tcpPort, std::strerror(errno));
+			return false;
+		}
+	}
+
+	if (m_unixListener < 0 and m_tcpListener < 0)
+	{
+		std::fprintf(stderr, "No socket to listen on\n");
+		return false;
+	}
+
+	for (int fd : { m_wakeFd, m_unixListener, m_tcpListener })
+	{
+		if (fd < 0)
+		{
+			continue;
+		}
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+		{
+			std::perror("epoll_ctl");
+			return false;
+		}
+	}
+	return true;
+}//End of start
+
+// Function: run
+// The event loop: read everything readable, resolve it as one batch, write the responses.
+void RollService::run()
+{
+	epoll_event events[MAX_EVENTS];
+	m_running = true;
+	while (m_running)
+	{
+		int count = epoll_wait(m_epoll, events, MAX_EVENTS, -1);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			std::perror("epoll_wait");
+			break;
+		}
+
+		for (int i = 0; i < count; ++i)
+		{
+			const int fd = events[i].data.fd;
+			if (fd == m_wakeFd)
+			{
+				m_running = false;
+			}
+			else if (fd == m_unixListener or fd == m_tcpListener)
+			{
+				accept(fd);
+			}
+			else if (static_cast<std::size_t>(fd) < m_connections.size() and m_connections[fd])
+			{
+				if (events[i].events & EPOLLOUT)
+				{
+					flush(*m_connections[fd]);
+				}
+				if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) and m_connections[fd])
+				{
+					readFrom(*m_connections[fd]);
+				}
+			}
+		}
+
+		if (not m_pending.empty())
+		{
+			resolveBatch();
+		}
+		for (int fd : m_dirty)
+		{
+			if (m_connections[fd])
+			{
+				m_connections[fd]->dirty = false;
+				flush(*m_connections[fd]);
+			}
+		}
+		m_dirty.clear();
+	}
+}//End of run
+
+void RollService::stop()
+{
+	std::uint64_t one = 1;
+	[[maybe_unused]] ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+}
+
+// Function: accept
+// Accepts every pending connection on a listener.
+void RollService::accept(int listener)
+{
+	while (true)
+	{
+		int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0)
+		{
+			return; // EAGAIN, or a client that gave up; the listener stays registered either way
+		}
+		if (listener == m_tcpListener)
+		{
+			int noDelay = 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+		}
+
+		if (static_cast<std::size_t>(fd) >= m_connections.size())
+		{
+			m_connections.resize(static_cast<std::size_t>(fd) + 1);
+		}
+		m_connections[fd] = std::make_unique<Connection>();
+		m_connections[fd]->fd = fd;
+		m_connections[fd]->serial = ++m_stats.connections;
+
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+		{
+			closeConnection(fd);
+			continue;
+		}
+		m_connections[fd]->interest = EPOLLIN;
+	}
+}//End of accept
+
+// Function: readFrom
+// Reads up to READ_BUDGET_BYTES from a connection's socket and queues its complete request frames into the
+// batch. Whatever is left is read on a later wake-up (epoll is level-triggered), so one fast client cannot
+// hold up the others. At end of input the connection stops reading and is closed once its responses are out.
+void RollService::readFrom(Connection& connection)
+{
+	const int fd = connection.fd;
+	std::size_t budget = READ_BUDGET_BYTES;
+	while (budget > 0)
+	{
+		const std::size_t space = std::min(connection.input.size() - connection.inputUsed, budget);
+		ssize_t count = ::read(fd, connection.input.data() + connection.inputUsed, space);
+		if (count < 0 and errno != EAGAIN and errno != EINTR)
+		{
+			closeConnection(fd);
+			return;
+		}
+		if (count == 0)
+		{
+			// Half-closed: answer what was already sent, then close in flush
+			connection.readClosed = true;
+			if (not connection.dirty)
+			{
+				connection.dirty = true;
+				m_dirty.push_back(fd);
+			}
+			return;
+		}
+		if (count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			break; // EAGAIN: everything available has been read
+		}
+		connection.inputUsed += static_cast<std::size_t>(count);
+		budget -= static_cast<std::size_t>(count);
+
+		// Queue the complete frames and keep a trailing partial one
+		std::size_t offset = 0;
+		for (; offset + Protocol::REQUEST_BYTES <= connection.inputUsed; offset += Protocol::REQUEST_BYTES)
+		{
+			if (m_pending.size() == MAX_BATCH)
+			{
+				resolveBatch();
+			}
+			Pending pending{ fd, connection.serial, Protocol::decodeRequest(connection.input.data() + offset), 0, false };
+			pending.valid = Protocol::isValidRequest(pending.request);
+			if (pending.valid)
+			{
+				const auto& p = pending.request.parameters;
+				if (pending.request.kind == Protocol::RequestKind::OPPOSED)
+				{
+					pending.row = static_cast<std::uint32_t>(m_opposedCount++);
+					for (std::size_t column = 0; column < 6; ++column) m_opposedColumns[column][pending.row] = p[column];
+				}
+				else
+				{
+					pending.row = static_cast<std::uint32_t>(m_targetCount++);
+					for (std::size_t column = 0; column < 4; ++column) m_targetColumns[column][pending.row] = p[column];
+				}
+			}
+			m_pending.push_back(pending);
+		}
+		std::memmove(connection.input.data(), connection.input.data() + offset, connection.inputUsed - offset);
+		connection.inputUsed -= offset;
+
+		if (static_cast<std::size_t>(count) < space)
+		{
+			break; // Short read: the socket is empty, skip the EAGAIN round trip
+		}
+	}
+}//End of readFrom
+
+// Function: resolveBatch
+// Resolves the queued requests with the batch roll functions and appends the responses to their connections.
+void RollService::resolveBatch()
+{
+	if (m_opposedCount > 0)
+	{
+		const std::size_t n = m_opposedCount;
+		auto column = [&](std::size_t index) { return std::span<const int>(m_opposedColumns[index].data(), n); };
+		Core::opposedRollBatch(m_rng, { column(0), column(1), column(2), column(3), column(4), column(5) },
+			{ { m_winners.data(), n }, { m_opposedDegrees.data(), n }, { m_critWins.get(), n }, { m_critLosses.get(), n },
+			  { { m_attackerTotals.data(), n }, {}, {}, {} }, { { m_defenderTotals.data(), n }, {}, {}, {} } });
+	}
+	if (m_targetCount > 0)
+	{
+		const std::size_t n = m_targetCount;
+		auto column = [&](std::size_t index) { return std::span<const int>(m_targetColumns[index].data(), n); };
+		Core::targetRollBatch(m_rng, { column(0), column(1), column(2), column(3) },
+			{ { m_successes.get(), n }, { m_targetDegrees.data(), n },
+			  { { m_targetTotals.data(), n }, { m_critSuccesses.get(), n }, { m_critFailures.get(), n }, {} } });
+	}
+
+	for (const Pending& pending : m_pending)
+	{
+		if (not m_connections[pending.fd] or m_connections[pending.fd]->serial != pending.serial)
+		{
+			continue; // Closed while the batch was being gathered
+		}
+		Connection& connection = *m_connections[pending.fd];
+
+		Protocol::Response response;
+		response.id = pending.request.id;
+		response.kind = pending.request.kind;
+		if (not pending.valid)
+		{
+			response.status = Protocol::Status::BAD_REQUEST;
+			++m_stats.badRequests;
+		}
+		else if (pending.request.kind == Protocol::RequestKind::OPPOSED)
+		{
+			const std::uint32_t row = pending.row;
+			response.outcome = static_cast<std::uint8_t>(m_winners[row] == Core::Winner::ATTACKER ? 1 : m_winners[row] == Core::Winner::DEFENDER ? 2 : 0);
+			response.flags = (m_critWins[row] ? Protocol::FLAG_CRIT_WIN : 0) | (m_critLosses[row] ? Protocol::FLAG_CRIT_LOSS : 0);
+			response.degree = toInt16(m_opposedDegrees[row]);
+			response.totals = { toInt16(m_attackerTotals[row]), toInt16(m_defenderTotals[row]) };
+		}
+		else
+		{
+			const std::uint32_t row = pending.row;
+			response.outcome = m_successes[row] ? 1 : 0;
+			response.flags = (m_critSuccesses[row] ? Protocol::FLAG_CRIT_WIN : 0) | (m_critFailures[row] ? Protocol::FLAG_CRIT_LOSS : 0);
+			response.degree = toInt16(m_targetDegrees[row]);
+			response.totals = { toInt16(m_targetTotals[row]), 0 };
+		}
+
+		const std::size_t size = connection.output.size();
+		connection.output.resize(size + Protocol::RESPONSE_BYTES);
+		Protocol::encodeResponse(response, connection.output.data() + size);
+		if (not connection.dirty)
+		{
+			connection.dirty = true;
+			m_dirty.push_back(pending.fd);
+		}
+	}
+
+	++m_stats.batches;
+	m_stats.requests += m_pending.size();
+	m_stats.largestBatch = std::max<std::uint64_t>(m_stats.largestBatch, m_pending.size());
+	m_pending.clear();
+	m_opposedCount = 0;
+	m_targetCount = 0;
+}//End of resolveBatch
+
+// Function: flush
+// Writes as much pending output as the socket takes and updates the epoll interest.
+void RollService::flush(Connection& connection)
+{
+	while (connection.outputSent < connection.output.size())
+	{
+		ssize_t count = ::send(connection.fd, connection.output.data() + connection.outputSent,
+			connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			if (errno != EAGAIN)
+			{
+				closeConnection(connection.fd);
+				return;
+			}
+			break;
+		}
+		connection.outputSent += static_cast<std::size_t>(count);
+	}
+	if (connection.outputSent == connection.output.size())
+	{
+		connection.output.clear();
+		connection.outputSent = 0;
+		if (connection.readClosed)
+		{
+			closeConnection(connection.fd);
+			return;
+		}
+	}
+	updateInterest(connection);
+}//End of flush
+
+// Function: updateInterest
+// Waits for writability while output is pending, and stops reading a client that does not read its responses.
+void RollService::updateInterest(Connection& connection)
+{
+	const std::size_t backlog = connection.output.size() - connection.outputSent;
+	std::uint32_t interest = (backlog < OUTPUT_BACKLOG_BYTES and not connection.readClosed ? static_cast<std::uint32_t>(EPOLLIN) : 0u)
+		| (backlog > 0 ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+	if (interest != connection.interest)
+	{
+		epoll_event event{};
+		event.events = interest;
+		event.data.fd = connection.fd;
+		epoll_ctl(m_epoll, EPOLL_CTL_MOD, connection.fd, &event);
+		connection.interest = interest;
+	}
+}//End of updateInterest
+
+void RollService::closeConnection(int fd)
+{
+	epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+	::close(fd);
+	m_connections[fd].reset();
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/Core.h"
+#include "Protocol.h"
+
+//RollService.h
+// Single-threaded roll server: one epoll loop accepts connections on a Unix domain socket (and optionally
+// loopback TCP), reads fixed-size request frames and answers them (see Protocol.h).
+//
+// Everything readable in one epoll wake-up forms one batch: its opposed and target requests are gathered
+// into columns and resolved with opposedRollBatch and targetRollBatch, then every connection's responses
+// are written back in one write() call. Under load, batches grow by themselves; a lone request is
+// resolved as soon as it arrives, without waiting for company.
+
+// Structure: ServiceOptions
+// Command line options of the roll service.
+struct ServiceOptions
+{
+	std::string socketPath = "/tmp/core-roll.sock"; // Unix domain socket to listen on ("" disables it)
+	int tcpPort = 0;                                 // Loopback TCP port to listen on (0 disables it)
+	bool hasSeed = false;                            // True if --seed was given
+	std::uint64_t seed = 0;                          // Seed of the service's RngContext
+};
+
+// Structure: ServiceStats
+// Counters reported when the service stops.
+struct ServiceStats
+{
+	std::uint64_t connections = 0;
+	std::uint64_t requests = 0;
+	std::uint64_t badRequests = 0;
+	std::uint64_t batches = 0;
+	std::uint64_t largestBatch = 0;
+};
+
+// Function: parseServiceOptions
+// Parses [--socket path] [--tcp port] [--seed N].
+//
+// Returns:
+// - True if every argument was understood.
+bool parseServiceOptions(int argc, char** argv, ServiceOptions& options);
+
+// Class: RollService
+// The epoll event loop and its connections.
+class RollService
+{
+public:
+	explicit RollService(const ServiceOptions& options);
+	~RollService();
+
+	RollService(const RollService&) = delete;
+	RollService& operator=(const RollService&) = delete;
+
+	// Function: start
+	// Creates the listening sockets and the epoll instance.
+	//
+	// Returns:
+	// - True if every configured socket is listening; otherwise prints the reason to stderr.
+	bool start();
+
+	// Function: run
+	// Serves connections until stop() is called.
+	void run();
+
+	// Function: stop
+	// Makes run() return. Safe to call from another thread or a signal handler.
+	void stop();
+
+	const ServiceStats& stats() const { return m_stats; }
+
+private:
+	struct Connection;
+
+	// Structure: Pending
+	// A request of the current batch and where its response goes.
+	struct Pending
+	{
+		int fd;
+		std::uint64_t serial; // Connection::serial of the requesting connection
+		Protocol::Request request;
+		std::uint32_t row; // Row of the request in the opposed or target columns
+		bool valid;
+	};
+
+	void accept(int listener);
+	void readFrom(Connection& connection);
+	void resolveBatch();
+	void flush(Connection& connection);
+	void updateInterest(Connection& connection);
+	void closeConnection(int fd);
+
+	ServiceOptions m_options;
+	int m_epoll = -1;
+	int m_unixListener = -1;
+	int m_tcpListener = -1;
+	int m_wakeFd = -1; // eventfd written by stop()
+	bool m_running = false;
+	Core::RngContext m_rng;
+
+	std::vector<std::unique_ptr<Connection>> m_connections; // Indexed by file descriptor
+	std::vector<int> m_dirty;                              // Connections with responses to write
+
+	// Batch columns, allocated once for MAX_BATCH rows. std::vector<bool> cannot back a std::span<bool>.
+	static constexpr std::size_t MAX_BATCH = 4096;
+	std::vector<Pending> m_pending;
+	std::size_t m_opposedCount = 0;
+	std::size_t m_targetCount = 0;
+	std::vector<int> m_opposedColumns[6];
+	std::vector<Core::Winner> m_winners;
+	std::vector<int> m_opposedDegrees;
+	std::unique_ptr<bool[]> m_critWins;
+	std::unique_ptr<bool[]> m_critLosses;
+	std::vector<int> m_attackerTotals;
+	std::vector<int> m_defenderTotals;
+	std::vector<int> m_targetColumns[4];
+	std::unique_ptr<bool[]> m_successes;
+	std::vector<int> m_targetDegrees;
+	std::vector<int> m_targetTotals;
+	std::unique_ptr<bool[]> m_critSuccesses;
+	std::unique_ptr<bool[]> m_critFailures;
+
+	ServiceStats m_stats;
+};
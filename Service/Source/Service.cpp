@@ -0,0 +1,51 @@
+#include <csignal>
+#include <cstdio>
+
+#include "RollService.h"
+
+//Service.cpp
+// Roll service executable. Usage: RollService [--socket path] [--tcp port] [--seed N]
+
+namespace
+{
+	RollService* g_service = nullptr;
+
+	void handleSignal(int)
+	{
+		if (g_service)
+		{
+			g_service->stop(); // Writes to an eventfd, which is async-signal-safe
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	ServiceOptions options;
+	if (not parseServiceOptions(argc - 1, argv + 1, options))
+	{
+		std::fprintf(stderr, "Usage: RollService [--socket path] [--tcp port] [--seed N]\n");
+		return 2;
+	}
+
+	RollService service(options);
+	if (not service.start())
+	{
+		return 1;
+	}
+	g_service = &service;
+	std::signal(SIGINT, handleSignal);
+	std::signal(SIGTERM, handleSignal);
+
+	std::fprintf(stderr, "Listening on %s%s\n", options.socketPath.c_str(),
+		options.tcpPort > 0 ? (" and 127.0.0.1:" + std::to_string(options.tcpPort)).c_str() : "");
+	service.run();
+	g_service = nullptr;
+
+	const ServiceStats& stats = service.stats();
+	std::fprintf(stderr, "%llu connections, %llu requests (%llu bad) in %llu batches, largest batch %llu\n",
+		static_cast<unsigned long long>(stats.connections), static_cast<unsigned long long>(stats.requests),
+		static_cast<unsigned long long>(stats.badRequests), static_cast<unsigned long long>(stats.batches),
+		static_cast<unsigned long long>(stats.largestBatch));
+	return 0;
+}
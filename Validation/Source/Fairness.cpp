@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Core/Arena.h"
+#include "Core/Core.h"
+#include "Core/Distribution.h"
+#include "Core/PackedDice.h"
+#include "Core/ThreadPool.h"
+#include "Statistics.h"
+
+//Fairness.cpp
+// Statistical fairness validator. Rolls every case of a parameter grid through rollDice, skillRoll,
+// opposedRoll and targetRoll (dice and skill rolls also through PackedDice) on all cores, counts the
+// outcomes in per-worker histograms and tests them against the exact distributions from Core::Distribution
+// with chi-squared, Kolmogorov-Smirnov and lag-1 serial correlation tests. Crit flags are also checked against the totals they imply.
+//
+// Each test fails if its p-value is below alpha divided by the number of tests (Bonferroni), so a fair
+// build passes a full sweep with probability at least 1 - alpha. The default seed is fixed, making CI
+// runs reproducible. Exits with 1 if any test fails.
+//
+// Usage: Fairness [--rolls N] [--threads N] [--seed N] [--alpha A] [--quick]
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr std::uint64_t CHUNK_ROLLS = std::uint64_t{ 1 } << 16; // Rolls per work item, each on its own stream
+	constexpr std::size_t DICE_BLOCK = 4096;                          // Dice per rollDice call
+	constexpr std::uint64_t DEFAULT_ROLLS = 100'000'000;
+	constexpr std::uint64_t QUICK_ROLLS = 200'000;
+
+	// Structure: Options
+	struct Options
+	{
+		std::uint64_t rolls = DEFAULT_ROLLS; // Per case
+		unsigned threads = 0;                // 0: all cores
+		std::uint64_t seed = 0x5EED;
+		double alpha = 1e-3;
+		bool quick = false;
+		bool rollsGiven = false;
+	};
+
+	bool parseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string argument = argv[i];
+			if (argument == "--quick")
+			{
+				options.quick = true;
+				continue;
+			}
+			if (i + 1 >= argc)
+			{
+				return false;
+			}
+			const char* value = argv[++i];
+			if (argument == "--rolls") { options.rolls = std::strtoull(value, nullptr, 10); options.rollsGiven = true; }
+			else if (argument == "--threads") options.threads = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+			else if (argument == "--seed") options.seed = std::strtoull(value, nullptr, 0);
+			else if (argument == "--alpha") options.alpha = std::strtod(value, nullptr);
+			else return false;
+		}
+		if (options.quick and not options.rollsGiven)
+		{
+			options.rolls = QUICK_ROLLS;
+		}
+		return options.rolls > 0 and options.alpha > 0.0 and options.alpha < 1.0;
+	}
+
+	// Structure: Tally
+	// Streaming counters of one worker for one case.
+	struct Tally
+	{
+		std::vector<std::vector<std::uint64_t>> histograms; // One per Histogram of the case
+		Fairness::SerialCorrelation serial;
+		std::uint64_t inconsistencies = 0; // Impossible values or crit flags that contradict the total
+
+		// Function: count
+		// Adds one observation to a histogram, treating out-of-range bins as inconsistencies.
+		void count(std::size_t histogram, long long bin)
+		{
+			std::vector<std::uint64_t>& bins = histograms[histogram];
+			if (bin < 0 or bin >= static_cast<long long>(bins.size()))
+			{
+				++inconsistencies;
+				return;
+			}
+			++bins[static_cast<std::size_t>(bin)];
+		}
+	};
+
+	// Structure: Histogram
+	// An observed quantity of a case and its exact distribution.
+	struct Histogram
+	{
+		std::string label;
+		std::vector<double> expected;
+		bool ordered; // Also run the Kolmogorov-Smirnov test (bins are ordered values, not categories)
+	};
+
+	// Structure: Case
+	// One point of the parameter grid: what to roll and what the rolls should look like.
+	struct Case
+	{
+		std::string name;
+		std::vector<Histogram> histograms;
+		bool serial; // Test the serial correlation of the values fed to Tally::serial
+		std::function<void(Core::RngContext& rng, std::uint64_t rolls, Tally& tally)> roll;
+	};
+
+	Case diceCase(int diceSides, bool packed)
+	{
+		std::vector<double> uniform(diceSides, 1.0 / diceSides);
+		return { std::string(packed ? "PackedDice/" : "") + "rollDice/d" + std::to_string(diceSides), { { "faces", uniform, true } }, true,
+			[diceSides, packed](Core::RngContext& rng, std::uint64_t rolls, Tally& tally) {
+				Core::Arena arena(DICE_BLOCK * sizeof(int) + 64);
+				Core::PackedDice source(rng);
+				for (std::uint64_t done = 0; done < rolls; done += DICE_BLOCK)
+				{
+					const int count = static_cast<int>(std::min<std::uint64_t>(DICE_BLOCK, rolls - done));
+					std::pmr::vector<int> dice = packed ? std::pmr::vector<int>(count, &arena) : Core::rollDice(rng, &arena, count, diceSides, 1);
+					if (packed)
+					{
+						source.fill(dice, 1, diceSides);
+					}
+					for (int die : dice)
+					{
+						tally.count(0, die - 1);
+						tally.serial.add(die);
+					}
+					arena.reset();
+				}
+			} };
+	}
+
+	Case skillCase(int baseDiceCount, int boons, int banes, int diceSides, bool packed)
+	{
+		const Core::Distribution::SkillRollPmf& pmf = Core::Distribution::skillRoll(boons, banes, baseDiceCount, diceSides, 1);
+		return { std::string(packed ? "PackedDice/" : "") + "skillRoll/base:" + std::to_string(baseDiceCount) + "/d" + std::to_string(diceSides)
+				+ "/boons:" + std::to_string(boons) + "/banes:" + std::to_string(banes),
+			{ { "totals", pmf.pmf, true } }, true,
+			[=, &pmf](Core::RngContext& rng, std::uint64_t rolls, Tally& tally) {
+				Core::PackedDice source(rng);
+				for (std::uint64_t i = 0; i < rolls; ++i)
+				{
+					const Core::SkillRollResult roll = packed
+						? Core::skillRoll(source, 0, boons, banes, baseDiceCount, diceSides, 1)
+						: Core::skillRoll(rng, 0, boons, banes, baseDiceCount, diceSides, 1);
+					tally.count(0, roll.total - pmf.minTotal);
+					tally.serial.add(roll.total);
+					tally.inconsistencies += roll.critSuccess != (roll.total == pmf.maxTotal());
+					tally.inconsistencies += roll.critFailure != (roll.total == pmf.minTotal);
+				}
+			} };
+	}
+
+	Case targetCase(int skillLevel, int difficultyLevel, int boons, int banes)
+	{
+		const Core::Distribution::TargetRollOdds& odds = Core::Distribution::targetRoll(skillLevel, difficultyLevel, boons, banes);
+		return { "targetRoll/skill:" + std::to_string(skillLevel) + "/difficulty:" + std::to_string(difficultyLevel)
+				+ "/boons:" + std::to_string(boons) + "/banes:" + std::to_string(banes),
+			{ { "success", { 1.0 - odds.success, odds.success }, false }, { "degrees", odds.degrees, true } }, false,
+			[=, &odds](Core::RngContext& rng, std::uint64_t rolls, Tally& tally) {
+				for (std::uint64_t i = 0; i < rolls; ++i)
+				{
+					const Core::TargetRollResult result = Core::targetRoll(rng, skillLevel, difficultyLevel, boons, banes);
+					tally.count(0, result.success ? 1 : 0);
+					tally.count(1, result.degree - odds.minDegree);
+					tally.inconsistencies += result.critSuccess != result.roll.critSuccess;
+					tally.inconsistencies += result.critFailure != result.roll.critFailure;
+				}
+			} };
+	}
+
+	Case opposedCase(int attackerSkillLevel, int defenderSkillLevel, int attackerBoons, int defenderBanes, int baseDiceCount)
+	{
+		const Core::Distribution::OpposedRollOdds& odds = Core::Distribution::opposedRoll(attackerSkillLevel, defenderSkillLevel,
+			attackerBoons, 0, 0, defenderBanes, baseDiceCount);
+		return { "opposedRoll/base:" + std::to_string(baseDiceCount) + "/skills:" + std::to_string(attackerSkillLevel)
+				+ "-" + std::to_string(defenderSkillLevel) + "/attackerBoons:" + std::to_string(attackerBoons)
+				+ "/defenderBanes:" + std::to_string(defenderBanes),
+			{ { "winner", { odds.tie, odds.attacker, odds.defender }, false },
+			  { "critWin", { 1.0 - odds.critWin, odds.critWin }, false },
+			  { "critLoss", { 1.0 - odds.critLoss, odds.critLoss }, false },
+			  { "degrees", odds.degrees, true } }, false,
+			[=](Core::RngContext& rng, std::uint64_t rolls, Tally& tally) {
+				for (std::uint64_t i = 0; i < rolls; ++i)
+				{
+					const Core::OpposedRollResult result = Core::opposedRoll(rng, attackerSkillLevel, defenderSkillLevel,
+						attackerBoons, 0, 0, defenderBanes, baseDiceCount);
+					tally.count(0, static_cast<long long>(result.winner));
+					tally.count(1, result.critWin ? 1 : 0);
+					tally.count(2, result.critLoss ? 1 : 0);
+					tally.count(3, result.degree);
+				}
+			} };
+	}
+
+	// Function: buildGrid
+	// The common parameter grid, or a small slice of it for --quick.
+	std::vector<Case> buildGrid(bool quick)
+	{
+		std::vector<Case> cases;
+		const std::vector<int> diceSides = quick ? std::vector<int>{ 6, 20 } : std::vector<int>{ 2, 3, 4, 6, 8, 10, 12, 20, 100 };
+		for (bool packed : { false, true })
+		{
+			for (int sides : diceSides)
+			{
+				cases.push_back(diceCase(sides, packed));
+			}
+		}
+
+		// Base 3 d6 takes the DefaultDice path; the others exercise the generic kernels
+		struct Modifiers { int boons; int banes; };
+		const std::vector<Modifiers> modifiers = quick
+			? std::vector<Modifiers>{ { 0, 0 }, { 2, 0 }, { 0, 2 } }
+			: std::vector<Modifiers>{ { 0, 0 }, { 1, 0 }, { 2, 0 }, { 3, 0 }, { 5, 0 }, { 0, 1 }, { 0, 2 }, { 0, 3 }, { 2, 2 }, { 3, 1 } };
+		for (bool packed : { false, true })
+		{
+			for (int baseDiceCount : { 3, 4 })
+			{
+				for (const Modifiers& m : modifiers)
+				{
+					cases.push_back(skillCase(baseDiceCount, m.boons, m.banes, 6, packed));
+				}
+			}
+			if (not quick)
+			{
+				cases.push_back(skillCase(2, 1, 0, 10, packed));
+				cases.push_back(skillCase(3, 0, 2, 20, packed));
+			}
+		}
+
+		for (int difficulty : quick ? std::vector<int>{ 3 } : std::vector<int>{ 1, 3, 5, 8 })
+		{
+			for (const Modifiers& m : quick ? std::vector<Modifiers>{ { 1, 0 } } : std::vector<Modifiers>{ { 0, 0 }, { 2, 0 }, { 0, 2 } })
+			{
+				cases.push_back(targetCase(2, difficulty, m.boons, m.banes));
+			}
+		}
+
+		cases.push_back(opposedCase(0, 0, 0, 0, 3));
+		if (not quick)
+		{
+			cases.push_back(opposedCase(2, 1, 2, 1, 3));
+			cases.push_back(opposedCase(0, 3, 3, 0, 3));
+			cases.push_back(opposedCase(1, 1, 1, 2, 4));
+		}
+		return cases;
+	}//End of buildGrid
+
+	// Function: runCase
+	// Splits the case's rolls into chunks on separate RngContext streams, rolls them on the pool and merges
+	// the workers' tallies.
+	Tally runCase(const Case& testCase, std::size_t caseIndex, const Options& options, Core::ThreadPool& pool)
+	{
+		Tally empty;
+		for (const Histogram& histogram : testCase.histograms)
+		{
+			empty.histograms.emplace_back(histogram.expected.size(), 0);
+		}
+		std::vector<Tally> tallies(pool.size(), empty);
+
+		const std::uint64_t chunks = (options.rolls + CHUNK_ROLLS - 1) / CHUNK_ROLLS;
+		pool.parallelFor(static_cast<std::size_t>(chunks), [&](std::size_t chunk, unsigned worker) {
+			Core::RngContext rng(options.seed, (static_cast<std::uint64_t>(caseIndex) << 32) | chunk);
+			const std::uint64_t first = chunk * CHUNK_ROLLS;
+			testCase.roll(rng, std::min(CHUNK_ROLLS, options.rolls - first), tallies[worker]);
+			tallies[worker].serial.endSequence();
+		});
+
+		Tally merged = empty;
+		for (const Tally& tally : tallies)
+		{
+			for (std::size_t h = 0; h < merged.histograms.size(); ++h)
+			{
+				for (std::size_t bin = 0; bin < merged.histograms[h].size(); ++bin)
+				{
+					merged.histograms[h][bin] += tally.histograms[h][bin];
+				}
+			}
+			merged.serial.merge(tally.serial);
+			merged.inconsistencies += tally.inconsistencies;
+		}
+		return merged;
+	}//End of runCase
+
+	// Structure: Report
+	// Results of every test, printed once all cases have run.
+	struct Report
+	{
+		struct Line
+		{
+			std::string name;
+			Fairness::TestResult result;
+		};
+		std::vector<Line> lines;
+		std::vector<std::string> inconsistent; // Cases with impossible values or contradictory crit flags
+	};
+
+	void addTests(Report& report, const Case& testCase, const Tally& tally)
+	{
+		for (std::size_t h = 0; h < testCase.histograms.size(); ++h)
+		{
+			const Histogram& histogram = testCase.histograms[h];
+			const std::string prefix = testCase.name + " " + histogram.label;
+			report.lines.push_back({ prefix + " chi2", Fairness::chiSquaredTest(tally.histograms[h], histogram.expected) });
+			if (histogram.ordered)
+			{
+				report.lines.push_back({ prefix + " ks", Fairness::kolmogorovSmirnovTest(tally.histograms[h], histogram.expected) });
+			}
+		}
+		if (testCase.serial)
+		{
+			report.lines.push_back({ testCase.name + " serial", Fairness::serialCorrelationTest(tally.serial) });
+		}
+		if (tally.inconsistencies != 0)
+		{
+			report.inconsistent.push_back(testCase.name + ": " + std::to_string(tally.inconsistencies) + " inconsistent rolls");
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (not parseOptions(argc, argv, options))
+	{
+		std::fprintf(stderr, "Usage: Fairness [--rolls N] [--threads N] [--seed N] [--alpha A] [--quick]\n");
+		return 2;
+	}
+
+	Core::ThreadPool pool(options.threads);
+	const std::vector<Case> cases = buildGrid(options.quick);
+	std::printf("%zu cases x %llu rolls on %u threads, seed %llu\n", cases.size(),
+		static_cast<unsigned long long>(options.rolls), pool.size(), static_cast<unsigned long long>(options.seed));
+
+	const Clock::time_point start = Clock::now();
+	Report report;
+	for (std::size_t i = 0; i < cases.size(); ++i)
+	{
+		addTests(report, cases[i], runCase(cases[i], i, options, pool));
+	}
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	const double threshold = options.alpha / static_cast<double>(report.lines.size());
+	int failures = 0;
+	for (const Report::Line& line : report.lines)
+	{
+		const bool passed = line.result.pValue >= threshold;
+		failures += passed ? 0 : 1;
+		std::printf("%-72s %12.5g  p=%-10.4g %s\n", line.name.c_str(), line.result.statistic, line.result.pValue, passed ? "pass" : "FAIL");
+	}
+	for (const std::string& message : report.inconsistent)
+	{
+		std::printf("FAIL %s\n", message.c_str());
+	}
+	failures += static_cast<int>(report.inconsistent.size());
+
+	const double totalRolls = static_cast<double>(options.rolls) * static_cast<double>(cases.size());
+	std::printf("%zu tests, threshold p < %.3g, %d failed; %.3g rolls in %.1f s (%.3g rolls/s)\n",
+		report.lines.size(), threshold, failures, totalRolls, seconds, totalRolls / seconds);
+	return failures == 0 ? 0 : 1;
+}
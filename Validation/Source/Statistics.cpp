@@ -0,0 +1,211 @@
+#include "Statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	constexpr double MIN_EXPECTED_COUNT = 5.0; // Chi-squared bins are merged until they expect this many counts
+	constexpr int MAX_ITERATIONS = 10000;
+	constexpr double EPSILON = 1e-15;
+
+	// Function: regularizedGammaQ
+	// Q(a, x) = Gamma(a, x) / Gamma(a): a series for x < a + 1, a continued fraction (Lentz) otherwise.
+	double regularizedGammaQ(double a, double x)
+	{
+		if (x <= 0.0)
+		{
+			return 1.0;
+		}
+		const double logPrefix = a * std::log(x) - x - std::lgamma(a);
+
+		if (x < a + 1.0)
+		{
+			double term = 1.0 / a;
+			double sum = term;
+			for (int n = 1; n < MAX_ITERATIONS and std::abs(term) > std::abs(sum) * EPSILON; ++n)
+			{
+				term *= x / (a + n);
+				sum += term;
+			}
+			return std::max(0.0, 1.0 - sum * std::exp(logPrefix));
+		}
+
+		const double tiny = 1e-300;
+		double b = x + 1.0 - a;
+		double c = 1.0 / tiny;
+		double d = 1.0 / b;
+		double fraction = d;
+		for (int n = 1; n < MAX_ITERATIONS; ++n)
+		{
+			const double an = -n * (n - a);
+			b += 2.0;
+			d = an * d + b;
+			d = std::abs(d) < tiny ? tiny : d;
+			c = b + an / c;
+			c = std::abs(c) < tiny ? tiny : c;
+			d = 1.0 / d;
+			const double delta = d * c;
+			fraction *= delta;
+			if (std::abs(delta - 1.0) < EPSILON)
+			{
+				break;
+			}
+		}
+		return std::exp(logPrefix) * fraction;
+	}//End of regularizedGammaQ
+
+	// Function: kolmogorovPValue
+	// Upper tail of the Kolmogorov distribution, P(K > lambda).
+	double kolmogorovPValue(double lambda)
+	{
+		if (lambda < 0.2)
+		{
+			return 1.0;
+		}
+		double sum = 0.0;
+		double sign = 1.0;
+		for (int k = 1; k <= 100; ++k)
+		{
+			const double term = sign * std::exp(-2.0 * k * k * lambda * lambda);
+			sum += term;
+			if (std::abs(term) < 1e-16)
+			{
+				break;
+			}
+			sign = -sign;
+		}
+		return std::clamp(2.0 * sum, 0.0, 1.0);
+	}
+
+	std::uint64_t totalCount(std::span<const std::uint64_t> observed)
+	{
+		std::uint64_t total = 0;
+		for (std::uint64_t count : observed)
+		{
+			total += count;
+		}
+		return total;
+	}
+}
+
+//Statistics.cpp
+namespace Fairness
+{
+	double chiSquaredPValue(double statistic, double degreesOfFreedom)
+	{
+		return degreesOfFreedom <= 0.0 ? 1.0 : regularizedGammaQ(degreesOfFreedom / 2.0, statistic / 2.0);
+	}
+
+	// Function: chiSquaredTest
+	// Sweeps the bins in order, closing a merged bin once it expects MIN_EXPECTED_COUNT counts; a short
+	// remainder is folded into the last merged bin.
+	TestResult chiSquaredTest(std::span<const std::uint64_t> observed, std::span<const double> expected)
+	{
+		TestResult result;
+		const double total = static_cast<double>(totalCount(observed));
+		if (total == 0.0)
+		{
+			return result;
+		}
+
+		std::vector<double> mergedObserved;
+		std::vector<double> mergedExpected;
+		double pendingObserved = 0.0;
+		double pendingExpected = 0.0;
+		for (std::size_t i = 0; i < observed.size(); ++i)
+		{
+			const double probability = i < expected.size() ? expected[i] : 0.0;
+			if (probability <= 0.0 and observed[i] != 0)
+			{
+				result.statistic = INFINITY; // A value the distribution cannot produce
+				result.pValue = 0.0;
+				return result;
+			}
+			pendingObserved += static_cast<double>(observed[i]);
+			pendingExpected += probability * total;
+			if (pendingExpected >= MIN_EXPECTED_COUNT)
+			{
+				mergedObserved.push_back(pendingObserved);
+				mergedExpected.push_back(pendingExpected);
+				pendingObserved = pendingExpected = 0.0;
+			}
+		}
+		if (pendingExpected > 0.0 or pendingObserved > 0.0)
+		{
+			if (mergedObserved.empty())
+			{
+				mergedObserved.push_back(0.0);
+				mergedExpected.push_back(0.0);
+			}
+			mergedObserved.back() += pendingObserved;
+			mergedExpected.back() += pendingExpected;
+		}
+
+		for (std::size_t i = 0; i < mergedObserved.size(); ++i)
+		{
+			const double difference = mergedObserved[i] - mergedExpected[i];
+			result.statistic += difference * difference / mergedExpected[i];
+		}
+		result.degreesOfFreedom = static_cast<int>(mergedObserved.size()) - 1;
+		result.pValue = chiSquaredPValue(result.statistic, result.degreesOfFreedom);
+		return result;
+	}//End of chiSquaredTest
+
+	// Function: kolmogorovSmirnovTest
+	// D is the largest gap between the observed and expected CDFs at the bin boundaries.
+	TestResult kolmogorovSmirnovTest(std::span<const std::uint64_t> observed, std::span<const double> expected)
+	{
+		TestResult result;
+		const std::uint64_t total = totalCount(observed);
+		if (total == 0)
+		{
+			return result;
+		}
+
+		double observedCdf = 0.0;
+		double expectedCdf = 0.0;
+		for (std::size_t i = 0; i < observed.size(); ++i)
+		{
+			observedCdf += static_cast<double>(observed[i]) / static_cast<double>(total);
+			expectedCdf += i < expected.size() ? expected[i] : 0.0;
+			result.statistic = std::max(result.statistic, std::abs(observedCdf - expectedCdf));
+		}
+		const double root = std::sqrt(static_cast<double>(total));
+		result.pValue = kolmogorovPValue((root + 0.12 + 0.11 / root) * result.statistic);
+		return result;
+	}//End of kolmogorovSmirnovTest
+
+	void SerialCorrelation::merge(const SerialCorrelation& other)
+	{
+		count += other.count;
+		pairs += other.pairs;
+		sum += other.sum;
+		sumSquares += other.sumSquares;
+		sumProducts += other.sumProducts;
+	}
+
+	// Function: serialCorrelationTest
+	// Computes r from the exact integer sums in long double to avoid cancellation.
+	TestResult serialCorrelationTest(const SerialCorrelation& correlation)
+	{
+		TestResult result;
+		if (correlation.pairs < 2)
+		{
+			return result;
+		}
+		const long double mean = static_cast<long double>(correlation.sum) / correlation.count;
+		const long double variance = static_cast<long double>(correlation.sumSquares) / correlation.count - mean * mean;
+		if (variance <= 0.0L)
+		{
+			return result; // Constant sequence: nothing to correlate
+		}
+		const long double covariance = static_cast<long double>(correlation.sumProducts) / correlation.pairs - mean * mean;
+		const double r = static_cast<double>(covariance / variance);
+		const double z = r * std::sqrt(static_cast<double>(correlation.pairs));
+		result.statistic = r;
+		result.pValue = std::erfc(std::abs(z) / std::sqrt(2.0));
+		return result;
+	}//End of serialCorrelationTest
+}//End of Namespace Fairness
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+//Statistics.h
+// Goodness-of-fit tests for the fairness validator. Every test works on streaming counters (histograms and
+// running sums), so billions of rolls are checked without storing a single sample.
+namespace Fairness
+{
+	// Structure: TestResult
+	// Outcome of one hypothesis test. A small pValue means the observed rolls are unlikely under the
+	// expected distribution.
+	struct TestResult
+	{
+		double statistic = 0.0;
+		double pValue = 1.0;
+		int degreesOfFreedom = 0; // Chi-squared only
+	};
+
+	// Function: chiSquaredPValue
+	// Upper tail probability of the chi-squared distribution.
+	double chiSquaredPValue(double statistic, double degreesOfFreedom);
+
+	// Function: chiSquaredTest
+	// Pearson's chi-squared test of observed counts against expected probabilities. Neighbouring bins are
+	// merged until each expects at least 5 counts. A count in a bin of probability 0 gives a p-value of 0.
+	TestResult chiSquaredTest(std::span<const std::uint64_t> observed, std::span<const double> expected);
+
+	// Function: kolmogorovSmirnovTest
+	// Kolmogorov-Smirnov test of observed counts against expected probabilities over ordered bins. The
+	// asymptotic p-value is conservative for discrete distributions.
+	TestResult kolmogorovSmirnovTest(std::span<const std::uint64_t> observed, std::span<const double> expected);
+
+	// Structure: SerialCorrelation
+	// Exact running sums for the lag-1 autocorrelation of integer values. Sequences accumulated separately
+	// (one per chunk of rolls) can be merged; only pairs within a sequence are counted.
+	struct SerialCorrelation
+	{
+		std::uint64_t count = 0;      // Values
+		std::uint64_t pairs = 0;      // Consecutive pairs
+		std::int64_t sum = 0;
+		std::int64_t sumSquares = 0;
+		std::int64_t sumProducts = 0; // Sum of value[i] * value[i + 1]
+		std::int64_t previous = 0;
+		bool hasPrevious = false;
+
+		void add(int value)
+		{
+			if (hasPrevious)
+			{
+				sumProducts += previous * value;
+				++pairs;
+			}
+			previous = value;
+			hasPrevious = true;
+			sum += value;
+			sumSquares += static_cast<std::int64_t>(value) * value;
+			++count;
+		}
+
+		// Function: endSequence
+		// Starts a new sequence, so the next value does not pair with the last one.
+		void endSequence() { hasPrevious = false; }
+
+		void merge(const SerialCorrelation& other);
+	};
+
+	// Function: serialCorrelationTest
+	// Tests that the lag-1 autocorrelation is 0. The statistic is the correlation coefficient r, and
+	// r * sqrt(pairs) is approximately standard normal for independent values.
+	TestResult serialCorrelationTest(const SerialCorrelation& correlation);
+}//End of Namespace Fairness
@@ -0,0 +1,378 @@
+#include "harness.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#include "Core/Arena.h"
+#include "Core/Core.h"
+#include "Core/DicePrefetcher.h"
+#include "Core/Dice.h"
+#include "Core/DiceExpression.h"
+#include "Core/Distribution.h"
+#include "Core/Encounter.h"
+#include "Core/Journal.h"
+#include "Core/OutcomeTables.h"
+#include "Core/RollScheduler.h"
+#include "Core/Roster.h"
+
+// Benchmarks for the Core roll paths. Usage:
+//   bench [--filter=substring] [--json=path|-] [--min-time=seconds] [--threads=N] [--list]
+
+namespace
+{
+    // Boons/banes grid shared by the skill, opposed and target cases
+    struct Modifiers
+    {
+        int boons;
+        int banes;
+    };
+    constexpr Modifiers MODIFIER_GRID[] = { { 0, 0 }, { 2, 0 }, { 0, 2 }, { 5, 0 }, { 2, 2 } };
+    constexpr int BASE_DICE_GRID[] = { 3, 5 };
+    constexpr std::size_t BATCH_ROWS = 1024;
+
+    std::string suffix(int baseDiceCount, const Modifiers& modifiers)
+    {
+        return "/base:" + std::to_string(baseDiceCount) + "/boons:" + std::to_string(modifiers.boons)
+            + "/banes:" + std::to_string(modifiers.banes);
+    }
+
+    void addRollDice(std::vector<Bench::Case>& cases)
+    {
+        for (int count : { 1, 3, 8, 32 })
+        {
+            cases.push_back({ "rollDice/count:" + std::to_string(count), static_cast<std::uint64_t>(count), 1,
+                [count](Core::RngContext& rng, std::uint64_t ops) {
+                    for (std::uint64_t i = 0; i < ops; ++i) Bench::keep(Core::rollDice(rng, count, 6, 1).back());
+                } });
+        }
+        cases.push_back({ "rollDiceBatch/count:1024", 1024, 1, [](Core::RngContext& rng, std::uint64_t ops) {
+            std::vector<int> dice(1024);
+            for (std::uint64_t i = 0; i < ops; ++i)
+            {
+                Core::rollDiceBatch(rng, dice, 6, 1);
+                Bench::keep(dice.back());
+            }
+        } });
+    }
+
+    // Several dice per random word through PackedDice, against the one-word-per-die cases above
+    void addPackedDice(std::vector<Bench::Case>& cases)
+    {
+        cases.push_back({ "PackedDice::fill/count:1024", 1024, 1, [](Core::RngContext& rng, std::uint64_t ops) {
+            Core::PackedDice source(rng);
+            std::vector<int> dice(1024);
+            for (std::uint64_t i = 0; i < ops; ++i)
+            {
+                source.fill(dice, 1, 6);
+                Bench::keep(dice.back());
+            }
+        } });
+        for (const Modifiers& m : { MODIFIER_GRID[0], MODIFIER_GRID[1] })
+        {
+            cases.push_back({ "PackedDice/skillRoll" + suffix(3, m), 1, 1, [m](Core::RngContext& rng, std::uint64_t ops) {
+                Core::PackedDice source(rng);
+                for (std::uint64_t i = 0; i < ops; ++i) Bench::keep(Core::skillRoll(source, 2, m.boons, m.banes).total);
+            } });
+            cases.push_back({ "PackedDice/skillRoll" + suffix(5, m), 1, 1, [m](Core::RngContext& rng, std::uint64_t ops) {
+                Core::PackedDice source(rng);
+                for (std::uint64_t i = 0; i < ops; ++i) Bench::keep(Core::skillRoll(source, 2, m.boons, m.banes, 5, 6, 1).total);
+            } });
+        }
+    }
+
+    void addPrefetchedDice(std::vector<Bench::Case>& cases)
+    {
+        auto prefetcher = std::make_shared<Core::DicePrefetcher>();
+        for (const Modifiers& m : { MODIFIER_GRID[0], MODIFIER_GRID[1] })
+        {
+            cases.push_back({ "PrefetchedDice/skillRoll" + suffix(3, m), 1, 1, [prefetcher, m](Core::RngContext& rng, std::uint64_t ops) {
+                Core::PrefetchedDice source(*prefetcher, rng);
+                for (std::uint64_t i = 0; i < ops; ++i) Bench::keep(Core::skillRoll(source, 2, m.boons, m.banes).total);
+            } });
+        }
+    }
+
+    void addDicePlans(std::vector<Bench::Case>& cases)
+    {
+        for (const Modifiers& m : { MODIFIER_GRID[0], MODIFIER_GRID[1] })
+        {
+            std::shared_ptr<const Core::DicePlan> plan(new Core::DicePlan(*Core::DicePlan::skill(2, m.boons, m.banes)));
+            cases.push_back({ "DicePlan/skill" + suffix(3, m), 1, 1, [plan](Core::RngContext& rng, std::uint64_t ops) {
+                for (std::uint64_t i = 0; i < ops; ++i) Bench::keep(plan->roll(rng).total);
+            } });
+        }
+        const Core::DicePlan* exploding = Core::DicePlan::cached("4d6!kh3+2");
+        cases.push_back({ "DicePlan/4d6!kh3+2", 1, 1, [exploding](Core::RngContext& rng, std::uint64_t ops) {
+            for (std::uint64_t i = 0; i < ops; ++i) Bench::keep(exploding->roll(rng).total);
+        } });
+        const Core::DicePlan* kept = Core::DicePlan::cached("4d6kh3+2");
+        cases.push_back({ "DicePlan::rollBatch/4d6kh3+2/count:1024", 1024, 1, [kept](Core::RngContext& rng, std::uint64_t ops) {
+            std::vector<int> totals(1024);
+            for (std::uint64_t i = 0; i < ops; ++i)
+            {
+                kept->rollBatch(rng, totals.size(), { totals, {}, {}, {} });
+                Bench::keep(totals.back());
+            }
+        } });
+    }
+
+    void addSkillRolls(std::vector<Bench::Case>& cases, unsigned threads)
+    {
+        const std::string threadSuffix = threads > 1 ? "/threads:" + std::to_string(threads) : "";
+        for (int base : BASE_DICE_GRID)
+        {
+            for (const Modifiers& m : MODIFIER_GRID)
+            {
+                cases.push_back({ "skillRoll" + suffix(base, m) + threadSuffix, 1, threads,
+                    [base, m](Core::RngContext& rng, std::uint64_t ops) {
+                        for (std::uint64_t i = 0; i < ops; ++i)
+                            Bench::keep(Core::skillRoll(rng, 2, m.boons, m.banes, base, 6, 1).total);
+                    } });
+                cases.push_back({ "opposedRoll" + suffix(base, m) + threadSuffix, 2, threads,
+                    [base, m](Core::RngContext& rng, std::uint64_t ops) {
+                        for (std::uint64_t i = 0; i < ops; ++i)
+                            Bench::keep(Core::opposedRoll(rng, 3, 2, m.boons, m.banes, m.banes, m.boons, base, 6, 1).degree);
+                    } });
+                cases.push_back({ "targetRoll" + suffix(base, m) + threadSuffix, 1, threads,
+                    [base, m](Core::RngContext& rng, std::uint64_t ops) {
+                        for (std::uint64_t i = 0; i < ops; ++i)
+                            Bench::keep(Core::targetRoll(rng, 4, 4, m.boons, m.banes, base, 6, 1).degree);
+                    } });
+            }
+        }
+    }
+
+    void addSpecializedPaths(std::vector<Bench::Case>& cases)
+    {
+        for (const Modifiers& m : MODIFIER_GRID)
+        {
+            cases.push_back({ "Dice<3,6,1>::skillRoll" + suffix(3, m), 1, 1, [m](Core::RngContext& rng, std::uint64_t ops) {
+                for (std::uint64_t i = 0; i < ops; ++i) Bench::keep(Core::Dice<3, 6, 1>::skillRoll(rng, 2, m.boons, m.banes).total);
+            } });
+            cases.push_back({ "OutcomeTables::sampleTargetRoll" + suffix(3, m), 1, 1, [m](Core::RngContext& rng, std::uint64_t ops) {
+                for (std::uint64_t i = 0; i < ops; ++i)
+                    Bench::keep(Core::OutcomeTables::sampleTargetRoll(rng, 4, 4, m.boons, m.banes).degree);
+            } });
+        }
+    }
+
+    // Twelve-die pools spill out of DiceRolls: heap allocation per roll versus an arena reset per turn
+    void addArena(std::vector<Bench::Case>& cases)
+    {
+        constexpr std::uint64_t ROLLS_PER_TURN = 64;
+        cases.push_back({ "skillRoll/base:12/heap", 1, 1, [](Core::RngContext& rng, std::uint64_t ops) {
+            for (std::uint64_t i = 0; i < ops; ++i) Bench::keep(Core::skillRoll(rng, 2, 1, 0, 12).rolls.size());
+        } });
+        cases.push_back({ "skillRoll/base:12/arena", 1, 1, [](Core::RngContext& rng, std::uint64_t ops) {
+            Core::Arena arena;
+            for (std::uint64_t i = 0; i < ops; ++i)
+            {
+                Bench::keep(Core::skillRoll(rng, &arena, 2, 1, 0, 12).rolls.size());
+                if (i % ROLLS_PER_TURN == ROLLS_PER_TURN - 1) arena.reset();
+            }
+        } });
+    }
+
+    void addBatches(std::vector<Bench::Case>& cases)
+    {
+        for (int base : BASE_DICE_GRID)
+        {
+            for (const Modifiers& m : MODIFIER_GRID)
+            {
+                cases.push_back({ "opposedRollBatch" + suffix(base, m) + "/rows:1024", BATCH_ROWS, 1,
+                    [base, m](Core::RngContext& rng, std::uint64_t ops) {
+                        std::vector<int> skills(BATCH_ROWS, 3), boons(BATCH_ROWS, m.boons), banes(BATCH_ROWS, m.banes);
+                        std::vector<Core::Winner> winners(BATCH_ROWS);
+                        std::vector<int> degrees(BATCH_ROWS);
+                        for (std::uint64_t i = 0; i < ops; ++i)
+                        {
+                            Core::opposedRollBatch(rng, { skills, skills, boons, banes, banes, boons },
+                                { winners, degrees, {}, {}, {}, {} }, base, 6, 1);
+                            Bench::keep(degrees.back());
+                        }
+                    } });
+            }
+        }
+    }
+
+    void addEncounter(std::vector<Bench::Case>& cases, Core::ThreadPool& pool)
+    {
+        for (unsigned combatants : { 200u, 2000u })
+        {
+            cases.push_back({ "Encounter::resolveRound/combatants:" + std::to_string(combatants), combatants, 1,
+                [combatants, &pool](Core::RngContext& rng, std::uint64_t ops) {
+                    Core::Encounter encounter(combatants);
+                    encounter.setConditionEffect(0, 0, 1);
+                    std::vector<Core::Pairing> pairings;
+                    for (Core::CombatantId i = 0; i < combatants; ++i)
+                    {
+                        encounter.addCombatant(static_cast<int>(i % 7), static_cast<int>(i % 3), 0, i % 2);
+                        pairings.push_back({ i, (i * 31 + 7) % combatants });
+                    }
+                    std::vector<Core::Winner> winners(combatants);
+                    for (std::uint64_t i = 0; i < ops; ++i)
+                    {
+                        encounter.resolveRound(rng, pairings, { winners, {}, {}, {}, {}, {} }, pool.size() > 1 ? &pool : nullptr);
+                        Bench::keep(winners.back());
+                    }
+                } });
+        }
+    }
+
+    void addJournal(std::vector<Bench::Case>& cases)
+    {
+        const std::string path = (std::filesystem::temp_directory_path() / "core_bench_journal.bin").string();
+        cases.push_back({ "JournalWriter::targetRoll" + suffix(3, MODIFIER_GRID[1]), 1, 1, [path](Core::RngContext& rng, std::uint64_t ops) {
+            Core::JournalWriter writer;
+            writer.open(path);
+            for (std::uint64_t i = 0; i < ops; ++i)
+                Bench::keep(writer.targetRoll(rng, 4, static_cast<int>(i & 7), 2, 0).degree);
+        } });
+    }
+
+    void addOpposedMatrix(std::vector<Bench::Case>& cases, Core::ThreadPool& pool)
+    {
+        constexpr std::size_t SIDE = 2048;
+        cases.push_back({ "Distribution::opposedMatrix/2048x2048", SIDE * SIDE, 1, [&pool](Core::RngContext&, std::uint64_t ops) {
+            std::vector<int> skills(SIDE), boons(SIDE), banes(SIDE);
+            for (std::size_t i = 0; i < SIDE; ++i)
+            {
+                skills[i] = static_cast<int>(i % 13);
+                boons[i] = static_cast<int>(i % 4);
+                banes[i] = static_cast<int>(i % 3);
+            }
+            std::vector<float> attacker(SIDE * SIDE), defender(SIDE * SIDE), tie(SIDE * SIDE);
+            for (std::uint64_t i = 0; i < ops; ++i)
+            {
+                Core::Distribution::opposedMatrix({ skills, boons, banes }, { skills, banes, boons },
+                    { attacker, defender, tie }, 3, 6, 1, &pool);
+                Bench::keep(attacker.back());
+            }
+        } });
+    }
+
+    // Script for the scheduler case: `rolls` skill rolls in a row
+    Core::RollTask rollingScript(Core::RollScheduler& scheduler, int skill, int rolls)
+    {
+        for (int i = 0; i < rolls; ++i)
+        {
+            Bench::keep((co_await scheduler.skillRoll(skill, 1, 0)).total);
+        }
+    }
+
+    void addRollScheduler(std::vector<Bench::Case>& cases)
+    {
+        constexpr int SCRIPTS = 1024;
+        constexpr int ROLLS = 16;
+        cases.push_back({ "RollScheduler/skillRoll/scripts:1024", SCRIPTS * ROLLS, 1, [](Core::RngContext& rng, std::uint64_t ops) {
+            for (std::uint64_t i = 0; i < ops; ++i)
+            {
+                Core::RollScheduler scheduler(rng.stream(i));
+                for (int script = 0; script < SCRIPTS; ++script)
+                {
+                    scheduler.spawn(rollingScript(scheduler, script % 7, ROLLS));
+                }
+                scheduler.run();
+            }
+        } });
+    }
+
+    void addRoster(std::vector<Bench::Case>& cases, Core::ThreadPool& pool)
+    {
+        constexpr std::size_t RECORDS = 1 << 16;
+        const std::string path = (std::filesystem::temp_directory_path() / "core_bench_roster.bin").string();
+        cases.push_back({ "Roster/targetRollSweep/records:65536", RECORDS, 1, [path, &pool](Core::RngContext&, std::uint64_t ops) {
+            std::vector<std::uint64_t> ids(RECORDS);
+            std::vector<std::uint32_t> tags(RECORDS);
+            std::vector<std::int8_t> boons(RECORDS), banes(RECORDS), levels(RECORDS);
+            for (std::size_t i = 0; i < RECORDS; ++i)
+            {
+                ids[i] = i;
+                tags[i] = static_cast<std::uint32_t>(i % 4);
+                boons[i] = static_cast<std::int8_t>(i % 3);
+                levels[i] = static_cast<std::int8_t>(i % 7);
+            }
+            Core::Roster roster;
+            if (not Core::writeRoster(path, { ids, tags, boons, banes, { "skill" }, { levels } }) or not roster.open(path))
+            {
+                return;
+            }
+            Core::RosterSweepOptions options;
+            options.pool = &pool;
+            Core::Stats::RollStats stats;
+            for (std::uint64_t i = 0; i < ops; ++i)
+            {
+                options.seed = i;
+                Core::targetRollSweep(roster, {}, 3, stats, {}, options);
+                Bench::keep(stats.rolls);
+            }
+        } });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Bench::Options options;
+    if (not Bench::parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: bench [--filter=substring] [--json=path|-] [--min-time=seconds] [--threads=N] [--list]\n";
+        return 2;
+    }
+
+    std::unique_ptr<Core::ThreadPool> pool = std::make_unique<Core::ThreadPool>(options.threads);
+    std::vector<Bench::Case> cases;
+    addRollDice(cases);
+    addPackedDice(cases);
+    addPrefetchedDice(cases);
+    addDicePlans(cases);
+    addSkillRolls(cases, 1);
+    addSpecializedPaths(cases);
+    addArena(cases);
+    addBatches(cases);
+    addEncounter(cases, *pool);
+    addJournal(cases);
+    addRollScheduler(cases);
+    addRoster(cases, *pool);
+    addOpposedMatrix(cases, *pool);
+    if (pool->size() > 1)
+    {
+        addSkillRolls(cases, pool->size());
+    }
+
+    std::vector<Bench::Result> results;
+    for (const Bench::Case& benchCase : cases)
+    {
+        if (benchCase.name.find(options.filter) == std::string::npos)
+        {
+            continue;
+        }
+        if (options.list)
+        {
+            std::cout << benchCase.name << '\n';
+            continue;
+        }
+        std::cerr << "Running " << benchCase.name << '\n';
+        results.push_back(Bench::runCase(benchCase, options, *pool));
+    }
+    if (options.list)
+    {
+        return 0;
+    }
+
+    if (options.jsonPath == "-")
+    {
+        Bench::writeJson(std::cout, results, options);
+    }
+    else
+    {
+        Bench::writeTable(std::cout, results);
+        if (not options.jsonPath.empty())
+        {
+            std::ofstream json(options.jsonPath);
+            Bench::writeJson(json, results, options);
+        }
+    }
+    return 0;
+}
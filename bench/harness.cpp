@@ -0,0 +1,251 @@
+#include "harness.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <thread>
+
+#include "Core/DiceKernels.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::atomic<std::uint64_t> g_allocations{ 0 };
+
+    // Class: CacheMissCounter
+    // Counts last-level cache misses of the calling thread through perf_event_open where permitted.
+    class CacheMissCounter
+    {
+    public:
+        CacheMissCounter()
+        {
+#if defined(__linux__)
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        ~CacheMissCounter()
+        {
+#if defined(__linux__)
+            if (m_fd >= 0)
+            {
+                close(m_fd);
+            }
+#endif
+        }
+
+        void start()
+        {
+#if defined(__linux__)
+            if (m_fd >= 0)
+            {
+                ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        // Function: stop
+        // Returns the misses since start(), or -1 if the counter is unavailable.
+        long long stop()
+        {
+#if defined(__linux__)
+            if (m_fd >= 0)
+            {
+                ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+                long long count = 0;
+                if (read(m_fd, &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count)))
+                {
+                    return count;
+                }
+            }
+#endif
+            return -1;
+        }
+
+    private:
+        int m_fd = -1;
+    };
+
+    // Function: runOnce
+    // Runs `ops` operations of a case and returns the elapsed seconds.
+    double runOnce(const Bench::Case& benchCase, std::uint64_t ops, Core::ThreadPool& pool)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (benchCase.threads <= 1)
+        {
+            Core::RngContext rng(1);
+            benchCase.body(rng, ops);
+        }
+        else
+        {
+            const unsigned chunks = benchCase.threads;
+            pool.parallelFor(chunks, [&](std::size_t chunk, unsigned) {
+                Core::RngContext rng(1, chunk);
+                benchCase.body(rng, ops / chunks + (chunk < ops % chunks ? 1 : 0));
+            });
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void writeJsonString(std::ostream& out, const std::string& text)
+    {
+        out << '"';
+        for (char c : text)
+        {
+            if (c == '"' or c == '\\') out << '\\';
+            out << c;
+        }
+        out << '"';
+    }
+}
+
+// Every heap allocation in the bench process goes through these, so allocations per op can be counted.
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace Bench
+{
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument = argv[i];
+            auto value = [&argument](const char* prefix) -> const char* {
+                std::size_t length = std::strlen(prefix);
+                return argument.compare(0, length, prefix) == 0 ? argument.c_str() + length : nullptr;
+            };
+
+            if (const char* filter = value("--filter=")) options.filter = filter;
+            else if (const char* json = value("--json=")) options.jsonPath = json;
+            else if (const char* minTime = value("--min-time=")) options.minSeconds = std::atof(minTime);
+            else if (const char* threads = value("--threads=")) options.threads = static_cast<unsigned>(std::atoi(threads));
+            else if (argument == "--list") options.list = true;
+            else return false;
+        }
+        return true;
+    }
+
+    std::uint64_t allocationCount()
+    {
+        return g_allocations.load(std::memory_order_relaxed);
+    }
+
+    Result runCase(const Case& benchCase, const Options& options, Core::ThreadPool& pool)
+    {
+        // Grow the operation count until one run takes long enough to measure
+        std::uint64_t ops = 1;
+        double seconds = runOnce(benchCase, ops, pool);
+        while (seconds < options.minSeconds)
+        {
+            double scale = seconds > 0.0 ? options.minSeconds * 1.2 / seconds : 100.0;
+            scale = scale < 2.0 ? 2.0 : (scale > 100.0 ? 100.0 : scale);
+            ops = static_cast<std::uint64_t>(static_cast<double>(ops) * scale);
+            seconds = runOnce(benchCase, ops, pool);
+        }
+
+        // Measured run, with allocation and (single-threaded) cache miss counts
+        CacheMissCounter cacheMisses;
+        std::uint64_t allocationsBefore = allocationCount();
+        if (benchCase.threads <= 1) cacheMisses.start();
+        seconds = runOnce(benchCase, ops, pool);
+        long long misses = benchCase.threads <= 1 ? cacheMisses.stop() : -1;
+        std::uint64_t allocations = allocationCount() - allocationsBefore;
+
+        Result result;
+        result.name = benchCase.name;
+        result.threads = benchCase.threads;
+        result.ops = ops;
+        result.seconds = seconds;
+        result.nsPerOp = seconds * 1e9 / static_cast<double>(ops);
+        result.rollsPerSecond = static_cast<double>(ops * benchCase.rollsPerOp) / seconds;
+        result.allocationsPerOp = static_cast<double>(allocations) / static_cast<double>(ops);
+        result.cacheMissesPerOp = misses < 0 ? -1.0 : static_cast<double>(misses) / static_cast<double>(ops);
+        return result;
+    }
+
+    void writeTable(std::ostream& out, const std::vector<Result>& results)
+    {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-60s %10s %14s %10s %12s\n", "Benchmark", "ns/op", "rolls/s", "allocs/op", "misses/op");
+        out << line;
+        for (const Result& result : results)
+        {
+            char misses[32] = "n/a";
+            if (result.cacheMissesPerOp >= 0.0)
+            {
+                std::snprintf(misses, sizeof(misses), "%.3f", result.cacheMissesPerOp);
+            }
+            std::snprintf(line, sizeof(line), "%-60s %10.1f %14.4g %10.3f %12s\n", result.name.c_str(),
+                result.nsPerOp, result.rollsPerSecond, result.allocationsPerOp, misses);
+            out << line;
+        }
+    }
+
+    void writeJson(std::ostream& out, const std::vector<Result>& results, const Options& options)
+    {
+        std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        out << "{\n  \"context\": {\n";
+        out << "    \"date\": \"" << date << "\",\n";
+        out << "    \"hardwareConcurrency\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"instructionSet\": \""
+            << (Core::Kernels::activeKernelTable().instructionSet == Core::Kernels::InstructionSet::AVX2 ? "AVX2" : "SCALAR") << "\",\n";
+        out << "    \"minSeconds\": " << options.minSeconds << "\n  },\n";
+        out << "  \"benchmarks\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            out << "    { \"name\": ";
+            writeJsonString(out, result.name);
+            out << ", \"threads\": " << result.threads
+                << ", \"ops\": " << result.ops
+                << ", \"seconds\": " << result.seconds
+                << ", \"nsPerOp\": " << result.nsPerOp
+                << ", \"rollsPerSecond\": " << result.rollsPerSecond
+                << ", \"allocationsPerOp\": " << result.allocationsPerOp
+                << ", \"cacheMissesPerOp\": ";
+            if (result.cacheMissesPerOp < 0.0) out << "null";
+            else out << result.cacheMissesPerOp;
+            out << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+}
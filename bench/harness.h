@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Core/Rng.h"
+#include "Core/ThreadPool.h"
+
+// Small self-contained benchmark harness for the Core roll paths.
+//
+// Each case runs a body for a calibrated number of operations and reports wall time per operation,
+// rolls per second, heap allocations per operation (counted by the harness's global operator new) and,
+// on Linux when perf events are permitted, last-level cache misses per operation for single-threaded cases.
+// Results print as a table and can be written as JSON for diffing runs over time.
+namespace Bench
+{
+    // Body signature: run `ops` operations drawing from `rng`.
+    using Body = std::function<void(Core::RngContext& rng, std::uint64_t ops)>;
+
+    // Structure: Case
+    // One benchmark. Multi-threaded cases split their operations over the pool's workers, each worker
+    // drawing from its own stream.
+    struct Case
+    {
+        std::string name;
+        std::uint64_t rollsPerOp; // Rolls resolved by one operation (dice for rollDice, rows for batches)
+        unsigned threads;         // 1 for single-threaded cases
+        Body body;
+    };
+
+    // Structure: Result
+    // Measurements of one case.
+    struct Result
+    {
+        std::string name;
+        unsigned threads;
+        std::uint64_t ops;
+        double seconds;
+        double nsPerOp;
+        double rollsPerSecond;
+        double allocationsPerOp;
+        double cacheMissesPerOp; // Negative if not measured
+    };
+
+    // Structure: Options
+    // Command line options of the bench executable.
+    struct Options
+    {
+        std::string filter;        // Only run cases whose name contains this
+        std::string jsonPath;      // Write JSON results here if not empty ("-" for stdout)
+        double minSeconds = 0.25;  // Minimum measured time per case
+        unsigned threads = 0;      // Workers for multi-threaded cases (0: hardware concurrency)
+        bool list = false;         // Print case names and exit
+    };
+
+    // Function: parseOptions
+    // Parses --filter=, --json=, --min-time=, --threads= and --list. Returns false on unknown arguments.
+    bool parseOptions(int argc, char** argv, Options& options);
+
+    // Function: allocationCount
+    // Number of global operator new calls so far in the process.
+    std::uint64_t allocationCount();
+
+    // Function: runCase
+    // Calibrates the operation count until a run lasts at least minSeconds, then reports that run.
+    Result runCase(const Case& benchCase, const Options& options, Core::ThreadPool& pool);
+
+    // Function: writeTable
+    // Prints results as an aligned text table.
+    void writeTable(std::ostream& out, const std::vector<Result>& results);
+
+    // Function: writeJson
+    // Writes results and run context as a JSON document.
+    void writeJson(std::ostream& out, const std::vector<Result>& results, const Options& options);
+
+    // Function: keep
+    // Prevents the compiler from discarding a computed value.
+    template <typename T>
+    inline void keep(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile T sink;
+        sink = value;
+#endif
+    }
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "Core/Arena.h"
+#include "Core/Core.h"
+
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+
+namespace {
+    // Upstream resource that counts what the arena asks it for
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        int allocations = 0;
+        int outstanding = 0;
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++allocations;
+            ++outstanding;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            --outstanding;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+}
+
+// Allocations are aligned, and after one turn a reset arena serves the same turn without the upstream
+TEST(ArenaTests, ResetReusesMemory) {
+    CountingResource upstream;
+    {
+        Core::Arena arena(256, &upstream);
+        int afterFirstTurn = 0;
+        for (int turn = 0; turn < 3; ++turn) {
+            for (int i = 0; i < 100; ++i) {
+                void* p = arena.allocate(24 + i % 8, i % 2 ? 16 : 4);
+                EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % (i % 2 ? 16 : 4), 0u);
+            }
+            EXPECT_GE(arena.bytesUsed(), 2400u);
+            arena.reset();
+            EXPECT_EQ(arena.bytesUsed(), 0u);
+            afterFirstTurn = turn == 0 ? upstream.allocations : afterFirstTurn;
+        }
+        // The first turn needed several blocks; reset merged them, and later turns needed nothing new
+        EXPECT_NE(arena.allocate(arena.capacity() / 2, 8), nullptr);
+        EXPECT_EQ(upstream.allocations, afterFirstTurn);
+        EXPECT_EQ(upstream.outstanding, 1);
+    }
+    EXPECT_EQ(upstream.outstanding, 0);
+}
+
+// The pmr overloads roll exactly like the plain ones and keep large pools in the arena
+TEST(ArenaTests, PmrOverloadsMatchPlainRolls) {
+    Core::Arena arena;
+    Core::RngContext plain(5);
+    Core::RngContext pooled(5);
+
+    std::pmr::vector<int> dice = Core::rollDice(pooled, &arena, 10, 20);
+    EXPECT_EQ(std::vector<int>(dice.begin(), dice.end()), Core::rollDice(plain, 10, 20));
+    EXPECT_EQ(dice.get_allocator().resource(), &arena);
+
+    for (int i = 0; i < 50; ++i) {
+        // 12 dice do not fit inline in DiceRolls, so they spill into the arena
+        Core::SkillRollResult a = Core::skillRoll(plain, 1, i % 4, 0, 12, 6, 1);
+        Core::SkillRollResult b = Core::skillRoll(pooled, &arena, 1, i % 4, 0, 12, 6, 1);
+        EXPECT_EQ(a.total, b.total);
+        EXPECT_EQ(a.rolls, b.rolls);
+        EXPECT_FALSE(b.rolls.isInline());
+
+        Core::OpposedRollResult c = Core::opposedRoll(plain, 1, 2, 0, 1, 1, 0, 3, 10, 1);
+        Core::OpposedRollResult d = Core::opposedRoll(pooled, &arena, 1, 2, 0, 1, 1, 0, 3, 10, 1);
+        EXPECT_EQ(c.winner, d.winner);
+        EXPECT_EQ(c.attackerRoll.rolls, d.attackerRoll.rolls);
+
+        Core::TargetRollResult e = Core::targetRoll(plain, 2, 3, 1, 0);
+        Core::TargetRollResult f = Core::targetRoll(pooled, &arena, 2, 3, 1, 0);
+        EXPECT_EQ(e.degree, f.degree);
+        EXPECT_EQ(e.roll.rolls, f.roll.rolls);
+    }
+    EXPECT_EQ(plain.position(), pooled.position());
+    EXPECT_GT(arena.bytesUsed(), 50 * 12 * sizeof(int));
+}
+
+// Results spilled into an arena, or into any resource passed with BlockRelease::NONE, may outlive its reset
+// and the resource itself and are still destroyed safely; other resources still get their blocks back
+TEST(ArenaTests, ResultsOutliveReset) {
+    auto arena = std::make_unique<Core::Arena>(256);
+    Core::RngContext rng(8);
+    std::vector<Core::SkillRollResult> results;
+    for (int i = 0; i < 20; ++i) {
+        results.push_back(Core::skillRoll(rng, arena.get(), 1, 0, 0, 12, 6, 1));
+        ASSERT_FALSE(results.back().rolls.isInline());
+    }
+
+    // Reuse the recycled memory so anything the destructors read from it is garbage
+    arena->reset();
+    std::memset(arena->allocate(arena->capacity(), 1), 0xA5, arena->capacity());
+    results.erase(results.begin(), results.begin() + 10);
+    arena.reset();
+    results.clear();
+
+    auto monotonic = std::make_unique<std::pmr::monotonic_buffer_resource>();
+    for (int i = 0; i < 10; ++i) {
+        results.push_back(Core::skillRoll(rng, { monotonic.get(), Core::BlockRelease::NONE }, 1, 0, 0, 12, 6, 1));
+    }
+    monotonic->release();
+    monotonic.reset();
+    results.clear();
+
+    CountingResource counting;
+    {
+        const std::vector<int> dice(12, 3);
+        Core::DiceRolls rolls(dice, &counting);
+        EXPECT_EQ(counting.outstanding, 1);
+    }
+    EXPECT_EQ(counting.outstanding, 0);
+}
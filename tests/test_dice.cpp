@@ -26,3 +26,65 @@ TEST(CoreTests, TargetRoll) {
     EXPECT_FALSE(result.critSuccess && result.critFailure); // Cannot be both critSuccess and critFailure
     EXPECT_GE(result.degree, -5);                    // Degree should make sense
 }
+
+// Test for skillRollBatch function
+TEST(CoreTests, SkillRollBatch) {
+    const int skillLevels[] = { 0, 2, 4, 6 };
+    const int boons[] = { 0, 2, 0, 1 };
+    const int banes[] = { 0, 0, 3, 1 };
+    int totals[4];
+    bool critSuccess[4];
+    bool critFailure[4];
+    int dice[4 * 3];
+
+    ASSERT_TRUE(Core::skillRollBatch({ skillLevels, boons, banes }, { totals, critSuccess, critFailure, dice }, 3, 6, 1));
+    for (int i = 0; i < 4; ++i) {
+        int diceTotal = 0;
+        for (int d = 0; d < 3; ++d) {
+            EXPECT_GE(dice[i * 3 + d], 1);
+            EXPECT_LE(dice[i * 3 + d], 6);
+            diceTotal += dice[i * 3 + d];
+        }
+        EXPECT_EQ(totals[i], skillLevels[i] + diceTotal); // Total is the selected dice plus skill
+        EXPECT_EQ(critSuccess[i], diceTotal == 18);
+        EXPECT_EQ(critFailure[i], diceTotal == 3);
+    }
+}
+
+// Test for batch span validation
+TEST(CoreTests, BatchRejectsMisSizedSpans) {
+    const int skillLevels[] = { 1, 2 };
+    const int difficultyLevels[] = { 3, 3 };
+    const int zeros[] = { 0, 0 };
+    bool successes[1];
+    EXPECT_FALSE(Core::targetRollBatch({ skillLevels, difficultyLevels, zeros, zeros }, { successes, {}, {} }));
+
+    int dice[2 * 3];
+    Core::Winner winners[2];
+    EXPECT_TRUE(Core::opposedRollBatch({ skillLevels, skillLevels, zeros, zeros, zeros, zeros },
+        { winners, {}, {}, {}, { {}, {}, {}, dice }, {} }));
+}
+
+// Test for DiceRolls inline and spilled storage
+TEST(CoreTests, DiceRollsStorage) {
+    Core::DiceRolls small{ 6, 1, 4 };
+    EXPECT_TRUE(small.isInline());
+    EXPECT_EQ(small.toVector(), (std::vector<int>{ 6, 1, 4 }));
+
+    Core::DiceRolls wide{ -1000, 1000 };  // Value range too wide for 8-bit offsets
+    Core::DiceRolls many{ 1, 2, 3, 4, 5, 6, 1, 2, 3, 4 };
+    EXPECT_FALSE(wide.isInline());
+    EXPECT_FALSE(many.isInline());
+
+    Core::DiceRolls copy = many;
+    EXPECT_EQ(copy, many);
+    EXPECT_EQ(std::accumulate(copy.begin(), copy.end(), 0), 31);
+    copy = small;
+    EXPECT_EQ(copy, small);
+    EXPECT_EQ(wide[0], -1000);
+
+    Core::SkillRollResult result = Core::skillRoll(5, 2, 0, 3, 6, 1);
+    ASSERT_EQ(result.rolls.size(), 3u);
+    EXPECT_TRUE(result.rolls.isInline());
+    EXPECT_EQ(result.total, 5 + std::accumulate(result.rolls.begin(), result.rolls.end(), 0));
+}
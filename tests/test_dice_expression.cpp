@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+#include "Core/DiceExpression.h"
+#include "Core/Distribution.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+
+// Expressions compile into terms and a canonical form
+TEST(DiceExpressionTests, Compiles) {
+    std::optional<Core::DicePlan> plan = Core::DicePlan::compile(" 4 d6 k3 + 1 + 1");
+    ASSERT_TRUE(plan);
+    EXPECT_EQ(plan->expression(), "4d6kh3+2");
+    ASSERT_EQ(plan->terms().size(), 1u);
+    EXPECT_EQ(plan->terms()[0].kept, 3);
+    EXPECT_EQ(plan->minTotal(), 5);
+    EXPECT_EQ(plan->maxTotal(), 20);
+
+    EXPECT_EQ(Core::DicePlan::compile("3d6!")->expression(), "3d6!");
+    EXPECT_EQ(Core::DicePlan::compile("2d10kl1")->expression(), "2d10kl1");
+    EXPECT_EQ(Core::DicePlan::compile("4d6dl1")->expression(), "4d6kh3");
+    EXPECT_EQ(Core::DicePlan::compile("-d4+2d8r2-3")->expression(), "-1d4+2d8r2-3");
+    EXPECT_EQ(Core::DicePlan::compile("3d6kh3")->expression(), "3d6");
+    EXPECT_EQ(Core::DicePlan::compile("7")->expression(), "7");
+    EXPECT_EQ(Core::DicePlan::compile("1d6!")->maxTotal(), 6 * (Core::DicePlan::MAX_EXPLOSIONS + 1));
+
+    std::string error;
+    EXPECT_FALSE(Core::DicePlan::compile("", &error));
+    EXPECT_FALSE(Core::DicePlan::compile("3d6kh4", &error));
+    EXPECT_EQ(error, "Keep count out of range at position 6");
+    EXPECT_FALSE(Core::DicePlan::compile("3d6x", &error));
+    EXPECT_FALSE(Core::DicePlan::compile("3d6!!"));
+    EXPECT_FALSE(Core::DicePlan::compile("3d1!"));
+    EXPECT_FALSE(Core::DicePlan::compile("3d6r6"));
+    EXPECT_FALSE(Core::DicePlan::compile("3d6dl3"));
+    EXPECT_FALSE(Core::DicePlan::compile("0d6"));
+    EXPECT_FALSE(Core::DicePlan::compile("3d6+"));
+    EXPECT_FALSE(Core::DicePlan::compile("99999999999"));
+
+    // Cached plans are compiled once
+    const Core::DicePlan* cached = Core::DicePlan::cached("4d6kh3+2");
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cached, Core::DicePlan::cached("4d6kh3+2"));
+    EXPECT_EQ(Core::DicePlan::cached("4d6kh"), nullptr);
+}
+
+// The built-in skill plan reproduces skillRoll and targetRoll from the same context
+TEST(DiceExpressionTests, SkillPlanMatchesSkillRoll) {
+    struct Config { int skill, boons, banes, base, sides, min; };
+    for (const Config& c : { Config{ 2, 0, 0, 3, 6, 1 }, Config{ 1, 2, 0, 3, 6, 1 }, Config{ 0, 1, 3, 4, 8, 0 },
+                             Config{ 3, 0, 0, 0, 6, 1 } }) {
+        std::optional<Core::DicePlan> plan = Core::DicePlan::skill(c.skill, c.boons, c.banes, c.base, c.sides, c.min);
+        ASSERT_TRUE(plan);
+        Core::RngContext a(17);
+        Core::RngContext b(17);
+        for (int i = 0; i < 500; ++i) {
+            Core::SkillRollResult expected = Core::skillRoll(a, c.skill, c.boons, c.banes, c.base, c.sides, c.min);
+            Core::DicePlanResult result = plan->roll(b);
+            ASSERT_EQ(result.total, expected.total);
+            ASSERT_EQ(result.critSuccess, expected.critSuccess);
+            ASSERT_EQ(result.critFailure, expected.critFailure);
+        }
+        EXPECT_EQ(a.position(), b.position());
+    }
+
+    Core::RngContext a(5);
+    Core::RngContext b(5);
+    std::optional<Core::DicePlan> plan = Core::DicePlan::skill(2, 1, 0);
+    for (int i = 0; i < 200; ++i) {
+        Core::TargetRollResult expected = Core::targetRoll(a, 2, i % 5, 1, 0);
+        Core::TargetRollResult result = plan->rollTarget(b, i % 5);
+        ASSERT_EQ(result.success, expected.success);
+        ASSERT_EQ(result.degree, expected.degree);
+        ASSERT_EQ(result.roll.total, expected.roll.total);
+    }
+}
+
+// Batches draw the same dice as one roll() per row, on the block path and the row-by-row path
+TEST(DiceExpressionTests, BatchMatchesRolls) {
+    for (const char* expression : { "4d6kh3+2", "2d6+3d6kl1-1", "3d6!kl2-1d4r1" }) {
+        const Core::DicePlan* plan = Core::DicePlan::cached(expression);
+        ASSERT_NE(plan, nullptr);
+        constexpr std::size_t ROWS = 3000;
+        auto totals = std::make_unique<int[]>(ROWS);
+        auto crits = std::make_unique<bool[]>(ROWS);
+        Core::RngContext batch(8);
+        ASSERT_TRUE(plan->rollBatch(batch, ROWS, { { totals.get(), ROWS }, { crits.get(), ROWS }, {}, {} }));
+
+        Core::RngContext single(8);
+        for (std::size_t row = 0; row < ROWS; ++row) {
+            Core::DicePlanResult result = plan->roll(single);
+            ASSERT_EQ(totals[row], result.total) << expression << " row " << row;
+            ASSERT_EQ(crits[row], result.critSuccess);
+        }
+        EXPECT_EQ(batch.position(), single.position());
+        EXPECT_FALSE(plan->rollBatch(batch, ROWS + 1, { { totals.get(), ROWS }, {}, {}, {} }));
+    }
+}
+
+// Exact distributions agree with skillRoll's and with sampling for rerolls, explosions and subtraction
+TEST(DiceExpressionTests, ExactDistribution) {
+    const Core::Distribution::SkillRollPmf& skill = Core::Distribution::skillRoll(2, 0);
+    const Core::Distribution::SkillRollPmf& plan = *Core::Distribution::dicePlan(*Core::DicePlan::skill(0, 2, 0));
+    ASSERT_EQ(plan.minTotal, skill.minTotal);
+    ASSERT_EQ(plan.pmf.size(), skill.pmf.size());
+    for (std::size_t i = 0; i < skill.pmf.size(); ++i) {
+        EXPECT_NEAR(plan.pmf[i], skill.pmf[i], 1e-12);
+    }
+    EXPECT_NEAR(plan.critSuccess, skill.critSuccess, 1e-12);
+    EXPECT_NEAR(plan.critFailure, skill.critFailure, 1e-12);
+    EXPECT_NEAR(Core::Distribution::targetRoll(*Core::DicePlan::skill(1, 2, 0), 3)->success,
+                Core::Distribution::targetRoll(1, 3, 2, 0).success, 1e-12);
+
+    const Core::DicePlan* mixed = Core::DicePlan::cached("3d6!kl2-1d4r1+1");
+    const Core::Distribution::SkillRollPmf& exact = *Core::Distribution::dicePlan(*mixed);
+    EXPECT_EQ(exact.minTotal, mixed->minTotal());
+    EXPECT_EQ(exact.maxTotal(), mixed->maxTotal());
+    double mass = 0.0;
+    for (double p : exact.pmf) mass += p;
+    EXPECT_NEAR(mass, 1.0, 1e-12);
+
+    constexpr int SAMPLES = 400000;
+    std::map<int, int> counts;
+    int critSuccesses = 0;
+    int critFailures = 0;
+    Core::RngContext rng(11);
+    for (int i = 0; i < SAMPLES; ++i) {
+        Core::DicePlanResult result = mixed->roll(rng);
+        ++counts[result.total];
+        critSuccesses += result.critSuccess;
+        critFailures += result.critFailure;
+    }
+    for (int total = exact.minTotal; total <= exact.maxTotal(); ++total) {
+        double p = exact.probability(total);
+        double sigma = std::sqrt(p * (1.0 - p) / SAMPLES);
+        EXPECT_NEAR(counts[total] / static_cast<double>(SAMPLES), p, 5.0 * sigma + 1e-6) << "total " << total;
+    }
+    EXPECT_NEAR(critSuccesses / static_cast<double>(SAMPLES), exact.critSuccess, 0.002);
+    EXPECT_NEAR(critFailures / static_cast<double>(SAMPLES), exact.critFailure, 0.002);
+}
+
+// Plans whose exact distribution is over the work limit are refused at once rather than computed
+TEST(DiceExpressionTests, ExactDistributionBudget) {
+    for (const char* expression : { "64d1000!", "128d1000kh64", "256d1000!" }) {
+        const Core::DicePlan* plan = Core::DicePlan::cached(expression);
+        ASSERT_NE(plan, nullptr) << expression;
+        EXPECT_EQ(Core::Distribution::dicePlan(*plan), nullptr) << expression;
+        EXPECT_EQ(Core::Distribution::targetRoll(*plan, 3), nullptr) << expression;
+    }
+    const Core::DicePlan* affordable = Core::DicePlan::cached("10d20!");
+    ASSERT_NE(Core::Distribution::dicePlan(*affordable), nullptr);
+    EXPECT_EQ(Core::Distribution::dicePlan(*affordable)->minTotal, 10);
+}
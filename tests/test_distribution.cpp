@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "Core/Distribution.h"
+
+#include <map>
+
+namespace {
+    // Enumerates every pool of `poolSize` dice and tallies skillRoll's selection, for checking the exact engine.
+    std::map<int, double> bruteForceTotals(int boons, int banes, int baseDiceCount, int diceSides, int minValue) {
+        int poolSize = baseDiceCount + std::abs(boons - banes);
+        int faces = diceSides - minValue + 1;
+        int outcomes = 1;
+        for (int i = 0; i < poolSize; ++i) outcomes *= faces;
+
+        std::map<int, double> totals;
+        std::vector<int> pool(poolSize);
+        for (int index = 0; index < outcomes; ++index) {
+            int rest = index;
+            for (int& die : pool) { die = minValue + rest % faces; rest /= faces; }
+            std::vector<int> sorted = pool;
+            if (boons > banes) std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+            else if (banes > boons) std::sort(sorted.begin(), sorted.end());
+            totals[std::accumulate(sorted.begin(), sorted.begin() + baseDiceCount, 0)] += 1.0 / outcomes;
+        }
+        return totals;
+    }
+}
+
+// Plain 3d6 matches the textbook values
+TEST(DistributionTests, Plain3d6) {
+    const Core::Distribution::SkillRollPmf& roll = Core::Distribution::skillRoll();
+    EXPECT_EQ(roll.minTotal, 3);
+    EXPECT_EQ(roll.maxTotal(), 18);
+    EXPECT_NEAR(roll.probability(10), 27.0 / 216.0, 1e-12);
+    EXPECT_NEAR(roll.critSuccess, 1.0 / 216.0, 1e-12);
+    EXPECT_NEAR(roll.critFailure, 1.0 / 216.0, 1e-12);
+    EXPECT_EQ(&roll, &Core::Distribution::skillRoll(2, 2)); // Memoized by net boons
+}
+
+// Keep-highest and keep-lowest pools match exhaustive enumeration
+TEST(DistributionTests, MatchesEnumeration) {
+    const int cases[][5] = { { 1, 0, 3, 6, 1 }, { 0, 2, 3, 6, 1 }, { 3, 0, 2, 4, 1 }, { 0, 1, 2, 3, -1 } };
+    for (const auto& c : cases) {
+        const auto& roll = Core::Distribution::skillRoll(c[0], c[1], c[2], c[3], c[4]);
+        for (const auto& [total, probability] : bruteForceTotals(c[0], c[1], c[2], c[3], c[4])) {
+            EXPECT_NEAR(roll.probability(total), probability, 1e-12);
+        }
+    }
+    EXPECT_NEAR(Core::Distribution::skillRoll(1, 0).critSuccess, 21.0 / 1296.0, 1e-12);
+    EXPECT_NEAR(Core::Distribution::skillRoll(1, 0).critFailure, 1.0 / 1296.0, 1e-12);
+}
+
+// Target and opposed odds are consistent with the underlying PMF and the opposedRoll rules
+TEST(DistributionTests, TargetAndOpposedOdds) {
+    const auto& target = Core::Distribution::targetRoll(4, 5, 2, 0); // Needs 16 or more on the dice
+    double expected = 0.0;
+    for (int total = 16; total <= 18; ++total) expected += Core::Distribution::skillRoll(2, 0).probability(total);
+    EXPECT_NEAR(target.success, expected, 1e-12);
+
+    double degreeMass = 0.0;
+    for (double p : target.degrees) degreeMass += p;
+    EXPECT_NEAR(degreeMass, 1.0, 1e-12);
+
+    // Evenly matched contestants: the outcome is symmetric
+    const auto& even = Core::Distribution::opposedRoll(3, 3);
+    EXPECT_NEAR(even.attacker, even.defender, 1e-12);
+    EXPECT_NEAR(even.attacker + even.defender + even.tie, 1.0, 1e-12);
+
+    // Higher skill wins every tied total, so the result can never be a tie
+    const auto& favoured = Core::Distribution::opposedRoll(4, 3);
+    EXPECT_NEAR(favoured.tie, 0.0, 1e-12);
+    EXPECT_GT(favoured.attacker, favoured.defender);
+    EXPECT_NEAR(favoured.critWin, 2.0 * (1.0 / 216.0) * (215.0 / 216.0), 1e-12);
+}
+
+// Every matrix cell equals the pairwise exact odds, across tie-breaks, crit overrides and saturated differences
+TEST(DistributionTests, OpposedMatrix) {
+    std::vector<int> skills, boons, banes;
+    for (int skill : { -30, 0, 2, 3, 9, 40 }) {
+        for (int net : { -2, 0, 3 }) {
+            skills.push_back(skill);
+            boons.push_back(std::max(net, 0) + 1);
+            banes.push_back(std::max(-net, 0) + 1);
+        }
+    }
+    const std::size_t n = skills.size();
+    const Core::SkillRollBatchInput side{ skills, boons, banes };
+
+    Core::ThreadPool single(1), quad(4);
+    std::vector<float> attacker(n * n), defender(n * n), tie(n * n), parallel(n * n);
+    ASSERT_TRUE(Core::Distribution::opposedMatrix(side, side, { attacker, defender, tie }, 3, 6, 1, &single));
+    ASSERT_TRUE(Core::Distribution::opposedMatrix(side, side, { parallel, {}, {} }, 3, 6, 1, &quad));
+    EXPECT_EQ(attacker, parallel);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            const auto& odds = Core::Distribution::opposedRoll(skills[i], skills[j], boons[i], banes[i], boons[j], banes[j]);
+            EXPECT_NEAR(attacker[i * n + j], odds.attacker, 1e-6);
+            EXPECT_NEAR(defender[i * n + j], odds.defender, 1e-6);
+            EXPECT_NEAR(tie[i * n + j], odds.tie, 1e-6);
+        }
+    }
+
+    // An invalid dice configuration rolls plain skill levels, as opposedRoll does
+    std::vector<float> invalid(n * n);
+    ASSERT_TRUE(Core::Distribution::opposedMatrix(side, side, { invalid, {}, {} }, 0, 6, 1));
+    EXPECT_FLOAT_EQ(invalid[(n - 1) * n], 1.0f);
+    EXPECT_FLOAT_EQ(invalid[0], 0.0f);
+
+    std::vector<float> small(n * n - 1);
+    EXPECT_FALSE(Core::Distribution::opposedMatrix(side, side, { small, {}, {} }));
+    EXPECT_FALSE(Core::Distribution::opposedMatrix(side, { skills, boons, std::span(banes).first(1) }, { attacker, {}, {} }));
+}
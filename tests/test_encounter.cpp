@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "Core/Encounter.h"
+
+#include <memory>
+
+namespace {
+    Core::Encounter makeSkirmish(std::vector<Core::Pairing>& pairings) {
+        Core::Encounter encounter;
+        encounter.setConditionEffect(0, 0, 2); // e.g. wounded
+        encounter.setConditionEffect(1, 1, 0); // e.g. flanking
+        for (int i = 0; i < 600; ++i) {
+            encounter.addCombatant(i % 9, i % 3, i % 2, static_cast<std::uint32_t>(i % 4));
+        }
+        for (Core::CombatantId i = 0; i < 300; ++i) {
+            pairings.push_back({ i, 599 - i });
+            pairings.push_back({ 599 - i, (i * 7) % 600 });
+        }
+        return encounter;
+    }
+}
+
+// Rounds resolve identically with and without a thread pool
+TEST(EncounterTests, RoundIsIndependentOfThreads) {
+    std::vector<Core::Pairing> pairings;
+    Core::Encounter encounter = makeSkirmish(pairings);
+    for (int i = 0; i < 3; ++i) {
+        pairings.insert(pairings.end(), pairings.begin(), pairings.begin() + 600); // Several chunks
+    }
+    const std::size_t n = pairings.size();
+
+    std::vector<Core::Winner> serialWinners(n), parallelWinners(n);
+    std::vector<int> serialTotals(n), parallelTotals(n);
+    Core::RngContext serialRng(21), parallelRng(21);
+    Core::ThreadPool pool(4);
+    ASSERT_TRUE(encounter.resolveRound(serialRng, pairings, { serialWinners, {}, {}, {}, { serialTotals, {}, {}, {} }, {} }));
+    ASSERT_TRUE(encounter.resolveRound(parallelRng, pairings, { parallelWinners, {}, {}, {}, { parallelTotals, {}, {}, {} }, {} }, &pool));
+    EXPECT_EQ(serialWinners, parallelWinners);
+    EXPECT_EQ(serialTotals, parallelTotals);
+
+    // Every attacker total is its skill level plus a 3d6 selection
+    for (std::size_t i = 0; i < n; ++i) {
+        int skill = encounter.skillLevels()[pairings[i].attacker];
+        EXPECT_GE(serialTotals[i], skill + 3);
+        EXPECT_LE(serialTotals[i], skill + 18);
+    }
+}
+
+// Conditions fold into effective boons and banes; bad pairings are rejected
+TEST(EncounterTests, ConditionsAndValidation) {
+    std::vector<Core::Pairing> pairings;
+    Core::Encounter encounter = makeSkirmish(pairings);
+    EXPECT_EQ(encounter.effectiveBoons(3), 0 + 1);   // Condition bits 0 and 1
+    EXPECT_EQ(encounter.effectiveBanes(3), 1 + 2);
+    EXPECT_EQ(encounter.effectiveBanes(2), 0);       // Condition bit 1 only
+    EXPECT_FALSE(encounter.setConditionEffect(Core::MAX_CONDITIONS, 1, 0));
+
+    Core::RngContext rng(1);
+    std::vector<Core::Winner> winners(2);
+    const Core::Pairing bad[] = { { 0, 1 }, { 0, 600 } };
+    EXPECT_FALSE(encounter.resolveRound(rng, bad, { winners, {}, {}, {}, {}, {} }));
+    EXPECT_FALSE(encounter.resolveRound(rng, pairings, { winners, {}, {}, {}, {}, {} })); // Output too small
+}
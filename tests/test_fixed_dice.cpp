@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+#include "Core/Dice.h"
+
+// Dice<B, S, M> reproduces the generic batch path: same dice in the same order, same totals and crits,
+// and the same number of words drawn
+template <int B, int S, int M>
+void expectMatchesBatch(std::uint64_t seed) {
+    Core::RngContext fixedRng(seed), batchRng(seed);
+    for (int i = 0; i < 400; ++i) {
+        int skill = i % 9 - 2;
+        int boons = i % 4;
+        int banes = (i / 4) % 3 + (i % 97 == 0 ? 8 : 0);
+
+        Core::SkillRollResult fixed = Core::Dice<B, S, M>::skillRoll(fixedRng, skill, boons, banes);
+
+        int total = 0;
+        bool critSuccess = false, critFailure = false;
+        int dice[B];
+        ASSERT_TRUE(Core::skillRollBatch(batchRng, { { &skill, 1 }, { &boons, 1 }, { &banes, 1 } },
+            { { &total, 1 }, { &critSuccess, 1 }, { &critFailure, 1 }, dice }, B, S, M));
+
+        EXPECT_EQ(fixed.total, total);
+        EXPECT_EQ(fixed.critSuccess, critSuccess);
+        EXPECT_EQ(fixed.critFailure, critFailure);
+        EXPECT_EQ(fixed.rolls.toVector(), std::vector<int>(dice, dice + B));
+        ASSERT_EQ(fixedRng.position(), batchRng.position());
+    }
+}
+
+TEST(FixedDiceTests, MatchesGenericPath) {
+    expectMatchesBatch<3, 6, 1>(11);
+    expectMatchesBatch<2, 10, 1>(12);
+    expectMatchesBatch<4, 20, -3>(13);
+}
+
+// The runtime-parameter functions give the same results whether or not they dispatch to DefaultDice
+TEST(FixedDiceTests, DefaultConfigDispatch) {
+    Core::RngContext a(5), b(5);
+    for (int i = 0; i < 100; ++i) {
+        Core::OpposedRollResult fromRuntime = Core::opposedRoll(a, i % 5, 2, i % 3, 0, 0, i % 2);
+        Core::OpposedRollResult fromFixed = Core::DefaultDice::opposedRoll(b, i % 5, 2, i % 3, 0, 0, i % 2);
+        EXPECT_EQ(fromRuntime.winner, fromFixed.winner);
+        EXPECT_EQ(fromRuntime.degree, fromFixed.degree);
+        EXPECT_EQ(fromRuntime.attackerRoll.rolls, fromFixed.attackerRoll.rolls);
+        EXPECT_EQ(fromRuntime.defenderRoll.rolls, fromFixed.defenderRoll.rolls);
+
+        Core::TargetRollResult target = Core::targetRoll(a, i % 6, 3);
+        Core::TargetRollResult fixedTarget = Core::DefaultDice::targetRoll(b, i % 6, 3);
+        EXPECT_EQ(target.success, fixedTarget.success);
+        EXPECT_EQ(target.degree, fixedTarget.degree);
+    }
+}
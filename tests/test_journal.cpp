@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "Core/Journal.h"
+
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+    std::string journalPath(const char* name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    void expectSameRoll(const Core::SkillRollResult& a, const Core::SkillRollResult& b) {
+        EXPECT_EQ(a.total, b.total);
+        EXPECT_EQ(a.rolls, b.rolls);
+        EXPECT_EQ(a.critSuccess, b.critSuccess);
+        EXPECT_EQ(a.critFailure, b.critFailure);
+    }
+}
+
+// A journal of mixed rolls on several contexts replays to identical results
+TEST(JournalTests, ReplayReproducesRolls) {
+    const std::string path = journalPath("core_journal_replay.bin");
+    std::vector<Core::SkillRollResult> skills;
+    std::vector<Core::OpposedRollResult> opposed;
+    std::vector<Core::TargetRollResult> targets;
+    {
+        Core::JournalWriter writer;
+        ASSERT_TRUE(writer.open(path));
+        Core::RngContext first(99, 0), second(99, 1);
+        for (int i = 0; i < 20000; ++i) {
+            Core::RngContext& rng = (i % 7 == 0) ? second : first;
+            if (i == 5000) {
+                first.seek(123456); // Position jump
+            }
+            switch (i % 3) {
+            case 0: skills.push_back(writer.skillRoll(rng, i % 9, i % 4, 1)); break;
+            case 1: opposed.push_back(writer.opposedRoll(rng, 3, 2, i % 2, 0, 1, i % 3)); break;
+            default: targets.push_back(writer.targetRoll(rng, 4, i % 12, 0, 0, (i % 50 == 2) ? 5 : 3, 6, 1)); break;
+            }
+        }
+        ASSERT_TRUE(writer.close());
+    }
+
+    Core::JournalReader reader;
+    ASSERT_TRUE(reader.open(path));
+    std::size_t skill = 0, opposedIndex = 0, target = 0;
+    Core::JournalEntry entry;
+    while (reader.next(entry)) {
+        switch (entry.kind) {
+        case Core::JournalRollKind::SKILL:
+            ASSERT_LT(skill, skills.size());
+            expectSameRoll(reader.replaySkillRoll(entry), skills[skill++]);
+            break;
+        case Core::JournalRollKind::OPPOSED: {
+            ASSERT_LT(opposedIndex, opposed.size());
+            Core::OpposedRollResult replayed = reader.replayOpposedRoll(entry);
+            const Core::OpposedRollResult& original = opposed[opposedIndex++];
+            EXPECT_EQ(replayed.winner, original.winner);
+            EXPECT_EQ(replayed.degree, original.degree);
+            expectSameRoll(replayed.attackerRoll, original.attackerRoll);
+            expectSameRoll(replayed.defenderRoll, original.defenderRoll);
+            break;
+        }
+        case Core::JournalRollKind::TARGET: {
+            ASSERT_LT(target, targets.size());
+            Core::TargetRollResult replayed = reader.replayTargetRoll(entry);
+            const Core::TargetRollResult& original = targets[target++];
+            EXPECT_EQ(replayed.success, original.success);
+            EXPECT_EQ(replayed.degree, original.degree);
+            expectSameRoll(replayed.roll, original.roll);
+            break;
+        }
+        }
+    }
+    EXPECT_FALSE(reader.corrupt());
+    EXPECT_EQ(skill, skills.size());
+    EXPECT_EQ(opposedIndex, opposed.size());
+    EXPECT_EQ(target, targets.size());
+    std::filesystem::remove(path);
+}
+
+// Repeated rolls cost two bytes each; truncated files are reported as corrupt
+TEST(JournalTests, CompactAndValidated) {
+    const std::string path = journalPath("core_journal_compact.bin");
+    {
+        Core::JournalWriter writer;
+        ASSERT_TRUE(writer.open(path));
+        Core::RngContext rng(5);
+        for (int i = 0; i < 100000; ++i) {
+            writer.targetRoll(rng, 3, 4);
+        }
+        ASSERT_TRUE(writer.close());
+    }
+    const auto size = std::filesystem::file_size(path);
+    EXPECT_LT(size, 8 + 2 * 100000 + 32);
+
+    std::filesystem::resize_file(path, size - 1);
+    Core::JournalReader reader;
+    ASSERT_TRUE(reader.open(path));
+    Core::JournalEntry entry;
+    std::size_t count = 0;
+    while (reader.next(entry)) {
+        ++count;
+    }
+    EXPECT_EQ(count, 99999u);
+    EXPECT_TRUE(reader.corrupt());
+    std::filesystem::remove(path);
+
+    EXPECT_FALSE(reader.open(journalPath("core_journal_missing.bin")));
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+#include "Core/DiceKernels.h"
+
+#include <functional>
+
+// The AVX2 kernels match the scalar kernels on the same random stream
+TEST(KernelTests, Avx2MatchesScalar) {
+    if (!Core::Kernels::isSupported(Core::Kernels::InstructionSet::AVX2)) {
+        GTEST_SKIP() << "AVX2 not supported on this CPU";
+    }
+    const auto& scalar = Core::Kernels::kernelTable(Core::Kernels::InstructionSet::SCALAR);
+    const auto& avx2 = Core::Kernels::kernelTable(Core::Kernels::InstructionSet::AVX2);
+    Core::RngContext rng(2024);
+
+    for (int sides : { 2, 6, 20, 100, 65536 }) {
+        std::vector<std::uint32_t> words(1001);
+        rng.fill(words.data(), words.size());
+        words[17] = 0; // Rejected for every range that does not divide 2^32
+        std::vector<int> fromScalar(words.size()), fromAvx2(words.size());
+        std::size_t scalarCount = scalar.diceFromWords(words.data(), words.size(), fromScalar.data(), 1, sides);
+        std::size_t avx2Count = avx2.diceFromWords(words.data(), words.size(), fromAvx2.data(), 1, sides);
+        ASSERT_EQ(scalarCount, avx2Count);
+        fromScalar.resize(scalarCount);
+        fromAvx2.resize(avx2Count);
+        EXPECT_EQ(fromScalar, fromAvx2);
+    }
+
+    for (int poolSize = 1; poolSize <= 12; ++poolSize) {
+        for (int trial = 0; trial < 200; ++trial) {
+            std::vector<int> pool = Core::rollDice(rng, poolSize, 6, 1);
+            int kept = 1 + trial % poolSize;
+            bool keepHighest = trial % 2 == 0;
+            std::vector<int> a = pool, b = pool;
+            scalar.selectKept(a.data(), poolSize, kept, keepHighest);
+            avx2.selectKept(b.data(), poolSize, kept, keepHighest);
+            ASSERT_TRUE(std::equal(a.begin(), a.begin() + kept, b.begin()));
+
+            Core::Kernels::KeptSummary sa = scalar.summarizeKept(pool.data(), poolSize, 6, 1);
+            Core::Kernels::KeptSummary sb = avx2.summarizeKept(pool.data(), poolSize, 6, 1);
+            EXPECT_EQ(sa.total, sb.total);
+            EXPECT_EQ(sa.critSuccess, sb.critSuccess);
+            EXPECT_EQ(sa.critFailure, sb.critFailure);
+        }
+    }
+}
+
+// The batched kernel path reproduces a plain per-die reference roller on the same stream
+TEST(KernelTests, BatchMatchesReference) {
+    constexpr int ROLLS = 500;
+    std::vector<int> skillLevels(ROLLS), boons(ROLLS), banes(ROLLS);
+    for (int i = 0; i < ROLLS; ++i) {
+        skillLevels[i] = i % 7;
+        boons[i] = i % 5;
+        banes[i] = (i / 5) % 4 + (i % 50 == 0 ? 9 : 0); // Include a few pools too big for the network
+    }
+
+    std::vector<int> totals(ROLLS), dice(ROLLS * 3);
+    std::unique_ptr<bool[]> critSuccess(new bool[ROLLS]), critFailure(new bool[ROLLS]);
+    Core::RngContext batchRng(77);
+    ASSERT_TRUE(Core::skillRollBatch(batchRng, { skillLevels, boons, banes },
+        { totals, { critSuccess.get(), ROLLS }, { critFailure.get(), ROLLS }, dice }));
+
+    Core::RngContext referenceRng(77);
+    for (int i = 0; i < ROLLS; ++i) {
+        std::vector<int> pool(3 + std::abs(boons[i] - banes[i]));
+        for (int& die : pool) die = referenceRng.uniform(1, 6);
+        if (boons[i] > banes[i]) std::sort(pool.begin(), pool.end(), std::greater<int>());
+        else if (banes[i] > boons[i]) std::sort(pool.begin(), pool.end());
+
+        EXPECT_TRUE(std::equal(pool.begin(), pool.begin() + 3, dice.begin() + i * 3));
+        EXPECT_EQ(totals[i], skillLevels[i] + pool[0] + pool[1] + pool[2]);
+        EXPECT_EQ(critSuccess[i], pool[0] == 6 && pool[1] == 6 && pool[2] == 6);
+        EXPECT_EQ(critFailure[i], pool[0] == 1 && pool[1] == 1 && pool[2] == 1);
+    }
+    EXPECT_EQ(batchRng.position(), referenceRng.position());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+#include "Core/Metrics.h"
+#include "Core/ThreadPool.h"
+
+#include <thread>
+
+using Core::metrics::RollKind;
+
+// Calls, validation failures and per-roll histograms add up across entry points
+TEST(MetricsTests, CountsCallsAndRolls) {
+    if (not Core::metrics::ENABLED) {
+        GTEST_SKIP() << "Built with CORE_ENABLE_METRICS=0";
+    }
+    const Core::metrics::Snapshot before = Core::metrics::snapshot();
+
+    Core::RngContext rng(8);
+    for (int i = 0; i < 100; ++i) {
+        Core::skillRoll(rng, 2, 2, 0);         // Default dice: pool of 5, net +2
+        Core::opposedRoll(rng, 1, 1, 0, 0, 0, 0, 4, 6, 1); // Generic path: pools of 4
+        Core::targetRoll(rng, 3, 3, 0, 0, 3, 0, 1); // Invalid: minValue > diceSides
+    }
+    std::vector<int> skills(10, 0), boons(10, 0), banes(10, 0), totals(10);
+    ASSERT_TRUE(Core::skillRollBatch(rng, { skills, boons, banes }, { totals, {}, {}, {} }));
+    EXPECT_FALSE(Core::skillRollBatch(rng, { skills, boons, banes }, { totals, {}, {}, {} }, 0));
+
+    const Core::metrics::Snapshot after = Core::metrics::snapshot();
+    EXPECT_EQ(after.callCount(RollKind::SKILL) - before.callCount(RollKind::SKILL), 100u);
+    EXPECT_EQ(after.callCount(RollKind::OPPOSED) - before.callCount(RollKind::OPPOSED), 100u);
+    EXPECT_EQ(after.callCount(RollKind::TARGET) - before.callCount(RollKind::TARGET), 100u);
+    EXPECT_EQ(after.failureCount(RollKind::TARGET) - before.failureCount(RollKind::TARGET), 100u);
+    EXPECT_EQ(after.failureCount(RollKind::SKILL) - before.failureCount(RollKind::SKILL), 0u);
+    EXPECT_EQ(after.callCount(RollKind::SKILL_BATCH) - before.callCount(RollKind::SKILL_BATCH), 2u);
+    EXPECT_EQ(after.rowCount(RollKind::SKILL_BATCH) - before.rowCount(RollKind::SKILL_BATCH), 20u);
+    EXPECT_EQ(after.failureCount(RollKind::SKILL_BATCH) - before.failureCount(RollKind::SKILL_BATCH), 1u);
+
+    // 100 skill rolls + 200 opposed sides + 10 batch rows were resolved
+    EXPECT_EQ(after.skillRolls() - before.skillRolls(), 310u);
+    EXPECT_EQ(after.poolSizes[5] - before.poolSizes[5], 100u);
+    EXPECT_EQ(after.poolSizes[4] - before.poolSizes[4], 200u);
+    EXPECT_EQ(after.netModifiers[Core::metrics::NET_MODIFIER_LIMIT + 2] - before.netModifiers[Core::metrics::NET_MODIFIER_LIMIT + 2], 100u);
+    std::uint64_t totalsRecorded = 0;
+    for (std::size_t i = 0; i < Core::metrics::DICE_TOTAL_BUCKETS; ++i) {
+        totalsRecorded += after.diceTotals[i] - before.diceTotals[i];
+    }
+    EXPECT_EQ(totalsRecorded, 310u);
+}
+
+// Counters of pool workers and of exited threads are merged into the snapshot
+TEST(MetricsTests, MergesThreads) {
+    if (not Core::metrics::ENABLED) {
+        GTEST_SKIP() << "Built with CORE_ENABLE_METRICS=0";
+    }
+    const Core::metrics::Snapshot before = Core::metrics::snapshot();
+
+    std::thread worker([] {
+        Core::RngContext rng(1);
+        for (int i = 0; i < 1000; ++i) {
+            Core::targetRoll(rng, 2, 3);
+        }
+    });
+    worker.join();
+
+    Core::ThreadPool pool(3);
+    pool.parallelFor(300, [](std::size_t index, unsigned) {
+        Core::RngContext rng(2, index);
+        Core::targetRoll(rng, 2, 3);
+    });
+
+    const Core::metrics::Snapshot after = Core::metrics::snapshot();
+    EXPECT_EQ(after.callCount(RollKind::TARGET) - before.callCount(RollKind::TARGET), 1300u);
+
+    std::uint64_t samples = 0;
+    for (std::size_t i = 0; i < Core::metrics::LATENCY_BUCKETS; ++i) {
+        samples += after.latencies[i] - before.latencies[i];
+    }
+    EXPECT_GE(samples, 1000 / Core::metrics::LATENCY_SAMPLE_INTERVAL);
+    EXPECT_GT(after.latencyPercentile(0.5), 0u);
+}
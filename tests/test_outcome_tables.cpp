@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "Core/Distribution.h"
+#include "Core/OutcomeTables.h"
+
+namespace Tables = Core::OutcomeTables;
+
+// The compile-time counts agree with the memoized exact distributions
+TEST(OutcomeTableTests, MatchesDistribution) {
+    for (int net = -Tables::MAX_NET_BOONS; net <= Tables::MAX_NET_BOONS; ++net) {
+        int boons = net > 0 ? net : 0;
+        int banes = net < 0 ? -net : 0;
+        const Tables::SkillCounts& counts = Tables::skillCounts(net);
+        const Core::Distribution::SkillRollPmf& pmf = Core::Distribution::skillRoll(boons, banes);
+        for (int total = Tables::MIN_TOTAL; total <= Tables::MAX_TOTAL; ++total) {
+            EXPECT_NEAR(static_cast<double>(counts.counts[total - Tables::MIN_TOTAL]) / counts.pools, pmf.probability(total), 1e-12);
+        }
+
+        for (int skill : { -4, 0, 3, 9 }) {
+            for (int difficulty = 1; difficulty <= 10; ++difficulty) {
+                Tables::TargetOdds odds = Tables::targetOdds(skill, difficulty, net);
+                const Core::Distribution::TargetRollOdds& exact = Core::Distribution::targetRoll(skill, difficulty, boons, banes);
+                EXPECT_NEAR(odds.probability(odds.success), exact.success, 1e-12);
+                EXPECT_NEAR(odds.probability(odds.critSuccess), exact.critSuccess, 1e-12);
+                EXPECT_NEAR(odds.probability(odds.critFailure), exact.critFailure, 1e-12);
+                for (int degree = -12; degree <= 6; ++degree) {
+                    EXPECT_NEAR(odds.probability(Tables::targetDegreeCount(skill, difficulty, net, degree)),
+                        exact.degreeProbability(degree), 1e-12);
+                }
+            }
+        }
+    }
+
+    for (int attackerNet : { -6, -2, 0, 1, 6 }) {
+        for (int defenderNet : { -3, 0, 2 }) {
+            for (int skillDifference : { -20, -5, -1, 0, 1, 7, 20 }) {
+                Tables::OpposedOdds odds = Tables::opposedOdds(skillDifference, 0, attackerNet, defenderNet);
+                const Core::Distribution::OpposedRollOdds& exact = Core::Distribution::opposedRoll(skillDifference, 0,
+                    attackerNet > 0 ? attackerNet : 0, attackerNet < 0 ? -attackerNet : 0,
+                    defenderNet > 0 ? defenderNet : 0, defenderNet < 0 ? -defenderNet : 0);
+                EXPECT_EQ(odds.attackerWins + odds.defenderWins + odds.ties, odds.pools);
+                EXPECT_NEAR(odds.probability(odds.attackerWins), exact.attacker, 1e-12);
+                EXPECT_NEAR(odds.probability(odds.defenderWins), exact.defender, 1e-12);
+                EXPECT_NEAR(odds.probability(odds.ties), exact.tie, 1e-12);
+                EXPECT_NEAR(odds.probability(odds.critWins), exact.critWin, 1e-12);
+                EXPECT_NEAR(odds.probability(odds.critLosses), exact.critLoss, 1e-12);
+            }
+        }
+    }
+}
+
+// Alias sampling reproduces the tabulated distribution
+TEST(OutcomeTableTests, SamplingMatchesCounts) {
+    constexpr int SAMPLES = 400000;
+    Core::RngContext rng(314);
+    for (int net : { -6, 0, 2 }) {
+        std::vector<int> histogram(Tables::TOTAL_COUNT);
+        for (int i = 0; i < SAMPLES; ++i) {
+            int total = Tables::sampleSkillTotal(rng, net);
+            ASSERT_GE(total, Tables::MIN_TOTAL);
+            ASSERT_LE(total, Tables::MAX_TOTAL);
+            ++histogram[total - Tables::MIN_TOTAL];
+        }
+        const Tables::SkillCounts& counts = Tables::skillCounts(net);
+        for (int t = 0; t < Tables::TOTAL_COUNT; ++t) {
+            double expected = static_cast<double>(counts.counts[t]) / counts.pools;
+            EXPECT_NEAR(static_cast<double>(histogram[t]) / SAMPLES, expected, 5 * std::sqrt(expected / SAMPLES) + 1e-6);
+        }
+    }
+
+    Core::TargetRollResult sampled = Tables::sampleTargetRoll(rng, 2, 3, 1, 0);
+    EXPECT_TRUE(sampled.roll.rolls.empty());
+    EXPECT_EQ(sampled.success, sampled.roll.total >= 12);
+    EXPECT_EQ(Tables::sampleTargetRoll(rng, 2, 3, 9, 0).roll.rolls.size(), 3u); // Untabulated: falls back to rolling
+}
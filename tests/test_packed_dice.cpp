@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+#include "Core/Dice.h"
+#include "Core/PackedDice.h"
+
+#include <array>
+#include <climits>
+
+// Dice per word is the best k for each range, and powers of two split the word into bit fields
+TEST(PackedDiceTests, DicePerWord) {
+    EXPECT_EQ(Core::PackedDice::dicePerWord(6), 23u);
+    EXPECT_EQ(Core::PackedDice::dicePerWord(20), 14u);
+    EXPECT_EQ(Core::PackedDice::dicePerWord(16), 16u);
+    EXPECT_EQ(Core::PackedDice::dicePerWord(2), 64u);
+    EXPECT_EQ(Core::PackedDice::dicePerWord(std::uint64_t{ 1 } << 32), 2u);
+}
+
+// Every face comes up equally often, using about one 64-bit word per 22.6 d6
+TEST(PackedDiceTests, UniformAndFrugal) {
+    Core::PackedDice dice(Core::RngContext(3));
+    constexpr int ROLLS = 600000;
+    std::array<int, 6> faces{};
+    for (int i = 0; i < ROLLS; ++i) {
+        int die = dice.roll(1, 6);
+        ASSERT_GE(die, 1);
+        ASSERT_LE(die, 6);
+        ++faces[die - 1];
+    }
+    for (int count : faces) {
+        EXPECT_NEAR(count, ROLLS / 6, 1000); // About 3.5 standard deviations
+    }
+    EXPECT_NEAR(static_cast<double>(dice.wordsDrawn()), ROLLS / 22.65, 100);
+
+    // A one-faced die needs no words; the full int range still works
+    const std::uint64_t drawn = dice.wordsDrawn();
+    EXPECT_EQ(dice.roll(4, 4), 4);
+    EXPECT_EQ(dice.wordsDrawn(), drawn);
+    std::vector<int> wide(10);
+    dice.fill(wide, INT_MIN, INT_MAX);
+    EXPECT_EQ(dice.wordsDrawn(), drawn + 5);
+}
+
+// Both roll paths take their dice from a PackedDice in the same order, and use far fewer words
+TEST(PackedDiceTests, RollsThroughCore) {
+    Core::PackedDice fixed(Core::RngContext(9));
+    Core::PackedDice generic(Core::RngContext(9));
+    for (int i = 0; i < 200; ++i) {
+        Core::SkillRollResult a = Core::Dice<4, 6, 1>::skillRoll(fixed, 1, i % 3, i % 2);
+        Core::SkillRollResult b = Core::skillRoll(generic, 1, i % 3, i % 2, 4, 6, 1);
+        EXPECT_EQ(a.total, b.total);
+        EXPECT_EQ(a.rolls, b.rolls);
+        EXPECT_EQ(a.critSuccess, b.critSuccess);
+    }
+
+    Core::RngContext plain(4);
+    Core::PackedDice packed(Core::RngContext(4));
+    for (int i = 0; i < 1000; ++i) {
+        Core::TargetRollResult target = Core::targetRoll(packed, 2, 3, 1, 0);
+        EXPECT_EQ(target.success, target.roll.total >= 12);
+        Core::targetRoll(plain, 2, 3, 1, 0);
+        Core::OpposedRollResult opposed = Core::opposedRoll(packed, 1, 1);
+        EXPECT_EQ(opposed.attackerRoll.rolls.size(), 3u);
+        Core::opposedRoll(plain, 1, 1);
+    }
+    // Positions count 32-bit words: 10 dice per iteration cost 10 words plain, under one packed
+    EXPECT_GT(plain.position(), 10 * packed.rng().position());
+    EXPECT_TRUE(Core::rollDice(packed, 0).empty());
+    EXPECT_EQ(Core::rollDice(packed, 7, 20, 11).size(), 7u);
+}
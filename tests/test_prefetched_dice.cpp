@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+#include "Core/DicePrefetcher.h"
+#include "Core/Dice.h"
+#include "Core/PackedDice.h"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+    // Waits for the producer to top the ring up, failing if it has not within a generous deadline
+    void waitUntilFull(const Core::PrefetchedDice& dice) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline) {
+            Core::PrefetchStats stats = dice.stats();
+            if (stats.occupancy == stats.capacity) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        FAIL() << "The ring was never filled";
+    }
+}
+
+// The ring replays the PackedDice sequence while it never runs dry, and refills as it drains
+TEST(PrefetchedDiceTests, MatchesPackedDice) {
+    Core::DicePrefetcher prefetcher;
+    Core::PrefetchedDice dice(prefetcher, Core::RngContext(12), 1, 6, 1000);
+    Core::PackedDice packed(Core::RngContext(12));
+    ASSERT_NO_FATAL_FAILURE(waitUntilFull(dice));
+    EXPECT_EQ(dice.stats().capacity, 1024u);
+
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 600; ++i) {
+            ASSERT_EQ(dice.roll(1, 6), packed.roll(1, 6));
+        }
+        ASSERT_NO_FATAL_FAILURE(waitUntilFull(dice));
+    }
+
+    Core::PrefetchStats stats = dice.stats();
+    EXPECT_EQ(stats.popped, 2400u);
+    EXPECT_EQ(stats.underflows, 0u);
+    EXPECT_EQ(stats.produced, 2400u + 1024u);
+}
+
+// A consumer slower than the producer asks for exactly one refill per cycle, and sees it before running dry
+TEST(PrefetchedDiceTests, RefillsSlowConsumer) {
+    Core::DicePrefetcher prefetcher;
+    Core::PrefetchedDice dice(prefetcher, Core::RngContext(31), 1, 6, 64);
+    Core::PackedDice packed(Core::RngContext(31));
+    ASSERT_NO_FATAL_FAILURE(waitUntilFull(dice));
+
+    // Each cycle drains the ring to its low-water mark, then waits for the refill that must have been requested
+    for (std::uint64_t cycle = 1; cycle <= 8; ++cycle) {
+        for (int i = 0; i < 32; ++i) {
+            ASSERT_EQ(dice.roll(1, 6), packed.roll(1, 6));
+        }
+        EXPECT_EQ(dice.stats().refillRequests, cycle);
+        ASSERT_NO_FATAL_FAILURE(waitUntilFull(dice));
+    }
+    Core::PrefetchStats stats = dice.stats();
+    EXPECT_EQ(stats.popped, 8u * 32u);
+    EXPECT_EQ(stats.underflows, 0u);
+    EXPECT_EQ(stats.produced, 64u + 8u * 32u);
+}
+
+// Other ranges and an empty ring fall back to inline dice, counted as underflows
+TEST(PrefetchedDiceTests, FallsBackInline) {
+    Core::DicePrefetcher prefetcher;
+    Core::PrefetchedDice dice(prefetcher, Core::RngContext(5), 1, 6, 64);
+    ASSERT_NO_FATAL_FAILURE(waitUntilFull(dice));
+
+    for (int i = 0; i < 100; ++i) {
+        int die = dice.roll(1, 20);
+        ASSERT_GE(die, 1);
+        ASSERT_LE(die, 20);
+    }
+    EXPECT_EQ(dice.stats().underflows, 100u);
+    EXPECT_EQ(dice.stats().popped, 0u);
+
+    // Draining faster than the producer refills may underflow, but every die is still in range
+    for (int i = 0; i < 100000; ++i) {
+        int die = dice.roll(1, 6);
+        ASSERT_GE(die, 1);
+        ASSERT_LE(die, 6);
+    }
+    Core::PrefetchStats stats = dice.stats();
+    EXPECT_EQ(stats.popped + stats.underflows, 100100u);
+}
+
+// The roll functions take their dice from the ring, through both the fixed and the generic paths
+TEST(PrefetchedDiceTests, RollsThroughCore) {
+    Core::DicePrefetcher prefetcher;
+    Core::PrefetchedDice fixed(prefetcher, Core::RngContext(9));
+    Core::PrefetchedDice generic(prefetcher, Core::RngContext(9));
+    ASSERT_NO_FATAL_FAILURE(waitUntilFull(fixed));
+    ASSERT_NO_FATAL_FAILURE(waitUntilFull(generic));
+    for (int i = 0; i < 200; ++i) {
+        Core::SkillRollResult a = Core::Dice<4, 6, 1>::skillRoll(fixed, 1, i % 3, i % 2);
+        Core::SkillRollResult b = Core::skillRoll(generic, 1, i % 3, i % 2, 4, 6, 1);
+        EXPECT_EQ(a.total, b.total);
+        EXPECT_EQ(a.rolls, b.rolls);
+    }
+
+    Core::TargetRollResult target = Core::targetRoll(generic, 2, 3, 1, 0);
+    EXPECT_EQ(target.success, target.roll.total >= 12);
+    EXPECT_EQ(Core::opposedRoll(generic, 1, 1).attackerRoll.rolls.size(), 3u);
+    EXPECT_EQ(Core::rollDice(generic, 7, 20, 11).size(), 7u);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+
+// Known-answer tests from the Random123 reference implementation
+TEST(RngTests, PhiloxKnownAnswers) {
+    Core::Philox4x32::Block zero = Core::Philox4x32::generate({ 0, 0, 0, 0 }, { 0, 0 });
+    EXPECT_EQ(zero, (Core::Philox4x32::Block{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }));
+
+    Core::Philox4x32::Block pi = Core::Philox4x32::generate(
+        { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, { 0xa4093822, 0x299f31d0 });
+    EXPECT_EQ(pi, (Core::Philox4x32::Block{ 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }));
+}
+
+// Same seed and stream reproduce the same rolls; seek jumps to any position
+TEST(RngTests, ContextIsReproducible) {
+    Core::RngContext first(1234);
+    Core::RngContext second(1234);
+    EXPECT_EQ(Core::rollDice(first, 50, 6, 1), Core::rollDice(second, 50, 6, 1));
+
+    std::uint64_t position = first.position();
+    std::uint64_t expected = first.next64();
+    Core::RngContext replay(1234);
+    replay.seek(position);
+    EXPECT_EQ(replay.next64(), expected);
+
+    Core::RngContext otherStream = Core::RngContext(1234).stream(1);
+    Core::RngContext mainStream(1234);
+    EXPECT_NE(Core::rollDice(otherStream, 50, 6, 1), Core::rollDice(mainStream, 50, 6, 1));
+}
+
+// Per-job streams give identical results whatever order the jobs run in
+TEST(RngTests, StreamsAreIndependentOfScheduling) {
+    const Core::RngContext master(42);
+    constexpr int JOBS = 8;
+    int forward[JOBS];
+    int backward[JOBS];
+
+    for (int job = 0; job < JOBS; ++job) {
+        Core::RngContext rng = master.stream(job);
+        forward[job] = Core::opposedRoll(rng, 3, 2, 1, 0, 0, 1).attackerRoll.total;
+    }
+    for (int job = JOBS - 1; job >= 0; --job) {
+        Core::RngContext rng = master.stream(job);
+        backward[job] = Core::opposedRoll(rng, 3, 2, 1, 0, 0, 1).attackerRoll.total;
+    }
+    for (int job = 0; job < JOBS; ++job) {
+        EXPECT_EQ(forward[job], backward[job]);
+    }
+}
+
+// uniform covers the whole range without leaving it
+TEST(RngTests, UniformStaysInRange) {
+    Core::RngContext rng(7);
+    bool seen[7] = {};
+    for (int i = 0; i < 10000; ++i) {
+        int value = rng.uniform(-3, 3);
+        ASSERT_GE(value, -3);
+        ASSERT_LE(value, 3);
+        seen[value + 3] = true;
+    }
+    for (bool face : seen) {
+        EXPECT_TRUE(face);
+    }
+}
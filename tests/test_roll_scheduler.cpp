@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+#include "Core/RollScheduler.h"
+
+namespace {
+    // What one entity script saw, filled in as it runs
+    struct Entity {
+        int skill = 0;
+        int total = 0;
+        bool success = false;
+        Core::Winner winner = Core::Winner::TIE;
+        int degree = 0;
+        bool finished = false;
+    };
+
+    // A sequential script: a skill roll, a target roll it depends on, then an opposed roll
+    Core::RollTask script(Core::RollScheduler& scheduler, Entity& entity) {
+        Core::SkillRollResult roll = co_await scheduler.skillRoll(entity.skill, 1, 0);
+        entity.total = roll.total;
+        Core::TargetRollResult target = co_await scheduler.targetRoll(entity.skill, roll.total > 12 ? 3 : 2);
+        entity.success = target.success;
+        Core::OpposedRollResult opposed = co_await scheduler.opposedRoll(entity.skill, 3, 0, 0, 0, 1);
+        entity.winner = opposed.winner;
+        entity.degree = opposed.degree;
+        entity.finished = true;
+    }
+
+    std::vector<Entity> runScripts(std::size_t count, Core::ThreadPool* pool) {
+        std::vector<Entity> entities(count);
+        Core::RollScheduler scheduler(Core::RngContext(21), { Core::DEFAULT_BASE_DICE_COUNT, Core::DEFAULT_DICE_SIDES, Core::DEFAULT_MIN_VALUE, pool });
+        for (std::size_t i = 0; i < count; ++i) {
+            entities[i].skill = static_cast<int>(i % 6);
+            scheduler.spawn(script(scheduler, entities[i]));
+        }
+        EXPECT_EQ(scheduler.size(), count);
+        EXPECT_EQ(scheduler.run(), 4u); // Start, then one tick per awaited roll
+        EXPECT_EQ(scheduler.rollsResolved(), 3 * count);
+        EXPECT_EQ(scheduler.size(), 0u);
+        return entities;
+    }
+}
+
+// Each tick resolves every script's roll as one batch, in spawn order, like the scalar calls in that order
+TEST(RollSchedulerTests, MatchesScalarRolls) {
+    constexpr std::size_t COUNT = 100;
+    std::vector<Entity> entities = runScripts(COUNT, nullptr);
+
+    Core::RngContext rng(21);
+    std::vector<int> totals(COUNT);
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        totals[i] = Core::skillRoll(rng, entities[i].skill, 1, 0).total;
+        EXPECT_EQ(entities[i].total, totals[i]);
+    }
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(entities[i].success, Core::targetRoll(rng, entities[i].skill, totals[i] > 12 ? 3 : 2).success);
+    }
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        Core::OpposedRollResult opposed = Core::opposedRoll(rng, entities[i].skill, 3, 0, 0, 0, 1);
+        EXPECT_EQ(entities[i].winner, opposed.winner);
+        EXPECT_EQ(entities[i].degree, opposed.degree);
+        EXPECT_TRUE(entities[i].finished);
+    }
+}
+
+// Resuming scripts across a pool changes nothing about the results
+TEST(RollSchedulerTests, PoolResumesDeterministically) {
+    Core::ThreadPool pool(4);
+    std::vector<Entity> serial = runScripts(500, nullptr);
+    std::vector<Entity> parallel = runScripts(500, &pool);
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_EQ(serial[i].total, parallel[i].total);
+        EXPECT_EQ(serial[i].success, parallel[i].success);
+        EXPECT_EQ(serial[i].winner, parallel[i].winner);
+    }
+}
+
+// Frames of finished tasks are reused, and scripts that end early free their slots
+TEST(RollSchedulerTests, PooledFrames) {
+    runScripts(64, nullptr);
+    const std::uint64_t allocations = Core::CoroutineFramePool::upstreamAllocations();
+    runScripts(64, nullptr);
+    EXPECT_EQ(Core::CoroutineFramePool::upstreamAllocations(), allocations);
+
+    Core::RollScheduler scheduler(Core::RngContext(1));
+    int resumed = 0;
+    auto waiter = [](int& counter) -> Core::RollTask {
+        co_await std::suspend_always{}; // Waits a tick without a roll
+        ++counter;
+    };
+    scheduler.spawn(waiter(resumed));
+    scheduler.spawn(waiter(resumed));
+    EXPECT_EQ(scheduler.tick(), 2u);
+    EXPECT_EQ(scheduler.tick(), 0u);
+    EXPECT_EQ(resumed, 2);
+    EXPECT_EQ(scheduler.rollsResolved(), 0u);
+}
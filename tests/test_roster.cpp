@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+#include "Core/Roster.h"
+#include "Core/ThreadPool.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+namespace {
+    constexpr std::size_t RECORDS = 10000;
+    constexpr std::uint32_t VETERAN = 1u << 0;
+    constexpr std::uint32_t SCOUT = 1u << 1;
+
+    // Column storage for a synthetic roster, written to a temporary file
+    struct RosterFile {
+        RosterFile() : path((std::filesystem::temp_directory_path() / "core_test_roster.bin").string()) {
+            for (std::size_t i = 0; i < RECORDS; ++i) {
+                ids.push_back(1000 + i);
+                tags.push_back(static_cast<std::uint32_t>(i % 4)); // None, VETERAN, SCOUT, both
+                boons.push_back(static_cast<std::int8_t>(i % 3));
+                banes.push_back(static_cast<std::int8_t>(i % 5 == 0 ? 2 : 0));
+                stealth.push_back(static_cast<std::int8_t>(i % 7));
+                melee.push_back(static_cast<std::int8_t>(i % 11 - 2));
+            }
+        }
+        ~RosterFile() { std::remove(path.c_str()); }
+
+        bool write() const {
+            return Core::writeRoster(path, { ids, tags, boons, banes, { "stealth", "melee" }, { stealth, melee } });
+        }
+
+        std::string path;
+        std::vector<std::uint64_t> ids;
+        std::vector<std::uint32_t> tags;
+        std::vector<std::int8_t> boons, banes, stealth, melee;
+    };
+
+    struct SweepResult {
+        explicit SweepResult(std::size_t records)
+            : successes(new bool[records]()), degrees(records, -99), totals(records, -99) {}
+
+        Core::TargetRollBatchOutput output(std::size_t records) {
+            return { { successes.get(), records }, degrees, { totals, {}, {}, {} } };
+        }
+
+        std::unique_ptr<bool[]> successes;
+        std::vector<int> degrees, totals;
+        Core::Stats::RollStats stats;
+    };
+}
+
+// A written roster opens in place with its columns intact; malformed files are refused
+TEST(RosterTests, WriteAndOpen) {
+    RosterFile file;
+    ASSERT_TRUE(file.write());
+
+    Core::Roster roster;
+    ASSERT_TRUE(roster.open(file.path));
+    EXPECT_EQ(roster.size(), RECORDS);
+    EXPECT_EQ(roster.skillCount(), 2u);
+    EXPECT_EQ(roster.skillName(1), "melee");
+    EXPECT_EQ(roster.findSkill("stealth"), 0);
+    EXPECT_EQ(roster.findSkill("swimming"), -1);
+    EXPECT_TRUE(std::equal(file.ids.begin(), file.ids.end(), roster.ids().begin()));
+    EXPECT_TRUE(std::equal(file.melee.begin(), file.melee.end(), roster.skillLevels(1).begin()));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(roster.tags().data()) % 64, 0u);
+    roster.close();
+    EXPECT_FALSE(roster.isOpen());
+
+    // Inconsistent columns are not written
+    std::vector<std::int8_t> shortColumn(RECORDS - 1);
+    EXPECT_FALSE(Core::writeRoster(file.path, { file.ids, file.tags, file.boons, file.banes, { "stealth" }, { shortColumn } }));
+    EXPECT_FALSE(Core::writeRoster(file.path, { file.ids, file.tags, file.boons, file.banes, { "a", "a" }, { file.stealth, file.melee } }));
+
+    // A truncated file, or one with a bad magic number, does not open
+    ASSERT_TRUE(file.write());
+    std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 1);
+    EXPECT_FALSE(roster.open(file.path));
+    ASSERT_TRUE(file.write());
+    {
+        std::fstream stream(file.path, std::ios::in | std::ios::out | std::ios::binary);
+        stream.put('X');
+    }
+    EXPECT_FALSE(roster.open(file.path));
+    EXPECT_FALSE(roster.isOpen());
+}
+
+// A sweep equals per-record targetRoll on each chunk's stream, whatever the thread count
+TEST(RosterTests, TargetSweepMatchesScalar) {
+    RosterFile file;
+    ASSERT_TRUE(file.write());
+    Core::Roster roster;
+    ASSERT_TRUE(roster.open(file.path));
+
+    const Core::RosterQuery query{ roster.findSkill("stealth"), VETERAN, 1, 0 };
+    Core::ThreadPool single(1), quad(4);
+    Core::RosterSweepOptions options;
+    options.seed = 9;
+    options.chunkSize = 1000;
+
+    SweepResult serial(RECORDS), parallel(RECORDS);
+    options.pool = &single;
+    ASSERT_TRUE(Core::targetRollSweep(roster, query, 3, serial.stats, serial.output(RECORDS), options));
+    options.pool = &quad;
+    ASSERT_TRUE(Core::targetRollSweep(roster, query, 3, parallel.stats, parallel.output(RECORDS), options));
+    EXPECT_EQ(serial.stats, parallel.stats);
+    EXPECT_EQ(serial.degrees, parallel.degrees);
+    EXPECT_EQ(serial.totals, parallel.totals);
+    EXPECT_EQ(serial.stats.rolls, RECORDS / 2);
+
+    Core::Stats::RollStats expected;
+    for (std::size_t chunk = 0; chunk < RECORDS / options.chunkSize; ++chunk) {
+        Core::RngContext rng(options.seed, chunk);
+        for (std::size_t i = chunk * options.chunkSize; i < (chunk + 1) * options.chunkSize; ++i) {
+            if ((file.tags[i] & VETERAN) == 0) {
+                EXPECT_EQ(serial.degrees[i], -99); // Unselected rows are left untouched
+                continue;
+            }
+            Core::TargetRollResult roll = Core::targetRoll(rng, file.stealth[i], 3, file.boons[i] + 1, file.banes[i]);
+            EXPECT_EQ(serial.successes[i], roll.success);
+            EXPECT_EQ(serial.degrees[i], roll.degree);
+            EXPECT_EQ(serial.totals[i], roll.roll.total);
+            expected.add(roll);
+        }
+    }
+    EXPECT_EQ(serial.stats, expected);
+}
+
+// Skill sweeps select by every required tag bit; bad queries and outputs are refused
+TEST(RosterTests, SkillSweepAndValidation) {
+    RosterFile file;
+    ASSERT_TRUE(file.write());
+    Core::Roster roster;
+
+    Core::Stats::RollStats stats;
+    EXPECT_FALSE(Core::skillRollSweep(roster, {}, stats));
+    ASSERT_TRUE(roster.open(file.path));
+    EXPECT_FALSE(Core::skillRollSweep(roster, { 2 }, stats));
+    std::vector<int> shortTotals(RECORDS - 1);
+    EXPECT_FALSE(Core::skillRollSweep(roster, {}, stats, { shortTotals, {}, {}, {} }));
+
+    std::vector<int> totals(RECORDS, -99);
+    ASSERT_TRUE(Core::skillRollSweep(roster, { roster.findSkill("melee"), VETERAN | SCOUT }, stats, { totals, {}, {}, {} }));
+    EXPECT_EQ(stats.rolls, RECORDS / 4);
+    EXPECT_EQ(stats.totals.total(), RECORDS / 4);
+    for (std::size_t i = 0; i < RECORDS; ++i) {
+        EXPECT_EQ(totals[i] != -99, file.tags[i] == (VETERAN | SCOUT));
+    }
+}
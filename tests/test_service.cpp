@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "RollService.h"
+
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Frames survive an encode/decode round trip, including negative fields
+TEST(ServiceTests, ProtocolRoundTrip) {
+    Protocol::Request request;
+    request.id = 0xDEADBEEF;
+    request.kind = Protocol::RequestKind::OPPOSED;
+    request.parameters = { -3, 1000, 64, 0, 2, 1 };
+    std::uint8_t frame[Protocol::REQUEST_BYTES];
+    Protocol::encodeRequest(request, frame);
+    Protocol::Request decoded = Protocol::decodeRequest(frame);
+    EXPECT_EQ(decoded.id, request.id);
+    EXPECT_EQ(decoded.kind, request.kind);
+    EXPECT_EQ(decoded.parameters, request.parameters);
+    EXPECT_TRUE(Protocol::isValidRequest(decoded));
+    decoded.parameters[2] = Protocol::MAX_MODIFIER + 1;
+    EXPECT_FALSE(Protocol::isValidRequest(decoded));
+
+    Protocol::Response response;
+    response.id = 7;
+    response.status = Protocol::Status::BAD_REQUEST;
+    response.degree = -4;
+    response.totals = { -12, 300 };
+    std::uint8_t reply[Protocol::RESPONSE_BYTES];
+    Protocol::encodeResponse(response, reply);
+    Protocol::Response back = Protocol::decodeResponse(reply);
+    EXPECT_EQ(back.id, 7u);
+    EXPECT_EQ(back.status, Protocol::Status::BAD_REQUEST);
+    EXPECT_EQ(back.degree, -4);
+    EXPECT_EQ(back.totals, response.totals);
+}
+
+// A pipelined burst is answered in order, with bad requests flagged
+TEST(ServiceTests, AnswersPipelinedRequests) {
+    ServiceOptions options;
+    options.socketPath = (std::filesystem::temp_directory_path() / "core_roll_test.sock").string();
+    options.hasSeed = true;
+    options.seed = 3;
+    RollService service(options);
+    ASSERT_TRUE(service.start());
+    std::thread server([&service] { service.run(); });
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+    ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+    constexpr std::uint32_t COUNT = 3000;
+    std::vector<std::uint8_t> frames(COUNT * Protocol::REQUEST_BYTES);
+    for (std::uint32_t id = 0; id < COUNT; ++id) {
+        Protocol::Request request;
+        request.id = id;
+        request.kind = id % 2 ? Protocol::RequestKind::OPPOSED : Protocol::RequestKind::TARGET;
+        request.parameters = { 3, 2, static_cast<std::int16_t>(id % 3), 0, 0, 0 };
+        if (id % 100 == 99) {
+            request.parameters[0] = Protocol::MAX_SKILL_LEVEL + 1;
+        }
+        Protocol::encodeRequest(request, frames.data() + id * Protocol::REQUEST_BYTES);
+    }
+    // Send in uneven pieces so frames straddle reads
+    for (std::size_t offset = 0; offset < frames.size();) {
+        std::size_t piece = std::min<std::size_t>(frames.size() - offset, 1237);
+        ASSERT_EQ(write(fd, frames.data() + offset, piece), static_cast<ssize_t>(piece));
+        offset += piece;
+    }
+
+    std::vector<std::uint8_t> replies(COUNT * Protocol::RESPONSE_BYTES);
+    for (std::size_t received = 0; received < replies.size();) {
+        ssize_t count = read(fd, replies.data() + received, replies.size() - received);
+        ASSERT_GT(count, 0);
+        received += static_cast<std::size_t>(count);
+    }
+    for (std::uint32_t id = 0; id < COUNT; ++id) {
+        Protocol::Response response = Protocol::decodeResponse(replies.data() + id * Protocol::RESPONSE_BYTES);
+        ASSERT_EQ(response.id, id);
+        if (id % 100 == 99) {
+            EXPECT_EQ(response.status, Protocol::Status::BAD_REQUEST);
+            continue;
+        }
+        EXPECT_EQ(response.status, Protocol::Status::OK);
+        EXPECT_GE(response.totals[0], 3 + 3);
+        EXPECT_LE(response.totals[0], 3 + 18);
+        if (response.kind == Protocol::RequestKind::OPPOSED) {
+            EXPECT_LE(response.outcome, 2);
+        }
+    }
+
+    close(fd);
+    service.stop();
+    server.join();
+    EXPECT_EQ(service.stats().requests, COUNT);
+    EXPECT_EQ(service.stats().badRequests, COUNT / 100);
+}
+
+// A client that pipelines several read budgets' worth of requests and then shuts down its side still gets
+// every response before the service closes the connection
+TEST(ServiceTests, AnswersHalfClosedClient) {
+    ServiceOptions options;
+    options.socketPath = (std::filesystem::temp_directory_path() / "core_roll_half_close.sock").string();
+    options.hasSeed = true;
+    options.seed = 4;
+    RollService service(options);
+    ASSERT_TRUE(service.start());
+    std::thread server([&service] { service.run(); });
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+    ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+    constexpr std::uint32_t COUNT = 20000;
+    std::vector<std::uint8_t> frames(COUNT * Protocol::REQUEST_BYTES);
+    for (std::uint32_t id = 0; id < COUNT; ++id) {
+        Protocol::Request request;
+        request.id = id;
+        request.kind = Protocol::RequestKind::TARGET;
+        request.parameters = { 2, 3, 1, 0, 0, 0 };
+        Protocol::encodeRequest(request, frames.data() + id * Protocol::REQUEST_BYTES);
+    }
+    for (std::size_t offset = 0; offset < frames.size();) {
+        ssize_t count = write(fd, frames.data() + offset, frames.size() - offset);
+        ASSERT_GT(count, 0);
+        offset += static_cast<std::size_t>(count);
+    }
+    ASSERT_EQ(shutdown(fd, SHUT_WR), 0);
+
+    std::vector<std::uint8_t> replies;
+    std::uint8_t buffer[4096];
+    ssize_t count;
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+        replies.insert(replies.end(), buffer, buffer + count);
+    }
+    EXPECT_EQ(count, 0); // Closed by the service once everything was sent
+    ASSERT_EQ(replies.size(), COUNT * Protocol::RESPONSE_BYTES);
+    for (std::uint32_t id = 0; id < COUNT; ++id) {
+        ASSERT_EQ(Protocol::decodeResponse(replies.data() + id * Protocol::RESPONSE_BYTES).id, id);
+    }
+
+    close(fd);
+    service.stop();
+    server.join();
+    EXPECT_EQ(service.stats().requests, COUNT);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "Core/Distribution.h"
+#include "Core/Simulator.h"
+
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+// Reports depend only on the options, not on how many threads ran them
+TEST(SimulatorTests, ReproducibleAcrossThreadCounts) {
+    Core::SimulationOptions options;
+    options.seed = 99;
+    options.maxTrials = 50'000;
+    options.trialsPerItem = 1000;
+
+    Core::ThreadPool single(1);
+    Core::ThreadPool quad(4);
+    Core::OpposedScenario scenario{ 3, 2, 1, 0, 0, 1 };
+    Core::SimulationReport a = Core::Simulator(options, &single).run(scenario);
+    Core::SimulationReport b = Core::Simulator(options, &quad).run(scenario);
+
+    EXPECT_EQ(a.trials, 50'000u);
+    EXPECT_EQ(a.attackerWins, b.attackerWins);
+    EXPECT_EQ(a.critWins, b.critWins);
+    EXPECT_EQ(a.degreeCounts, b.degreeCounts);
+}
+
+// Sampled rates agree with the exact distribution engine
+TEST(SimulatorTests, AgreesWithExactOdds) {
+    Core::SimulationOptions options;
+    options.seed = 5;
+    options.maxTrials = 200'000;
+    Core::SimulationReport report = Core::Simulator(options).run(Core::TargetScenario{ 4, 4, 1, 0 });
+    const auto& exact = Core::Distribution::targetRoll(4, 4, 1, 0);
+    EXPECT_NEAR(report.attackerWinRate(), exact.success, 0.01);
+    EXPECT_NEAR(report.critWinRate(), exact.critSuccess, 0.002);
+}
+
+// Early stopping ends the run once the requested interval width is reached
+TEST(SimulatorTests, StopsEarly) {
+    Core::SimulationOptions options;
+    options.maxTrials = 10'000'000;
+    options.targetIntervalWidth = 0.02;
+    Core::SimulationReport report = Core::Simulator(options).run([](Core::RngContext& rng) {
+        bool heads = rng.uniform(0, 1) == 1;
+        return Core::TrialOutcome{ heads ? Core::Winner::ATTACKER : Core::Winner::DEFENDER, 0, false, false };
+    });
+    EXPECT_TRUE(report.stoppedEarly);
+    EXPECT_LT(report.trials, options.maxTrials);
+    EXPECT_LE(report.intervalWidth(report.attackerWins), 0.02);
+}
+
+// Every estimator mode agrees with the exact odds within its own error bounds
+TEST(SimulatorTests, EstimatorsAgreeWithExactOdds) {
+    const Core::OpposedScenario scenario{ 3, 2, 0, 3, 2, 0 }; // Banes make the attacker's critical success rare
+    const auto& exact = Core::Distribution::opposedRoll(3, 2, 0, 3, 2, 0);
+    Core::SimulationOptions options;
+    options.seed = 11;
+    options.maxTrials = 100'000;
+
+    for (Core::EstimatorMode mode : { Core::EstimatorMode::PLAIN, Core::EstimatorMode::IMPORTANCE,
+                                      Core::EstimatorMode::STRATIFIED, Core::EstimatorMode::QUASI_RANDOM }) {
+        Core::EstimateReport report = Core::Simulator(options).estimate(scenario, mode);
+        SCOPED_TRACE(static_cast<int>(mode));
+        EXPECT_GE(report.trials, 99'000u);
+        EXPECT_GT(report.weightEffectiveSampleSize, 0.0);
+        for (auto [estimate, expected] : { std::pair{ report.attackerWin, exact.attacker }, std::pair{ report.defenderWin, exact.defender },
+                                           std::pair{ report.critWin, exact.critWin }, std::pair{ report.critLoss, exact.critLoss } }) {
+            EXPECT_NEAR(estimate.value, expected, 5.0 * estimate.standardError + 1e-12);
+            EXPECT_LE(estimate.lower, estimate.value);
+            EXPECT_GE(estimate.upper, estimate.value);
+        }
+    }
+}
+
+// Importance sampling and stratification pin down rare crits far better than plain trials, and
+// low-discrepancy points sharpen the common outcomes
+TEST(SimulatorTests, EstimatorsReduceVariance) {
+    const Core::OpposedScenario scenario{ 2, 2, 0, 4, 0, 4 }; // A critical success needs seven sixes: 1 in 279936
+    Core::SimulationOptions options;
+    options.maxTrials = 50'000;
+
+    Core::EstimateReport tilted = Core::Simulator(options).estimate(scenario, Core::EstimatorMode::IMPORTANCE);
+    EXPECT_GT(tilted.critWin.value, 0.0);
+    EXPECT_GT(tilted.critWin.effectiveSampleSize, 20.0 * tilted.trials);
+    EXPECT_LT(tilted.weightEffectiveSampleSize, static_cast<double>(tilted.trials));
+
+    Core::EstimateReport quasiRandom = Core::Simulator(options).estimate(scenario, Core::EstimatorMode::QUASI_RANDOM);
+    EXPECT_GT(quasiRandom.attackerWin.effectiveSampleSize, 1.5 * quasiRandom.trials);
+
+    Core::EstimateReport stratified = Core::Simulator(options).estimate(scenario, Core::EstimatorMode::STRATIFIED);
+    const auto& exact = Core::Distribution::opposedRoll(2, 2, 0, 4, 0, 4);
+    EXPECT_NEAR(stratified.critWin.value, exact.critWin, 1e-12);
+    EXPECT_EQ(stratified.critWin.standardError, 0.0);
+    EXPECT_TRUE(std::isinf(stratified.critWin.effectiveSampleSize));
+    EXPECT_GT(stratified.attackerWin.standardError, 0.0);
+}
+
+// Estimates depend only on the options, not on how many threads ran them
+TEST(SimulatorTests, EstimatorsReproducibleAcrossThreadCounts) {
+    Core::SimulationOptions options;
+    options.seed = 3;
+    options.maxTrials = 20'000;
+    options.trialsPerItem = 1000;
+    Core::ThreadPool single(1), quad(4);
+    for (Core::EstimatorMode mode : { Core::EstimatorMode::IMPORTANCE, Core::EstimatorMode::STRATIFIED,
+                                      Core::EstimatorMode::QUASI_RANDOM }) {
+        Core::EstimateReport a = Core::Simulator(options, &single).estimate({ 3, 3, 1, 0, 0, 1 }, mode);
+        Core::EstimateReport b = Core::Simulator(options, &quad).estimate({ 3, 3, 1, 0, 0, 1 }, mode);
+        EXPECT_EQ(a.trials, b.trials);
+        EXPECT_EQ(a.attackerWin.value, b.attackerWin.value);
+        EXPECT_EQ(a.critLoss.standardError, b.critLoss.standardError);
+    }
+}
+
+// A loop started from one of the pool's own tasks runs inline instead of deadlocking, and matches a
+// simulation run on its own
+TEST(SimulatorTests, NestedOnSamePool) {
+    Core::ThreadPool pool(4);
+    Core::SimulationOptions options;
+    options.seed = 17;
+    options.maxTrials = 20'000;
+    options.trialsPerItem = 1000;
+    const Core::OpposedScenario scenario{ 2, 1, 0, 0, 1, 0 };
+    const Core::SimulationReport expected = Core::Simulator(options, &pool).run(scenario);
+
+    std::vector<std::uint64_t> attackerWins(8);
+    std::vector<std::atomic<int>> inner(8);
+    pool.parallelFor(attackerWins.size(), [&](std::size_t index, unsigned worker) {
+        attackerWins[index] = Core::Simulator(options, &pool).run(scenario).attackerWins;
+        pool.parallelFor(100, [&](std::size_t, unsigned innerWorker) {
+            EXPECT_EQ(innerWorker, worker);
+            ++inner[index];
+        });
+    });
+    for (std::size_t i = 0; i < attackerWins.size(); ++i) {
+        EXPECT_EQ(attackerWins[i], expected.attackerWins);
+        EXPECT_EQ(inner[i].load(), 100);
+    }
+}
+
+// An exception from any task reaches the caller once every worker has stopped, and the pool stays usable
+TEST(SimulatorTests, PoolPropagatesExceptions) {
+    Core::ThreadPool pool(4);
+    for (std::size_t thrower : { std::size_t{ 0 }, std::size_t{ 999 } }) {
+        std::atomic<int> ran{ 0 };
+        EXPECT_THROW(pool.parallelFor(1000, [&](std::size_t index, unsigned) {
+            ++ran;
+            if (index == thrower) {
+                throw std::runtime_error("task failed");
+            }
+        }), std::runtime_error);
+        EXPECT_GE(ran.load(), 1);
+        EXPECT_LE(ran.load(), 1000);
+    }
+
+    std::atomic<std::size_t> sum{ 0 };
+    pool.parallelFor(1000, [&](std::size_t index, unsigned) { sum += index; });
+    EXPECT_EQ(sum.load(), 999u * 1000u / 2u);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "Core/Core.h"
+#include "Core/Stats.h"
+#include "Core/ThreadPool.h"
+
+#include <climits>
+#include <cmath>
+
+namespace {
+    // Accumulates `count` target and opposed rolls from stream `stream` of a fixed seed
+    Core::Stats::RollStats rollShard(std::uint64_t stream, int count) {
+        Core::RngContext rng(42, stream);
+        Core::Stats::RollStats stats;
+        for (int i = 0; i < count; ++i) {
+            stats.add(Core::targetRoll(rng, 2, 3, i % 3, i % 2));
+            stats.add(Core::opposedRoll(rng, 2, 1, 1, 0));
+        }
+        return stats;
+    }
+}
+
+// Results land in the right counters, and a serialized accumulator reads back identically
+TEST(StatsTests, AddAndSerialize) {
+    Core::Stats::RollStats stats;
+    stats.add(Core::SkillRollResult{ 14, {}, false, false });
+    stats.add(Core::TargetRollResult{ true, 1, { 17, {}, true, false }, true, false });
+    stats.add(Core::OpposedRollResult{ Core::Winner::DEFENDER, -2, { 8, {}, false, false }, { 16, {}, false, false }, false, false });
+    EXPECT_EQ(stats.rolls, 3u);
+    EXPECT_EQ(stats.winnerCount(Core::Winner::ATTACKER), 1u);
+    EXPECT_EQ(stats.winnerCount(Core::Winner::DEFENDER), 1u);
+    EXPECT_EQ(stats.critWins, 1u);
+    EXPECT_EQ(stats.totals.total(), 4u);
+    EXPECT_EQ(stats.totals.minValue(), 8);
+    EXPECT_EQ(stats.totals.maxValue(), 17);
+    EXPECT_EQ(stats.totals.count(16), 1u);
+    EXPECT_EQ(stats.degrees.count(-2), 1u);
+    EXPECT_DOUBLE_EQ(stats.totalMoments.mean(), 13.75);
+
+    std::vector<std::uint8_t> bytes;
+    stats.serialize(bytes);
+    Core::Stats::RollStats restored;
+    ASSERT_TRUE(Core::Stats::RollStats::deserialize(bytes, restored));
+    EXPECT_EQ(restored, stats);
+
+    // Truncated, extended or mislabeled input is rejected
+    EXPECT_FALSE(Core::Stats::RollStats::deserialize(std::span(bytes).first(bytes.size() - 1), restored));
+    bytes.push_back(0);
+    EXPECT_FALSE(Core::Stats::RollStats::deserialize(bytes, restored));
+    bytes.pop_back();
+    bytes[3] = 2;
+    EXPECT_FALSE(Core::Stats::RollStats::deserialize(bytes, restored));
+}
+
+// Any reduction tree gives the same accumulator and the same bytes, and stays small
+TEST(StatsTests, MergeIsAssociative) {
+    std::vector<Core::Stats::RollStats> shards;
+    for (std::uint64_t stream = 0; stream < 6; ++stream) {
+        shards.push_back(rollShard(stream, 2000));
+    }
+
+    Core::Stats::RollStats left;
+    for (const auto& shard : shards) left.merge(shard);
+
+    Core::Stats::RollStats right;
+    for (auto shard = shards.rbegin(); shard != shards.rend(); ++shard) right.merge(*shard);
+
+    Core::Stats::RollStats pairs[3];
+    for (int i = 0; i < 3; ++i) {
+        pairs[i] = shards[2 * i + 1];
+        pairs[i].merge(shards[2 * i]);
+    }
+    Core::Stats::RollStats tree = pairs[2];
+    pairs[0].merge(pairs[1]);
+    tree.merge(pairs[0]);
+
+    EXPECT_EQ(left, right);
+    EXPECT_EQ(left, tree);
+    EXPECT_EQ(left.rolls, 24000u);
+    std::vector<std::uint8_t> a, b;
+    left.serialize(a);
+    tree.serialize(b);
+    EXPECT_EQ(a, b);
+    EXPECT_LT(a.size(), 512u);
+}
+
+// Variance is exact even where the sum-of-squares formula cancels catastrophically
+TEST(StatsTests, StableMoments) {
+    Core::Stats::Moments moments;
+    for (int i = 0; i < 100000; ++i) {
+        moments.add(INT_MAX - 3 + i % 4); // 2^31 - 4 .. 2^31 - 1
+    }
+    EXPECT_EQ(moments.count(), 100000u);
+    EXPECT_NEAR(moments.mean(), INT_MAX - 1.5, 1e-6);
+    EXPECT_NEAR(moments.variance(), 1.25 * 100000 / 99999, 1e-9);
+
+    Core::Stats::Moments negative;
+    for (int value : { -7, -3, 1, 5, INT_MIN }) {
+        negative.add(value);
+    }
+    double mean = (-7.0 - 3.0 + 1.0 + 5.0 + INT_MIN) / 5.0;
+    double squares = 0.0;
+    for (double value : { -7.0, -3.0, 1.0, 5.0, static_cast<double>(INT_MIN) }) squares += (value - mean) * (value - mean);
+    EXPECT_NEAR(negative.mean(), mean, 1e-6);
+    EXPECT_NEAR(negative.variance() / (squares / 4.0), 1.0, 1e-12);
+}
+
+// Per-worker shards merged after a parallel loop equal serial accumulation
+TEST(StatsTests, ShardedMatchesSerial) {
+    Core::ThreadPool pool(4);
+    Core::Stats::ShardedStats shards(pool.size());
+    pool.parallelFor(8, [&](std::size_t index, unsigned worker) {
+        shards.shard(worker).merge(rollShard(index, 500));
+    });
+
+    Core::Stats::RollStats serial;
+    for (std::uint64_t stream = 0; stream < 8; ++stream) {
+        serial.merge(rollShard(stream, 500));
+    }
+    EXPECT_EQ(shards.merged(), serial);
+}